@@ -67,6 +67,8 @@
 //
 // -Initial implementation by Joseph Goldstone spring 2006
 //
+// -CLUT entries are computed in parallel 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 #include <iostream>
@@ -162,7 +164,9 @@ CLUT::makeAToBxTag(const unsigned int edgeN,
 
   CLUT_stuffer stuffer(edgeN, rawXYZ, flare, illuminant[1], CATToPCS,
                        mediaWhite, LABPCS);
-  m_innerCLUT->Iterate(&stuffer);
+  // CLUT_stuffer::PixelOp only reads its measurement data so it is safe
+  // to call from several threads at once
+  m_innerCLUT->IterateParallel(&stuffer);
 
   LPIccCurve* oLUT = lut16->NewCurvesB();
   if (inputShaperGamma == 1.0)
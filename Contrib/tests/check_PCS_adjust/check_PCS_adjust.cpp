@@ -0,0 +1,301 @@
+/*
+  File:       check_PCS_adjust.cpp
+ 
+  Contains:   Checks that merged PCS adjustments give the same results as unmerged ones
+
+  Version:    V1
+ 
+  Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "IccCmm.h"
+#include "IccProfile.h"
+#include "IccTag.h"
+#include "IccTagMPE.h"
+#include "IccMpeBasic.h"
+#include "IccUtil.h"
+
+//Largest difference (in internal encoding) allowed between a merged and an
+//unmerged chain.  Merging only changes float rounding.
+#define MAX_CHAIN_DIFF ((icFloatNumber)1.0e-4)
+
+static icUInt32Number g_nSeed = 1;
+
+static icFloatNumber NextRand()
+{
+  g_nSeed = g_nSeed * 1664525 + 1013904223;
+
+  return (icFloatNumber)(g_nSeed>>8) / (icFloatNumber)16777216.0;
+}
+
+static CIccTagXYZ *NewXYZTag(icFloatNumber X, icFloatNumber Y, icFloatNumber Z)
+{
+  CIccTagXYZ *pTag = new CIccTagXYZ();
+
+  (*pTag)[0].X = icDtoF(X);
+  (*pTag)[0].Y = icDtoF(Y);
+  (*pTag)[0].Z = icDtoF(Z);
+
+  return pTag;
+}
+
+static void InitHeader(CIccProfile *pIcc, icProfileClassSignature nClass)
+{
+  pIcc->InitHeader();
+  pIcc->m_Header.version = icVersionNumberV4;
+  pIcc->m_Header.deviceClass = nClass;
+  pIcc->m_Header.colorSpace = icSigRgbData;
+  pIcc->m_Header.pcs = icSigLabData;
+}
+
+static LPIccCurve *SetIdentityCurves(LPIccCurve *pCurves, int nCurves)
+{
+  int i;
+
+  for (i=0; i<nCurves; i++)
+    pCurves[i] = new CIccTagCurve(0);
+
+  return pCurves;
+}
+
+static void FillCLUT(CIccCLUT *pCLUT)
+{
+  icUInt32Number i, n = pCLUT->NumPoints() * pCLUT->GetOutputChannels();
+  icFloatNumber *pData = pCLUT->GetData(0);
+
+  //Keep values away from the encoding limits so that no chain clips
+  for (i=0; i<n; i++)
+    pData[i] = (icFloatNumber)0.25 + NextRand() * (icFloatNumber)0.5;
+}
+
+///RGB output profile with lutAtoBType/lutBtoAType tags, Lab PCS and a non D50 media white
+static CIccProfile *NewLutProfile()
+{
+  CIccProfile *pIcc = new CIccProfile();
+  int i;
+
+  InitHeader(pIcc, icSigOutputClass);
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9300, (icFloatNumber)0.9700, (icFloatNumber)0.8000));
+
+  for (i=0; i<3; i++) {
+    CIccTagLutAtoB *pAToB = new CIccTagLutAtoB();
+    pAToB->Init(3, 3);
+    SetIdentityCurves(pAToB->NewCurvesA(), 3);
+    FillCLUT(pAToB->NewCLUT(9));
+    SetIdentityCurves(pAToB->NewCurvesB(), 3);
+    pIcc->AttachTag((icTagSignature)(icSigAToB0Tag+i), pAToB);
+
+    CIccTagLutBtoA *pBToA = new CIccTagLutBtoA();
+    pBToA->Init(3, 3);
+    SetIdentityCurves(pBToA->NewCurvesB(), 3);
+    FillCLUT(pBToA->NewCLUT(9));
+    SetIdentityCurves(pBToA->NewCurvesA(), 3);
+    pIcc->AttachTag((icTagSignature)(icSigBToA0Tag+i), pBToA);
+  }
+
+  return pIcc;
+}
+
+static CIccTagMultiProcessElement *NewMatrixMpe(const icFloatNumber *pMatrix, const icFloatNumber *pConstants)
+{
+  CIccTagMultiProcessElement *pMpe = new CIccTagMultiProcessElement(3, 3);
+  CIccMpeMatrix *pMatrixElem = new CIccMpeMatrix();
+  int i;
+
+  pMatrixElem->SetSize(3, 3);
+  for (i=0; i<9; i++)
+    pMatrixElem->GetMatrix()[i] = pMatrix[i];
+  for (i=0; i<3; i++)
+    pMatrixElem->GetConstants()[i] = pConstants[i];
+  pMpe->Attach(pMatrixElem);
+
+  return pMpe;
+}
+
+///RGB display profile with DToB/BToD matrix element tags for every intent, Lab PCS and a D65 media white
+static CIccProfile *NewMpeProfile()
+{
+  static const icFloatNumber toLab[9] = { 30, 60, 10,  60, -60, 0,  0, 50, -50 };
+  static const icFloatNumber toLabOffset[3] = { 0, 0, 0 };
+  static const icFloatNumber fromLab[9] = { (icFloatNumber)0.01, (icFloatNumber)0.004, 0,
+                                            (icFloatNumber)0.01, 0, 0,
+                                            (icFloatNumber)0.01, 0, (icFloatNumber)-0.004 };
+  static const icFloatNumber fromLabOffset[3] = { 0, 0, 0 };
+
+  CIccProfile *pIcc = new CIccProfile();
+  int i;
+
+  InitHeader(pIcc, icSigDisplayClass);
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9505, (icFloatNumber)1.0, (icFloatNumber)1.0890));
+
+  for (i=0; i<4; i++) {
+    pIcc->AttachTag((icTagSignature)(icSigDToB0Tag+i), NewMatrixMpe(toLab, toLabOffset));
+    pIcc->AttachTag((icTagSignature)(icSigBToD0Tag+i), NewMatrixMpe(fromLab, fromLabOffset));
+  }
+
+  return pIcc;
+}
+
+///Creates a CMM for a chain of profiles (applied in order), with the first xform being an input xform if bFirstInput
+static CIccCmm *NewChain(icColorSpaceSignature nSrcSpace, bool bFirstInput, CIccProfile **pProfiles, int nProfiles,
+                         icRenderingIntent nIntent, bool bUseMpe)
+{
+  CIccCmm *pCmm = new CIccCmm(nSrcSpace, icSigUnknownData, bFirstInput);
+  int i;
+
+  for (i=0; i<nProfiles; i++) {
+    if (pCmm->AddXform(*pProfiles[i], nIntent, icInterpLinear, icXformLutColor, bUseMpe)!=icCmmStatOk) {
+      delete pCmm;
+      return NULL;
+    }
+  }
+
+  if (pCmm->Begin()!=icCmmStatOk) {
+    delete pCmm;
+    return NULL;
+  }
+
+  return pCmm;
+}
+
+///Compares applying both profiles in one CMM (which merges PCS adjustments)
+///with applying each profile in its own CMM (which can't)
+static bool CheckChain(const char *szName, CIccProfile *pFirst, CIccProfile *pSecond,
+                       icRenderingIntent nIntent, bool bUseMpe)
+{
+  CIccProfile *pBoth[2] = { pFirst, pSecond };
+  CIccCmm *pMerged = NewChain(icSigRgbData, true, pBoth, 2, nIntent, bUseMpe);
+  CIccCmm *pIn = NewChain(icSigRgbData, true, &pFirst, 1, nIntent, bUseMpe);
+  CIccCmm *pOut = NewChain(icSigLabData, false, &pSecond, 1, nIntent, bUseMpe);
+  icFloatNumber maxDiff = 0;
+  bool bOk = pMerged && pIn && pOut;
+
+  if (bOk) {
+    icFloatNumber src[3], pcs[3], merged[3], unmerged[3];
+    int i, j;
+
+    for (i=0; i<1000; i++) {
+      for (j=0; j<3; j++)
+        src[j] = (icFloatNumber)0.1 + NextRand() * (icFloatNumber)0.8;
+
+      pMerged->Apply(merged, src);
+      pIn->Apply(pcs, src);
+      pOut->Apply(unmerged, pcs);
+
+      for (j=0; j<3; j++) {
+        if (fabs(merged[j] - unmerged[j]) > maxDiff)
+          maxDiff = (icFloatNumber)fabs(merged[j] - unmerged[j]);
+      }
+    }
+    bOk = maxDiff <= MAX_CHAIN_DIFF;
+  }
+
+  if (!pMerged || !pIn || !pOut)
+    printf("%-40s unable to create CMM\tFAIL\n", szName);
+  else
+    printf("%-40s max difference %g\t%s\n", szName, maxDiff, bOk ? "PASS" : "FAIL");
+
+  if (pMerged)
+    delete pMerged;
+  if (pIn)
+    delete pIn;
+  if (pOut)
+    delete pOut;
+
+  return bOk;
+}
+
+int main(int argc, char* argv[])
+{
+  CIccProfile *pLut = NewLutProfile();
+  CIccProfile *pMpe = NewMpeProfile();
+  static const icRenderingIntent intents[4] = { icPerceptual, icRelativeColorimetric, icSaturation, icAbsoluteColorimetric };
+  static const char *szIntent[4] = { "perceptual", "relative", "saturation", "absolute" };
+  char name[80];
+  bool bOk = true;
+  int i;
+
+  for (i=0; i<4; i++) {
+    sprintf(name, "lut -> lut (%s)", szIntent[i]);
+    bOk = CheckChain(name, pLut, pLut, intents[i], true) && bOk;
+
+    sprintf(name, "mpe -> lut (%s)", szIntent[i]);
+    bOk = CheckChain(name, pMpe, pLut, intents[i], true) && bOk;
+
+    sprintf(name, "lut -> mpe (%s)", szIntent[i]);
+    bOk = CheckChain(name, pLut, pMpe, intents[i], true) && bOk;
+
+    sprintf(name, "mpe -> mpe (%s)", szIntent[i]);
+    bOk = CheckChain(name, pMpe, pMpe, intents[i], true) && bOk;
+  }
+
+  delete pMpe;
+  delete pLut;
+
+  printf("%s\n", bOk ? "All chains match" : "Merged and unmerged chains differ");
+
+  return bOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
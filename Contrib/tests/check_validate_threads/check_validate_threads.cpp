@@ -0,0 +1,231 @@
+/*
+  File:       check_validate_threads.cpp
+ 
+  Contains:   Checks that validating tags on several threads gives the same report as one thread
+
+  Version:    V1
+ 
+  Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string>
+#include "IccProfile.h"
+#include "IccTag.h"
+#include "IccUtil.h"
+
+//Number of times each multi-threaded validation is repeated, so that tags
+//finishing in a different order on each run would show up
+#define VALIDATE_PASSES 20
+
+static icUInt32Number g_nSeed = 1;
+
+static icFloatNumber NextRand()
+{
+  g_nSeed = g_nSeed * 1664525 + 1013904223;
+
+  return (icFloatNumber)(g_nSeed>>8) / (icFloatNumber)16777216.0;
+}
+
+static CIccTagXYZ *NewXYZTag(icFloatNumber X, icFloatNumber Y, icFloatNumber Z)
+{
+  CIccTagXYZ *pTag = new CIccTagXYZ();
+
+  (*pTag)[0].X = icDtoF(X);
+  (*pTag)[0].Y = icDtoF(Y);
+  (*pTag)[0].Z = icDtoF(Z);
+
+  return pTag;
+}
+
+static CIccTagMultiLocalizedUnicode *NewTextTag(const icChar *szText)
+{
+  CIccTagMultiLocalizedUnicode *pTag = new CIccTagMultiLocalizedUnicode();
+
+  pTag->SetText(szText);
+
+  return pTag;
+}
+
+///Gamma curve, stopping short of 1.0 when !bFullRange so that the tag reports a warning
+static CIccTagCurve *NewCurveTag(icFloatNumber gamma, bool bFullRange)
+{
+  CIccTagCurve *pTag = new CIccTagCurve(256);
+  icFloatNumber scale = bFullRange ? (icFloatNumber)1.0 : (icFloatNumber)0.95;
+  int i;
+
+  for (i=0; i<256; i++)
+    (*pTag)[i] = (icFloatNumber)pow(i/255.0, gamma) * scale;
+
+  return pTag;
+}
+
+static LPIccCurve *SetIdentityCurves(LPIccCurve *pCurves, int nCurves)
+{
+  int i;
+
+  for (i=0; i<nCurves; i++)
+    pCurves[i] = new CIccTagCurve(0);
+
+  return pCurves;
+}
+
+static void FillCLUT(CIccCLUT *pCLUT)
+{
+  icUInt32Number i, n = pCLUT->NumPoints() * pCLUT->GetOutputChannels();
+  icFloatNumber *pData = pCLUT->GetData(0);
+
+  for (i=0; i<n; i++)
+    pData[i] = NextRand();
+}
+
+///RGB output profile with lut, matrix/TRC, text and XYZ tags, some of which report problems
+static CIccProfile *NewProfile()
+{
+  CIccProfile *pIcc = new CIccProfile();
+  int i;
+
+  pIcc->InitHeader();
+  pIcc->m_Header.version = icVersionNumberV4;
+  pIcc->m_Header.deviceClass = icSigOutputClass;
+  pIcc->m_Header.colorSpace = icSigRgbData;
+  pIcc->m_Header.pcs = icSigLabData;
+
+  pIcc->AttachTag(icSigProfileDescriptionTag, NewTextTag("check_validate_threads"));
+  pIcc->AttachTag(icSigCopyrightTag, NewTextTag("No copyright"));
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9642, (icFloatNumber)1.0, (icFloatNumber)0.8249));
+  pIcc->AttachTag(icSigMediaBlackPointTag, NewXYZTag((icFloatNumber)-0.01, (icFloatNumber)0.0, (icFloatNumber)0.0));
+
+  pIcc->AttachTag(icSigRedColorantTag, NewXYZTag((icFloatNumber)0.4361, (icFloatNumber)0.2225, (icFloatNumber)0.0139));
+  pIcc->AttachTag(icSigGreenColorantTag, NewXYZTag((icFloatNumber)0.3851, (icFloatNumber)0.7169, (icFloatNumber)0.0971));
+  pIcc->AttachTag(icSigBlueColorantTag, NewXYZTag((icFloatNumber)0.1431, (icFloatNumber)0.0606, (icFloatNumber)0.7139));
+  pIcc->AttachTag(icSigRedTRCTag, NewCurveTag((icFloatNumber)2.2, false));
+  pIcc->AttachTag(icSigGreenTRCTag, NewCurveTag((icFloatNumber)2.2, true));
+  pIcc->AttachTag(icSigBlueTRCTag, NewCurveTag((icFloatNumber)1.8, false));
+
+  for (i=0; i<3; i++) {
+    CIccTagLutAtoB *pAToB = new CIccTagLutAtoB();
+    pAToB->Init(3, 3);
+    SetIdentityCurves(pAToB->NewCurvesA(), 3);
+    FillCLUT(pAToB->NewCLUT(17));
+    SetIdentityCurves(pAToB->NewCurvesB(), 3);
+    pIcc->AttachTag((icTagSignature)(icSigAToB0Tag+i), pAToB);
+
+    CIccTagLutBtoA *pBToA = new CIccTagLutBtoA();
+    pBToA->Init(3, 3);
+    SetIdentityCurves(pBToA->NewCurvesB(), 3);
+    FillCLUT(pBToA->NewCLUT(17));
+    SetIdentityCurves(pBToA->NewCurvesA(), 3);
+    pIcc->AttachTag((icTagSignature)(icSigBToA0Tag+i), pBToA);
+  }
+
+  return pIcc;
+}
+
+///Validates pIcc on nThreads threads VALIDATE_PASSES times and compares each result with the single threaded one
+static bool CheckThreads(CIccProfile *pIcc, icUInt32Number nThreads,
+                         icValidateStatus nExpectStatus, const std::string &sExpectReport)
+{
+  int nMismatch = 0;
+  int i;
+
+  for (i=0; i<VALIDATE_PASSES; i++) {
+    std::string sReport;
+    icValidateStatus nStatus = pIcc->Validate(sReport, nThreads);
+
+    if (nStatus!=nExpectStatus || sReport!=sExpectReport)
+      nMismatch++;
+  }
+
+  printf("%u thread(s)%s: %d of %d reports differ\t%s\n", nThreads, nThreads ? "" : " (one per processor)",
+         nMismatch, VALIDATE_PASSES, nMismatch ? "FAIL" : "PASS");
+
+  return !nMismatch;
+}
+
+int main(int argc, char* argv[])
+{
+  CIccProfile *pIcc = NewProfile();
+  std::string sReport;
+  icValidateStatus nStatus = pIcc->Validate(sReport, 1);
+  bool bOk = true;
+
+  //The profile has problems in more than one tag, so the order that tag
+  //reports are merged in matters
+  if (nStatus==icValidateOK || sReport.empty()) {
+    printf("Single threaded validation found no problems\tFAIL\n");
+    bOk = false;
+  }
+
+  bOk = CheckThreads(pIcc, 0, nStatus, sReport) && bOk;
+  bOk = CheckThreads(pIcc, 4, nStatus, sReport) && bOk;
+  bOk = CheckThreads(pIcc, 32, nStatus, sReport) && bOk;
+
+  delete pIcc;
+
+  printf("%s\n", bOk ? "All reports match" : "Multi-threaded validation reports differ");
+
+  return bOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -67,6 +67,16 @@
 // -Initial implementation by Max Derhak 5-15-2003
 // -Added support for Monochrome ICC profile apply by Rohit Patil 12-03-2008
 // -Integrated changes for PCS adjustment by George Pawle 12-09-2008
+// -Added CIccColorEncoding and batch encoding conversions 10-19-2026
+// -Fold PCS adjustments into matrix/TRC xforms and adjacent xforms 10-19-2026
+// -Added array versions of CIccPCS::LabToXyz and XyzToLab 10-19-2026
+// -Added index based named color apply interfaces 10-19-2026
+// -Added apply chain performance counters 10-19-2026
+// -Added setup phase timing events 10-19-2026
+// -Fixed CIccApplyMruCmm::Apply of multiple pixels 10-19-2026
+// -Added SaveCompiled/LoadCompiled compiled transform blobs 10-19-2026
+// -Added CIccCmm::GetXform 10-19-2026
+// -Apply of multiple pixels uses array PCS conversions 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -78,6 +88,8 @@
 #include "IccTag.h"
 #include "IccIO.h"
 #include "IccApplyBPC.h"
+#include "IccProfLibVer.h"
+#include "md5.h"
 
 #ifdef USESAMPLEICCNAMESPACE
 namespace sampleICC {
@@ -190,6 +202,69 @@ const icFloatNumber *CIccPCS::Check(const icFloatNumber *SrcPixel, const CIccXfo
   return rv;
 }
 
+/**
+ **************************************************************************
+ * Name: CIccPCS::Check
+ * 
+ * Purpose:
+ *  Array version of Check() that adjusts nPixels packed pixels to the
+ *  xform's needed PCS using the array PCS conversions.
+ * 
+ * Args: 
+ *   pConvert = buffer for nPixels*3 adjusted values,
+ *   SrcPixels = source pixel data (this may need adjusting),
+ *   pXform = the xform that who's Apply function will shortly be called,
+ *   nPixels = number of pixels in SrcPixels
+ * 
+ * Return: 
+ *  SrcPixels or pConvert if the pixel data was adjusted.
+ **************************************************************************
+ */
+const icFloatNumber *CIccPCS::Check(icFloatNumber *pConvert, const icFloatNumber *SrcPixels,
+                                    const CIccXform *pXform, icUInt32Number nPixels)
+{
+  icColorSpaceSignature NextSpace = pXform->GetSrcSpace();
+  bool bIsV2 = pXform->UseLegacyPCS();
+  bool bIsNextV2Lab = bIsV2 && (NextSpace == icSigLabData);
+  const icFloatNumber *rv;
+  bool bNoClip = pXform->NoClipPCS();
+
+  if (m_bIsV2Lab && !bIsNextV2Lab) {
+    Lab2ToLab4(pConvert, SrcPixels, nPixels, bNoClip);
+    if (NextSpace==icSigXYZData) {
+      LabToXyz(pConvert, pConvert, nPixels, bNoClip);
+    }
+    rv = pConvert;
+  }
+  else if (!m_bIsV2Lab && bIsNextV2Lab) {
+    if (m_Space==icSigXYZData) {
+      XyzToLab(pConvert, SrcPixels, nPixels, bNoClip);
+      SrcPixels = pConvert;
+    }
+    Lab4ToLab2(pConvert, SrcPixels, nPixels);
+    rv = pConvert;
+  }
+  else if (m_Space==NextSpace) {
+    rv = SrcPixels;
+  }
+  else if (m_Space==icSigXYZData && NextSpace==icSigLabData) {
+    XyzToLab(pConvert, SrcPixels, nPixels, bNoClip);
+    rv = pConvert;
+  }
+  else if (m_Space==icSigLabData && NextSpace==icSigXYZData) {
+    LabToXyz(pConvert, SrcPixels, nPixels, bNoClip);
+    rv = pConvert;
+  }
+  else {
+    rv = SrcPixels;
+  }
+
+  m_Space = pXform->GetDstSpace();
+  m_bIsV2Lab = bIsV2 && (m_Space == icSigLabData);
+
+  return rv;
+}
+
 /**
  **************************************************************************
  * Name: CIccPCS::CheckLast
@@ -223,6 +298,39 @@ void CIccPCS::CheckLast(icFloatNumber *Pixel, icColorSpaceSignature DestSpace, b
   }
 }
 
+/**
+ **************************************************************************
+ * Name: CIccPCS::CheckLast
+ * 
+ * Purpose: 
+ *   Array version of CheckLast() that adjusts nPixels packed pixels.
+ * 
+ * Args: 
+ *  Pixels = Pixel data,
+ *  DestSpace = destination color space,
+ *  nPixels = number of pixels in Pixels,
+ *  bNoClip = indicates whether PCS should be clipped
+ **************************************************************************
+ */
+void CIccPCS::CheckLast(icFloatNumber *Pixels, icColorSpaceSignature DestSpace, icUInt32Number nPixels, bool bNoClip)
+{
+  if (m_bIsV2Lab) {
+    Lab2ToLab4(Pixels, Pixels, nPixels, bNoClip);
+    if (DestSpace==icSigXYZData) {
+      LabToXyz(Pixels, Pixels, nPixels, bNoClip);
+    }
+  }
+  else if (m_Space==DestSpace) {
+    return;
+  }
+  else if (m_Space==icSigXYZData) {
+    XyzToLab(Pixels, Pixels, nPixels, bNoClip);
+  }
+  else if (m_Space==icSigLabData) {
+    LabToXyz(Pixels, Pixels, nPixels, bNoClip);
+  }
+}
+
 /**
  **************************************************************************
  * Name: CIccPCS::UnitClip
@@ -262,30 +370,58 @@ icFloatNumber CIccPCS::NegClip(icFloatNumber v)
  * Name: CIccPCS::LabToXyz
  * 
  * Purpose: 
- *  Convert Lab to XYZ
+ *  Convert Lab to XYZ.  Uses the same conversion as the array version so
+ *  that single pixel and batch applies give identical results.
  **************************************************************************
  */
 void CIccPCS::LabToXyz(icFloatNumber *Dst, const icFloatNumber *Src, bool bNoClip)
 {
-  icFloatNumber Lab[3];
+  LabToXyz(Dst, Src, 1, bNoClip);
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccPCS::XyzToLab
+ * 
+ * Purpose: 
+ *  Convert XYZ to Lab.  Uses the same conversion as the array version so
+ *  that single pixel and batch applies give identical results.
+ **************************************************************************
+ */
+void CIccPCS::XyzToLab(icFloatNumber *Dst, const icFloatNumber *Src, bool bNoClip)
+{
+  XyzToLab(Dst, Src, 1, bNoClip);
+}
 
-  memcpy(&Lab,Src,sizeof(Lab));
 
-  icLabFromPcs(Lab);
+/**
+ **************************************************************************
+ * Name: CIccPCS::LabToXyz
+ * 
+ * Purpose: 
+ *  Convert nPixels packed Lab pixels to XYZ
+ **************************************************************************
+ */
+void CIccPCS::LabToXyz(icFloatNumber *Dst, const icFloatNumber *Src, icUInt32Number nPixels, bool bNoClip)
+{
+  icUInt32Number i, n = nPixels*3;
 
-  icLabtoXYZ(Lab);
+  for (i=0; i<n; i+=3) {
+    Dst[i] = (icFloatNumber)(Src[i] * 100.0);
+    Dst[i+1] = (icFloatNumber)(Src[i+1]*255.0 - 128.0);
+    Dst[i+2] = (icFloatNumber)(Src[i+2]*255.0 - 128.0);
+  }
 
-  icXyzToPcs(Lab);
+  icLabtoXYZN(Dst, Dst, nPixels);
 
   if (!bNoClip) {
-    Dst[0] = UnitClip(Lab[0]);
-    Dst[1] = UnitClip(Lab[1]);
-    Dst[2] = UnitClip(Lab[2]);
+    for (i=0; i<n; i++)
+      Dst[i] = UnitClip((icFloatNumber)(Dst[i] * 32768.0 / 65535.0));
   }
   else {
-    Dst[0] = Lab[0];
-    Dst[1] = Lab[1];
-    Dst[2] = Lab[2];
+    for (i=0; i<n; i++)
+      Dst[i] = (icFloatNumber)(Dst[i] * 32768.0 / 65535.0);
   }
 }
 
@@ -295,40 +431,33 @@ void CIccPCS::LabToXyz(icFloatNumber *Dst, const icFloatNumber *Src, bool bNoCli
  * Name: CIccPCS::XyzToLab
  * 
  * Purpose: 
- *  Convert XYZ to Lab
+ *  Convert nPixels packed XYZ pixels to Lab
  **************************************************************************
  */
-void CIccPCS::XyzToLab(icFloatNumber *Dst, const icFloatNumber *Src, bool bNoClip)
+void CIccPCS::XyzToLab(icFloatNumber *Dst, const icFloatNumber *Src, icUInt32Number nPixels, bool bNoClip)
 {
-  icFloatNumber XYZ[3];
-
+  icUInt32Number i, n = nPixels*3;
 
   if (!bNoClip) {
-    XYZ[0] = UnitClip(Src[0]);
-    XYZ[1] = UnitClip(Src[1]);
-    XYZ[2] = UnitClip(Src[2]);
+    for (i=0; i<n; i++)
+      Dst[i] = (icFloatNumber)(UnitClip(Src[i]) * 65535.0 / 32768.0);
   }
   else {
-    XYZ[0] = Src[0];
-    XYZ[1] = Src[1];
-    XYZ[2] = Src[2];
+    for (i=0; i<n; i++)
+      Dst[i] = (icFloatNumber)(Src[i] * 65535.0 / 32768.0);
   }
- 
-  icXyzFromPcs(XYZ);
 
-  icXYZtoLab(XYZ);
+  icXYZtoLabN(Dst, Dst, nPixels);
 
-  icLabToPcs(XYZ);
+  for (i=0; i<n; i+=3) {
+    Dst[i] = (icFloatNumber)(Dst[i] / 100.0);
+    Dst[i+1] = (icFloatNumber)((Dst[i+1] + 128.0) / 255.0);
+    Dst[i+2] = (icFloatNumber)((Dst[i+2] + 128.0) / 255.0);
+  }
 
   if (!bNoClip) {
-    Dst[0] = UnitClip(XYZ[0]);
-    Dst[1] = UnitClip(XYZ[1]);
-    Dst[2] = UnitClip(XYZ[2]);
-  }
-  else {
-    Dst[0] = XYZ[0];
-    Dst[1] = XYZ[1];
-    Dst[2] = XYZ[2];
+    for (i=0; i<n; i++)
+      Dst[i] = UnitClip(Dst[i]);
   }
 }
 
@@ -400,6 +529,44 @@ void CIccPCS::Lab4ToLab2(icFloatNumber *Dst, const icFloatNumber *Src)
   Dst[2] = (icFloatNumber)(Src[2] * 65280.0f / 65535.0f);
 }
 
+/**
+ **************************************************************************
+ * Name: CIccPCS::Lab2ToLab4
+ * 
+ * Purpose: 
+ *  Convert nPixels packed version 2 Lab pixels to version 4 Lab
+ **************************************************************************
+ */
+void CIccPCS::Lab2ToLab4(icFloatNumber *Dst, const icFloatNumber *Src, icUInt32Number nPixels, bool bNoClip)
+{
+  icUInt32Number i, n = nPixels*3;
+
+  if (bNoClip) {
+    for (i=0; i<n; i++)
+      Dst[i] = (icFloatNumber)(Src[i] * 65535.0f / 65280.0f);
+  }
+  else {
+    for (i=0; i<n; i++)
+      Dst[i] = UnitClip((icFloatNumber)(Src[i] * 65535.0f / 65280.0f));
+  }
+}
+
+/**
+ **************************************************************************
+ * Name: CIccPCS::Lab4ToLab2
+ * 
+ * Purpose: 
+ *  Convert nPixels packed version 4 Lab pixels to version 2 Lab
+ **************************************************************************
+ */
+void CIccPCS::Lab4ToLab2(icFloatNumber *Dst, const icFloatNumber *Src, icUInt32Number nPixels)
+{
+  icUInt32Number i, n = nPixels*3;
+
+  for (i=0; i<n; i++)
+    Dst[i] = (icFloatNumber)(Src[i] * 65280.0f / 65535.0f);
+}
+
 /**
 **************************************************************************
 * Name: CIccCreateXformHintManager::CIccCreateXformHintManager
@@ -540,6 +707,11 @@ CIccXform::CIccXform()
   m_nIntent = icUnknownIntent;
 	m_pAdjustPCS = NULL;
 	m_bAdjustPCS = false;
+	m_bApplyAdjustPCS = false;
+  m_nLutType = icXformLutColor;
+  m_bUseMpeTags = false;
+  m_bAdjustPCSHint = false;
+  m_bCompiledPCS = false;
 }
 
 
@@ -799,6 +971,8 @@ CIccXform *CIccXform::Create(CIccProfile *pProfile, bool bInput/* =true */, icRe
 
   if (rv) {
     rv->SetParams(pProfile, bInput, nIntent, nInterp, pHintManager);
+    rv->m_nLutType = nLutType;
+    rv->m_bUseMpeTags = bUseMpeTags;
   }
 
   return rv;
@@ -831,6 +1005,7 @@ void CIccXform::SetParams(CIccProfile *pProfile, bool bInput, icRenderingIntent
 		CIccCreateAdjustPCSXformHint *pAdjustPCSHint = (CIccCreateAdjustPCSXformHint*)pHint;
 		m_pAdjustPCS = pAdjustPCSHint->GetNewAdjustPCSXform();
 	}
+  m_bAdjustPCSHint = m_pAdjustPCS!=NULL;
 }
 
 /**
@@ -872,16 +1047,15 @@ CIccXform *CIccXform::Create(CIccProfile &Profile, bool bInput/* =true */, icRen
 
 /**
  **************************************************************************
- * Name: CIccXform::Begin
+ * Name: CIccXform::CalcPCSAdjust
  * 
  * Purpose: 
- *  This function will be called before the xform is applied.  Derived objects
- *  should also call this base class function to initialize for Absolute Colorimetric
- *  Intent handling which is performed through the use of the CheckSrcAbs and
- *  CheckDstAbs functions.
+ *  Sets up the PCS scale and offset used for absolute intent, version 2
+ *  perceptual black point and PCS adjustment hint (such as BPC) handling.
+ *  Called by Begin() unless the adjustment was restored by LoadCompiled().
  **************************************************************************
  */
-icStatusCMM CIccXform::Begin()
+icStatusCMM CIccXform::CalcPCSAdjust()
 {
   if (m_nIntent==icAbsoluteColorimetric) {
     CIccTag *pTag = m_pProfile->FindTag(icSigMediaWhitePointTag);
@@ -951,6 +1125,7 @@ icStatusCMM CIccXform::Begin()
 
 
 	if (m_pAdjustPCS) {
+		CIccSetupTimer setupTimer(icSetupAdjustPCS);
 		CIccProfile ProfileCopy(*m_pProfile);
 
 		// need to read in all the tags, so that a copy of the profile can be made
@@ -970,6 +1145,162 @@ icStatusCMM CIccXform::Begin()
   return icCmmStatOk;
 }
 
+
+/**
+ **************************************************************************
+ * Name: CIccXform::Begin
+ * 
+ * Purpose: 
+ *  This function will be called before the xform is applied.  Derived objects
+ *  should also call this base class function to initialize for Absolute Colorimetric
+ *  Intent handling which is performed through the use of the CheckSrcAbs and
+ *  CheckDstAbs functions.
+ **************************************************************************
+ */
+icStatusCMM CIccXform::Begin()
+{
+  if (!m_bCompiledPCS) {
+    icStatusCMM rv = CalcPCSAdjust();
+
+    if (rv != icCmmStatOk)
+      return rv;
+  }
+
+  m_bApplyAdjustPCS = m_bAdjustPCS;
+  if (m_bAdjustPCS) {
+    memcpy(m_ApplyPCSScale, m_PCSScale, sizeof(m_ApplyPCSScale));
+    memcpy(m_ApplyPCSOffset, m_PCSOffset, sizeof(m_ApplyPCSOffset));
+  }
+
+  return icCmmStatOk;
+}
+
+/**
+ **************************************************************************
+ * Name: CIccXform::CombinePCSAdjust
+ * 
+ * Purpose: 
+ *  Merges the PCS adjustment that pPrev applies after its transform with
+ *  the PCS adjustment that this xform applies before its transform.  This
+ *  is only done when the PCS passes between the two xforms unchanged so
+ *  that one PCS to XYZ to PCS conversion is avoided for each pixel.
+ *  Both xforms must have had Begin() called.
+ * 
+ * Args: 
+ *  pPrev = xform applied immediately before this xform
+ * 
+ * Return: 
+ *  true if the adjustments were combined.
+ **************************************************************************
+ */
+bool CIccXform::CombinePCSAdjust(CIccXform *pPrev)
+{
+  if (!pPrev || !pPrev->m_bInput || !pPrev->m_bApplyAdjustPCS || m_bInput || !m_bApplyAdjustPCS)
+    return false;
+
+  icColorSpaceSignature Space = m_pProfile->m_Header.pcs;
+
+  if (pPrev->m_pProfile->m_Header.pcs!=Space ||
+      pPrev->GetDstSpace()!=Space || GetSrcSpace()!=Space)
+    return false;
+
+  if (Space==icSigLabData) {
+    if (pPrev->UseLegacyPCS()!=UseLegacyPCS())
+      return false;
+  }
+#ifndef SAMPLEICC_NOCLIPLABTOXYZ
+  else {
+    //AdjustPCS clips negative XYZ values after each adjustment
+    return false;
+  }
+#endif
+
+  int i;
+  for (i=0; i<3; i++) {
+    m_ApplyPCSOffset[i] = m_ApplyPCSScale[i] * pPrev->m_ApplyPCSOffset[i] + m_ApplyPCSOffset[i];
+    m_ApplyPCSScale[i] = m_ApplyPCSScale[i] * pPrev->m_ApplyPCSScale[i];
+  }
+  pPrev->m_bApplyAdjustPCS = false;
+
+  return true;
+}
+
+/**
+ **************************************************************************
+ * Name: CIccXform::SaveCompiled
+ * 
+ * Purpose: 
+ *  Writes the PCS adjustment computed by Begin() (absolute intent, version 2
+ *  perceptual black point and PCS adjustment hint factors) and whether a PCS
+ *  adjustment hint was used.  Derived xforms
+ *  that have other costly setup state should call this first and then write
+ *  their own state.
+ * 
+ * Args: 
+ *  pIO = IO object to write state to
+ * 
+ * Return: 
+ *  true if state was written
+ **************************************************************************
+ */
+bool CIccXform::SaveCompiled(CIccIO *pIO)
+{
+  icUInt32Number nFlags = (m_bAdjustPCS ? 1 : 0) | (m_bAdjustPCSHint ? 2 : 0);
+
+  if (!pIO->Write32(&nFlags))
+    return false;
+
+  if (m_bAdjustPCS) {
+    if (pIO->WriteFloat32Float(m_PCSScale, 3)!=3 ||
+        pIO->WriteFloat32Float(m_PCSOffset, 3)!=3)
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ **************************************************************************
+ * Name: CIccXform::LoadCompiled
+ * 
+ * Purpose: 
+ *  Reads state written by SaveCompiled().  Must be called after the xform is
+ *  created and before Begin() so that Begin() uses the restored state rather
+ *  than computing it from the profile.
+ * 
+ * Args: 
+ *  pIO = IO object to read state from
+ * 
+ * Return: 
+ *  true if state was read
+ **************************************************************************
+ */
+bool CIccXform::LoadCompiled(CIccIO *pIO)
+{
+  icUInt32Number nFlags;
+
+  if (!pIO->Read32(&nFlags) || nFlags>3)
+    return false;
+
+  m_bAdjustPCS = (nFlags & 1)!=0;
+  m_bAdjustPCSHint = (nFlags & 2)!=0;
+  if (m_bAdjustPCS) {
+    if (pIO->ReadFloat32Float(m_PCSScale, 3)!=3 ||
+        pIO->ReadFloat32Float(m_PCSOffset, 3)!=3)
+      return false;
+  }
+
+  //Factors from an adjustment hint are already included
+  if (m_pAdjustPCS) {
+    delete m_pAdjustPCS;
+    m_pAdjustPCS = NULL;
+  }
+
+  m_bCompiledPCS = true;
+
+  return true;
+}
+
 /**
 **************************************************************************
 * Name: CIccXform::GetNewApply
@@ -1024,9 +1355,9 @@ void CIccXform::AdjustPCS(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel
 		DstPixel[2] = SrcPixel[2];
 	}
 
-	DstPixel[0] = (icFloatNumber)(DstPixel[0] * m_PCSScale[0] + m_PCSOffset[0]);
-	DstPixel[1] = (icFloatNumber)(DstPixel[1] * m_PCSScale[1] + m_PCSOffset[1]);
-	DstPixel[2] = (icFloatNumber)(DstPixel[2] * m_PCSScale[2] + m_PCSOffset[2]);
+	DstPixel[0] = (icFloatNumber)(DstPixel[0] * m_ApplyPCSScale[0] + m_ApplyPCSOffset[0]);
+	DstPixel[1] = (icFloatNumber)(DstPixel[1] * m_ApplyPCSScale[1] + m_ApplyPCSOffset[1]);
+	DstPixel[2] = (icFloatNumber)(DstPixel[2] * m_ApplyPCSScale[2] + m_ApplyPCSOffset[2]);
 
 	if (Space==icSigLabData) {
 		if (UseLegacyPCS()) {
@@ -1064,7 +1395,7 @@ void CIccXform::AdjustPCS(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel
 const icFloatNumber *CIccXform::CheckSrcAbs(CIccApplyXform *pApply, const icFloatNumber *Pixel) const
 {
   icFloatNumber *pAbsLab = pApply->m_AbsLab;
-	if (m_bAdjustPCS && !m_bInput) {
+	if (m_bApplyAdjustPCS && !m_bInput) {
 		AdjustPCS(pAbsLab, Pixel);
         return pAbsLab;
       }
@@ -1088,7 +1419,7 @@ const icFloatNumber *CIccXform::CheckSrcAbs(CIccApplyXform *pApply, const icFloa
  */
 void CIccXform::CheckDstAbs(icFloatNumber *Pixel) const
 {
-	if (m_bAdjustPCS && m_bInput) {
+	if (m_bApplyAdjustPCS && m_bInput) {
 		AdjustPCS(Pixel, Pixel);
           }
         }
@@ -1192,42 +1523,122 @@ CIccApplyXform::~CIccApplyXform()
 
 /**
 **************************************************************************
-* Name: CIccXformMonochrome::CIccXformMonochrome
+* Name: icSaveCompiledCurves
 * 
 * Purpose: 
-*  Constructor
+*  Writes a count of curves followed by the size and float entries of each
+*  curve.  Only sampled curves (such as the inverse curves made by Begin())
+*  can be written.
 **************************************************************************
 */
-CIccXformMonochrome::CIccXformMonochrome()
+static bool icSaveCompiledCurves(CIccIO *pIO, CIccCurve **pCurves, icUInt32Number nCurves)
 {
-	m_Curve = NULL;
-	m_ApplyCurvePtr = NULL;
-	m_bFreeCurve = false;
+  if (!pIO->Write32(&nCurves))
+    return false;
+
+  icUInt32Number i;
+  for (i=0; i<nCurves; i++) {
+    if (!pCurves[i] || pCurves[i]->GetType()!=icSigCurveType)
+      return false;
+
+    CIccTagCurve *pCurve = (CIccTagCurve*)pCurves[i];
+    icUInt32Number nSize = pCurve->GetSize();
+
+    if (!pIO->Write32(&nSize))
+      return false;
+    if (nSize && pIO->WriteFloat32Float(pCurve->GetData(0), nSize)!=(icInt32Number)nSize)
+      return false;
+  }
+
+  return true;
 }
 
 /**
 **************************************************************************
-* Name: CIccXformMonochrome::~CIccXformMonochrome
+* Name: icLoadCompiledCurves
 * 
 * Purpose: 
-*  Destructor
+*  Reads curves written by icSaveCompiledCurves().  nCurves is the number
+*  of curves expected (zero is also accepted).  The caller owns the
+*  returned curves.
+* 
+* Return: 
+*  The number of curves read or -1 if the data is bad.
 **************************************************************************
 */
-CIccXformMonochrome::~CIccXformMonochrome()
+static int icLoadCompiledCurves(CIccIO *pIO, CIccCurve **pCurves, icUInt32Number nCurves)
 {
-	if (m_bFreeCurve && m_Curve) {
-		delete m_Curve;
-	}
+  icUInt32Number n, i;
+
+  if (!pIO->Read32(&n) || (n && n!=nCurves))
+    return -1;
+
+  for (i=0; i<n; i++) {
+    icUInt32Number nSize;
+
+    if (!pIO->Read32(&nSize) || nSize<2 || nSize>65536)
+      break;
+
+    CIccTagCurve *pCurve = new CIccTagCurve(nSize);
+
+    if (pIO->ReadFloat32Float(pCurve->GetData(0), nSize)!=(icInt32Number)nSize) {
+      delete pCurve;
+      break;
+    }
+    pCurves[i] = pCurve;
+  }
+
+  if (i<n) {
+    while (i) {
+      i--;
+      delete pCurves[i];
+      pCurves[i] = NULL;
+    }
+    return -1;
+  }
+
+  return (int)n;
 }
 
 /**
 **************************************************************************
-* Name: CIccXformMonochrome::Begin
+* Name: CIccXformMonochrome::CIccXformMonochrome
 * 
 * Purpose: 
-*  Does the initialization of the Xform before Apply() is called.
-*  Must be called before Apply().
-*
+*  Constructor
+**************************************************************************
+*/
+CIccXformMonochrome::CIccXformMonochrome()
+{
+	m_Curve = NULL;
+	m_ApplyCurvePtr = NULL;
+	m_bFreeCurve = false;
+	m_bCompiledCurve = false;
+}
+
+/**
+**************************************************************************
+* Name: CIccXformMonochrome::~CIccXformMonochrome
+* 
+* Purpose: 
+*  Destructor
+**************************************************************************
+*/
+CIccXformMonochrome::~CIccXformMonochrome()
+{
+	if (m_bFreeCurve && m_Curve) {
+		delete m_Curve;
+	}
+}
+
+/**
+**************************************************************************
+* Name: CIccXformMonochrome::Begin
+* 
+* Purpose: 
+*  Does the initialization of the Xform before Apply() is called.
+*  Must be called before Apply().
+*
 **************************************************************************
 */
 icStatusCMM CIccXformMonochrome::Begin()
@@ -1248,7 +1659,8 @@ icStatusCMM CIccXformMonochrome::Begin()
 		}
 	}
 	else {
-		m_Curve = GetInvCurve(icSigGrayTRCTag);
+		if (!m_bCompiledCurve)
+			m_Curve = GetInvCurve(icSigGrayTRCTag);
 		m_bFreeCurve = true;
 
 		if (!m_Curve) {
@@ -1379,6 +1791,7 @@ CIccCurve *CIccXformMonochrome::GetInvCurve(icSignature sig) const
 {
 	CIccCurve *pCurve;
 	CIccTagCurve *pInvCurve;
+	CIccSetupTimer setupTimer(icSetupInvCurve, -1, sig);
 
 	if (!(pCurve = GetCurve(sig)))
 		return NULL;
@@ -1386,6 +1799,7 @@ CIccCurve *CIccXformMonochrome::GetInvCurve(icSignature sig) const
 	pCurve->Begin();
 
 	pInvCurve = new CIccTagCurve(2048);
+	setupTimer.SetBytes(2048*sizeof(icFloatNumber));
 
 	int i;
 	icFloatNumber x;
@@ -1456,6 +1870,53 @@ LPIccCurve* CIccXformMonochrome::ExtractOutputCurves()
 	return NULL;
 }
 
+/**
+**************************************************************************
+* Name: CIccXformMonochrome::SaveCompiled
+* 
+* Purpose: 
+*  Writes the PCS adjustment and, for output xforms, the inverse gray
+*  curve.  Should be called only after Begin() has been called.
+**************************************************************************
+*/
+bool CIccXformMonochrome::SaveCompiled(CIccIO *pIO)
+{
+	if (!CIccXform::SaveCompiled(pIO))
+		return false;
+
+	return icSaveCompiledCurves(pIO, &m_Curve, m_bInput ? 0 : 1);
+}
+
+/**
+**************************************************************************
+* Name: CIccXformMonochrome::LoadCompiled
+* 
+* Purpose: 
+*  Reads state written by SaveCompiled().  Must be called before Begin().
+**************************************************************************
+*/
+bool CIccXformMonochrome::LoadCompiled(CIccIO *pIO)
+{
+	if (!CIccXform::LoadCompiled(pIO))
+		return false;
+
+	CIccCurve *pCurve = NULL;
+	int n = icLoadCompiledCurves(pIO, &pCurve, m_bInput ? 0 : 1);
+
+	if (n<0)
+		return false;
+
+	if (n) {
+		if (m_bFreeCurve && m_Curve)
+			delete m_Curve;
+		m_Curve = pCurve;
+		m_bFreeCurve = true;
+		m_bCompiledCurve = true;
+	}
+
+	return true;
+}
+
 /**
  **************************************************************************
  * Name: CIccXformMatrixTRC::CIccXformMatrixTRC
@@ -1469,6 +1930,9 @@ CIccXformMatrixTRC::CIccXformMatrixTRC()
   m_Curve[0] = m_Curve[1] = m_Curve[2] = NULL;
   m_ApplyCurvePtr = NULL;
   m_bFreeCurve = false;
+  m_bCompiledCurve = false;
+  m_offset[0] = m_offset[1] = m_offset[2] = 0.0;
+  m_bOffset = false;
 }
 
 /**
@@ -1554,9 +2018,11 @@ icStatusCMM CIccXformMatrixTRC::Begin()
       return icCmmStatBadSpaceLink;
     }
 
-    m_Curve[0] = GetInvCurve(icSigRedTRCTag);
-    m_Curve[1] = GetInvCurve(icSigGreenTRCTag);
-    m_Curve[2] = GetInvCurve(icSigBlueTRCTag);
+    if (!m_bCompiledCurve) {
+      m_Curve[0] = GetInvCurve(icSigRedTRCTag);
+      m_Curve[1] = GetInvCurve(icSigGreenTRCTag);
+      m_Curve[2] = GetInvCurve(icSigBlueTRCTag);
+    }
 
     m_bFreeCurve = true;
 
@@ -1576,6 +2042,39 @@ icStatusCMM CIccXformMatrixTRC::Begin()
   if (!m_Curve[0]->IsIdentity() || !m_Curve[1]->IsIdentity() || !m_Curve[2]->IsIdentity()) {
     m_ApplyCurvePtr = m_Curve;
   }
+
+  m_offset[0] = m_offset[1] = m_offset[2] = 0.0;
+  m_bOffset = false;
+
+#ifdef SAMPLEICC_NOCLIPLABTOXYZ
+  //Fold any XYZ PCS scale and offset adjustment into the matrix
+  if (m_bApplyAdjustPCS && m_pProfile->m_Header.pcs==icSigXYZData) {
+    int i, j;
+
+    if (m_bInput) {
+      //PCS = Scale * (M * RGB) + Offset
+      for (i=0; i<3; i++) {
+        for (j=0; j<3; j++)
+          m_e[i*3+j] = (icFloatNumber)(m_e[i*3+j] * m_ApplyPCSScale[i]);
+        m_offset[i] = m_ApplyPCSOffset[i];
+      }
+    }
+    else {
+      //RGB = InvM * (Scale * PCS + Offset)
+      for (i=0; i<3; i++) {
+        double offset = 0.0;
+        for (j=0; j<3; j++) {
+          offset += m_e[i*3+j] * m_ApplyPCSOffset[j] * 65535.0 / 32768.0;
+          m_e[i*3+j] = (icFloatNumber)(m_e[i*3+j] * m_ApplyPCSScale[j]);
+        }
+        m_offset[i] = (icFloatNumber)offset;
+      }
+    }
+
+    m_bOffset = m_offset[0]!=0.0 || m_offset[1]!=0.0 || m_offset[2]!=0.0;
+    m_bApplyAdjustPCS = false;
+  }
+#endif
   
   return icCmmStatOk;
 }
@@ -1641,6 +2140,12 @@ void CIccXformMatrixTRC::Apply(CIccApplyXform* pApply, icFloatNumber *DstPixel,
     DstPixel[0] = XYZScale((icFloatNumber)(m_e[0] * LinR + m_e[1] * LinG + m_e[2] * LinB));
     DstPixel[1] = XYZScale((icFloatNumber)(m_e[3] * LinR + m_e[4] * LinG + m_e[5] * LinB));
     DstPixel[2] = XYZScale((icFloatNumber)(m_e[6] * LinR + m_e[7] * LinG + m_e[8] * LinB));
+
+    if (m_bOffset) {
+      DstPixel[0] += m_offset[0];
+      DstPixel[1] += m_offset[1];
+      DstPixel[2] += m_offset[2];
+    }
   }
   else {
     double X = XYZDescale(Pixel[0]);
@@ -1648,14 +2153,14 @@ void CIccXformMatrixTRC::Apply(CIccApplyXform* pApply, icFloatNumber *DstPixel,
     double Z = XYZDescale(Pixel[2]);
 
     if (m_ApplyCurvePtr) {
-      DstPixel[0] = RGBClip((icFloatNumber)(m_e[0] * X + m_e[1] * Y + m_e[2] * Z), m_ApplyCurvePtr[0]);
-      DstPixel[1] = RGBClip((icFloatNumber)(m_e[3] * X + m_e[4] * Y + m_e[5] * Z), m_ApplyCurvePtr[1]);
-      DstPixel[2] = RGBClip((icFloatNumber)(m_e[6] * X + m_e[7] * Y + m_e[8] * Z), m_ApplyCurvePtr[2]);
+      DstPixel[0] = RGBClip((icFloatNumber)(m_e[0] * X + m_e[1] * Y + m_e[2] * Z + m_offset[0]), m_ApplyCurvePtr[0]);
+      DstPixel[1] = RGBClip((icFloatNumber)(m_e[3] * X + m_e[4] * Y + m_e[5] * Z + m_offset[1]), m_ApplyCurvePtr[1]);
+      DstPixel[2] = RGBClip((icFloatNumber)(m_e[6] * X + m_e[7] * Y + m_e[8] * Z + m_offset[2]), m_ApplyCurvePtr[2]);
     }
     else {
-      DstPixel[0] = (icFloatNumber)(m_e[0] * X + m_e[1] * Y + m_e[2] * Z);
-      DstPixel[1] = (icFloatNumber)(m_e[3] * X + m_e[4] * Y + m_e[5] * Z);
-      DstPixel[2] = (icFloatNumber)(m_e[6] * X + m_e[7] * Y + m_e[8] * Z);
+      DstPixel[0] = (icFloatNumber)(m_e[0] * X + m_e[1] * Y + m_e[2] * Z + m_offset[0]);
+      DstPixel[1] = (icFloatNumber)(m_e[3] * X + m_e[4] * Y + m_e[5] * Z + m_offset[1]);
+      DstPixel[2] = (icFloatNumber)(m_e[6] * X + m_e[7] * Y + m_e[8] * Z + m_offset[2]);
     }
   }
 
@@ -1730,6 +2235,7 @@ CIccCurve *CIccXformMatrixTRC::GetInvCurve(icSignature sig) const
 {
   CIccCurve *pCurve;
   CIccTagCurve *pInvCurve;
+  CIccSetupTimer setupTimer(icSetupInvCurve, -1, sig);
 
   if (!(pCurve = GetCurve(sig)))
     return NULL;
@@ -1737,6 +2243,7 @@ CIccCurve *CIccXformMatrixTRC::GetInvCurve(icSignature sig) const
   pCurve->Begin();
 
   pInvCurve = new CIccTagCurve(2048);
+  setupTimer.SetBytes(2048*sizeof(icFloatNumber));
 
   int i;
   icFloatNumber x;
@@ -1811,6 +2318,56 @@ LPIccCurve* CIccXformMatrixTRC::ExtractOutputCurves()
   return NULL;
 }
 
+/**
+ **************************************************************************
+ * Name: CIccXformMatrixTRC::SaveCompiled
+ * 
+ * Purpose: 
+ *  Writes the PCS adjustment and, for output xforms, the inverse TRC
+ *  curves.  Should be called only after Begin() has been called.
+ **************************************************************************
+ */
+bool CIccXformMatrixTRC::SaveCompiled(CIccIO *pIO)
+{
+  if (!CIccXform::SaveCompiled(pIO))
+    return false;
+
+  return icSaveCompiledCurves(pIO, m_Curve, m_bInput ? 0 : 3);
+}
+
+/**
+ **************************************************************************
+ * Name: CIccXformMatrixTRC::LoadCompiled
+ * 
+ * Purpose: 
+ *  Reads state written by SaveCompiled().  Must be called before Begin().
+ **************************************************************************
+ */
+bool CIccXformMatrixTRC::LoadCompiled(CIccIO *pIO)
+{
+  if (!CIccXform::LoadCompiled(pIO))
+    return false;
+
+  CIccCurve *pCurves[3] = {NULL, NULL, NULL};
+  int n = icLoadCompiledCurves(pIO, pCurves, m_bInput ? 0 : 3);
+
+  if (n<0)
+    return false;
+
+  if (n) {
+    int i;
+    for (i=0; i<3; i++) {
+      if (m_bFreeCurve && m_Curve[i])
+        delete m_Curve[i];
+      m_Curve[i] = pCurves[i];
+    }
+    m_bFreeCurve = true;
+    m_bCompiledCurve = true;
+  }
+
+  return true;
+}
+
 /**
  **************************************************************************
  * Name: CIccXform3DLut::CIccXform3DLut
@@ -2674,6 +3231,39 @@ icStatusCMM CIccXformNDLut::Begin()
 }
 
 
+/**
+ **************************************************************************
+ * Name: CIccXformNDLut::GetNewApply
+ * 
+ * Purpose: 
+ *  Allocates the apply data for the xform.  CLUTs with too many nodes for
+ *  InterpND to weight on the stack get their node weights allocated here
+ *  once rather than on every pixel.
+ **************************************************************************
+ */
+CIccApplyXform *CIccXformNDLut::GetNewApply(icStatusCMM &status)
+{
+  CIccApplyNDLutXform *rv = new CIccApplyNDLutXform(this);
+
+  if (!rv) {
+    status = icCmmStatAllocErr;
+    return NULL;
+  }
+
+  if (m_pTag->m_CLUT && m_pTag->m_CLUT->GetNumOffset()>icCLUTMaxLocalNodes) {
+    rv->m_pNodeWeights = new icFloatNumber[m_pTag->m_CLUT->GetNumOffset()];
+    if (!rv->m_pNodeWeights) {
+      status = icCmmStatAllocErr;
+      delete rv;
+      return NULL;
+    }
+  }
+
+  status = icCmmStatOk;
+  return rv;
+}
+
+
 /**
  **************************************************************************
  * Name: CIccXformNDLut::Apply
@@ -2690,8 +3280,12 @@ icStatusCMM CIccXformNDLut::Begin()
 void CIccXformNDLut::Apply(CIccApplyXform* pApply, icFloatNumber *DstPixel, const icFloatNumber *SrcPixel) const
 {
   icFloatNumber Pixel[16];
+  icFloatNumber *pNodeWeights = NULL;
   int i;
 
+  if (pApply && pApply->GetXformType()==icXformTypeNDLut)
+    pNodeWeights = ((CIccApplyNDLutXform*)pApply)->GetNodeWeights();
+
   SrcPixel = CheckSrcAbs(pApply, SrcPixel);
   for (i=0; i<m_nNumInput; i++)
     Pixel[i] = SrcPixel[i];
@@ -2711,7 +3305,7 @@ void CIccXformNDLut::Apply(CIccApplyXform* pApply, icFloatNumber *DstPixel, cons
         m_pTag->m_CLUT->Interp6d(Pixel, Pixel);
         break;
       default:
-        m_pTag->m_CLUT->InterpND(Pixel, Pixel);
+        m_pTag->m_CLUT->InterpND(Pixel, Pixel, pNodeWeights);
         break;
       }
     }
@@ -2738,7 +3332,7 @@ void CIccXformNDLut::Apply(CIccApplyXform* pApply, icFloatNumber *DstPixel, cons
         m_pTag->m_CLUT->Interp6d(Pixel, Pixel);
         break;
       default:
-        m_pTag->m_CLUT->InterpND(Pixel, Pixel);
+        m_pTag->m_CLUT->InterpND(Pixel, Pixel, pNodeWeights);
         break;
       }
     }
@@ -2875,6 +3469,9 @@ CIccXformNamedColor::CIccXformNamedColor(CIccTag *pTag, icColorSpaceSignature cs
 
   m_nSrcSpace = icSigUnknownData;
   m_nDestSpace = icSigUnknownData;
+
+  m_pSrcIndexMap = NULL;
+  m_nSrcIndexMap = 0;
 }
 
 
@@ -2888,6 +3485,8 @@ CIccXformNamedColor::CIccXformNamedColor(CIccTag *pTag, icColorSpaceSignature cs
  */
 CIccXformNamedColor::~CIccXformNamedColor()
 {
+  if (m_pSrcIndexMap)
+    delete [] m_pSrcIndexMap;
 }
 
 /**
@@ -2956,32 +3555,58 @@ icStatusCMM CIccXformNamedColor::Begin()
  **************************************************************************
  */
 icStatusCMM CIccXformNamedColor::Apply(CIccApplyXform* pApply, icChar *DstColorName, const icFloatNumber *SrcPixel) const
+{
+  icInt32Number nIndex;
+  icStatusCMM rv;
+
+  rv = ApplyToIndex(pApply, nIndex, SrcPixel);
+  if (rv != icCmmStatOk)
+    return rv;
+
+  m_pTag->GetColorName(DstColorName, nIndex);
+
+  return icCmmStatOk;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccXformNamedColor::ApplyToIndex
+ * 
+ * Purpose: 
+ *  Finds the named color entry closest to a pixel.
+ *  
+ * Args:
+ *  pApply = ApplyXform object containging temporary storage used during Apply
+ *  nDstIndex = receives the index of the named color entry,
+ *  SrcPixel = Source pixel which is to be applied.
+ **************************************************************************
+ */
+icStatusCMM CIccXformNamedColor::ApplyToIndex(CIccApplyXform* pApply, icInt32Number &nDstIndex, const icFloatNumber *SrcPixel) const
 {
   const CIccTagNamedColor2 *pTag = m_pTag;
   if (pTag == NULL)
     return icCmmStatBadXform;
 
   icFloatNumber DevicePix[16], PCSPix[3];
-  std::string NamedColor;
-  icUInt32Number i, j;
+  icUInt32Number i;
 
   if (IsSrcPCS()) {
     SrcPixel = CheckSrcAbs(pApply, SrcPixel);
     for(i=0; i<3; i++)
       PCSPix[i] = SrcPixel[i];
 
-    j = pTag->FindCachedPCSColor(PCSPix);
-    pTag->GetColorName(NamedColor, j);
+    nDstIndex = pTag->FindCachedPCSColor(PCSPix);
   }
   else {
     for(i=0; i<m_pTag->GetDeviceCoords(); i++)
       DevicePix[i] = SrcPixel[i];
 
-    j = pTag->FindDeviceColor(DevicePix);
-    pTag->GetColorName(NamedColor, j);
+    nDstIndex = pTag->FindDeviceColor(DevicePix);
   }
 
-  sprintf(DstColorName, "%s", NamedColor.c_str());
+  if (nDstIndex<0)
+    return icCmmStatColorNotFound;
 
   return icCmmStatOk;
 }
@@ -3001,41 +3626,96 @@ icStatusCMM CIccXformNamedColor::Apply(CIccApplyXform* pApply, icChar *DstColorN
 **************************************************************************
 */
 icStatusCMM CIccXformNamedColor::Apply(CIccApplyXform* pApply, icFloatNumber *DstPixel, const icChar *SrcColorName) const
+{
+  if (m_pTag == NULL)
+    return icCmmStatProfileMissingTag;
+
+  if (m_nSrcSpace != icSigNamedData)
+    return icCmmStatBadSpaceLink;
+
+  return ApplyFromIndex(pApply, DstPixel, m_pTag->FindColor(SrcColorName));
+}
+
+
+/**
+**************************************************************************
+* Name: CIccXformNamedColor::ApplyFromIndex
+* 
+* Purpose: 
+*  Copies the PCS or device values of a named color entry.
+*  
+* Args:
+*  pApply = ApplyXform object containging temporary storage used during Apply
+*  DstPixel = Destination pixel where the result is stored,
+*  nSrcIndex = index of the named color entry.
+**************************************************************************
+*/
+icStatusCMM CIccXformNamedColor::ApplyFromIndex(CIccApplyXform* pApply, icFloatNumber *DstPixel, icInt32Number nSrcIndex) const
 {
   const CIccTagNamedColor2 *pTag = m_pTag;
 
   if (pTag == NULL)
     return icCmmStatProfileMissingTag;
 
-  icUInt32Number j;
-
   if (m_nSrcSpace != icSigNamedData)
     return icCmmStatBadSpaceLink;
 
-  if (IsDestPCS()) {
-
-    j = pTag->FindColor(SrcColorName);
-    if (j<0)
-      return icCmmStatColorNotFound;
+  if (nSrcIndex<0 || (icUInt32Number)nSrcIndex>=pTag->GetSize())
+    return icCmmStatColorNotFound;
 
-    if (m_nDestSpace == icSigLabData) {
-      memcpy(DstPixel, pTag->GetEntry(j)->pcsCoords, 3*sizeof(icFloatNumber));
-    }
-    else {
-      memcpy(DstPixel, pTag->GetEntry(j)->pcsCoords, 3*sizeof(icFloatNumber));
-    }
+  if (IsDestPCS()) {
+    memcpy(DstPixel, pTag->GetEntry(nSrcIndex)->pcsCoords, 3*sizeof(icFloatNumber));
     CheckDstAbs(DstPixel);
   }
   else {
-    j = pTag->FindColor(SrcColorName);
-    if (j<0)
-      return icCmmStatColorNotFound;
-    memcpy(DstPixel, pTag->GetEntry(j)->deviceCoords, pTag->GetDeviceCoords()*sizeof(icFloatNumber));
+    memcpy(DstPixel, pTag->GetEntry(nSrcIndex)->deviceCoords, pTag->GetDeviceCoords()*sizeof(icFloatNumber));
   }
 
   return icCmmStatOk;
 }
 
+
+/**
+**************************************************************************
+* Name: CIccXformNamedColor::LinkSrcIndex
+* 
+* Purpose: 
+*  Builds the map used by MapSrcIndex() from the entries of the named
+*  color tag of the previous xform to the entries of this one, matching
+*  them by full color name.  This lets a named color result be passed
+*  between xforms as an index rather than as a string.
+*  
+* Args:
+*  pPrev = previous named color xform, or NULL to remove the map
+**************************************************************************
+*/
+bool CIccXformNamedColor::LinkSrcIndex(const CIccXformNamedColor *pPrev)
+{
+  if (m_pSrcIndexMap) {
+    delete [] m_pSrcIndexMap;
+    m_pSrcIndexMap = NULL;
+  }
+  m_nSrcIndexMap = 0;
+
+  if (!pPrev || !pPrev->m_pTag || !m_pTag)
+    return true;
+
+  icUInt32Number i, n = pPrev->m_pTag->GetSize();
+  icChar szName[96];
+
+  m_pSrcIndexMap = new icInt32Number[n];
+  if (!m_pSrcIndexMap)
+    return false;
+
+  for (i=0; i<n; i++) {
+    pPrev->m_pTag->GetColorName(szName, (icInt32Number)i);
+    m_pSrcIndexMap[i] = m_pTag->FindColor(szName);
+  }
+  m_nSrcIndexMap = n;
+
+  return true;
+}
+
 /**
  **************************************************************************
  * Name: CIccXformNamedColor::SetSrcSpace
@@ -3319,6 +3999,8 @@ CIccXform *CIccXformMpe::Create(CIccProfile *pProfile, bool bInput/* =true */, i
 
   if (rv) {
     rv->SetParams(pProfile, bInput, nIntent, nInterp, pHintManager);
+    rv->m_nLutType = nLutType;
+    rv->m_bUseMpeTags = true;
   }
 
   return rv;
@@ -3344,6 +4026,11 @@ icStatusCMM CIccXformMpe::Begin()
   if (status != icCmmStatOk)
     return status;
 
+  //Apply() doesn't adjust the PCS of absolute intent (B2D3/D2B3) tags so
+  //there is no adjustment for CombinePCSAdjust() to merge
+  if (m_nIntent == icAbsoluteColorimetric)
+    m_bApplyAdjustPCS = false;
+
   if (!m_pTag) {
     return icCmmStatInvalidLut;
   }
@@ -3483,6 +4170,34 @@ CIccApplyXformMpe::~CIccApplyXformMpe()
 }
 
 
+/**
+**************************************************************************
+* Name: CIccApplyNDLutXform::CIccApplyNDLutXform
+* 
+* Purpose: 
+*  Constructor
+**************************************************************************
+*/
+CIccApplyNDLutXform::CIccApplyNDLutXform(CIccXformNDLut *pXform) : CIccApplyXform(pXform)
+{
+  m_pNodeWeights = NULL;
+}
+
+/**
+**************************************************************************
+* Name: CIccApplyNDLutXform::~CIccApplyNDLutXform
+* 
+* Purpose: 
+*  Destructor
+**************************************************************************
+*/
+CIccApplyNDLutXform::~CIccApplyNDLutXform()
+{
+  if (m_pNodeWeights)
+    delete [] m_pNodeWeights;
+}
+
+
 /**
 **************************************************************************
 * Name: CIccApplyCmm::CIccApplyCmm
@@ -3529,6 +4244,72 @@ CIccApplyCmm::~CIccApplyCmm()
 }
 
 
+/**
+**************************************************************************
+* Name: icCheckPCS
+* 
+* Purpose: 
+*  Calls pPCS->Check() accumulating the time spent in pcsPerf when built
+*  with ICC_PERF_COUNTERS.
+**************************************************************************
+*/
+static __inline const icFloatNumber *icCheckPCS(CIccPCS *pPCS, CIccPerfCounter &pcsPerf,
+                                                const icFloatNumber *pSrc, const CIccXform *pXform)
+{
+#ifdef ICC_PERF_COUNTERS
+  icPerfCount nStart = icPerfTicks();
+  pSrc = pPCS->Check(pSrc, pXform);
+  pcsPerf.Add(icPerfTicks() - nStart, 0);
+
+  return pSrc;
+#else
+  return pPCS->Check(pSrc, pXform);
+#endif
+}
+
+/**
+**************************************************************************
+* Name: icCheckPCS
+* 
+* Purpose: 
+*  Array version of icCheckPCS() that adjusts nPixels packed pixels.
+**************************************************************************
+*/
+static __inline const icFloatNumber *icCheckPCS(CIccPCS *pPCS, CIccPerfCounter &pcsPerf, icFloatNumber *pConvert,
+                                                const icFloatNumber *pSrc, const CIccXform *pXform,
+                                                icUInt32Number nPixels)
+{
+#ifdef ICC_PERF_COUNTERS
+  icPerfCount nStart = icPerfTicks();
+  pSrc = pPCS->Check(pConvert, pSrc, pXform, nPixels);
+  pcsPerf.Add(icPerfTicks() - nStart, 0);
+
+  return pSrc;
+#else
+  return pPCS->Check(pConvert, pSrc, pXform, nPixels);
+#endif
+}
+
+/**
+**************************************************************************
+* Name: icApplyXform
+* 
+* Purpose: 
+*  Adjusts the PCS of pSrc for pApply's xform and applies it.  When built
+*  with ICC_PERF_COUNTERS the time spent in each step is accumulated in
+*  pcsPerf and pApply's counter.
+**************************************************************************
+*/
+static __inline void icApplyXform(CIccApplyXform *pApply, CIccPCS *pPCS, CIccPerfCounter &pcsPerf,
+                                  icFloatNumber *pDst, const icFloatNumber *pSrc)
+{
+  pSrc = icCheckPCS(pPCS, pcsPerf, pSrc, pApply->GetXform());
+
+  ICC_PERF_START(nStart);
+  pApply->Apply(pDst, pSrc);
+  ICC_PERF_STOP(pApply->GetPerf(), nStart, 1);
+}
+
 /**
 **************************************************************************
 * Name: CIccApplyCmm::Apply
@@ -3561,26 +4342,28 @@ icStatusCMM CIccApplyCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber *Sr
   if (n>1) {
     for (j=0, i=m_Xforms->begin(); j<n-1 && i!=m_Xforms->end(); i++, j++) {
 
-      i->ptr->Apply(pDst, m_pPCS->Check(pSrc, i->ptr->GetXform()));
+      icApplyXform(i->ptr, m_pPCS, m_PCSPerf, pDst, pSrc);
       pSrc = pDst;
     }
 
     pLastXform = i->ptr->GetXform();   
-    i->ptr->Apply(DstPixel, m_pPCS->Check(pSrc, pLastXform));
+    icApplyXform(i->ptr, m_pPCS, m_PCSPerf, DstPixel, pSrc);
     bNoClip = pLastXform->NoClipPCS();
   }
   else if (n==1) {
     i = m_Xforms->begin();
 
     pLastXform = i->ptr->GetXform();
-    i->ptr->Apply(DstPixel, m_pPCS->Check(SrcPixel, pLastXform));
+    icApplyXform(i->ptr, m_pPCS, m_PCSPerf, DstPixel, SrcPixel);
     bNoClip = pLastXform->NoClipPCS();
   }
   else {
     bNoClip = true;
   }
 
+  ICC_PERF_START(nStart);
   m_pPCS->CheckLast(DstPixel, m_pCmm->m_nDestSpace, bNoClip);
+  ICC_PERF_STOP(m_PCSPerf, nStart, 1);
 
   return icCmmStatOk;
 }
@@ -3594,57 +4377,870 @@ icStatusCMM CIccApplyCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber *Sr
 *  
 * Args:
 *  DstPixel = Destination pixel where the result is stored,
-*  SrcPixel = Source pixel which is to be applied.
+*  SrcPixel = Source pixel which is to be applied,
+*  nPixels = number of pixels to apply.
 **************************************************************************
 */
+//Number of pixels that are pushed through each xform at a time by CIccApplyCmm::Apply()
+#define icApplyBlockPixels 128
+
 icStatusCMM CIccApplyCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel, icUInt32Number nPixels)
 {
-  icFloatNumber Pixel[16], *pDst;
+  icFloatNumber Pixels[2][icApplyBlockPixels*16], Convert[icApplyBlockPixels*3], *pDst;
   const icFloatNumber *pSrc;
   CIccApplyXformList::iterator i;
+  CIccApplyXform *pApply;
   int j, n = (int)m_Xforms->size();
-  icUInt32Number k;
+  icUInt32Number nSrcSamples, nDstSamples, nBlock, k;
 
   if (!n)
     return icCmmStatBadXform;
 
-  for (k=0; k<nPixels; k++) {
+  //Each block of pixels is pushed through one xform at a time so that PCS
+  //adjustments can use the array PCS conversions
+  for (; nPixels; nPixels-=nBlock) {
+    nBlock = nPixels<icApplyBlockPixels ? nPixels : icApplyBlockPixels;
+
     m_pPCS->Reset(m_pCmm->m_nSrcSpace);
 
     pSrc = SrcPixel;
-    pDst = Pixel;
+    nSrcSamples = m_pCmm->GetSourceSamples();
 
-    if (n>1) {
-      for (j=0, i=m_Xforms->begin(); j<n-1 && i!=m_Xforms->end(); i++, j++) {
+    for (j=0, i=m_Xforms->begin(); j<n && i!=m_Xforms->end(); i++, j++) {
+      pApply = i->ptr;
 
-        i->ptr->Apply(pDst, m_pPCS->Check(pSrc, i->ptr->GetXform()));
-        pSrc = pDst;
+      if (j==n-1) {
+        pDst = DstPixel;
+        nDstSamples = m_pCmm->GetDestSamples();
       }
+      else {
+        pDst = Pixels[j&1];
+        nDstSamples = icGetSpaceSamples(pApply->GetXform()->GetDstSpace());
+        if (!nDstSamples)
+          nDstSamples = 16;
+      }
+
+      pSrc = icCheckPCS(m_pPCS, m_PCSPerf, Convert, pSrc, pApply->GetXform(), nBlock);
+
+      ICC_PERF_START(nStart);
+      for (k=0; k<nBlock; k++) {
+        pApply->Apply(pDst + k*nDstSamples, pSrc + k*nSrcSamples);
+      }
+      ICC_PERF_STOP(pApply->GetPerf(), nStart, nBlock);
+
+      pSrc = pDst;
+      nSrcSamples = nDstSamples;
+    }
+
+    ICC_PERF_START(nStart);
+    m_pPCS->CheckLast(DstPixel, m_pCmm->m_nDestSpace, nBlock, false);
+    ICC_PERF_STOP(m_PCSPerf, nStart, nBlock);
+
+    DstPixel += nBlock*m_pCmm->GetDestSamples();
+    SrcPixel += nBlock*m_pCmm->GetSourceSamples();
+  }
+
+  return icCmmStatOk;
+}
+
+/**
+**************************************************************************
+* Name: icGetXformTypeName
+* 
+* Purpose: 
+*  Returns a printable name for an xform type
+**************************************************************************
+*/
+static const icChar *icGetXformTypeName(icXformType nType)
+{
+  switch(nType) {
+  case icXformTypeMatrixTRC:
+    return "MatrixTRC";
+  case icXformType3DLut:
+    return "3DLut";
+  case icXformType4DLut:
+    return "4DLut";
+  case icXformTypeNDLut:
+    return "NDLut";
+  case icXformTypeNamedColor:
+    return "NamedColor";
+  case icXformTypeMpe:
+    return "Mpe";
+  case icXformTypeMonochrome:
+    return "Monochrome";
+  default:
+    return "Unknown";
+  }
+}
+
+/**
+**************************************************************************
+* Name: CIccApplyCmm::ResetPerf
+* 
+* Purpose: 
+*  Resets the performance counters of the xforms, multi process
+*  elements and PCS conversions in the apply chain.
+**************************************************************************
+*/
+void CIccApplyCmm::ResetPerf()
+{
+  CIccApplyXformList::iterator i;
+
+  for (i=m_Xforms->begin(); i!=m_Xforms->end(); i++) {
+    i->ptr->GetPerf().Reset();
+
+    if (i->ptr->GetXformType()==icXformTypeMpe) {
+      CIccApplyTagMpe *pApplyTag = ((CIccApplyXformMpe*)i->ptr)->GetApplyTag();
+
+      if (pApplyTag) {
+        CIccApplyMpeIter e;
+
+        for (e=pApplyTag->begin(); e!=pApplyTag->end(); e++)
+          e->ptr->GetPerf().Reset();
+      }
+    }
+  }
+
+  m_PCSPerf.Reset();
+}
+
+/**
+**************************************************************************
+* Name: CIccApplyCmm::GetPerfReport
+* 
+* Purpose: 
+*  Appends a report of the performance counters of the apply chain to
+*  sReport.  Each xform is listed in order followed by its multi process
+*  elements (if any), with the time spent in PCS conversions last.
+**************************************************************************
+*/
+void CIccApplyCmm::GetPerfReport(std::string &sReport)
+{
+  CIccApplyXformList::iterator i;
+  char name[64];
+  int n, m;
+
+  if (!icPerfCountersEnabled()) {
+    sReport += "Performance counters not enabled (build IccProfLib with ICC_PERF_COUNTERS defined)\n";
+    return;
+  }
+
+  for (n=0, i=m_Xforms->begin(); i!=m_Xforms->end(); i++, n++) {
+    sprintf(name, "Xform %d (%s)", n, icGetXformTypeName(i->ptr->GetXform()->GetXformType()));
+    i->ptr->GetPerf().Describe(sReport, name);
+
+    if (i->ptr->GetXformType()==icXformTypeMpe) {
+      CIccApplyTagMpe *pApplyTag = ((CIccApplyXformMpe*)i->ptr)->GetApplyTag();
+
+      if (pApplyTag) {
+        CIccApplyMpeIter e;
+
+        for (m=0, e=pApplyTag->begin(); e!=pApplyTag->end(); e++, m++) {
+          sprintf(name, "  Element %d (%s)", m, e->ptr->GetElem()->GetClassName());
+          e->ptr->GetPerf().Describe(sReport, name);
+        }
+      }
+    }
+  }
+
+  m_PCSPerf.Describe(sReport, "PCS conversion");
+}
+
+void CIccApplyCmm::AppendApplyXform(CIccApplyXform *pApplyXform)
+{
+  CIccApplyXformPtr ptr;
+  ptr.ptr = pApplyXform;
+
+  m_Xforms->push_back(ptr);
+}
+
+//////////////////////////////////////////////////////////////////////
+// Class CIccColorEncoding
+//////////////////////////////////////////////////////////////////////
+
+//Conversion kernels resolved by CIccColorEncoding::Begin().  Each kernel
+//reproduces the arithmetic of the corresponding case in
+//CIccCmm::ToInternalEncoding() or CIccCmm::FromInternalEncoding().
+typedef enum {
+  icEncKernelNone = 0,
+
+  //To internal
+  icEncKernelToCopy,
+  icEncKernelToClip,
+  icEncKernelToPercent,
+  icEncKernelToPercentClip,
+  icEncKernelTo8Bit,
+  icEncKernelTo16Bit,
+  icEncKernelToLabValue,
+  icEncKernelToLab8Bit,
+  icEncKernelToLab16BitV2,
+  icEncKernelToXyzValue,
+  icEncKernelToXyzPercent,
+  icEncKernelToXyz16Bit,
+
+  //From internal
+  icEncKernelFromCopy,
+  icEncKernelFromClip,
+  icEncKernelFromPercent,
+  icEncKernelFromPercentClip,
+  icEncKernelFrom8Bit,
+  icEncKernelFrom16Bit,
+  icEncKernelFromLabValue,
+  icEncKernelFromLab8Bit,
+  icEncKernelFromLab16BitV2,
+  icEncKernelFromXyzValue,
+  icEncKernelFromXyzPercent,
+  icEncKernelFromXyz16Bit
+} icEncKernel;
+
+//Inline equivalents of the IccUtil conversion functions
+static inline icFloatNumber icEncU8toF(icUInt8Number v)
+{
+  return (icFloatNumber)((icFloatNumber)v / 255.0);
+}
+
+static inline icFloatNumber icEncU16toF(icUInt16Number v)
+{
+  return (icFloatNumber)((icFloatNumber)v / 65535.0);
+}
+
+static inline icFloatNumber icEncUSFtoD(icU1Fixed15Number v)
+{
+  return (icFloatNumber)((icFloatNumber)v / 32768.0);
+}
+
+static inline icUInt8Number icEncFtoU8(icFloatNumber v)
+{
+  if (v<0)
+    v = 0;
+  else if (v>1.0)
+    v = 1.0;
+
+  return (icUInt8Number)(v*255.0 + 0.5);
+}
+
+static inline icUInt16Number icEncFtoU16(icFloatNumber v)
+{
+  if (v<0)
+    v = 0;
+  else if (v>1.0)
+    v = 1.0;
+
+  return (icUInt16Number)(v*65535.0 + 0.5);
+}
+
+static inline icU1Fixed15Number icEncDtoUSF(icFloatNumber v)
+{
+  if (v<0)
+    v = 0;
+  else if (v>65535.0/32768.0)
+    v = (icFloatNumber)(65535.0/32768.0);
+
+  return (icU1Fixed15Number)(v*32768.0 + 0.5);
+}
+
+static inline icUInt8Number icEncABtoU8(icFloatNumber v)
+{
+  v += 128.0f;
+  if (v<0)
+    v = 0;
+  else if (v>255)
+    v = 255;
+
+  return (icUInt8Number)(v + 0.5);
+}
+
+static inline icFloatNumber icEncUnitClip(icFloatNumber v)
+{
+  if (v<0)
+    v = 0;
+  if (v>1.0)
+    v = 1.0;
+
+  return v;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccColorEncoding::CIccColorEncoding
+ * 
+ * Purpose: 
+ *  Constructor
+ **************************************************************************
+ */
+CIccColorEncoding::CIccColorEncoding()
+{
+  m_nSpace = icSigUnknownData;
+  m_nEncode = icEncodeUnknown;
+  m_nSamples = 0;
+  m_bToInternal = true;
+  m_bClip = true;
+  m_nKernel = icEncKernelNone;
+  m_pLut8 = NULL;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccColorEncoding::~CIccColorEncoding
+ * 
+ * Purpose: 
+ *  Destructor
+ **************************************************************************
+ */
+CIccColorEncoding::~CIccColorEncoding()
+{
+  if (m_pLut8)
+    delete [] m_pLut8;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccColorEncoding::Begin
+ * 
+ * Purpose: 
+ *  Resolves the conversion to use for a color space and encoding.
+ *  
+ * Args:
+ *  nSpace = color space signature of the data,
+ *  nEncode = icFloatColorEncoding type of the data,
+ *  bToInternal = true to convert to internal encoding, false to convert
+ *   from internal encoding,
+ *  bClip = flag to clip to internal range
+ * 
+ * Return:
+ *  icCmmStatOk if the conversion is supported, otherwise
+ *  icCmmStatBadColorEncoding.
+ **************************************************************************
+ */
+icStatusCMM CIccColorEncoding::Begin(icColorSpaceSignature nSpace, icFloatColorEncoding nEncode,
+                                     bool bToInternal, bool bClip)
+{
+  if (m_pLut8) {
+    delete [] m_pLut8;
+    m_pLut8 = NULL;
+  }
+
+  m_nSpace = nSpace;
+  m_nEncode = nEncode;
+  m_nSamples = icGetSpaceSamples(nSpace);
+  m_bToInternal = bToInternal;
+  m_bClip = bClip;
+  m_nKernel = icEncKernelNone;
+
+  if (!m_nSamples)
+    return icCmmStatBadColorEncoding;
+
+  icEncKernel nKernel = icEncKernelNone;
+
+  switch(nSpace) {
+    case icSigLabData:
+      switch(nEncode) {
+        case icEncodeValue:
+          nKernel = bToInternal ? icEncKernelToLabValue : icEncKernelFromLabValue;
+          break;
+        case icEncodeFloat:
+          nKernel = bToInternal ? icEncKernelToCopy : icEncKernelFromCopy;
+          break;
+        case icEncode8Bit:
+          nKernel = bToInternal ? icEncKernelToLab8Bit : icEncKernelFromLab8Bit;
+          break;
+        case icEncode16Bit:
+          nKernel = bToInternal ? icEncKernelTo16Bit : icEncKernelFrom16Bit;
+          break;
+        case icEncode16BitV2:
+          nKernel = bToInternal ? icEncKernelToLab16BitV2 : icEncKernelFromLab16BitV2;
+          break;
+        default:
+          break;
+      }
+      break;
+
+    case icSigXYZData:
+      switch(nEncode) {
+        case icEncodeValue:
+        case icEncodeFloat:
+          nKernel = bToInternal ? icEncKernelToXyzValue : icEncKernelFromXyzValue;
+          break;
+        case icEncodePercent:
+          nKernel = bToInternal ? icEncKernelToXyzPercent : icEncKernelFromXyzPercent;
+          break;
+        case icEncode16Bit:
+        case icEncode16BitV2:
+          nKernel = bToInternal ? icEncKernelToXyz16Bit : icEncKernelFromXyz16Bit;
+          break;
+        default:
+          break;
+      }
+      break;
+
+    case icSigNamedData:
+      break;
+
+    default:
+      switch(nEncode) {
+        case icEncodeValue:
+          if (icIsSpaceCLR(nSpace) && m_nSamples>=3)
+            nKernel = bToInternal ? icEncKernelToLabValue : icEncKernelFromLabValue;
+          break;
+        case icEncodePercent:
+          if (bToInternal)
+            nKernel = bClip ? icEncKernelToPercentClip : icEncKernelToPercent;
+          else
+            nKernel = bClip ? icEncKernelFromPercentClip : icEncKernelFromPercent;
+          break;
+        case icEncodeFloat:
+          if (bToInternal)
+            nKernel = bClip ? icEncKernelToClip : icEncKernelToCopy;
+          else
+            nKernel = bClip ? icEncKernelFromClip : icEncKernelFromCopy;
+          break;
+        case icEncode8Bit:
+          nKernel = bToInternal ? icEncKernelTo8Bit : icEncKernelFrom8Bit;
+          break;
+        case icEncode16Bit:
+        case icEncode16BitV2:
+          nKernel = bToInternal ? icEncKernelTo16Bit : icEncKernelFrom16Bit;
+          break;
+        default:
+          break;
+      }
+      break;
+  }
+
+  if (nKernel==icEncKernelNone)
+    return icCmmStatBadColorEncoding;
+
+  m_nKernel = nKernel;
+
+  if (bToInternal && nEncode==icEncode8Bit) {
+    //Build a table for each channel using the single pixel conversion
+    icUInt8Number pixel[16];
+    icFloatNumber internal[16];
+    icUInt32Number i, j;
+
+    m_pLut8 = new icFloatNumber[m_nSamples*256];
+    if (!m_pLut8) {
+      m_nKernel = icEncKernelNone;
+      return icCmmStatAllocErr;
+    }
+
+    for (i=0; i<256; i++) {
+      memset(pixel, i, sizeof(pixel));
+      CIccCmm::ToInternalEncoding(nSpace, internal, pixel);
+      for (j=0; j<m_nSamples; j++) {
+        m_pLut8[j*256+i] = internal[j];
+      }
+    }
+  }
+
+  return icCmmStatOk;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccColorEncoding::Apply
+ * 
+ * Purpose: 
+ *  Converts nPixels pixels of floating point data in the direction and
+ *  encoding established by Begin().  pDst and pSrc may be the same
+ *  buffer if both strides are the same.
+ *  
+ * Args:
+ *  pDst = converted data is stored here,
+ *  pSrc = the data to be converted,
+ *  nPixels = number of pixels to convert,
+ *  nDstStride = values between pixels in pDst (0 = samples),
+ *  nSrcStride = values between pixels in pSrc (0 = samples)
+ **************************************************************************
+ */
+icStatusCMM CIccColorEncoding::Apply(icFloatNumber *pDst, const icFloatNumber *pSrc, icUInt32Number nPixels,
+                                     icUInt32Number nDstStride, icUInt32Number nSrcStride) const
+{
+  icUInt32Number n = m_nSamples;
+  icUInt32Number i, j;
+
+  if (!nDstStride)
+    nDstStride = n;
+  if (!nSrcStride)
+    nSrcStride = n;
+
+  //Packed pixels with per value conversions are done as one long run
+  icUInt32Number nRun = n, nCount = nPixels;
+  if (nDstStride==n && nSrcStride==n) {
+    nRun = n * nPixels;
+    nCount = 1;
+  }
+
+  const icFloatNumber *s;
+  icFloatNumber *d;
+
+  switch((icEncKernel)m_nKernel) {
+    case icEncKernelToCopy:
+    case icEncKernelFromCopy:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        if (d!=s)
+          memcpy(d, s, nRun*sizeof(icFloatNumber));
+      }
+      break;
+
+    case icEncKernelToClip:
+    case icEncKernelFromClip:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = icEncUnitClip(s[j]);
+      }
+      break;
+
+    case icEncKernelToPercent:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = (icFloatNumber)(s[j]/100.0);
+      }
+      break;
+
+    case icEncKernelToPercentClip:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = icEncUnitClip((icFloatNumber)(s[j]/100.0));
+      }
+      break;
+
+    case icEncKernelTo8Bit:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = icEncU8toF((icUInt8Number)s[j]);
+      }
+      break;
+
+    case icEncKernelTo16Bit:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = icEncU16toF((icUInt16Number)s[j]);
+      }
+      break;
+
+    case icEncKernelToLabValue:
+      for (i=0, s=pSrc, d=pDst; i<nPixels; i++, s+=nSrcStride, d+=nDstStride) {
+        d[0] = (icFloatNumber)(s[0] / 100.0);
+        d[1] = (icFloatNumber)((s[1] + 128.0) / 255.0);
+        d[2] = (icFloatNumber)((s[2] + 128.0) / 255.0);
+        for (j=3; j<n; j++)
+          d[j] = s[j];
+      }
+      break;
+
+    case icEncKernelToLab8Bit:
+      for (i=0, s=pSrc, d=pDst; i<nPixels; i++, s+=nSrcStride, d+=nDstStride) {
+        icFloatNumber L = icEncU8toF((icUInt8Number)s[0])*100.0f;
+        icFloatNumber a = (icFloatNumber)(icUInt8Number)s[1] - 128.0f;
+        icFloatNumber b = (icFloatNumber)(icUInt8Number)s[2] - 128.0f;
 
-      i->ptr->Apply(DstPixel, m_pPCS->Check(pSrc, i->ptr->GetXform()));
+        d[0] = (icFloatNumber)(L / 100.0);
+        d[1] = (icFloatNumber)((a + 128.0) / 255.0);
+        d[2] = (icFloatNumber)((b + 128.0) / 255.0);
+      }
+      break;
+
+    case icEncKernelToLab16BitV2:
+      if (nCount==1) {
+        for (j=0; j<nRun; j++)
+          pDst[j] = icEncU16toF((icUInt16Number)pSrc[j]);
+        CIccPCS::Lab2ToLab4(pDst, pDst, nPixels, false);
+      }
+      else {
+        for (i=0, s=pSrc, d=pDst; i<nPixels; i++, s+=nSrcStride, d+=nDstStride) {
+          d[0] = icEncU16toF((icUInt16Number)s[0]);
+          d[1] = icEncU16toF((icUInt16Number)s[1]);
+          d[2] = icEncU16toF((icUInt16Number)s[2]);
+          CIccPCS::Lab2ToLab4(d, d);
+        }
+      }
+      break;
+
+    case icEncKernelToXyzValue:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = (icFloatNumber)(s[j] * 32768.0 / 65535.0);
+      }
+      break;
+
+    case icEncKernelToXyzPercent:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++) {
+          icFloatNumber v = (icFloatNumber)(s[j] / 100.0);
+          d[j] = (icFloatNumber)(v * 32768.0 / 65535.0);
+        }
+      }
+      break;
+
+    case icEncKernelToXyz16Bit:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = icEncUSFtoD((icU1Fixed15Number)s[j]);
+      }
+      break;
+
+    case icEncKernelFromPercent:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = (icFloatNumber)(s[j]*100.0);
+      }
+      break;
+
+    case icEncKernelFromPercentClip:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = (icFloatNumber)(icEncUnitClip(s[j])*100.0);
+      }
+      break;
+
+    case icEncKernelFrom8Bit:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = icEncFtoU8(s[j]);
+      }
+      break;
+
+    case icEncKernelFrom16Bit:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = icEncFtoU16(s[j]);
+      }
+      break;
+
+    case icEncKernelFromLabValue:
+      for (i=0, s=pSrc, d=pDst; i<nPixels; i++, s+=nSrcStride, d+=nDstStride) {
+        d[0] = (icFloatNumber)(s[0] * 100.0);
+        d[1] = (icFloatNumber)(s[1]*255.0 - 128.0);
+        d[2] = (icFloatNumber)(s[2]*255.0 - 128.0);
+        for (j=3; j<n; j++)
+          d[j] = s[j];
+      }
+      break;
+
+    case icEncKernelFromLab8Bit:
+      for (i=0, s=pSrc, d=pDst; i<nPixels; i++, s+=nSrcStride, d+=nDstStride) {
+        icFloatNumber L = (icFloatNumber)(s[0] * 100.0);
+        icFloatNumber a = (icFloatNumber)(s[1]*255.0 - 128.0);
+        icFloatNumber b = (icFloatNumber)(s[2]*255.0 - 128.0);
+
+        d[0] = (icUInt8Number)(L/100.0 * 255.0 + 0.5);
+        d[1] = icEncABtoU8(a);
+        d[2] = icEncABtoU8(b);
+      }
+      break;
+
+    case icEncKernelFromLab16BitV2:
+      for (i=0, s=pSrc, d=pDst; i<nPixels; i++, s+=nSrcStride, d+=nDstStride) {
+        d[0] = icEncFtoU16((icFloatNumber)(s[0] * 65280.0f / 65535.0f));
+        d[1] = icEncFtoU16((icFloatNumber)(s[1] * 65280.0f / 65535.0f));
+        d[2] = icEncFtoU16((icFloatNumber)(s[2] * 65280.0f / 65535.0f));
+      }
+      break;
+
+    case icEncKernelFromXyzValue:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = (icFloatNumber)(s[j] * 65535.0 / 32768.0);
+      }
+      break;
+
+    case icEncKernelFromXyzPercent:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++) {
+          icFloatNumber v = (icFloatNumber)(s[j] * 65535.0 / 32768.0);
+          d[j] = (icFloatNumber)(v * 100.0);
+        }
+      }
+      break;
+
+    case icEncKernelFromXyz16Bit:
+      for (i=0, s=pSrc, d=pDst; i<nCount; i++, s+=nSrcStride, d+=nDstStride) {
+        for (j=0; j<nRun; j++)
+          d[j] = icEncDtoUSF(s[j]);
+      }
+      break;
+
+    default:
+      return icCmmStatBadColorEncoding;
+  }
+
+  return icCmmStatOk;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccColorEncoding::Apply
+ * 
+ * Purpose: 
+ *  Converts nPixels pixels of 8 bit data to internal encoding using
+ *  the tables built by Begin(icEncode8Bit, true).
+ **************************************************************************
+ */
+icStatusCMM CIccColorEncoding::Apply(icFloatNumber *pInternal, const icUInt8Number *pData, icUInt32Number nPixels,
+                                     icUInt32Number nInternalStride, icUInt32Number nDataStride) const
+{
+  if (!m_pLut8)
+    return icCmmStatBadColorEncoding;
+
+  icUInt32Number n = m_nSamples;
+  icUInt32Number i, j;
+
+  if (!nInternalStride)
+    nInternalStride = n;
+  if (!nDataStride)
+    nDataStride = n;
+
+  if (n==3) {
+    const icFloatNumber *lut0 = m_pLut8, *lut1 = m_pLut8+256, *lut2 = m_pLut8+512;
+    for (i=0; i<nPixels; i++, pInternal+=nInternalStride, pData+=nDataStride) {
+      pInternal[0] = lut0[pData[0]];
+      pInternal[1] = lut1[pData[1]];
+      pInternal[2] = lut2[pData[2]];
     }
-    else if (n==1) {
-      i = m_Xforms->begin();
-      i->ptr->Apply(DstPixel, m_pPCS->Check(SrcPixel, i->ptr->GetXform()));
+  }
+  else {
+    for (i=0; i<nPixels; i++, pInternal+=nInternalStride, pData+=nDataStride) {
+      const icFloatNumber *lut = m_pLut8;
+      for (j=0; j<n; j++, lut+=256)
+        pInternal[j] = lut[pData[j]];
     }
+  }
+
+  return icCmmStatOk;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccColorEncoding::Apply
+ * 
+ * Purpose: 
+ *  Converts nPixels pixels of 16 bit data to internal encoding
+ *  (requires Begin(icEncode16Bit, true)).
+ **************************************************************************
+ */
+icStatusCMM CIccColorEncoding::Apply(icFloatNumber *pInternal, const icUInt16Number *pData, icUInt32Number nPixels,
+                                     icUInt32Number nInternalStride, icUInt32Number nDataStride) const
+{
+  if (!m_bToInternal || m_nEncode!=icEncode16Bit)
+    return icCmmStatBadColorEncoding;
+
+  icUInt32Number n = m_nSamples;
+  icUInt32Number i, j;
 
-    m_pPCS->CheckLast(DstPixel, m_pCmm->m_nDestSpace);
+  if (!nInternalStride)
+    nInternalStride = n;
+  if (!nDataStride)
+    nDataStride = n;
 
-    DstPixel += m_pCmm->GetDestSamples();
-    SrcPixel += m_pCmm->GetSourceSamples();
+  if (m_nKernel==icEncKernelToXyz16Bit) {
+    for (i=0; i<nPixels; i++, pInternal+=nInternalStride, pData+=nDataStride) {
+      for (j=0; j<n; j++)
+        pInternal[j] = icEncUSFtoD(pData[j]);
+    }
+  }
+  else {
+    for (i=0; i<nPixels; i++, pInternal+=nInternalStride, pData+=nDataStride) {
+      for (j=0; j<n; j++)
+        pInternal[j] = icEncU16toF(pData[j]);
+    }
   }
 
   return icCmmStatOk;
 }
 
-void CIccApplyCmm::AppendApplyXform(CIccApplyXform *pApplyXform)
+
+/**
+ **************************************************************************
+ * Name: CIccColorEncoding::Apply
+ * 
+ * Purpose: 
+ *  Converts nPixels pixels from internal encoding to 8 bit data
+ *  (requires Begin(icEncode8Bit, false)).
+ **************************************************************************
+ */
+icStatusCMM CIccColorEncoding::Apply(icUInt8Number *pData, const icFloatNumber *pInternal, icUInt32Number nPixels,
+                                     icUInt32Number nDataStride, icUInt32Number nInternalStride) const
 {
-  CIccApplyXformPtr ptr;
-  ptr.ptr = pApplyXform;
+  if (m_bToInternal || m_nEncode!=icEncode8Bit)
+    return icCmmStatBadColorEncoding;
 
-  m_Xforms->push_back(ptr);
+  icUInt32Number n = m_nSamples;
+  icUInt32Number i, j;
+
+  if (!nInternalStride)
+    nInternalStride = n;
+  if (!nDataStride)
+    nDataStride = n;
+
+  if (m_nKernel==icEncKernelFromLab8Bit) {
+    for (i=0; i<nPixels; i++, pInternal+=nInternalStride, pData+=nDataStride) {
+      icFloatNumber L = (icFloatNumber)(pInternal[0] * 100.0);
+      icFloatNumber a = (icFloatNumber)(pInternal[1]*255.0 - 128.0);
+      icFloatNumber b = (icFloatNumber)(pInternal[2]*255.0 - 128.0);
+
+      pData[0] = (icUInt8Number)(L/100.0 * 255.0 + 0.5);
+      pData[1] = icEncABtoU8(a);
+      pData[2] = icEncABtoU8(b);
+    }
+  }
+  else {
+    for (i=0; i<nPixels; i++, pInternal+=nInternalStride, pData+=nDataStride) {
+      for (j=0; j<n; j++)
+        pData[j] = icEncFtoU8(pInternal[j]);
+    }
+  }
+
+  return icCmmStatOk;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccColorEncoding::Apply
+ * 
+ * Purpose: 
+ *  Converts nPixels pixels from internal encoding to 16 bit data
+ *  (requires Begin(icEncode16Bit, false)).
+ **************************************************************************
+ */
+icStatusCMM CIccColorEncoding::Apply(icUInt16Number *pData, const icFloatNumber *pInternal, icUInt32Number nPixels,
+                                     icUInt32Number nDataStride, icUInt32Number nInternalStride) const
+{
+  if (m_bToInternal || m_nEncode!=icEncode16Bit)
+    return icCmmStatBadColorEncoding;
+
+  icUInt32Number n = m_nSamples;
+  icUInt32Number i, j;
+
+  if (!nInternalStride)
+    nInternalStride = n;
+  if (!nDataStride)
+    nDataStride = n;
+
+  if (m_nKernel==icEncKernelFromXyz16Bit) {
+    for (i=0; i<nPixels; i++, pInternal+=nInternalStride, pData+=nDataStride) {
+      for (j=0; j<n; j++)
+        pData[j] = icEncDtoUSF(pInternal[j]);
+    }
+  }
+  else {
+    for (i=0; i<nPixels; i++, pInternal+=nInternalStride, pData+=nDataStride) {
+      for (j=0; j<n; j++)
+        pData[j] = icEncFtoU16(pInternal[j]);
+    }
+  }
+
+  return icCmmStatOk;
 }
 
+
 /**
  **************************************************************************
  * Name: CIccCmm::CIccCmm
@@ -3675,6 +5271,8 @@ CIccCmm::CIccCmm(icColorSpaceSignature nSrcSpace /*=icSigUnknownData*/,
   m_Xforms->clear();
 
   m_pApply = NULL;
+  m_pSetupListener = NULL;
+  m_pCompiledData = NULL;
 }
 
 /**
@@ -3700,6 +5298,9 @@ CIccCmm::~CIccCmm()
 
   if (m_pApply)
     delete m_pApply;
+
+  if (m_pCompiledData)
+    free(m_pCompiledData);
 }
 
 /**
@@ -3727,7 +5328,17 @@ icStatusCMM CIccCmm::AddXform(const icChar *szProfilePath,
                               bool bUseMpeTags /*=true*/,
                               CIccCreateXformHintManager *pHintManager /*=NULL*/)
 {
-  CIccProfile *pProfile = OpenIccProfile(szProfilePath);
+  CIccSetupScope setupScope(m_pSetupListener);
+  CIccProfile *pProfile;
+
+  {
+    CIccSetupTimer setupTimer(icSetupProfileOpen, (icInt32Number)GetNumXforms());
+
+    pProfile = OpenIccProfile(szProfilePath);
+
+    if (pProfile)
+      setupTimer.SetBytes(pProfile->m_Header.size);
+  }
 
   if (!pProfile) 
     return icCmmStatCantOpenProfile;
@@ -3770,20 +5381,27 @@ icStatusCMM CIccCmm::AddXform(icUInt8Number *pProfileMem,
                               bool bUseMpeTags /*=true*/,
                               CIccCreateXformHintManager *pHintManager /*=NULL*/)
 {
-  CIccMemIO *pFile = new CIccMemIO;
+  CIccSetupScope setupScope(m_pSetupListener);
+  CIccProfile *pProfile;
 
-  if (!pFile || !pFile->Attach(pProfileMem, nProfileLen))
-    return icCmmStatCantOpenProfile;
+  {
+    CIccSetupTimer setupTimer(icSetupProfileOpen, (icInt32Number)GetNumXforms());
+    CIccMemIO *pFile = new CIccMemIO;
 
-  CIccProfile *pProfile = new CIccProfile;
+    if (!pFile || !pFile->Attach(pProfileMem, nProfileLen))
+      return icCmmStatCantOpenProfile;
 
-  if (!pProfile)
-    return icCmmStatCantOpenProfile;
+    pProfile = new CIccProfile;
 
-  if (!pProfile->Attach(pFile)) {
-    delete pFile;
-    delete pProfile;
-    return icCmmStatCantOpenProfile;
+    if (!pProfile)
+      return icCmmStatCantOpenProfile;
+
+    if (!pProfile->Attach(pFile)) {
+      delete pFile;
+      delete pProfile;
+      return icCmmStatCantOpenProfile;
+    }
+    setupTimer.SetBytes(nProfileLen);
   }
 
   icStatusCMM rv = AddXform(pProfile, nIntent, nInterp, nLutType, bUseMpeTags, pHintManager);
@@ -3821,6 +5439,7 @@ icStatusCMM CIccCmm::AddXform(CIccProfile *pProfile,
                               bool bUseMpeTags /*=true*/,
                               CIccCreateXformHintManager *pHintManager /*=NULL*/)
 {
+  CIccSetupScope setupScope(m_pSetupListener);
   icColorSpaceSignature nSrcSpace, nDstSpace;
   bool bInput = !m_bLastInput;
 
@@ -3951,6 +5570,29 @@ icStatusCMM CIccCmm::AddXform(CIccProfile &Profile,
   return stat;
 }
 
+/**
+**************************************************************************
+* Name: icCombinePCSAdjustments
+* 
+* Purpose: 
+*  Combines the PCS adjustments of adjacent xforms that connect directly
+*  through the PCS so that each pixel is adjusted once.  Called after
+*  Begin() has been called for all of the xforms.
+*
+**************************************************************************
+*/
+static void icCombinePCSAdjustments(CIccXformList *pXforms)
+{
+  CIccXformList::iterator i;
+  CIccXform *pPrev = NULL;
+
+  for (i=pXforms->begin(); i!=pXforms->end(); i++) {
+    if (pPrev)
+      i->ptr->CombinePCSAdjust(pPrev);
+    pPrev = i->ptr;
+  }
+}
+
 /**
 **************************************************************************
 * Name: CIccCmm::GetNewApplyCmm
@@ -3966,6 +5608,9 @@ icStatusCMM CIccCmm::Begin(bool bAllocApplyCmm/*=true*/)
   if (m_pApply)
     return icCmmStatOk;
 
+  CIccSetupScope setupScope(m_pSetupListener);
+  CIccSetupTimer setupTimer(icSetupCmmBegin);
+
   if (m_nDestSpace==icSigUnknownData) {
     m_nDestSpace = m_nLastSpace;
   }
@@ -3979,8 +5624,11 @@ icStatusCMM CIccCmm::Begin(bool bAllocApplyCmm/*=true*/)
 
   icStatusCMM rv = icCmmStatOk;
   CIccXformList::iterator i;
+  icInt32Number n;
+
+  for (n=0, i=m_Xforms->begin(); i!=m_Xforms->end(); i++, n++) {
+    CIccSetupTimer xformTimer(icSetupXformBegin, n);
 
-  for (i=m_Xforms->begin(); i!=m_Xforms->end(); i++) {
     rv = i->ptr->Begin();
 
     if (rv!= icCmmStatOk) {
@@ -3988,7 +5636,11 @@ icStatusCMM CIccCmm::Begin(bool bAllocApplyCmm/*=true*/)
     }
   }
 
+  icCombinePCSAdjustments(m_Xforms);
+
   if (bAllocApplyCmm) {
+    CIccSetupTimer applyTimer(icSetupApply);
+
     m_pApply = GetNewApplyCmm(rv);
   }
   else
@@ -4702,6 +6354,130 @@ icStatusCMM CIccCmm::FromInternalEncoding(icColorSpaceSignature nSpace, icUInt16
 }
 
 
+/**
+ **************************************************************************
+ * Name: CIccCmm::ToInternalEncoding
+ * 
+ * Purpose: 
+ *  Batch functions for converting to Internal representation of pixel
+ *  colors.
+ *  
+ * Args:
+ *  nSpace = color space signature of the data,
+ *  nEncode = icFloatColorEncoding type of the data,
+ *  pInternal = converted data is stored here,
+ *  pData = the data to be converted
+ *  nPixels = number of pixels to convert
+ *  nInternalStride = values between pixels in pInternal (0 = samples)
+ *  nDataStride = values between pixels in pData (0 = samples)
+ *  bClip = flag to clip to internal range
+ **************************************************************************
+ */
+icStatusCMM CIccCmm::ToInternalEncoding(icColorSpaceSignature nSpace, icFloatColorEncoding nEncode,
+                                        icFloatNumber *pInternal, const icFloatNumber *pData,
+                                        icUInt32Number nPixels, icUInt32Number nInternalStride,
+                                        icUInt32Number nDataStride, bool bClip)
+{
+  CIccColorEncoding enc;
+  icStatusCMM stat = enc.Begin(nSpace, nEncode, true, bClip);
+
+  if (stat!=icCmmStatOk)
+    return stat;
+
+  return enc.Apply(pInternal, pData, nPixels, nInternalStride, nDataStride);
+}
+
+
+icStatusCMM CIccCmm::ToInternalEncoding(icColorSpaceSignature nSpace, icFloatNumber *pInternal,
+                                        const icUInt8Number *pData, icUInt32Number nPixels,
+                                        icUInt32Number nInternalStride, icUInt32Number nDataStride)
+{
+  CIccColorEncoding enc;
+  icStatusCMM stat = enc.Begin(nSpace, icEncode8Bit, true);
+
+  if (stat!=icCmmStatOk)
+    return stat;
+
+  return enc.Apply(pInternal, pData, nPixels, nInternalStride, nDataStride);
+}
+
+
+icStatusCMM CIccCmm::ToInternalEncoding(icColorSpaceSignature nSpace, icFloatNumber *pInternal,
+                                        const icUInt16Number *pData, icUInt32Number nPixels,
+                                        icUInt32Number nInternalStride, icUInt32Number nDataStride)
+{
+  CIccColorEncoding enc;
+  icStatusCMM stat = enc.Begin(nSpace, icEncode16Bit, true);
+
+  if (stat!=icCmmStatOk)
+    return stat;
+
+  return enc.Apply(pInternal, pData, nPixels, nInternalStride, nDataStride);
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccCmm::FromInternalEncoding
+ * 
+ * Purpose: 
+ *  Batch functions for converting from Internal representation of pixel
+ *  colors.
+ *  
+ * Args:
+ *  nSpace = color space signature of the data,
+ *  nEncode = icFloatColorEncoding type of the data,
+ *  pData = converted data is stored here,
+ *  pInternal = the data to be converted
+ *  nPixels = number of pixels to convert
+ *  nDataStride = values between pixels in pData (0 = samples)
+ *  nInternalStride = values between pixels in pInternal (0 = samples)
+ *  bClip = flag to clip data to internal range
+ **************************************************************************
+ */
+icStatusCMM CIccCmm::FromInternalEncoding(icColorSpaceSignature nSpace, icFloatColorEncoding nEncode,
+                                          icFloatNumber *pData, const icFloatNumber *pInternal,
+                                          icUInt32Number nPixels, icUInt32Number nDataStride,
+                                          icUInt32Number nInternalStride, bool bClip)
+{
+  CIccColorEncoding enc;
+  icStatusCMM stat = enc.Begin(nSpace, nEncode, false, bClip);
+
+  if (stat!=icCmmStatOk)
+    return stat;
+
+  return enc.Apply(pData, pInternal, nPixels, nDataStride, nInternalStride);
+}
+
+
+icStatusCMM CIccCmm::FromInternalEncoding(icColorSpaceSignature nSpace, icUInt8Number *pData,
+                                          const icFloatNumber *pInternal, icUInt32Number nPixels,
+                                          icUInt32Number nDataStride, icUInt32Number nInternalStride)
+{
+  CIccColorEncoding enc;
+  icStatusCMM stat = enc.Begin(nSpace, icEncode8Bit, false);
+
+  if (stat!=icCmmStatOk)
+    return stat;
+
+  return enc.Apply(pData, pInternal, nPixels, nDataStride, nInternalStride);
+}
+
+
+icStatusCMM CIccCmm::FromInternalEncoding(icColorSpaceSignature nSpace, icUInt16Number *pData,
+                                          const icFloatNumber *pInternal, icUInt32Number nPixels,
+                                          icUInt32Number nDataStride, icUInt32Number nInternalStride)
+{
+  CIccColorEncoding enc;
+  icStatusCMM stat = enc.Begin(nSpace, icEncode16Bit, false);
+
+  if (stat!=icCmmStatOk)
+    return stat;
+
+  return enc.Apply(pData, pInternal, nPixels, nDataStride, nInternalStride);
+}
+
+
 /**
  **************************************************************************
  * Name: CIccCmm::GetFloatColorEncoding
@@ -4799,6 +6575,33 @@ icUInt32Number CIccCmm::GetNumXforms() const
   return (icUInt32Number)m_Xforms->size();
 }
 
+/**
+ **************************************************************************
+ * Name: CIccCmm::GetXform
+ * 
+ * Purpose: 
+ *  Get an xform in the xform list
+ * 
+ * Args: 
+ *  nIndex = position of the xform in the list (0 is the first xform added)
+ *  
+ * Return:
+ *  the xform or NULL if there is no xform at nIndex
+ **************************************************************************
+ */
+const CIccXform *CIccCmm::GetXform(icUInt32Number nIndex) const
+{
+  CIccXformList::const_iterator i;
+
+  for (i=m_Xforms->begin(); i!=m_Xforms->end(); i++) {
+    if (!nIndex)
+      return i->ptr;
+    nIndex--;
+  }
+
+  return NULL;
+}
+
 
 /**
 **************************************************************************
@@ -4838,292 +6641,676 @@ icColorSpaceSignature CIccCmm::GetLastXformDest()
   return m_Xforms->rbegin()->ptr->GetDstSpace();
 }
 
+////
+// Compiled transform blobs (see CIccCmm::SaveCompiled())
+////
+
+#define icSigCompiledCmm        ((icUInt32Number)0x69636D63)  /* 'icmc' */
+#define icCompiledCmmVersion    1
+#define icCompiledHeaderSize    80
+#define icCompiledRecordSize    56
+
+#define icCompiledPad32(n)      (((n)+3) & ~((icUInt32Number)3))
+
 /**
-**************************************************************************
-* Name: CIccApplyCmm::CIccApplyCmm
-* 
-* Purpose: 
-*  Constructor
-*
-* Args:
-*  pCmm = ptr to CMM to apply against
-**************************************************************************
-*/
-CIccApplyNamedColorCmm::CIccApplyNamedColorCmm(CIccNamedColorCmm *pCmm) : CIccApplyCmm(pCmm)
+ **************************************************************************
+ * Name: icCompiledLibVersion
+ * 
+ * Purpose: 
+ *  Returns the library version (major, minor, patch bytes) that is stored
+ *  in compiled blobs.  Blobs are only loaded by the version that wrote them.
+ **************************************************************************
+ */
+static icUInt32Number icCompiledLibVersion()
 {
-}
+  unsigned int nMajor=0, nMinor=0, nPatch=0;
 
+  sscanf(ICCPROFLIBVER, "%u.%u.%u", &nMajor, &nMinor, &nPatch);
+
+  return ((nMajor & 0xff)<<24) | ((nMinor & 0xff)<<16) | ((nPatch & 0xff)<<8);
+}
 
 /**
-**************************************************************************
-* Name: CIccApplyCmm::CIccApplyCmm
-* 
-* Purpose: 
-*  Destructor
-**************************************************************************
-*/
-CIccApplyNamedColorCmm::~CIccApplyNamedColorCmm()
+ **************************************************************************
+ * Name: icCompiledUpdate32
+ * 
+ * Purpose: 
+ *  Adds a big endian 32 bit value to an MD5 calculation.
+ **************************************************************************
+ */
+static void icCompiledUpdate32(MD5_CTX *pContext, icUInt32Number nVal)
 {
+  unsigned char buf[4];
+
+  buf[0] = (unsigned char)(nVal>>24);
+  buf[1] = (unsigned char)(nVal>>16);
+  buf[2] = (unsigned char)(nVal>>8);
+  buf[3] = (unsigned char)nVal;
+
+  icMD5Update(pContext, buf, 4);
 }
 
+/**
+ **************************************************************************
+ * Name: icSerializeCompiledProfile
+ * 
+ * Purpose: 
+ *  Writes a copy of pProfile with all of its tags to pIO.  Tags that have
+ *  not been loaded yet are loaded first.
+ **************************************************************************
+ */
+static bool icSerializeCompiledProfile(CIccProfile *pProfile, CIccMemIO *pIO)
+{
+  TagEntryList::iterator i;
+
+  for (i=pProfile->m_Tags->begin(); i!=pProfile->m_Tags->end(); i++) {
+    pProfile->FindTag(i->TagInfo.sig);
+  }
+
+  CIccProfile Profile(*pProfile);
+  CIccNullIO NullIO;
+
+  if (!Profile.Write(&NullIO, icNeverWriteID))
+    return false;
+
+  icUInt32Number nSize = NullIO.GetLength();
+
+  if (!pIO->Alloc(nSize, true) || !Profile.Write(pIO, icNeverWriteID))
+    return false;
+
+  return (icUInt32Number)pIO->GetLength()==nSize;
+}
 
 /**
-**************************************************************************
-* Name: CIccApplyNamedColorCmm::Apply
-* 
-* Purpose: 
-*  Does the actual application of the Xforms in the list.
-*  
-* Args:
-*  DstPixel = Destination pixel where the result is stored,
-*  SrcPixel = Source pixel which is to be applied.
-**************************************************************************
-*/
-icStatusCMM CIccApplyNamedColorCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel)
+ **************************************************************************
+ * Name: icGetCompiledProfileID
+ * 
+ * Purpose: 
+ *  Gets the profile ID of pProfile.  The MD5 of the serialized profile is
+ *  used when the header has no profile ID.  pIO (if not NULL) already has
+ *  the serialized profile.
+ **************************************************************************
+ */
+static bool icGetCompiledProfileID(CIccProfile *pProfile, CIccMemIO *pIO, icProfileID &id)
 {
-  icFloatNumber Pixel[16], *pDst;
-  const icFloatNumber *pSrc;
-  CIccApplyXformList::iterator i;
-  int j, n = (int)m_Xforms->size();
-  CIccApplyXform *pApply;
-  const CIccXform *pApplyXform;
-  CIccXformNamedColor *pXform;
+  int i;
 
-  if (!n)
-    return icCmmStatBadXform;
+  for (i=0; i<16; i++) {
+    if (pProfile->m_Header.profileID.ID8[i])
+      break;
+  }
 
-  icChar NamedColor[256];
-  icStatusCMM rv;
+  if (i<16) {
+    id = pProfile->m_Header.profileID;
+    return true;
+  }
 
-  m_pPCS->Reset(m_pCmm->GetSourceSpace());
+  CIccMemIO ProfileIO;
 
-  pSrc = SrcPixel;
-  pDst = Pixel;
+  if (!pIO) {
+    if (!icSerializeCompiledProfile(pProfile, &ProfileIO))
+      return false;
+    pIO = &ProfileIO;
+  }
 
-  if (n>1) {
-    for (j=0, i=m_Xforms->begin(); j<n-1 && i!=m_Xforms->end(); i++, j++) {
+  CalcProfileID(pIO, &id);
 
-      pApply = i->ptr;
-      pApplyXform = pApply->GetXform();
-      if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-        pXform = (CIccXformNamedColor*)pApplyXform;
+  return true;
+}
 
-        switch(pXform->GetInterface()) {
-        case icApplyPixel2Pixel:
-          pXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pXform));
-          break;
+/**
+ **************************************************************************
+ * Name: icCalcCompiledKey
+ * 
+ * Purpose: 
+ *  Calculates the key of a list of xforms from their profile IDs and the
+ *  parameters that they were created with.
+ **************************************************************************
+ */
+static void icCalcCompiledKey(CIccXformList *pXforms, const icProfileID *pIDs, icProfileID &key)
+{
+  MD5_CTX context;
+  CIccXformList::iterator i;
+  int n;
 
-        case icApplyPixel2Named:
-          pXform->Apply(pApply, NamedColor, m_pPCS->Check(pSrc, pXform));
-          break;
+  icMD5Init(&context);
+  icCompiledUpdate32(&context, icSigCompiledCmm);
+  icCompiledUpdate32(&context, icCompiledCmmVersion);
+  icCompiledUpdate32(&context, (icUInt32Number)pXforms->size());
 
-        case icApplyNamed2Pixel:
-          if (j==0) {
-            return icCmmStatIncorrectApply;
-          }
+  for (n=0, i=pXforms->begin(); i!=pXforms->end(); i++, n++) {
+    CIccXform *pXform = i->ptr;
 
-          rv = pXform->Apply(pApply, pDst, NamedColor);
+    icMD5Update(&context, (unsigned char*)&pIDs[n].ID8[0], 16);
+    icCompiledUpdate32(&context, pXform->GetXformType());
+    icCompiledUpdate32(&context, pXform->IsInput() ? 1 : 0);
+    icCompiledUpdate32(&context, pXform->GetIntent());
+    icCompiledUpdate32(&context, pXform->GetInterp());
+    icCompiledUpdate32(&context, pXform->GetLutType());
+    icCompiledUpdate32(&context, (pXform->GetUseMpeTags() ? 1 : 0) | (pXform->HasAdjustPCSHint() ? 2 : 0));
+  }
 
-          if (rv) {
-            return rv;
-          }
-          break;
+  icMD5Final(&key.ID8[0], &context);
+}
 
-        default:
-          break;
-        }
-      }
-      else {
-        pApplyXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pApplyXform));
-      }
-      pSrc = pDst;
+/**
+ **************************************************************************
+ * Name: CIccCmm::GetCompiledKey
+ * 
+ * Purpose: 
+ *  Gets the key that SaveCompiled() stores for the xforms that have been
+ *  added.  The key can be passed to LoadCompiled() to make sure that a
+ *  blob isn't used after the profiles or parameters have changed.
+ * 
+ * Args: 
+ *  key = where the key is returned
+ * 
+ * Return: 
+ *  true if the key could be calculated.
+ **************************************************************************
+ */
+bool CIccCmm::GetCompiledKey(icProfileID &key)
+{
+  icUInt32Number nXforms = (icUInt32Number)m_Xforms->size();
+
+  if (!nXforms)
+    return false;
+
+  icProfileID *pIDs = new icProfileID[nXforms];
+  CIccXformList::iterator i;
+  icUInt32Number n;
+  bool rv = true;
+
+  for (n=0, i=m_Xforms->begin(); i!=m_Xforms->end(); i++, n++) {
+    if (!icGetCompiledProfileID((CIccProfile*)i->ptr->GetProfile(), NULL, pIDs[n])) {
+      rv = false;
+      break;
     }
+  }
 
-    pApply = i->ptr;
-    pApplyXform = pApply->GetXform();
-    if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-      pXform = (CIccXformNamedColor*)pApplyXform;
+  if (rv)
+    icCalcCompiledKey(m_Xforms, pIDs, key);
 
-      switch(pXform->GetInterface()) {
-      case icApplyPixel2Pixel:
-        pXform->Apply(pApply, DstPixel, m_pPCS->Check(pSrc, pXform));
-        break;
+  delete [] pIDs;
 
-      case icApplyPixel2Named:
-      default:
-        return icCmmStatIncorrectApply;
-        break;
+  return rv;
+}
 
-      case icApplyNamed2Pixel:
-        rv = pXform->Apply(pApply, DstPixel, NamedColor);
-        if (rv) {
-          return rv;
-        }
-        break;
+/**
+ **************************************************************************
+ * Name: CIccCmm::SaveCompiled
+ * 
+ * Purpose: 
+ *  Writes the ready to run transform to a blob that LoadCompiled() can use
+ *  to set up the same transform without rebuilding the state that Begin()
+ *  computes from the profiles.  All values are big endian.  The blob has an
+ *  80 byte header (signature, format version, sizes, key, MD5 checksum of
+ *  the rest of the blob, library version and color spaces) followed by one
+ *  record for each xform.  A record has the parameters of the xform, the
+ *  state written by CIccXform::SaveCompiled() and the profile.
+ *  Must be called after Begin().
+ * 
+ * Args: 
+ *  pIO = IO object to write the blob to
+ * 
+ * Return: 
+ *  icCmmStatOk, if the blob was written
+ **************************************************************************
+ */
+icStatusCMM CIccCmm::SaveCompiled(CIccIO *pIO)
+{
+  if (!m_pApply)
+    return icCmmStatIncorrectApply;
 
-      }
+  icUInt32Number nXforms = (icUInt32Number)m_Xforms->size();
+
+  if (!pIO || !nXforms)
+    return icCmmStatBadXform;
+
+  CIccMemIO *pProfileIO = new CIccMemIO[nXforms];
+  CIccMemIO *pStateIO = new CIccMemIO[nXforms];
+  icProfileID *pIDs = new icProfileID[nXforms];
+  icUInt32Number nTotal = icCompiledHeaderSize;
+  icStatusCMM rv = icCmmStatOk;
+  CIccXformList::iterator i;
+  icUInt32Number n;
+
+  for (n=0, i=m_Xforms->begin(); i!=m_Xforms->end(); i++, n++) {
+    CIccXform *pXform = i->ptr;
+    CIccProfile *pProfile = (CIccProfile*)pXform->GetProfile();
+
+    if (pXform->GetXformType()==icXformTypeNamedColor || !pProfile) {
+      rv = icCmmStatBadXform;
+      break;
     }
-    else {
-      pApplyXform->Apply(pApply, DstPixel, m_pPCS->Check(pSrc, pApplyXform));
+
+    if (!icSerializeCompiledProfile(pProfile, &pProfileIO[n]) ||
+        !icGetCompiledProfileID(pProfile, &pProfileIO[n], pIDs[n])) {
+      rv = icCmmStatInvalidProfile;
+      break;
     }
 
-  }
-  else if (n==1) {
-    i = m_Xforms->begin();
+    CIccNullIO NullIO;
 
-    pApply = i->ptr;
-    pApplyXform = pApply->GetXform();
-    if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-      return icCmmStatIncorrectApply;
+    if (!pXform->SaveCompiled(&NullIO) ||
+        !pStateIO[n].Alloc(NullIO.GetLength(), true) ||
+        !pXform->SaveCompiled(&pStateIO[n]) ||
+        pStateIO[n].GetLength()!=NullIO.GetLength()) {
+      rv = icCmmStatBadXform;
+      break;
+    }
+
+    nTotal += icCompiledRecordSize + icCompiledPad32(pStateIO[n].GetLength()) +
+              icCompiledPad32(pProfileIO[n].GetLength());
+  }
+
+  CIccMemIO Blob;
+
+  if (rv==icCmmStatOk && !Blob.Alloc(nTotal, true))
+    rv = icCmmStatAllocErr;
+
+  if (rv==icCmmStatOk) {
+    icUInt32Number nVal;
+    icProfileID key, checksum;
+
+    memset(&key, 0, sizeof(key));
+    memset(&checksum, 0, sizeof(checksum));
+
+    nVal = icSigCompiledCmm;      Blob.Write32(&nVal);
+    nVal = icCompiledCmmVersion;  Blob.Write32(&nVal);
+    nVal = nTotal;                Blob.Write32(&nVal);
+    nVal = icCompiledHeaderSize;  Blob.Write32(&nVal);
+    Blob.Write8(&key, sizeof(key));
+    Blob.Write8(&checksum, sizeof(checksum));
+    nVal = icCompiledLibVersion();  Blob.Write32(&nVal);
+    nVal = m_nSrcSpace;           Blob.Write32(&nVal);
+    nVal = m_nDestSpace;          Blob.Write32(&nVal);
+    nVal = m_nLastSpace;          Blob.Write32(&nVal);
+    nVal = m_nLastIntent;         Blob.Write32(&nVal);
+    nVal = m_bLastInput ? 1 : 0;  Blob.Write32(&nVal);
+    nVal = nXforms;               Blob.Write32(&nVal);
+    nVal = 0;                     Blob.Write32(&nVal);
+
+    for (n=0, i=m_Xforms->begin(); i!=m_Xforms->end(); i++, n++) {
+      CIccXform *pXform = i->ptr;
+      icUInt32Number nStateSize = pStateIO[n].GetLength();
+      icUInt32Number nProfileSize = pProfileIO[n].GetLength();
+      icUInt32Number nRecSize = icCompiledRecordSize + icCompiledPad32(nStateSize) + icCompiledPad32(nProfileSize);
+      icUInt32Number nProfileOffset = Blob.GetLength() + icCompiledRecordSize + icCompiledPad32(nStateSize);
+
+      Blob.Write32(&nRecSize);
+      nVal = pXform->GetXformType();    Blob.Write32(&nVal);
+      nVal = pXform->IsInput() ? 1 : 0; Blob.Write32(&nVal);
+      nVal = pXform->GetIntent();       Blob.Write32(&nVal);
+      nVal = pXform->GetInterp();       Blob.Write32(&nVal);
+      nVal = pXform->GetLutType();      Blob.Write32(&nVal);
+      nVal = (pXform->GetUseMpeTags() ? 1 : 0) | (pXform->HasAdjustPCSHint() ? 2 : 0);
+      Blob.Write32(&nVal);
+      Blob.Write8(&pIDs[n], sizeof(icProfileID));
+      Blob.Write32(&nProfileOffset);
+      Blob.Write32(&nProfileSize);
+      Blob.Write32(&nStateSize);
+
+      Blob.Write8(pStateIO[n].GetData(), nStateSize);
+      Blob.Align32();
+      Blob.Write8(pProfileIO[n].GetData(), nProfileSize);
+      Blob.Align32();
+    }
+
+    if ((icUInt32Number)Blob.GetLength()!=nTotal) {
+      rv = icCmmStatBadXform;
     }
+    else {
+      MD5_CTX context;
+
+      icMD5Init(&context);
+      icMD5Update(&context, Blob.GetData()+icCompiledHeaderSize, nTotal-icCompiledHeaderSize);
+      icMD5Final(&checksum.ID8[0], &context);
+
+      icCalcCompiledKey(m_Xforms, pIDs, key);
+
+      Blob.Seek(16, icSeekSet);
+      Blob.Write8(&key, sizeof(key));
+      Blob.Write8(&checksum, sizeof(checksum));
 
-    pApplyXform->Apply(pApply, DstPixel, m_pPCS->Check(pSrc, pApplyXform));
+      if (pIO->Write8(Blob.GetData(), nTotal)!=(icInt32Number)nTotal)
+        rv = icCmmStatCantOpenProfile;
+    }
   }
 
-  m_pPCS->CheckLast(DstPixel, m_pCmm->GetDestSpace());
+  delete [] pIDs;
+  delete [] pStateIO;
+  delete [] pProfileIO;
 
-  return icCmmStatOk;
+  return rv;
 }
 
+/**
+ **************************************************************************
+ * Name: CIccCmm::SaveCompiled
+ * 
+ * Purpose: 
+ *  Writes the ready to run transform to a file (see SaveCompiled(CIccIO*)).
+ * 
+ * Args: 
+ *  szFilename = name of the file to write
+ * 
+ * Return: 
+ *  icCmmStatOk, if the blob was written
+ **************************************************************************
+ */
+icStatusCMM CIccCmm::SaveCompiled(const icChar *szFilename)
+{
+  CIccFileIO FileIO;
+
+  if (!FileIO.Open(szFilename, "wb"))
+    return icCmmStatCantOpenProfile;
+
+  return SaveCompiled(&FileIO);
+}
 
 /**
-**************************************************************************
-* Name: CIccApplyNamedColorCmm::Apply
-* 
-* Purpose: 
-*  Does the actual application of the Xforms in the list.
-*  
-* Args:
-*  DstPixel = Destination pixel where the result is stored,
-*  SrcPixel = Source pixel which is to be applied.
-**************************************************************************
-*/
-icStatusCMM CIccApplyNamedColorCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel, icUInt32Number nPixels)
+ **************************************************************************
+ * Name: CIccCmm::LoadCompiled
+ * 
+ * Purpose: 
+ *  Sets up the CMM from a blob written by SaveCompiled() and then calls
+ *  Begin().  The CMM must not have any xforms.  The profiles in the blob
+ *  are attached in place, so tags are read from pData as they are needed
+ *  and pData must not be freed or changed until the CMM is deleted.
+ * 
+ * Args: 
+ *  pData = the blob (for example a memory mapped file)
+ *  nSize = number of bytes at pData
+ *  pKey = key that the blob must have (see GetCompiledKey()), NULL to not
+ *   check the key
+ * 
+ * Return: 
+ *  icCmmStatOk, if the CMM is ready to apply
+ *  icCmmStatBadCompiledData, if the blob is damaged, was written by another
+ *   version of the library, or has a different key
+ **************************************************************************
+ */
+icStatusCMM CIccCmm::LoadCompiled(const icUInt8Number *pData, icUInt32Number nSize,
+                                  const icProfileID *pKey /*=NULL*/)
 {
-  icFloatNumber Pixel[16], *pDst;
-  const icFloatNumber *pSrc;
-  CIccApplyXformList::iterator i;
-  int j, n = (int)m_Xforms->size();
-  CIccApplyXform *pApply;
-  const CIccXform *pApplyXform;
-  CIccXformNamedColor *pXform;
-  icUInt32Number k; 
+  CIccSetupScope setupScope(m_pSetupListener);
 
-  if (!n)
+  if (m_Xforms->size() || m_pApply)
     return icCmmStatBadXform;
 
-  icChar NamedColor[256];
-  icStatusCMM rv;
+  if (!pData || nSize<icCompiledHeaderSize)
+    return icCmmStatBadCompiledData;
+
+  CIccMemIO Blob;
+  icUInt32Number nSig, nVersion, nTotal, nHeaderSize, nLibVersion;
+  icUInt32Number nSrcSpace, nDestSpace, nLastSpace, nLastIntent, nFlags, nXforms, nReserved;
+  icProfileID key, checksum, sum;
+
+  Blob.Attach((icUInt8Number*)pData, nSize);
+
+  Blob.Read32(&nSig);
+  Blob.Read32(&nVersion);
+  Blob.Read32(&nTotal);
+  Blob.Read32(&nHeaderSize);
+  Blob.Read8(&key, sizeof(key));
+  Blob.Read8(&checksum, sizeof(checksum));
+  Blob.Read32(&nLibVersion);
+  Blob.Read32(&nSrcSpace);
+  Blob.Read32(&nDestSpace);
+  Blob.Read32(&nLastSpace);
+  Blob.Read32(&nLastIntent);
+  Blob.Read32(&nFlags);
+  Blob.Read32(&nXforms);
+  Blob.Read32(&nReserved);
+
+  if (nSig!=icSigCompiledCmm || nVersion!=icCompiledCmmVersion ||
+      nHeaderSize!=icCompiledHeaderSize || nTotal<nHeaderSize || nTotal>nSize ||
+      nLibVersion!=icCompiledLibVersion() || nFlags>1 ||
+      !nXforms || nXforms>(nTotal-nHeaderSize)/icCompiledRecordSize)
+    return icCmmStatBadCompiledData;
+
+  MD5_CTX context;
+
+  icMD5Init(&context);
+  icMD5Update(&context, (unsigned char*)pData+nHeaderSize, nTotal-nHeaderSize);
+  icMD5Final(&sum.ID8[0], &context);
+
+  if (memcmp(&sum, &checksum, sizeof(sum)))
+    return icCmmStatBadCompiledData;
+
+  if (pKey && memcmp(pKey, &key, sizeof(key)))
+    return icCmmStatBadCompiledData;
+
+  if ((m_nSrcSpace!=icSigUnknownData && !IsCompatSpace(m_nSrcSpace, (icColorSpaceSignature)nSrcSpace)) ||
+      (m_nDestSpace!=icSigUnknownData && !IsCompatSpace(m_nDestSpace, (icColorSpaceSignature)nDestSpace)))
+    return icCmmStatBadSpaceLink;
+
+  icStatusCMM rv = icCmmStatOk;
+  icUInt32Number n, nPos = nHeaderSize;
+
+  for (n=0; n<nXforms; n++) {
+    icUInt32Number nRecSize, nType, nInput, nIntent, nInterp, nLutType, nXformFlags;
+    icUInt32Number nProfileOffset, nProfileSize, nStateSize;
+    icProfileID id;
+
+    if (nPos>nTotal-icCompiledRecordSize) {
+      rv = icCmmStatBadCompiledData;
+      break;
+    }
+
+    Blob.Seek(nPos, icSeekSet);
+    Blob.Read32(&nRecSize);
+    Blob.Read32(&nType);
+    Blob.Read32(&nInput);
+    Blob.Read32(&nIntent);
+    Blob.Read32(&nInterp);
+    Blob.Read32(&nLutType);
+    Blob.Read32(&nXformFlags);
+    Blob.Read8(&id, sizeof(id));
+    Blob.Read32(&nProfileOffset);
+    Blob.Read32(&nProfileSize);
+    Blob.Read32(&nStateSize);
+
+    if (nRecSize<icCompiledRecordSize || nRecSize>nTotal-nPos || (nRecSize & 3) ||
+        nStateSize>nRecSize-icCompiledRecordSize ||
+        nProfileOffset<nPos+icCompiledRecordSize+nStateSize || nProfileOffset>nPos+nRecSize ||
+        nProfileSize<sizeof(icHeader) || nProfileSize>nPos+nRecSize-nProfileOffset ||
+        nInput>1 || nXformFlags>3) {
+      rv = icCmmStatBadCompiledData;
+      break;
+    }
+
+    CIccProfile *pProfile;
+
+    {
+      CIccSetupTimer setupTimer(icSetupProfileOpen, (icInt32Number)n);
+      CIccMemIO *pFile = new CIccMemIO;
+
+      pFile->Attach((icUInt8Number*)pData+nProfileOffset, nProfileSize);
+
+      pProfile = new CIccProfile;
+
+      if (!pProfile->Attach(pFile)) {
+        delete pFile;
+        delete pProfile;
+        rv = icCmmStatBadCompiledData;
+        break;
+      }
+      setupTimer.SetBytes(nProfileSize);
+    }
+
+    CIccXformPtr Xform;
 
-  for (k=0; k<nPixels; k++) {
-    m_pPCS->Reset(m_pCmm->GetSourceSpace());
+    Xform.ptr = CIccXform::Create(pProfile, nInput!=0, (icRenderingIntent)nIntent, (icXformInterp)nInterp,
+                                  (icXformLutType)nLutType, (nXformFlags & 1)!=0, NULL);
 
-    pSrc = SrcPixel;
-    pDst = Pixel;
+    if (!Xform.ptr) {
+      delete pProfile;
+      rv = icCmmStatBadCompiledData;
+      break;
+    }
 
-    if (n>1) {
-      for (j=0, i=m_Xforms->begin(); j<n-1 && i!=m_Xforms->end(); i++, j++) {
+    m_Xforms->push_back(Xform);
 
-        pApply = i->ptr;
-        pApplyXform = pApply->GetXform();
-        if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-          pXform = (CIccXformNamedColor*)pApplyXform;
+    CIccMemIO State;
 
-          switch(pXform->GetInterface()) {
-          case icApplyPixel2Pixel:
-            pXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pXform));
-            break;
+    if ((icUInt32Number)Xform.ptr->GetXformType()!=nType ||
+        (nStateSize && !State.Attach((icUInt8Number*)pData+nPos+icCompiledRecordSize, nStateSize)) ||
+        !Xform.ptr->LoadCompiled(&State)) {
+      rv = icCmmStatBadCompiledData;
+      break;
+    }
 
-          case icApplyPixel2Named:
-            pXform->Apply(pApply, NamedColor, m_pPCS->Check(pSrc, pXform));
-            break;
+    nPos += nRecSize;
+  }
 
-          case icApplyNamed2Pixel:
-            if (j==0) {
-              return icCmmStatIncorrectApply;
-            }
+  if (rv!=icCmmStatOk) {
+    CIccXformList::iterator i;
 
-            rv = pXform->Apply(pApply, pDst, NamedColor);
+    for (i=m_Xforms->begin(); i!=m_Xforms->end(); i++) {
+      if (i->ptr)
+        delete i->ptr;
+    }
+    m_Xforms->clear();
 
-            if (rv) {
-              return rv;
-            }
-            break;
+    return rv;
+  }
 
-          default:
-            break;
-          }
-        }
-        else {
-          pApplyXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pApplyXform));
-        }
-        pSrc = pDst;
-      }
+  if (m_nSrcSpace==icSigUnknownData)
+    m_nSrcSpace = (icColorSpaceSignature)nSrcSpace;
+  if (m_nDestSpace==icSigUnknownData)
+    m_nDestSpace = (icColorSpaceSignature)nDestSpace;
+  m_nLastSpace = (icColorSpaceSignature)nLastSpace;
+  m_nLastIntent = (icRenderingIntent)nLastIntent;
+  m_bLastInput = (nFlags & 1)!=0;
 
-      pApply = i->ptr;
-      pApplyXform = pApply->GetXform();
-      if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-        pXform = (CIccXformNamedColor*)pApplyXform;
+  return Begin();
+}
 
-        switch(pXform->GetInterface()) {
-        case icApplyPixel2Pixel:
-          pXform->Apply(pApply, DstPixel, m_pPCS->Check(pSrc, pXform));
-          break;
+/**
+ **************************************************************************
+ * Name: CIccCmm::LoadCompiled
+ * 
+ * Purpose: 
+ *  Reads a blob written by SaveCompiled() from the current position of pIO
+ *  to its end and sets up the CMM from it.  The blob is kept by the CMM.
+ * 
+ * Args: 
+ *  pIO = IO object to read the blob from
+ *  pKey = key that the blob must have, NULL to not check the key
+ * 
+ * Return: 
+ *  icCmmStatOk, if the CMM is ready to apply
+ **************************************************************************
+ */
+icStatusCMM CIccCmm::LoadCompiled(CIccIO *pIO, const icProfileID *pKey /*=NULL*/)
+{
+  if (m_Xforms->size() || m_pApply || m_pCompiledData)
+    return icCmmStatBadXform;
 
-        case icApplyPixel2Named:
-        default:
-          return icCmmStatIncorrectApply;
-          break;
+  if (!pIO)
+    return icCmmStatBadCompiledData;
 
-        case icApplyNamed2Pixel:
-          rv = pXform->Apply(pApply, DstPixel, NamedColor);
-          if (rv) {
-            return rv;
-          }
-          break;
+  icInt32Number nSize = pIO->GetLength() - pIO->Tell();
 
-        }
-      }
-      else {
-        pApplyXform->Apply(pApply, DstPixel, m_pPCS->Check(pSrc, pApplyXform));
-      }
+  if (nSize<icCompiledHeaderSize)
+    return icCmmStatBadCompiledData;
 
-    }
-    else if (n==1) {
-      i = m_Xforms->begin();
+  m_pCompiledData = (icUInt8Number*)malloc(nSize);
 
-      pApply = i->ptr;
-      pApplyXform = pApply->GetXform();
-      if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-        return icCmmStatIncorrectApply;
-      }
+  if (!m_pCompiledData)
+    return icCmmStatAllocErr;
 
-      pApplyXform->Apply(pApply, DstPixel, m_pPCS->Check(pSrc, pApplyXform));
-    }
+  icStatusCMM rv;
 
-    m_pPCS->CheckLast(DstPixel, m_pCmm->GetDestSpace());
+  if (pIO->Read8(m_pCompiledData, nSize)!=nSize)
+    rv = icCmmStatBadCompiledData;
+  else
+    rv = LoadCompiled(m_pCompiledData, (icUInt32Number)nSize, pKey);
 
-    SrcPixel += m_pCmm->GetSourceSamples();
-    DstPixel += m_pCmm->GetDestSamples();
+  if (rv!=icCmmStatOk && !m_Xforms->size()) {
+    free(m_pCompiledData);
+    m_pCompiledData = NULL;
   }
 
-  return icCmmStatOk;
+  return rv;
 }
 
+/**
+ **************************************************************************
+ * Name: CIccCmm::LoadCompiled
+ * 
+ * Purpose: 
+ *  Sets up the CMM from a file written by SaveCompiled().
+ * 
+ * Args: 
+ *  szFilename = name of the file to read
+ *  pKey = key that the blob must have, NULL to not check the key
+ * 
+ * Return: 
+ *  icCmmStatOk, if the CMM is ready to apply
+ **************************************************************************
+ */
+icStatusCMM CIccCmm::LoadCompiled(const icChar *szFilename, const icProfileID *pKey /*=NULL*/)
+{
+  CIccFileIO FileIO;
+
+  if (!FileIO.Open(szFilename, "rb"))
+    return icCmmStatCantOpenProfile;
+
+  return LoadCompiled(&FileIO, pKey);
+}
 
 /**
 **************************************************************************
-* Name: CIccApplyNamedColorCmm::Apply
+* Name: CIccApplyCmm::CIccApplyCmm
 * 
 * Purpose: 
-*  Does the actual application of the Xforms in the list.
+*  Constructor
+*
+* Args:
+*  pCmm = ptr to CMM to apply against
+**************************************************************************
+*/
+CIccApplyNamedColorCmm::CIccApplyNamedColorCmm(CIccNamedColorCmm *pCmm) : CIccApplyCmm(pCmm)
+{
+}
+
+
+/**
+**************************************************************************
+* Name: CIccApplyCmm::CIccApplyCmm
+* 
+* Purpose: 
+*  Destructor
+**************************************************************************
+*/
+CIccApplyNamedColorCmm::~CIccApplyNamedColorCmm()
+{
+}
+
+
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::ApplyChain
+* 
+* Purpose: 
+*  Does the actual application of the Xforms in the list.  The source is
+*  either a pixel or an entry index of the first xform's named color tag,
+*  and the destination is either a pixel or an entry index of the last
+*  xform's named color tag.  Named color results are passed between xforms
+*  as indexes (see CIccXformNamedColor::LinkSrcIndex()).
 *  
 * Args:
-*  DstColorName = Destination string where the result is stored,
-*  SrcPixel = Source pixel which is to be applied.
+*  DstPixel = Destination pixel where the result is stored (NULL if pDstIndex is used),
+*  pDstIndex = Destination index where the result is stored (NULL if DstPixel is used),
+*  SrcPixel = Source pixel which is to be applied (NULL if nSrcIndex is used),
+*  nSrcIndex = Source named color index which is to be applied.
 **************************************************************************
 */
-icStatusCMM CIccApplyNamedColorCmm::Apply(icChar* DstColorName, const icFloatNumber *SrcPixel)
+icStatusCMM CIccApplyNamedColorCmm::ApplyChain(icFloatNumber *DstPixel, icInt32Number *pDstIndex,
+                                               const icFloatNumber *SrcPixel, icInt32Number nSrcIndex)
 {
   icFloatNumber Pixel[16], *pDst;
   const icFloatNumber *pSrc;
@@ -5131,89 +7318,103 @@ icStatusCMM CIccApplyNamedColorCmm::Apply(icChar* DstColorName, const icFloatNum
   int j, n = (int)m_Xforms->size();
   CIccApplyXform *pApply;
   const CIccXform *pApplyXform;
-  CIccXformNamedColor *pXform;
+  const CIccXformNamedColor *pXform, *pFirst=NULL;
+  icInt32Number nIndex = nSrcIndex;
+  bool bLast;
+  icStatusCMM rv;
 
   if (!n)
     return icCmmStatBadXform;
 
-  icChar NamedColor[256];
-  icStatusCMM rv;
-
-  m_pPCS->Reset(m_pCmm->GetSourceSpace());
+  i = m_Xforms->begin();
+  pApplyXform = i->ptr->GetXform();
 
-  pSrc = SrcPixel;
-  pDst = Pixel;
-
-  if (n>1) {
-    for (j=0, i=m_Xforms->begin(); j<n-1 && i!=m_Xforms->end(); i++, j++) {
+  if (!SrcPixel) {
+    if (pApplyXform->GetXformType()!=icXformTypeNamedColor)
+      return icCmmStatIncorrectApply;
 
-      pApply = i->ptr;
-      pApplyXform = pApply->GetXform();
-      if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-        pXform = (CIccXformNamedColor*)pApplyXform;
-        switch(pXform->GetInterface()) {
-        case icApplyPixel2Pixel:
-          pXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pXform));
-          break;
+    pFirst = (const CIccXformNamedColor*)pApplyXform;
+    m_pPCS->Reset(pFirst->GetSrcSpace(), pFirst->UseLegacyPCS());
+  }
+  else {
+    if (n==1 && DstPixel && pApplyXform->GetXformType()==icXformTypeNamedColor)
+      return icCmmStatIncorrectApply;
 
-        case icApplyPixel2Named:
-          pXform->Apply(pApply, NamedColor, m_pPCS->Check(pSrc, pXform));
-          break;
+    m_pPCS->Reset(m_pCmm->GetSourceSpace());
+  }
 
-        case icApplyNamed2Pixel:
-          if (j==0) {
-            return icCmmStatIncorrectApply;
-          }
-          rv = pXform->Apply(pApply, pDst, NamedColor);
-          if (rv) {
-            return rv;
-          }
-          break;
+  pSrc = SrcPixel;
 
-        default:
-          break;
-        }
-      }
-      else {
-        pApplyXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pApplyXform));
-      }
-      pSrc = pDst;
-    }
+  for (j=0; i!=m_Xforms->end(); i++, j++) {
+    bLast = (j==n-1);
+    pDst = bLast ? DstPixel : Pixel;
 
     pApply = i->ptr;
     pApplyXform = pApply->GetXform();
+
+#ifdef ICC_PERF_COUNTERS
+    //PCS conversion time is accumulated separately in m_PCSPerf
+    icPerfCount nStart = icPerfTicks(), nPCSTicks = m_PCSPerf.m_nTicks;
+#endif
     if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-      pXform = (CIccXformNamedColor*)pApplyXform;
+      pXform = (const CIccXformNamedColor*)pApplyXform;
+
       switch(pXform->GetInterface()) {
+      case icApplyPixel2Pixel:
+        if (!pSrc || !pDst)
+          return icCmmStatIncorrectApply;
+        pXform->Apply(pApply, pDst, icCheckPCS(m_pPCS, m_PCSPerf, pSrc, pXform));
+        break;
 
       case icApplyPixel2Named:
-        pXform->Apply(pApply, DstColorName, m_pPCS->Check(pSrc, pXform));
+        if (!pSrc || (bLast && !pDstIndex))
+          return icCmmStatIncorrectApply;
+        rv = pXform->ApplyToIndex(pApply, nIndex, icCheckPCS(m_pPCS, m_PCSPerf, pSrc, pXform));
+        if (rv) {
+          return rv;
+        }
         break;
 
-      case icApplyPixel2Pixel:
       case icApplyNamed2Pixel:
+        if (!pDst || (j==0 && SrcPixel))
+          return icCmmStatIncorrectApply;
+        if (j>0)
+          nIndex = pXform->MapSrcIndex(nIndex);
+        rv = pXform->ApplyFromIndex(pApply, pDst, nIndex);
+        if (rv) {
+          return rv;
+        }
+        break;
+
       default:
-        return icCmmStatIncorrectApply;
+        if (bLast)
+          return icCmmStatIncorrectApply;
         break;
       }
     }
     else {
-      return icCmmStatIncorrectApply;
+      if (!pSrc || !pDst)
+        return icCmmStatIncorrectApply;
+      pApplyXform->Apply(pApply, pDst, icCheckPCS(m_pPCS, m_PCSPerf, pSrc, pApplyXform));
     }
-
+#ifdef ICC_PERF_COUNTERS
+    pApply->GetPerf().Add(icPerfTicks() - nStart - (m_PCSPerf.m_nTicks - nPCSTicks));
+#endif
+    pSrc = pDst;
   }
-  else if (n==1) {
-    i = m_Xforms->begin();
-    pApply = i->ptr;
-    pApplyXform = pApply->GetXform();
-    if (pApplyXform->GetXformType()!=icXformTypeNamedColor) {
-      return icCmmStatIncorrectApply;
-    }
 
-    pXform = (CIccXformNamedColor*)pApplyXform;
-    pXform->Apply(pApply, DstColorName, m_pPCS->Check(pSrc, pXform));
+  if (pDstIndex) {
+    *pDstIndex = nIndex;
+    return icCmmStatOk;
   }
 
+  ICC_PERF_START(nStart);
+  if (pFirst && n==1)
+    m_pPCS->Check(DstPixel, pFirst);
+
+  m_pPCS->CheckLast(DstPixel, m_pCmm->GetDestSpace());
+  ICC_PERF_STOP(m_PCSPerf, nStart, 1);
+
   return icCmmStatOk;
 }
 
@@ -5227,117 +7428,95 @@ icStatusCMM CIccApplyNamedColorCmm::Apply(icChar* DstColorName, const icFloatNum
 *  
 * Args:
 *  DstPixel = Destination pixel where the result is stored,
-*  SrcColorName = Source color name which is to be searched.
+*  SrcPixel = Source pixel which is to be applied.
 **************************************************************************
 */
-icStatusCMM CIccApplyNamedColorCmm::Apply(icFloatNumber *DstPixel, const icChar *SrcColorName)
+icStatusCMM CIccApplyNamedColorCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel)
 {
-  icFloatNumber Pixel[16], *pDst;
-  const icFloatNumber *pSrc;
-  CIccApplyXformList::iterator i;
-  int j, n = (int)m_Xforms->size();
-  CIccApplyXform *pApply;
-  const CIccXform *pApplyXform;
-  CIccXformNamedColor *pXform;
-
-  if (!n)
-    return icCmmStatBadXform;
-
-  icChar NamedColor[256];
-  icStatusCMM rv;
-
-  i=m_Xforms->begin();
-  pApply = i->ptr;
-  pApplyXform = pApply->GetXform();
-  if (pApplyXform->GetXformType()!=icXformTypeNamedColor)
-    return icCmmStatIncorrectApply;
-
-  pXform = (CIccXformNamedColor*)pApplyXform;  
-  m_pPCS->Reset(pXform->GetSrcSpace(), pXform->UseLegacyPCS());
-
-  pDst = Pixel;
-
-  if (n>1) {
-    rv = pXform->Apply(pApply, pDst, SrcColorName);
-    if (rv) {
-      return rv;
-    }
-
-    pSrc = pDst;
-
-    for (j=0, i++; j<n-2 && i!=m_Xforms->end(); i++, j++) {
-
-      pApply = i->ptr;
-      pApplyXform = pApply->GetXform();
-      if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-        CIccXformNamedColor *pXform = (CIccXformNamedColor*)pApplyXform;
-        switch(pXform->GetInterface()) {
-        case icApplyPixel2Pixel:
-          pXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pXform));
-          break;
-
-        case icApplyPixel2Named:
-          pXform->Apply(pApply, NamedColor, m_pPCS->Check(pSrc, pXform));
-          break;
-
-        case icApplyNamed2Pixel:
-          rv = pXform->Apply(pApply, pDst, NamedColor);
-          if (rv) {
-            return rv;
-          }
-          break;
-
-        default:
-          break;
-        }
-      }
-      else {
-        pApplyXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pApplyXform));
-      }
-      pSrc = pDst;
-    }
-
-    pApply = i->ptr;
-    pApplyXform = pApply->GetXform();
-    if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-      pXform = (CIccXformNamedColor*)pApplyXform;
-      switch(pXform->GetInterface()) {
-      case icApplyPixel2Pixel:
-        pXform->Apply(pApply, DstPixel, m_pPCS->Check(pSrc, pXform));
-        break;
-
-      case icApplyPixel2Named:
-      default:
-        return icCmmStatIncorrectApply;
-        break;
+  return ApplyChain(DstPixel, NULL, SrcPixel, -1);
+}
 
-      case icApplyNamed2Pixel:
-        rv = pXform->Apply(pApply, DstPixel, NamedColor);
-        if (rv) {
-          return rv;
-        }
-        break;
 
-      }
-    }
-    else {
-      pApplyXform->Apply(pApply, DstPixel, m_pPCS->Check(pSrc, pApplyXform));
-    }
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::Apply
+* 
+* Purpose: 
+*  Does the actual application of the Xforms in the list.
+*  
+* Args:
+*  DstPixel = Destination pixel where the result is stored,
+*  SrcPixel = Source pixel which is to be applied.
+**************************************************************************
+*/
+icStatusCMM CIccApplyNamedColorCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel, icUInt32Number nPixels)
+{
+  icUInt32Number k, nSrcSamples = m_pCmm->GetSourceSamples(), nDstSamples = m_pCmm->GetDestSamples();
+  icStatusCMM rv;
 
-  }
-  else if (n==1) {
-    rv = pXform->Apply(pApply, DstPixel, SrcColorName);
+  for (k=0; k<nPixels; k++) {
+    rv = ApplyChain(DstPixel, NULL, SrcPixel, -1);
     if (rv) {
       return rv;
     }
-    m_pPCS->Check(DstPixel, pXform);
+
+    SrcPixel += nSrcSamples;
+    DstPixel += nDstSamples;
   }
 
-  m_pPCS->CheckLast(DstPixel, m_pCmm->GetDestSpace());
+  return icCmmStatOk;
+}
+
+
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::Apply
+* 
+* Purpose: 
+*  Does the actual application of the Xforms in the list.
+*  
+* Args:
+*  DstColorName = Destination string where the result is stored,
+*  SrcPixel = Source pixel which is to be applied.
+**************************************************************************
+*/
+icStatusCMM CIccApplyNamedColorCmm::Apply(icChar* DstColorName, const icFloatNumber *SrcPixel)
+{
+  icInt32Number nIndex;
+  icStatusCMM rv;
+
+  rv = ApplyChain(NULL, &nIndex, SrcPixel, -1);
+  if (rv) {
+    return rv;
+  }
+
+  if (!((CIccNamedColorCmm*)m_pCmm)->GetDstColorName(DstColorName, nIndex))
+    return icCmmStatColorNotFound;
 
   return icCmmStatOk;
 }
 
+
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::Apply
+* 
+* Purpose: 
+*  Does the actual application of the Xforms in the list.
+*  
+* Args:
+*  DstPixel = Destination pixel where the result is stored,
+*  SrcColorName = Source color name which is to be searched.
+**************************************************************************
+*/
+icStatusCMM CIccApplyNamedColorCmm::Apply(icFloatNumber *DstPixel, const icChar *SrcColorName)
+{
+  if (!m_Xforms->size())
+    return icCmmStatBadXform;
+
+  return ApplyChain(DstPixel, NULL, NULL, ((CIccNamedColorCmm*)m_pCmm)->FindSrcColor(SrcColorName));
+}
+
 /**
 **************************************************************************
 * Name: CIccApplyNamedColorCmm::Apply
@@ -5352,102 +7531,144 @@ icStatusCMM CIccApplyNamedColorCmm::Apply(icFloatNumber *DstPixel, const icChar
 */
 icStatusCMM CIccApplyNamedColorCmm::Apply(icChar *DstColorName, const icChar *SrcColorName)
 {
-  icFloatNumber Pixel[16], *pDst;
-  const icFloatNumber *pSrc;
-  CIccApplyXformList::iterator i;
-  int j, n = (int)m_Xforms->size();
-  icChar NamedColor[256];
+  icInt32Number nIndex;
   icStatusCMM rv;
-  CIccApplyXform *pApply;
-  const CIccXform *pApplyXform;
-  CIccXformNamedColor *pXform;
 
-  if (!n)
+  if (!m_Xforms->size())
     return icCmmStatBadXform;
 
-  i=m_Xforms->begin();
+  rv = ApplyChain(NULL, &nIndex, NULL, ((CIccNamedColorCmm*)m_pCmm)->FindSrcColor(SrcColorName));
+  if (rv) {
+    return rv;
+  }
 
-  pApply = i->ptr;
-  pApplyXform = pApply->GetXform();
-  if (pApplyXform->GetXformType()!=icXformTypeNamedColor)
-    return icCmmStatIncorrectApply;
+  if (!((CIccNamedColorCmm*)m_pCmm)->GetDstColorName(DstColorName, nIndex))
+    return icCmmStatColorNotFound;
 
-  pXform = (CIccXformNamedColor*)pApplyXform;
+  return icCmmStatOk;
+}
 
-  m_pPCS->Reset(pXform->GetSrcSpace(), pXform->UseLegacyPCS());
 
-  pDst = Pixel;
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::ApplyToIndex
+* 
+* Purpose: 
+*  Applies the Xforms in the list to a pixel giving an entry index of the
+*  last xform's named color tag.
+*  
+* Args:
+*  nDstIndex = Destination index where the result is stored,
+*  SrcPixel = Source pixel which is to be applied.
+**************************************************************************
+*/
+icStatusCMM CIccApplyNamedColorCmm::ApplyToIndex(icInt32Number &nDstIndex, const icFloatNumber *SrcPixel)
+{
+  return ApplyChain(NULL, &nDstIndex, SrcPixel, -1);
+}
 
-  if (n>1) {
-    rv = pXform->Apply(pApply, pDst, SrcColorName);
 
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::ApplyToIndex
+* 
+* Purpose: 
+*  Applies the Xforms in the list to an array of pixels giving entry
+*  indexes of the last xform's named color tag.
+*  
+* Args:
+*  pDstIndex = Destination indexes where the results are stored,
+*  SrcPixel = Source pixels which are to be applied,
+*  nPixels = number of pixels to apply.
+**************************************************************************
+*/
+icStatusCMM CIccApplyNamedColorCmm::ApplyToIndex(icInt32Number *pDstIndex, const icFloatNumber *SrcPixel, icUInt32Number nPixels)
+{
+  icUInt32Number k, nSrcSamples = m_pCmm->GetSourceSamples();
+  icStatusCMM rv;
+
+  for (k=0; k<nPixels; k++) {
+    rv = ApplyChain(NULL, &pDstIndex[k], SrcPixel, -1);
     if (rv) {
       return rv;
     }
 
-    pSrc = pDst;
-
-    for (j=0, i++; j<n-2 && i!=m_Xforms->end(); i++, j++) {
-
-      pApply = i->ptr;
-      pApplyXform = pApply->GetXform();
-      if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-        pXform = (CIccXformNamedColor*)pApplyXform;
-        switch(pXform->GetInterface()) {
-        case icApplyPixel2Pixel:
-          pXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pXform));
-          break;
+    SrcPixel += nSrcSamples;
+  }
 
+  return icCmmStatOk;
+}
 
-        case icApplyPixel2Named:
-          pXform->Apply(pApply, NamedColor, m_pPCS->Check(pSrc, pXform));
-          break;
 
-        case icApplyNamed2Pixel:
-          rv = pXform->Apply(pApply, pDst, NamedColor);
-          if (rv) {
-            return rv;
-          }
-          break;
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::ApplyFromIndex
+* 
+* Purpose: 
+*  Applies the Xforms in the list to an entry index of the first xform's
+*  named color tag.
+*  
+* Args:
+*  DstPixel = Destination pixel where the result is stored,
+*  nSrcIndex = Source index which is to be applied.
+**************************************************************************
+*/
+icStatusCMM CIccApplyNamedColorCmm::ApplyFromIndex(icFloatNumber *DstPixel, icInt32Number nSrcIndex)
+{
+  return ApplyChain(DstPixel, NULL, NULL, nSrcIndex);
+}
 
-        default:
-          break;
-        }
-      }
-      else {
-        pApplyXform->Apply(pApply, pDst, m_pPCS->Check(pSrc, pXform));
-      }
-      pSrc = pDst;
-    }
 
-    pApply = i->ptr;
-    pApplyXform = pApply->GetXform();
-    if (pApplyXform->GetXformType()==icXformTypeNamedColor) {
-      pXform = (CIccXformNamedColor*)pApplyXform;
-      switch(pXform->GetInterface()) {
-      case icApplyPixel2Named:
-        pXform->Apply(pApply, DstColorName, m_pPCS->Check(pSrc, pXform));
-        break;
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::ApplyFromIndex
+* 
+* Purpose: 
+*  Applies the Xforms in the list to an array of entry indexes of the
+*  first xform's named color tag.
+*  
+* Args:
+*  DstPixel = Destination pixels where the results are stored,
+*  pSrcIndex = Source indexes which are to be applied,
+*  nPixels = number of indexes to apply.
+**************************************************************************
+*/
+icStatusCMM CIccApplyNamedColorCmm::ApplyFromIndex(icFloatNumber *DstPixel, const icInt32Number *pSrcIndex, icUInt32Number nPixels)
+{
+  icUInt32Number k, nDstSamples = m_pCmm->GetDestSamples();
+  icStatusCMM rv;
 
-      case icApplyPixel2Pixel:
-      case icApplyNamed2Pixel:
-      default:
-        return icCmmStatIncorrectApply;
-        break;
-      }
-    }
-    else {
-      return icCmmStatIncorrectApply;
+  for (k=0; k<nPixels; k++) {
+    rv = ApplyChain(DstPixel, NULL, NULL, pSrcIndex[k]);
+    if (rv) {
+      return rv;
     }
 
-  }
-  else if (n==1) {
-    return icCmmStatIncorrectApply;
+    DstPixel += nDstSamples;
   }
 
   return icCmmStatOk;
 }
 
+
+/**
+**************************************************************************
+* Name: CIccApplyNamedColorCmm::ApplyIndex
+* 
+* Purpose: 
+*  Applies the Xforms in the list to an entry index of the first xform's
+*  named color tag giving an entry index of the last xform's named color tag.
+*  
+* Args:
+*  nDstIndex = Destination index where the result is stored,
+*  nSrcIndex = Source index which is to be applied.
+**************************************************************************
+*/
+icStatusCMM CIccApplyNamedColorCmm::ApplyIndex(icInt32Number &nDstIndex, icInt32Number nSrcIndex)
+{
+  return ApplyChain(NULL, &nDstIndex, NULL, nSrcIndex);
+}
+
 /**
  **************************************************************************
  * Name: CIccNamedColorCmm::CIccNamedColorCmm
@@ -5504,7 +7725,17 @@ icStatusCMM CIccNamedColorCmm::AddXform(const icChar *szProfilePath,
                                         bool bUseMpeTags /*=true*/,
                                         CIccCreateXformHintManager *pHintManager /*=NULL*/)
 {
-  CIccProfile *pProfile = OpenIccProfile(szProfilePath);
+  CIccSetupScope setupScope(m_pSetupListener);
+  CIccProfile *pProfile;
+
+  {
+    CIccSetupTimer setupTimer(icSetupProfileOpen, (icInt32Number)GetNumXforms());
+
+    pProfile = OpenIccProfile(szProfilePath);
+
+    if (pProfile)
+      setupTimer.SetBytes(pProfile->m_Header.size);
+  }
 
   if (!pProfile) 
     return icCmmStatCantOpenProfile;
@@ -5542,6 +7773,7 @@ icStatusCMM CIccNamedColorCmm::AddXform(CIccProfile *pProfile,
                                         bool bUseMpeTags /*=true*/,
                                         CIccCreateXformHintManager *pHintManager /*=NULL*/)
 {
+  CIccSetupScope setupScope(m_pSetupListener);
   icColorSpaceSignature nSrcSpace, nDstSpace;
   CIccXformPtr Xform;
   bool bInput = !m_bLastInput;
@@ -5696,6 +7928,9 @@ icStatusCMM CIccNamedColorCmm::AddXform(CIccProfile *pProfile,
  */
  icStatusCMM CIccNamedColorCmm::Begin(bool bAllocNewApply/* =true */)
 {
+  CIccSetupScope setupScope(m_pSetupListener);
+  CIccSetupTimer setupTimer(icSetupCmmBegin);
+
   if (m_nDestSpace==icSigUnknownData) {
     m_nDestSpace = m_nLastSpace;
   }
@@ -5722,8 +7957,11 @@ icStatusCMM CIccNamedColorCmm::AddXform(CIccProfile *pProfile,
 
   icStatusCMM rv;
   CIccXformList::iterator i;
+  icInt32Number n;
+
+  for (n=0, i=m_Xforms->begin(); i!=m_Xforms->end(); i++, n++) {
+    CIccSetupTimer xformTimer(icSetupXformBegin, n);
 
-  for (i=m_Xforms->begin(); i!=m_Xforms->end(); i++) {
     rv = i->ptr->Begin();
 
     if (rv!= icCmmStatOk) {
@@ -5731,8 +7969,30 @@ icStatusCMM CIccNamedColorCmm::AddXform(CIccProfile *pProfile,
     }
   }
 
+  icCombinePCSAdjustments(m_Xforms);
+
+  //Let named color results pass between adjacent named color xforms as indexes
+  CIccXform *pPrev = NULL;
+  for (i=m_Xforms->begin(); i!=m_Xforms->end(); i++) {
+    if (i->ptr->GetXformType()==icXformTypeNamedColor) {
+      CIccXformNamedColor *pXform = (CIccXformNamedColor*)i->ptr;
+
+      if (pXform->GetInterface()==icApplyNamed2Pixel && pPrev &&
+          pPrev->GetXformType()==icXformTypeNamedColor &&
+          ((CIccXformNamedColor*)pPrev)->GetInterface()==icApplyPixel2Named) {
+        if (!pXform->LinkSrcIndex((CIccXformNamedColor*)pPrev))
+          return icCmmStatAllocErr;
+      }
+      else
+        pXform->LinkSrcIndex(NULL);
+    }
+    pPrev = i->ptr;
+  }
+
   if (bAllocNewApply) {
-    m_pApply = GetNewApplyCmm(rv);
+    CIccSetupTimer applyTimer(icSetupApply);
+
+    m_pApply = GetNewApply(rv);
   }
   else
     rv = icCmmStatOk;
@@ -5826,6 +8086,101 @@ icStatusCMM CIccNamedColorCmm::Apply(icChar* DstColorName, const icChar *SrcColo
 }
 
 
+/**
+**************************************************************************
+* Name: CIccNamedColorCmm::ApplyToIndex
+* 
+* Purpose: 
+*  Index based apply functions using the CMM's own apply object.
+*  See CIccApplyNamedColorCmm::ApplyToIndex() and ApplyFromIndex().
+**************************************************************************
+*/
+icStatusCMM CIccNamedColorCmm::ApplyToIndex(icInt32Number &nDstIndex, const icFloatNumber *SrcPixel)
+{
+  return ((CIccApplyNamedColorCmm*)m_pApply)->ApplyToIndex(nDstIndex, SrcPixel);
+}
+
+icStatusCMM CIccNamedColorCmm::ApplyToIndex(icInt32Number *pDstIndex, const icFloatNumber *SrcPixel, icUInt32Number nPixels)
+{
+  return ((CIccApplyNamedColorCmm*)m_pApply)->ApplyToIndex(pDstIndex, SrcPixel, nPixels);
+}
+
+icStatusCMM CIccNamedColorCmm::ApplyFromIndex(icFloatNumber *DstPixel, icInt32Number nSrcIndex)
+{
+  return ((CIccApplyNamedColorCmm*)m_pApply)->ApplyFromIndex(DstPixel, nSrcIndex);
+}
+
+icStatusCMM CIccNamedColorCmm::ApplyFromIndex(icFloatNumber *DstPixel, const icInt32Number *pSrcIndex, icUInt32Number nPixels)
+{
+  return ((CIccApplyNamedColorCmm*)m_pApply)->ApplyFromIndex(DstPixel, pSrcIndex, nPixels);
+}
+
+icStatusCMM CIccNamedColorCmm::ApplyIndex(icInt32Number &nDstIndex, icInt32Number nSrcIndex)
+{
+  return ((CIccApplyNamedColorCmm*)m_pApply)->ApplyIndex(nDstIndex, nSrcIndex);
+}
+
+
+/**
+**************************************************************************
+* Name: CIccNamedColorCmm::FindSrcColor
+* 
+* Purpose: 
+*  Finds a color name in the named color tag of the first xform.
+*  
+* Args:
+*  SrcColorName = Source color name which is to be searched.
+*
+* Return:
+*  Source index to pass to ApplyFromIndex(), or -1 if not found.
+**************************************************************************
+*/
+icInt32Number CIccNamedColorCmm::FindSrcColor(const icChar *SrcColorName) const
+{
+  if (!m_Xforms->size())
+    return -1;
+
+  const CIccXform *pXform = m_Xforms->front().ptr;
+  if (pXform->GetXformType()!=icXformTypeNamedColor)
+    return -1;
+
+  const CIccTagNamedColor2 *pTag = ((const CIccXformNamedColor*)pXform)->GetTag();
+  if (!pTag)
+    return -1;
+
+  return pTag->FindColor(SrcColorName);
+}
+
+
+/**
+**************************************************************************
+* Name: CIccNamedColorCmm::GetDstColorName
+* 
+* Purpose: 
+*  Formats a color name from the named color tag of the last xform.
+*  
+* Args:
+*  DstColorName = Destination string (at least 96 characters) where the result is stored, 
+*  nDstIndex = Destination index returned by ApplyToIndex().
+**************************************************************************
+*/
+bool CIccNamedColorCmm::GetDstColorName(icChar *DstColorName, icInt32Number nDstIndex) const
+{
+  if (!m_Xforms->size())
+    return false;
+
+  const CIccXform *pXform = m_Xforms->back().ptr;
+  if (pXform->GetXformType()!=icXformTypeNamedColor)
+    return false;
+
+  const CIccTagNamedColor2 *pTag = ((const CIccXformNamedColor*)pXform)->GetTag();
+  if (!pTag)
+    return false;
+
+  return pTag->GetColorName(DstColorName, nDstIndex);
+}
+
+
 /**
  **************************************************************************
  * Name: CIccNamedColorCmm::SetLastXformDest
@@ -6101,12 +8456,14 @@ icStatusCMM CIccApplyMruCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber
 */
 icStatusCMM CIccApplyMruCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel, icUInt32Number nPixels)
 {
-  CIccMruPixel *ptr, *prev=NULL, *last=NULL;
+  CIccMruPixel *ptr, *prev, *last;
   int i;
   icFloatNumber *pixel, *dest;
   icUInt32Number k;
+  icUInt16Number nDstSamples = m_pCmm->GetDestSamples();
 
   for (k=0; k<nPixels;) {
+    prev = last = NULL;
     for (ptr = m_pFirst, i=0; ptr; ptr=ptr->pNext, i++) {
       if (!memcmp(SrcPixel, ptr->pPixelData, m_nSrcSize)) {
         memcpy(DstPixel, &ptr->pPixelData[m_nSrcSamples], m_nDstSize);
@@ -6148,11 +8505,44 @@ icStatusCMM CIccApplyMruCmm::Apply(icFloatNumber *DstPixel, const icFloatNumber
 
 next_k:
     k++;
+    SrcPixel += m_nSrcSamples;
+    DstPixel += nDstSamples;
   }
 
   return icCmmStatOk;
 }
 
+/**
+****************************************************************************
+* Name: CIccApplyMruCmm::ResetPerf
+* 
+* Purpose: Resets the performance counters of the cached CMM
+*****************************************************************************
+*/
+void CIccApplyMruCmm::ResetPerf()
+{
+  CIccApplyCmm::ResetPerf();
+
+  if (m_pCachedCmm && m_pCachedCmm->GetApply())
+    m_pCachedCmm->GetApply()->ResetPerf();
+}
+
+/**
+****************************************************************************
+* Name: CIccApplyMruCmm::GetPerfReport
+* 
+* Purpose: Appends the performance counters of the cached CMM to sReport.
+*  Only pixels missing from the cache are applied by the cached CMM.
+*****************************************************************************
+*/
+void CIccApplyMruCmm::GetPerfReport(std::string &sReport)
+{
+  if (m_pCachedCmm && m_pCachedCmm->GetApply())
+    m_pCachedCmm->GetApply()->GetPerfReport(sReport);
+  else
+    CIccApplyCmm::GetPerfReport(sReport);
+}
+
 #ifdef USESAMPLEICCNAMESPACE
 } //namespace sampleICC
 #endif
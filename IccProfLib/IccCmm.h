@@ -67,6 +67,14 @@
 // -Initial implementation by Max Derhak 5-15-2003
 // -Added support for Monochrome ICC profile apply by Rohit Patil 12-03-2008
 // -Integrate changes for PCS adjustment by George Pawle 12-09-2008
+// -Added CIccColorEncoding and batch encoding conversions 10-19-2026
+// -Fold PCS adjustments into matrix/TRC xforms and adjacent xforms 10-19-2026
+// -Added array versions of CIccPCS::LabToXyz and XyzToLab 10-19-2026
+// -Added index based named color apply interfaces 10-19-2026
+// -Added apply chain performance counters 10-19-2026
+// -Added setup phase timing events 10-19-2026
+// -Added SaveCompiled/LoadCompiled compiled transform blobs 10-19-2026
+// -Added CIccCmm::GetXform 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -76,6 +84,7 @@
 #include "IccProfile.h"
 #include "IccTag.h"
 #include "IccUtil.h"
+#include "IccPerf.h"
 #include <list>
 #include <cstring>
 #include <cstdlib>
@@ -99,6 +108,7 @@ typedef enum {
   icCmmStatBadColorEncoding   = 9,
   icCmmStatAllocErr           = 10,
   icCmmStatBadLutType         = 11,
+  icCmmStatBadCompiledData    = 12,
 } icStatusCMM;
 
 /// CMM Interpolation types
@@ -250,6 +260,7 @@ class CIccApplyXform;
  */
 class ICCPROFLIB_API CIccXform
 {
+  friend class CIccXformMpe;
 public:
   CIccXform();
   virtual ~CIccXform();
@@ -305,6 +316,21 @@ public:
 	/// Returns the rendering intent being used by the Xform
 	icRenderingIntent GetIntent() const { return m_nIntent; }
 
+  /// Returns the interpolation, lut type and MPE tag selection the Xform was created with
+  icXformInterp GetInterp() const { return m_nInterp; }
+  icXformLutType GetLutType() const { return m_nLutType; }
+  bool GetUseMpeTags() const { return m_bUseMpeTags; }
+  /// Returns true if the Xform was created with a PCS adjustment hint (such as black point compensation)
+  bool HasAdjustPCSHint() const { return m_bAdjustPCSHint; }
+
+  ///Writes state computed by Begin() that is costly to rebuild (see CIccCmm::SaveCompiled).  Call after Begin().
+  virtual bool SaveCompiled(CIccIO *pIO);
+  ///Restores state written by SaveCompiled() so that Begin() uses it rather than recomputing it.  Call before Begin().
+  virtual bool LoadCompiled(CIccIO *pIO);
+
+  ///Merges the PCS adjustment done after pPrev with the one done before this xform (called after Begin)
+  bool CombinePCSAdjust(CIccXform *pPrev);
+
 protected:
   //Called by derived classes to initialize Base
 
@@ -314,17 +340,31 @@ protected:
 
   virtual bool HasPerceptualHandling() { return true; }
 
+  icStatusCMM CalcPCSAdjust();
+
   CIccProfile *m_pProfile;
   bool m_bInput;
   icRenderingIntent m_nIntent;
   icXYZNumber m_MediaXYZ;
   icXformInterp m_nInterp;
+  icXformLutType m_nLutType;
+  bool m_bUseMpeTags;
+  bool m_bAdjustPCSHint;
 
 	// track PCS adjustments
 	IIccAdjustPCSXform* m_pAdjustPCS;
 	bool m_bAdjustPCS;
 	icFloatNumber m_PCSScale[3]; // scale and offset for PCS adjustment in XYZ
 	icFloatNumber m_PCSOffset[3];
+
+	// PCS adjustment done by CheckSrcAbs/CheckDstAbs (set by Begin, cleared or
+	// combined when the adjustment is folded into a neighbouring stage)
+	bool m_bApplyAdjustPCS;
+	icFloatNumber m_ApplyPCSScale[3];
+	icFloatNumber m_ApplyPCSOffset[3];
+
+  // PCS adjustment was restored by LoadCompiled() (Begin doesn't recompute it)
+  bool m_bCompiledPCS;
 };
 
 /**
@@ -368,12 +408,17 @@ public:
 
   const CIccXform *GetXform() { return m_pXform; }
 
+  ///Time spent in Apply (only updated when built with ICC_PERF_COUNTERS)
+  CIccPerfCounter &GetPerf() { return m_perf; }
+
 protected:
   icFloatNumber m_AbsLab[3];
 
   CIccApplyXform(CIccXform *pXform);
 
   const CIccXform *m_pXform;
+
+  CIccPerfCounter m_perf;
 };
 
 /**
@@ -420,6 +465,9 @@ public:
 	virtual LPIccCurve* ExtractInputCurves();
 	virtual LPIccCurve* ExtractOutputCurves();
 
+	virtual bool SaveCompiled(CIccIO *pIO);
+	virtual bool LoadCompiled(CIccIO *pIO);
+
 protected:
 
   virtual bool HasPerceptualHandling() { return false; }
@@ -429,6 +477,7 @@ protected:
 	CIccCurve *GetInvCurve(icSignature sig) const;
 
 	bool m_bFreeCurve;
+	bool m_bCompiledCurve; ///inverse curve restored by LoadCompiled()
 	/// used only when applying the xform
 	LPIccCurve m_ApplyCurvePtr;
 };
@@ -455,17 +504,23 @@ public:
   virtual LPIccCurve* ExtractInputCurves();
   virtual LPIccCurve* ExtractOutputCurves();
 
+  virtual bool SaveCompiled(CIccIO *pIO);
+  virtual bool LoadCompiled(CIccIO *pIO);
+
 protected:
 
   virtual bool HasPerceptualHandling() { return false; }
 
   icFloatNumber m_e[9];
+  icFloatNumber m_offset[3]; ///folded PCS offset (in PCS units for input, linear units for output)
+  bool m_bOffset;
   CIccCurve *m_Curve[3];
   CIccCurve *GetCurve(icSignature sig) const;
   CIccCurve *GetInvCurve(icSignature sig) const;
 
   CIccTagXYZ *GetColumn(icSignature sig) const;
   bool m_bFreeCurve;
+  bool m_bCompiledCurve; ///inverse curves restored by LoadCompiled()
   /// used only when applying the xform
   const LPIccCurve* m_ApplyCurvePtr;
 };
@@ -557,6 +612,7 @@ public:
   virtual icXformType GetXformType() const { return icXformTypeNDLut; }
 
   virtual icStatusCMM Begin();
+  virtual CIccApplyXform *GetNewApply(icStatusCMM &status);
   virtual void Apply(CIccApplyXform *pApplyXform, icFloatNumber *DstPixel, const icFloatNumber *SrcPixel) const;
 
   virtual bool UseLegacyPCS() const { return m_pTag->UseLegacyPCS(); }
@@ -574,6 +630,28 @@ protected:
   const CIccMatrix* m_ApplyMatrixPtr;
 };
 
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: The Apply ND-LUT Xform object.  Holds the CLUT node weights
+*  used by InterpND when there are too many nodes to weight on the stack.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccApplyNDLutXform : public CIccApplyXform
+{
+  friend class CIccXformNDLut;
+public:
+  virtual ~CIccApplyNDLutXform();
+  virtual icXformType GetXformType() const { return icXformTypeNDLut; }
+
+  icFloatNumber *GetNodeWeights() const { return m_pNodeWeights; }
+
+protected:
+  CIccApplyNDLutXform(CIccXformNDLut *pXform);
+
+  icFloatNumber *m_pNodeWeights;
+};
 
 
 /**
@@ -620,6 +698,18 @@ public:
   icStatusCMM Apply(CIccApplyXform *pApplyXform, icChar *DstColorName, const icFloatNumber *SrcPixel) const;
   icStatusCMM Apply(CIccApplyXform *pApplyXform, icFloatNumber *DstPixel, const icChar *SrcColorName) const;
 
+  ///Index based versions of the named Apply functions.  Indexes are entries of the named color tag.
+  icStatusCMM ApplyToIndex(CIccApplyXform *pApplyXform, icInt32Number &nDstIndex, const icFloatNumber *SrcPixel) const;
+  icStatusCMM ApplyFromIndex(CIccApplyXform *pApplyXform, icFloatNumber *DstPixel, icInt32Number nSrcIndex) const;
+
+  ///Builds the map from entries of pPrev's named color tag to entries of this one (by color name)
+  bool LinkSrcIndex(const CIccXformNamedColor *pPrev);
+  ///Maps an entry index of the linked previous named color tag to an entry index of this one
+  icInt32Number MapSrcIndex(icInt32Number nIndex) const
+  { return (nIndex>=0 && (icUInt32Number)nIndex<m_nSrcIndexMap) ? m_pSrcIndexMap[nIndex] : -1; }
+
+  const CIccTagNamedColor2 *GetTag() const { return m_pTag; }
+
   virtual bool UseLegacyPCS() const { return m_pTag->UseLegacyPCS(); }
 
   icStatusCMM SetSrcSpace(icColorSpaceSignature nSrcSpace);
@@ -647,6 +737,9 @@ protected:
   icApplyInterface m_nApplyInterface;
   icColorSpaceSignature m_nSrcSpace;
   icColorSpaceSignature m_nDestSpace;
+
+  icInt32Number *m_pSrcIndexMap;
+  icUInt32Number m_nSrcIndexMap;
 };
 
 
@@ -700,6 +793,8 @@ public:
   virtual ~CIccApplyXformMpe();
   virtual icXformType GetXformType() const { return icXformTypeMpe; }
 
+  CIccApplyTagMpe *GetApplyTag() const { return m_pApply; }
+
 protected:
   CIccApplyXformMpe(CIccXformMpe *pXform);
 
@@ -727,6 +822,12 @@ public:
   virtual const icFloatNumber *Check(const icFloatNumber *SrcPixel, const CIccXform *pXform);
   void CheckLast(icFloatNumber *SrcPixel, icColorSpaceSignature Space, bool bNoClip=false);
 
+  ///Array versions of Check and CheckLast used by batch applies.  Derived classes that
+  ///override Check() should also override the array version.
+  virtual const icFloatNumber *Check(icFloatNumber *pConvert, const icFloatNumber *SrcPixels,
+                                     const CIccXform *pXform, icUInt32Number nPixels);
+  void CheckLast(icFloatNumber *Pixels, icColorSpaceSignature Space, icUInt32Number nPixels, bool bNoClip);
+
   static void LabToXyz(icFloatNumber *Dst, const icFloatNumber *Src, bool bNoClip=false);
   static void XyzToLab(icFloatNumber *Dst, const icFloatNumber *Src, bool bNoClip=false);
   static void Lab2ToXyz(icFloatNumber *Dst, const icFloatNumber *Src, bool bNoClip=false);
@@ -736,6 +837,12 @@ public:
 
   static void Lab2ToLab4(icFloatNumber *Dst, const icFloatNumber *Src, bool bNoclip=false);
   static void Lab4ToLab2(icFloatNumber *Dst, const icFloatNumber *Src);
+
+  ///Array versions of LabToXyz, XyzToLab, Lab2ToLab4 and Lab4ToLab2 that convert nPixels packed pixels
+  static void LabToXyz(icFloatNumber *Dst, const icFloatNumber *Src, icUInt32Number nPixels, bool bNoClip);
+  static void XyzToLab(icFloatNumber *Dst, const icFloatNumber *Src, icUInt32Number nPixels, bool bNoClip);
+  static void Lab2ToLab4(icFloatNumber *Dst, const icFloatNumber *Src, icUInt32Number nPixels, bool bNoclip);
+  static void Lab4ToLab2(icFloatNumber *Dst, const icFloatNumber *Src, icUInt32Number nPixels);
 protected:
 
   bool m_bIsV2Lab;
@@ -794,6 +901,64 @@ typedef enum
   icEncodeUnknown,
 } icFloatColorEncoding;
 
+/**
+ **************************************************************************
+ * Type: Class
+ * 
+ * Purpose: Converts arrays of pixels between an icFloatColorEncoding and
+ *  the internal encoding of the CMM.  Begin() resolves the color space
+ *  and encoding combination once so that Apply() converts all pixels
+ *  with a single specialized loop.  Results are identical to calling
+ *  CIccCmm::ToInternalEncoding() or FromInternalEncoding() per pixel.
+ *
+ *  The 8 and 16 bit integer Apply() functions require the object to have
+ *  been started with icEncode8Bit or icEncode16Bit respectively.  Eight
+ *  bit data is converted to internal encoding with lookup tables built
+ *  by Begin().
+ *
+ *  Strides are the number of values from the start of one pixel to the
+ *  start of the next (0 = number of samples in the color space).
+ **************************************************************************
+ */
+class ICCPROFLIB_API CIccColorEncoding
+{
+public:
+  CIccColorEncoding();
+  virtual ~CIccColorEncoding();
+
+  icStatusCMM Begin(icColorSpaceSignature nSpace, icFloatColorEncoding nEncode, bool bToInternal, bool bClip=true);
+
+  icColorSpaceSignature GetSpace() const { return m_nSpace; }
+  icFloatColorEncoding GetEncoding() const { return m_nEncode; }
+  icUInt32Number GetNumSamples() const { return m_nSamples; }
+  bool IsToInternal() const { return m_bToInternal; }
+
+  icStatusCMM Apply(icFloatNumber *pDst, const icFloatNumber *pSrc, icUInt32Number nPixels=1,
+                    icUInt32Number nDstStride=0, icUInt32Number nSrcStride=0) const;
+
+  icStatusCMM Apply(icFloatNumber *pInternal, const icUInt8Number *pData, icUInt32Number nPixels=1,
+                    icUInt32Number nInternalStride=0, icUInt32Number nDataStride=0) const;
+  icStatusCMM Apply(icFloatNumber *pInternal, const icUInt16Number *pData, icUInt32Number nPixels=1,
+                    icUInt32Number nInternalStride=0, icUInt32Number nDataStride=0) const;
+  icStatusCMM Apply(icUInt8Number *pData, const icFloatNumber *pInternal, icUInt32Number nPixels=1,
+                    icUInt32Number nDataStride=0, icUInt32Number nInternalStride=0) const;
+  icStatusCMM Apply(icUInt16Number *pData, const icFloatNumber *pInternal, icUInt32Number nPixels=1,
+                    icUInt32Number nDataStride=0, icUInt32Number nInternalStride=0) const;
+
+protected:
+  icColorSpaceSignature m_nSpace;
+  icFloatColorEncoding m_nEncode;
+  icUInt32Number m_nSamples;
+  bool m_bToInternal;
+  bool m_bClip;
+
+  ///Resolved conversion (see IccCmm.cpp)
+  int m_nKernel;
+
+  ///m_nSamples tables of 256 entries for 8 bit data to internal encoding
+  icFloatNumber *m_pLut8;
+};
+
 //Forward Reference of CIccCmm for CIccCmmApply
 class CIccCmm;
 
@@ -822,6 +987,13 @@ public:
 
   CIccCmm *GetCmm() { return m_pCmm; }
 
+  ///Performance counters of the apply chain.  These are only updated when IccProfLib
+  ///is built with ICC_PERF_COUNTERS defined (see IccPerf.h and icPerfCountersEnabled()).
+  CIccApplyXformList *GetXforms() { return m_Xforms; }
+  const CIccPerfCounter &GetPCSPerf() const { return m_PCSPerf; }
+  virtual void ResetPerf();
+  virtual void GetPerfReport(std::string &sReport);
+
 protected:
   CIccApplyCmm(CIccCmm *pCmm);
 
@@ -829,6 +1001,9 @@ protected:
   CIccCmm *m_pCmm;
 
   CIccPCS *m_pPCS;
+
+  ///Time spent adjusting the PCS between xforms in CIccPCS::Check()
+  CIccPerfCounter m_PCSPerf;
 };
 
 /**
@@ -883,6 +1058,8 @@ public:
 
   ///Returns the number of profiles/transforms added 
   virtual icUInt32Number GetNumXforms() const;
+  ///Returns the nIndex'th transform added (NULL if there isn't one)
+  virtual const CIccXform *GetXform(icUInt32Number nIndex) const;
 
   ///Returns the source color space
   icColorSpaceSignature GetSourceSpace() const { return m_nSrcSpace; }
@@ -901,6 +1078,11 @@ public:
   ///Checks if this is a valid CMM object
   bool Valid() const { return m_bValid; }
 
+  ///Sets a listener that receives timing events for the setup phases of AddXform() and Begin() (see IccPerf.h).
+  ///The listener is not owned by the CMM.
+  void SetSetupListener(IIccSetupListener *pListener) { m_pSetupListener = pListener; }
+  IIccSetupListener *GetSetupListener() const { return m_pSetupListener; }
+
   //Function to convert check if Internal representation of 'gamt' color is in gamut.
   static bool IsInGamut(icFloatNumber *pData);
 
@@ -914,6 +1096,17 @@ public:
   icStatusCMM ToInternalEncoding(icFloatNumber *pInternal, const icUInt8Number *pData) {return ToInternalEncoding(m_nSrcSpace, pInternal, pData);}
   icStatusCMM ToInternalEncoding(icFloatNumber *pInternal, const icUInt16Number *pData) {return ToInternalEncoding(m_nSrcSpace, pInternal, pData);}
 
+  ///Batch versions that convert nPixels pixels (strides of 0 are the number of samples, see CIccColorEncoding)
+  static icStatusCMM ToInternalEncoding(icColorSpaceSignature nSpace, icFloatColorEncoding nEncode, 
+                                        icFloatNumber *pInternal, const icFloatNumber *pData, icUInt32Number nPixels,
+                                        icUInt32Number nInternalStride, icUInt32Number nDataStride, bool bClip=true);
+  static icStatusCMM ToInternalEncoding(icColorSpaceSignature nSpace, icFloatNumber *pInternal, 
+                                        const icUInt8Number *pData, icUInt32Number nPixels,
+                                        icUInt32Number nInternalStride=0, icUInt32Number nDataStride=0);
+  static icStatusCMM ToInternalEncoding(icColorSpaceSignature nSpace, icFloatNumber *pInternal, 
+                                        const icUInt16Number *pData, icUInt32Number nPixels,
+                                        icUInt32Number nInternalStride=0, icUInt32Number nDataStride=0);
+
   
   ///Functions for converting from Internal representation of pixel colors
   static icStatusCMM FromInternalEncoding(icColorSpaceSignature nSpace, icFloatColorEncoding nEncode, 
@@ -925,16 +1118,51 @@ public:
   icStatusCMM FromInternalEncoding(icUInt8Number *pData, icFloatNumber *pInternal) {return FromInternalEncoding(m_nDestSpace, pData, pInternal);}
   icStatusCMM FromInternalEncoding(icUInt16Number *pData, icFloatNumber *pInternal) {return FromInternalEncoding(m_nDestSpace, pData, pInternal);}
 
+  ///Batch versions that convert nPixels pixels (strides of 0 are the number of samples, see CIccColorEncoding)
+  static icStatusCMM FromInternalEncoding(icColorSpaceSignature nSpace, icFloatColorEncoding nEncode, 
+                                          icFloatNumber *pData, const icFloatNumber *pInternal, icUInt32Number nPixels,
+                                          icUInt32Number nDataStride, icUInt32Number nInternalStride, bool bClip=true);
+  static icStatusCMM FromInternalEncoding(icColorSpaceSignature nSpace, icUInt8Number *pData, 
+                                          const icFloatNumber *pInternal, icUInt32Number nPixels,
+                                          icUInt32Number nDataStride=0, icUInt32Number nInternalStride=0);
+  static icStatusCMM FromInternalEncoding(icColorSpaceSignature nSpace, icUInt16Number *pData, 
+                                          const icFloatNumber *pInternal, icUInt32Number nPixels,
+                                          icUInt32Number nDataStride=0, icUInt32Number nInternalStride=0);
+
   static const icChar *GetFloatColorEncoding(icFloatColorEncoding val);
   static icFloatColorEncoding GetFloatColorEncoding(const icChar* val);
 
   virtual icColorSpaceSignature GetFirstXformSource();
   virtual icColorSpaceSignature GetLastXformDest();
 
+  ///Writes the ready to run transform to a versioned, big endian blob that LoadCompiled() can use
+  ///to skip rebuilding transform state (inverse curves, black point and PCS adjustments) from
+  ///profiles.  The profiles are embedded in the blob.  Must be called after Begin().
+  icStatusCMM SaveCompiled(CIccIO *pIO);
+  icStatusCMM SaveCompiled(const icChar *szFilename);
+
+  ///Sets up a CMM that has no xforms from a blob written by SaveCompiled() and calls Begin().
+  ///icCmmStatBadCompiledData is returned if the blob is damaged, was written by another library
+  ///version, or (when pKey is not NULL) was compiled from different profiles or parameters.
+  icStatusCMM LoadCompiled(CIccIO *pIO, const icProfileID *pKey=NULL);
+  icStatusCMM LoadCompiled(const icChar *szFilename, const icProfileID *pKey=NULL);
+  ///Profiles are used in place, so pData (which may be memory mapped) must be available for the life of the CMM
+  icStatusCMM LoadCompiled(const icUInt8Number *pData, icUInt32Number nSize, const icProfileID *pKey=NULL);
+
+  ///Gets the key that identifies the added xforms in a compiled blob.  The key is an MD5 of the
+  ///color spaces and of each xform's profile ID (or the MD5 of the profile when it has no ID),
+  ///direction, intent, interpolation, lut type, MPE selection and PCS adjustment hint.
+  bool GetCompiledKey(icProfileID &key);
+
 protected:
 
   CIccApplyCmm *m_pApply;
 
+  ///Blob read by LoadCompiled(CIccIO*) that the profiles of the xforms are attached to
+  icUInt8Number *m_pCompiledData;
+
+  IIccSetupListener *m_pSetupListener;
+
   bool m_bValid;
 
   bool m_bLastInput;
@@ -975,8 +1203,20 @@ public:
   virtual icStatusCMM Apply(icFloatNumber *DstPixel, const icChar *SrcColorName);
   virtual icStatusCMM Apply(icChar* DstColorName, const icChar *SrcColorName);
 
+  ///Index based apply interfaces.  A destination index is an entry of the last xform's named color tag
+  ///and a source index is an entry of the first xform's named color tag.  Nothing is allocated or
+  ///formatted, use CIccNamedColorCmm::GetDstColorName() and FindSrcColor() to convert at the edges.
+  virtual icStatusCMM ApplyToIndex(icInt32Number &nDstIndex, const icFloatNumber *SrcPixel);
+  virtual icStatusCMM ApplyToIndex(icInt32Number *pDstIndex, const icFloatNumber *SrcPixel, icUInt32Number nPixels);
+  virtual icStatusCMM ApplyFromIndex(icFloatNumber *DstPixel, icInt32Number nSrcIndex);
+  virtual icStatusCMM ApplyFromIndex(icFloatNumber *DstPixel, const icInt32Number *pSrcIndex, icUInt32Number nPixels);
+  virtual icStatusCMM ApplyIndex(icInt32Number &nDstIndex, icInt32Number nSrcIndex);
+
 protected:
   CIccApplyNamedColorCmm(CIccNamedColorCmm *pCmm);
+
+  icStatusCMM ApplyChain(icFloatNumber *DstPixel, icInt32Number *pDstIndex,
+                         const icFloatNumber *SrcPixel, icInt32Number nSrcIndex);
 };
 
 /**
@@ -1019,6 +1259,18 @@ public:
   virtual icStatusCMM Apply(icChar* DstColorName, const icFloatNumber *SrcPixel);
   virtual icStatusCMM Apply(icChar* DstColorName, const icChar *SrcColorName);
 
+  //Index based apply functions (see CIccApplyNamedColorCmm) should only be called if using Begin(true);
+  icStatusCMM ApplyToIndex(icInt32Number &nDstIndex, const icFloatNumber *SrcPixel);
+  icStatusCMM ApplyToIndex(icInt32Number *pDstIndex, const icFloatNumber *SrcPixel, icUInt32Number nPixels);
+  icStatusCMM ApplyFromIndex(icFloatNumber *DstPixel, icInt32Number nSrcIndex);
+  icStatusCMM ApplyFromIndex(icFloatNumber *DstPixel, const icInt32Number *pSrcIndex, icUInt32Number nPixels);
+  icStatusCMM ApplyIndex(icInt32Number &nDstIndex, icInt32Number nSrcIndex);
+
+  ///Returns the index of a source color name for ApplyFromIndex(), or -1 if not found
+  icInt32Number FindSrcColor(const icChar *SrcColorName) const;
+  ///Formats the name of a destination index from ApplyToIndex() into DstColorName
+  bool GetDstColorName(icChar *DstColorName, icInt32Number nDstIndex) const;
+
   ///Returns the type of interface that will be applied
   icApplyInterface GetInterface() const {return m_nApplyInterface;}
 
@@ -1061,6 +1313,10 @@ public:
   //Make sure that when DstPixel==SrcPixel the sizeof DstPixel is greater than size of SrcPixel
   virtual icStatusCMM Apply(icFloatNumber *DstPixel, const icFloatNumber *SrcPixel, icUInt32Number nPixels);
 
+  ///Reports the counters of the cached CMM's apply chain
+  virtual void ResetPerf();
+  virtual void GetPerfReport(std::string &sReport);
+
 protected:
   CIccApplyMruCmm(CIccMruCmm *pCmm);
 
@@ -1124,6 +1380,7 @@ public:
   virtual icStatusCMM RemoveAllIO() { return m_pCmm->RemoveAllIO(); }
   virtual CIccPCS *GetPCS() { return m_pCmm->GetPCS(); }
   virtual icUInt32Number GetNumXforms() const { return m_pCmm->GetNumXforms(); }
+  virtual const CIccXform *GetXform(icUInt32Number nIndex) const { return m_pCmm->GetXform(nIndex); }
 
   virtual icColorSpaceSignature GetFirstXformSource() { return m_pCmm->GetFirstXformSource(); }
   virtual icColorSpaceSignature GetLastXformDest() { return m_pCmm->GetLastXformDest(); }
@@ -0,0 +1,849 @@
+/** @file
+    File:       IccDeviceLink.cpp
+
+    Contains:   Implementation of exporting a CMM as a device link profile
+
+    Version:    V1
+
+    Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation of CIccDeviceLink 10-19-2026
+// -Added PCS inputs to CIccDeviceLink::CreateMpeTag 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifdef WIN32
+#pragma warning( disable: 4786) //disable warning in <list.h>
+#endif
+
+#include <math.h>
+#include <string.h>
+#include "IccDeviceLink.h"
+#include "IccTagLut.h"
+#include "IccTagMPE.h"
+#include "IccMpeBasic.h"
+#include "IccTagProfSeqId.h"
+#include "IccIO.h"
+#include "IccUtil.h"
+
+#ifdef USESAMPLEICCNAMESPACE
+namespace sampleICC {
+#endif
+
+//Part of a fitted shaper that follows the output of the chain (the rest is the identity curve)
+#define icDevLinkShaperWeight   ((icFloatNumber)0.5)
+
+//Largest number of CLUT grid points that a link will be sampled at
+#define icDevLinkMaxGridNodes   0x1000000
+
+/**
+**************************************************************************
+* Name: icDevLinkInvShaper
+* 
+* Purpose: 
+*  Finds the input that a piecewise linear shaper curve (increasing from
+*  0.0 to 1.0) maps to u.
+**************************************************************************
+*/
+static icFloatNumber icDevLinkInvShaper(const icFloatNumber *pShaper, icUInt32Number nSize, icFloatNumber u)
+{
+  icUInt32Number lo=0, hi=nSize-1;
+
+  if (u<=pShaper[0])
+    return 0.0;
+  if (u>=pShaper[hi])
+    return 1.0;
+
+  while (hi-lo>1) {
+    icUInt32Number mid = (lo+hi)/2;
+
+    if (pShaper[mid]<=u)
+      lo = mid;
+    else
+      hi = mid;
+  }
+
+  icFloatNumber d = pShaper[hi] - pShaper[lo];
+  icFloatNumber f = d>0.0 ? (u - pShaper[lo]) / d : (icFloatNumber)0.0;
+
+  return ((icFloatNumber)lo + f) / (icFloatNumber)(nSize-1);
+}
+
+/**
+**************************************************************************
+* Name: icDevLinkPcsRange
+* 
+* Purpose: 
+*  Gets the range of actual values of a channel of a Lab or XYZ PCS (the
+*  range that is encoded as 0.0 to 1.0 by IccProfLib).
+**************************************************************************
+*/
+static void icDevLinkPcsRange(icColorSpaceSignature nSpace, icUInt32Number nChannel, icFloatNumber &lo, icFloatNumber &hi)
+{
+  if (nSpace==icSigLabData) {
+    lo = nChannel ? (icFloatNumber)-128.0 : (icFloatNumber)0.0;
+    hi = nChannel ? (icFloatNumber)127.0 : (icFloatNumber)100.0;
+  }
+  else {
+    lo = 0.0;
+    hi = (icFloatNumber)(65535.0 / 32768.0);
+  }
+}
+
+/**
+**************************************************************************
+* Name: icDevLinkProfileDesc
+* 
+* Purpose: 
+*  Gets the profile description of a profile as ASCII text.
+**************************************************************************
+*/
+static void icDevLinkProfileDesc(CIccProfile *pProfile, std::string &sDesc)
+{
+  CIccTag *pTag = pProfile->FindTag(icSigProfileDescriptionTag);
+
+  sDesc = "";
+
+  if (!pTag)
+    return;
+
+  switch (pTag->GetType()) {
+    case icSigTextDescriptionType:
+      sDesc = ((CIccTagTextDescription*)pTag)->GetText();
+      break;
+
+    case icSigTextType:
+      sDesc = ((CIccTagText*)pTag)->GetText();
+      break;
+
+    case icSigMultiLocalizedUnicodeType:
+      {
+        CIccTagMultiLocalizedUnicode *pDesc = (CIccTagMultiLocalizedUnicode*)pTag;
+        CIccLocalizedUnicode *pText = pDesc->Find();
+
+        if (!pText && pDesc->m_Strings->size())
+          pText = &(*pDesc->m_Strings->begin());
+
+        if (pText) {
+          icUInt32Number nSize = pText->GetAnsiSize();
+          icChar *szText = new icChar[nSize+1];
+
+          memset(szText, 0, nSize+1);
+          pText->GetAnsi(szText, nSize+1);
+          sDesc = szText;
+          delete [] szText;
+        }
+      }
+      break;
+
+    default:
+      break;
+  }
+}
+
+/**
+**************************************************************************
+* Name: icDevLinkDescText
+* 
+* Purpose: 
+*  Copies the text of a device manufacturer or model description tag to
+*  a profile sequence description entry.
+**************************************************************************
+*/
+static void icDevLinkDescText(CIccProfileDescText &text, CIccProfile *pProfile, icTagSignature sig)
+{
+  text.SetType(icSigMultiLocalizedUnicodeType);
+
+  CIccTag *pTag = pProfile->FindTag(sig);
+  CIccTagMultiLocalizedUnicode *pText = (CIccTagMultiLocalizedUnicode*)text.GetTag();
+
+  if (!pTag || !pText)
+    return;
+
+  if (pTag->GetType()==icSigMultiLocalizedUnicodeType)
+    *pText = *(CIccTagMultiLocalizedUnicode*)pTag;
+  else if (pTag->GetType()==icSigTextDescriptionType)
+    pText->SetText(((CIccTagTextDescription*)pTag)->GetText());
+}
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Fills a CLUT with the output of a CMM at each grid point.  Grid
+*  coordinates are mapped through the inverse of the shaper curves to get
+*  the input to the CMM.
+**************************************************************************
+*/
+class CIccDevLinkSampler : public IIccCLUTExec
+{
+public:
+  CIccDevLinkSampler(CIccCmm *pCmm, const icFloatNumber *pShaper, icUInt32Number nShaperSize, bool bLegacyDst)
+  {
+    m_pCmm = pCmm;
+    m_pShaper = pShaper;
+    m_nShaperSize = nShaperSize;
+    m_bLegacyDst = bLegacyDst;
+    m_nInput = icGetSpaceSamples(pCmm->GetSourceSpace());
+    m_status = icCmmStatOk;
+  }
+
+  virtual void PixelOp(icFloatNumber* pGridAdr, icFloatNumber* pData)
+  {
+    icFloatNumber Pixel[16];
+    icUInt32Number i;
+
+    for (i=0; i<m_nInput; i++) {
+      if (m_pShaper)
+        Pixel[i] = icDevLinkInvShaper(m_pShaper + i*m_nShaperSize, m_nShaperSize, pGridAdr[i]);
+      else
+        Pixel[i] = pGridAdr[i];
+    }
+
+    icStatusCMM stat = m_pCmm->Apply(pData, Pixel);
+
+    if (stat!=icCmmStatOk)
+      m_status = stat;
+
+    if (m_bLegacyDst)
+      CIccPCS::Lab4ToLab2(pData, pData);
+  }
+
+  icStatusCMM GetStatus() const { return m_status; }
+
+protected:
+  CIccCmm *m_pCmm;
+  const icFloatNumber *m_pShaper;
+  icUInt32Number m_nShaperSize;
+  icUInt32Number m_nInput;
+  bool m_bLegacyDst;
+  icStatusCMM m_status;
+};
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::CIccDeviceLink
+* 
+* Purpose: 
+*  Constructor
+* 
+* Args: 
+*  nLutType = type of tag to write the link as
+*  nGridPoints = number of grid points of each CLUT dimension (0 for the default)
+*  nShaperSize = number of entries in the fitted shaper curves (0 for identity curves)
+**************************************************************************
+*/
+CIccDeviceLink::CIccDeviceLink(icDevLinkLutType nLutType/*=icDevLinkLutAToB*/, icUInt8Number nGridPoints/*=0*/,
+                               icUInt16Number nShaperSize/*=256*/)
+{
+  m_nLutType = nLutType;
+  m_nGridPoints = nGridPoints;
+  m_nShaperSize = nShaperSize;
+  m_sCopyright = "No copyright, use freely";
+
+  m_nInput = m_nOutput = 0;
+  m_nSrcSpace = m_nDstSpace = icSigUnknownData;
+  m_nGrid = 0;
+  m_pShaper = NULL;
+  m_pCLUT = NULL;
+  m_bLegacyLab = false;
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::~CIccDeviceLink
+* 
+* Purpose: 
+*  Destructor
+**************************************************************************
+*/
+CIccDeviceLink::~CIccDeviceLink()
+{
+  Cleanup();
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::Cleanup
+* 
+* Purpose: 
+*  Frees the shaper curves and CLUT made by Sample()
+**************************************************************************
+*/
+void CIccDeviceLink::Cleanup()
+{
+  if (m_pShaper) {
+    delete [] m_pShaper;
+    m_pShaper = NULL;
+  }
+  if (m_pCLUT) {
+    delete m_pCLUT;
+    m_pCLUT = NULL;
+  }
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::GetDefaultGridPoints
+* 
+* Purpose: 
+*  Returns the number of grid points used for each CLUT dimension when
+*  none has been set.  Fewer points are used as the number of input
+*  channels grows to keep the CLUT size reasonable.
+**************************************************************************
+*/
+icUInt8Number CIccDeviceLink::GetDefaultGridPoints(icUInt32Number nInputChannels)
+{
+  static const icUInt8Number nGrids[8] = {0, 255, 65, 33, 17, 11, 9, 7};
+
+  if (nInputChannels<8)
+    return nGrids[nInputChannels];
+
+  icUInt32Number nGrid = (icUInt32Number)pow(1048576.0, 1.0/(double)nInputChannels);
+
+  return (icUInt8Number)(nGrid<2 ? 2 : nGrid);
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::Sample
+* 
+* Purpose: 
+*  Fits the shaper curves and samples the CMM at each point of the CLUT
+*  grid.
+* 
+* Args: 
+*  pCmm = CMM that Begin() has been called on
+*  bLegacyLab = Lab outputs of the grid use version 2 encoding
+**************************************************************************
+*/
+icStatusCMM CIccDeviceLink::Sample(CIccCmm *pCmm, bool bLegacyLab)
+{
+  Cleanup();
+
+  if (!pCmm || !pCmm->GetApply())
+    return icCmmStatIncorrectApply;
+
+  m_nSrcSpace = pCmm->GetSourceSpace();
+  m_nDstSpace = pCmm->GetDestSpace();
+  m_nInput = icGetSpaceSamples(m_nSrcSpace);
+  m_nOutput = icGetSpaceSamples(m_nDstSpace);
+
+  if (m_nSrcSpace==icSigNamedData || m_nDstSpace==icSigNamedData ||
+      !m_nInput || m_nInput>15 || !m_nOutput || m_nOutput>15)
+    return icCmmStatBadSpaceLink;
+
+  m_nGrid = m_nGridPoints ? m_nGridPoints : GetDefaultGridPoints(m_nInput);
+
+  if (m_nGrid<2 || pow((double)m_nGrid, (double)m_nInput)>(double)icDevLinkMaxGridNodes)
+    return icCmmStatInvalidLut;
+
+  m_bLegacyLab = bLegacyLab;
+
+  icStatusCMM stat;
+
+  if (m_nShaperSize>4096)
+    return icCmmStatInvalidLut;
+
+  icUInt32Number nSize = m_nShaperSize;
+
+  if (nSize>=2) {
+    icFloatNumber *pSrc = new icFloatNumber[nSize*m_nInput];
+    icFloatNumber *pDst = new icFloatNumber[nSize*m_nOutput];
+    icUInt32Number c, i, j, k, b;
+
+    m_pShaper = new icFloatNumber[nSize*m_nInput];
+
+    for (c=0; c<m_nInput; c++) {
+      icFloatNumber *pCurve = m_pShaper + c*nSize;
+
+      memset(pCurve, 0, nSize*sizeof(icFloatNumber));
+
+      //Accumulate how much the output changes along channel c with the other
+      //channels at their minimum, middle and maximum values
+      for (b=0; b<3; b++) {
+        icFloatNumber base = (icFloatNumber)b / 2.0f;
+
+        for (k=0; k<nSize; k++) {
+          for (i=0; i<m_nInput; i++)
+            pSrc[k*m_nInput+i] = (i==c) ? (icFloatNumber)k / (icFloatNumber)(nSize-1) : base;
+        }
+
+        stat = pCmm->Apply(pDst, pSrc, nSize);
+        if (stat!=icCmmStatOk) {
+          delete [] pSrc;
+          delete [] pDst;
+          Cleanup();
+          return stat;
+        }
+
+        for (k=1; k<nSize; k++) {
+          icFloatNumber d=0.0;
+
+          for (j=0; j<m_nOutput; j++) {
+            icFloatNumber e = pDst[k*m_nOutput+j] - pDst[(k-1)*m_nOutput+j];
+            d += e*e;
+          }
+          pCurve[k] += (icFloatNumber)sqrt(d);
+        }
+      }
+
+      for (k=1; k<nSize; k++)
+        pCurve[k] += pCurve[k-1];
+
+      icFloatNumber total = pCurve[nSize-1];
+
+      for (k=0; k<nSize; k++) {
+        icFloatNumber x = (icFloatNumber)k / (icFloatNumber)(nSize-1);
+
+        if (total>0.0)
+          pCurve[k] = (1.0f-icDevLinkShaperWeight)*x + icDevLinkShaperWeight*pCurve[k]/total;
+        else
+          pCurve[k] = x;
+      }
+      pCurve[0] = 0.0;
+      pCurve[nSize-1] = 1.0;
+    }
+
+    delete [] pSrc;
+    delete [] pDst;
+  }
+
+  m_pCLUT = new CIccCLUT((icUInt8Number)m_nInput, (icUInt16Number)m_nOutput, 4);
+
+  if (!m_pCLUT->Init(m_nGrid)) {
+    Cleanup();
+    return icCmmStatAllocErr;
+  }
+
+  CIccDevLinkSampler Sampler(pCmm, m_pShaper, nSize, bLegacyLab && m_nDstSpace==icSigLabData);
+
+  m_pCLUT->Iterate(&Sampler);
+
+  stat = Sampler.GetStatus();
+  if (stat!=icCmmStatOk) {
+    Cleanup();
+    return stat;
+  }
+
+  return icCmmStatOk;
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::NewLutTag
+* 
+* Purpose: 
+*  Makes a lut16Type or lutAtoBType tag from the sampled shaper curves and
+*  CLUT.  CLUT values are clipped to the 0.0 to 1.0 range of the tag.
+**************************************************************************
+*/
+CIccMBB *CIccDeviceLink::NewLutTag(bool bLut16)
+{
+  CIccMBB *pTag;
+  LPIccCurve *pCurves;
+  icUInt32Number i;
+
+  if (bLut16)
+    pTag = new CIccTagLut16();
+  else
+    pTag = new CIccTagLutAtoB();
+
+  pTag->Init((icUInt8Number)m_nInput, (icUInt8Number)m_nOutput);
+  pTag->SetColorSpaces(m_nSrcSpace, m_nDstSpace);
+
+  //Input curves are B curves of a lut16Type tag and A curves of a lutAtoBType tag
+  pCurves = bLut16 ? pTag->NewCurvesB() : pTag->NewCurvesA();
+  for (i=0; i<m_nInput; i++) {
+    CIccTagCurve *pCurve;
+
+    if (m_pShaper) {
+      pCurve = new CIccTagCurve(m_nShaperSize);
+      memcpy(pCurve->GetData(0), m_pShaper + i*m_nShaperSize, m_nShaperSize*sizeof(icFloatNumber));
+    }
+    else {
+      pCurve = new CIccTagCurve(0);
+      if (bLut16)
+        pCurve->SetSize(2, icInitIdentity);
+    }
+    pCurves[i] = pCurve;
+  }
+
+  CIccCLUT *pCLUT = pTag->NewCLUT(m_nGrid, 2);
+  icUInt32Number n = m_pCLUT->NumPoints() * m_nOutput;
+  icFloatNumber *pSrc = m_pCLUT->GetData(0);
+  icFloatNumber *pDst = pCLUT->GetData(0);
+
+  for (i=0; i<n; i++) {
+    if (pSrc[i]<0.0)
+      pDst[i] = 0.0;
+    else if (pSrc[i]>1.0)
+      pDst[i] = 1.0;
+    else
+      pDst[i] = pSrc[i];
+  }
+
+  pCurves = bLut16 ? pTag->NewCurvesA() : pTag->NewCurvesB();
+  for (i=0; i<m_nOutput; i++) {
+    CIccTagCurve *pCurve = new CIccTagCurve(0);
+
+    if (bLut16)
+      pCurve->SetSize(2, icInitIdentity);
+    pCurves[i] = pCurve;
+  }
+
+  return pTag;
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::NewMpeTag
+* 
+* Purpose: 
+*  Makes a multiProcessElementType tag from the sampled shaper curves and
+*  CLUT.  The float CLUT holds actual Lab and XYZ outputs.
+* 
+* Args: 
+*  bPcsInput = Lab and XYZ inputs are actual PCS values (as passed to a
+*   BToDx tag) that the curve set maps to the encoding passed to the CMM.
+*   Otherwise inputs are used as is (CIccXformMpe treats Lab and XYZ
+*   inputs of a link as device data).
+**************************************************************************
+*/
+CIccTagMultiProcessElement *CIccDeviceLink::NewMpeTag(bool bPcsInput)
+{
+  CIccTagMultiProcessElement *pTag = new CIccTagMultiProcessElement((icUInt16Number)m_nInput, (icUInt16Number)m_nOutput);
+  bool bScale = bPcsInput && (m_nSrcSpace==icSigLabData || m_nSrcSpace==icSigXYZData);
+  icUInt32Number i;
+
+  if (m_pShaper || bScale) {
+    CIccMpeCurveSet *pCurves = new CIccMpeCurveSet(m_nInput);
+    icFloatNumber params[4];
+
+    for (i=0; i<m_nInput; i++) {
+      CIccSegmentedCurve *pCurve = new CIccSegmentedCurve();
+      CIccFormulaCurveSegment *pFormula;
+      icFloatNumber lo=0.0, hi=1.0;
+
+      if (bScale)
+        icDevLinkPcsRange(m_nSrcSpace, i, lo, hi);
+
+      if (m_pShaper) {
+        //Sampled segments use the value of the previous segment at their start point
+        pFormula = new CIccFormulaCurveSegment(icMinFloat32Number, lo);
+        params[0] = 1.0; params[1] = 0.0; params[2] = 0.0; params[3] = 0.0;
+        pFormula->SetFunction(0, 4, params);
+        pCurve->Insert(pFormula);
+
+        CIccSampledCurveSegment *pSegment = new CIccSampledCurveSegment(lo, hi);
+        pSegment->SetSize(m_nShaperSize, false);
+        memcpy(pSegment->GetSamples(), m_pShaper + i*m_nShaperSize, m_nShaperSize*sizeof(icFloatNumber));
+        pCurve->Insert(pSegment);
+
+        pFormula = new CIccFormulaCurveSegment(hi, icMaxFloat32Number);
+        params[0] = 1.0; params[1] = 0.0; params[2] = 0.0; params[3] = 1.0;
+        pFormula->SetFunction(0, 4, params);
+        pCurve->Insert(pFormula);
+      }
+      else {
+        pFormula = new CIccFormulaCurveSegment(icMinFloat32Number, icMaxFloat32Number);
+        params[0] = 1.0;
+        params[1] = 1.0f / (hi-lo);
+        params[2] = -lo / (hi-lo);
+        params[3] = 0.0;
+        pFormula->SetFunction(0, 4, params);
+        pCurve->Insert(pFormula);
+      }
+
+      pCurves->SetCurve(i, pCurve);
+    }
+    pTag->Attach(pCurves);
+  }
+
+  CIccCLUT *pCLUT = new CIccCLUT((icUInt8Number)m_nInput, (icUInt16Number)m_nOutput, 4);
+  pCLUT->Init(m_nGrid);
+
+  icUInt32Number n = m_pCLUT->NumPoints();
+  icFloatNumber *pSrc = m_pCLUT->GetData(0);
+  icFloatNumber *pDst = pCLUT->GetData(0);
+
+  memcpy(pDst, pSrc, n*m_nOutput*sizeof(icFloatNumber));
+  if (m_nDstSpace==icSigLabData) {
+    for (i=0; i<n; i++, pDst+=3)
+      icLabFromPcs(pDst);
+  }
+  else if (m_nDstSpace==icSigXYZData) {
+    for (i=0; i<n; i++, pDst+=3)
+      icXyzFromPcs(pDst);
+  }
+
+  CIccMpeCLUT *pMpeCLUT = new CIccMpeCLUT();
+  pMpeCLUT->SetCLUT(pCLUT);
+  pTag->Attach(pMpeCLUT);
+
+  return pTag;
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::CreateLutTag
+* 
+* Purpose: 
+*  Samples a CMM into a lut16Type or lutAtoBType tag.
+* 
+* Args: 
+*  pCmm = CMM that Begin() has been called on
+*  bLut16 = make a lut16Type tag rather than a lutAtoBType tag
+*  status = result
+* 
+* Return: 
+*  A new tag owned by the caller or NULL
+**************************************************************************
+*/
+CIccMBB *CIccDeviceLink::CreateLutTag(CIccCmm *pCmm, bool bLut16, icStatusCMM &status)
+{
+  status = Sample(pCmm, bLut16);
+  if (status!=icCmmStatOk)
+    return NULL;
+
+  CIccMBB *pTag = NewLutTag(bLut16);
+
+  Cleanup();
+
+  return pTag;
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::CreateMpeTag
+* 
+* Purpose: 
+*  Samples a CMM into a multiProcessElementType tag.
+* 
+* Args: 
+*  pCmm = CMM that Begin() has been called on
+*  status = result
+*  bPcsInput = Lab and XYZ inputs of the tag are actual PCS values (for
+*   a BToDx tag made from a CMM that starts at the PCS)
+* 
+* Return: 
+*  A new tag owned by the caller or NULL
+**************************************************************************
+*/
+CIccTagMultiProcessElement *CIccDeviceLink::CreateMpeTag(CIccCmm *pCmm, icStatusCMM &status, bool bPcsInput/*=false*/)
+{
+  status = Sample(pCmm, false);
+  if (status!=icCmmStatOk)
+    return NULL;
+
+  CIccTagMultiProcessElement *pTag = NewMpeTag(bPcsInput);
+
+  Cleanup();
+
+  return pTag;
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::Create
+* 
+* Purpose: 
+*  Creates a device link profile from a CMM.  The link uses the source and
+*  destination color spaces of the CMM and the rendering intent of its
+*  first xform.
+* 
+* Args: 
+*  pCmm = CMM that Begin() has been called on
+*  status = result
+* 
+* Return: 
+*  A new profile owned by the caller or NULL
+**************************************************************************
+*/
+CIccProfile *CIccDeviceLink::Create(CIccCmm *pCmm, icStatusCMM &status)
+{
+  bool bLut16 = m_nLutType==icDevLinkLut16;
+
+  status = Sample(pCmm, bLut16);
+  if (status!=icCmmStatOk)
+    return NULL;
+
+  CIccProfile *pLink = new CIccProfile();
+  icUInt32Number i, nXforms = pCmm->GetNumXforms();
+  std::string sDesc;
+
+  pLink->InitHeader();
+  pLink->m_Header.deviceClass = icSigLinkClass;
+  pLink->m_Header.colorSpace = m_nSrcSpace;
+  pLink->m_Header.pcs = m_nDstSpace;
+
+  CIccTagProfileSeqDesc *pSeqDesc = new CIccTagProfileSeqDesc();
+  CIccTagProfileSequenceId *pSeqId = new CIccTagProfileSequenceId();
+
+  for (i=0; i<nXforms; i++) {
+    const CIccXform *pXform = pCmm->GetXform(i);
+    CIccProfile *pProfile = (CIccProfile*)pXform->GetProfile();
+
+    if (!pProfile)
+      continue;
+
+    if (!i)
+      pLink->m_Header.renderingIntent = pXform->GetIntent();
+
+    CIccProfileDescStruct ProfDesc;
+
+    ProfDesc.m_deviceMfg = pProfile->m_Header.manufacturer;
+    ProfDesc.m_deviceModel = pProfile->m_Header.model;
+    ProfDesc.m_attributes = pProfile->m_Header.attributes;
+    ProfDesc.m_technology = (icTechnologySignature)0;
+
+    CIccTag *pTag = pProfile->FindTag(icSigTechnologyTag);
+    if (pTag && pTag->GetType()==icSigSignatureType)
+      ProfDesc.m_technology = (icTechnologySignature)((CIccTagSignature*)pTag)->GetValue();
+
+    icDevLinkDescText(ProfDesc.m_deviceMfgDesc, pProfile, icSigDeviceMfgDescTag);
+    icDevLinkDescText(ProfDesc.m_deviceModelDesc, pProfile, icSigDeviceModelDescTag);
+    pSeqDesc->m_Descriptions->push_back(ProfDesc);
+
+    //Profiles without an ID get the MD5 of a copy written with all of its tags
+    CIccProfileIdDesc IdDesc(*pProfile);
+    icUInt32Number j;
+
+    for (j=0; j<16 && !IdDesc.m_profileID.ID8[j]; j++);
+    if (j==16) {
+      CIccProfile Copy(*pProfile);
+      CIccNullIO NullIO;
+      CIccMemIO IO;
+
+      Copy.Write(&NullIO, icNeverWriteID);
+      if (IO.Alloc(NullIO.GetLength(), true) && Copy.Write(&IO, icAlwaysWriteID))
+        IdDesc.m_profileID = Copy.m_Header.profileID;
+    }
+    pSeqId->AddProfileDescription(IdDesc);
+
+    std::string sProfDesc;
+    icDevLinkProfileDesc(pProfile, sProfDesc);
+    if (sProfDesc.size()) {
+      if (sDesc.size())
+        sDesc += " -> ";
+      sDesc += sProfDesc;
+    }
+  }
+
+  if (m_sDesc.size())
+    sDesc = m_sDesc;
+  else if (!sDesc.size())
+    sDesc = "Device link";
+
+  CIccTagMultiLocalizedUnicode *pText = new CIccTagMultiLocalizedUnicode();
+  pText->SetText(sDesc.c_str());
+  pLink->AttachTag(icSigProfileDescriptionTag, pText);
+
+  pText = new CIccTagMultiLocalizedUnicode();
+  pText->SetText(m_sCopyright.c_str());
+  pLink->AttachTag(icSigCopyrightTag, pText);
+
+  pLink->AttachTag(icSigProfileSequenceDescTag, pSeqDesc);
+  pLink->AttachTag(icSigProfileSequceIdTag, pSeqId);
+
+  pLink->AttachTag(icSigAToB0Tag, NewLutTag(bLut16));
+  if (m_nLutType==icDevLinkMpe)
+    pLink->AttachTag(icSigDToB0Tag, NewMpeTag(false));
+
+  Cleanup();
+
+  return pLink;
+}
+
+/**
+**************************************************************************
+* Name: CIccDeviceLink::Save
+* 
+* Purpose: 
+*  Creates a device link profile from a CMM and writes it to a file.
+* 
+* Args: 
+*  pCmm = CMM that Begin() has been called on
+*  szFilename = name of the file to write
+* 
+* Return: 
+*  icCmmStatOk if the link was written
+**************************************************************************
+*/
+icStatusCMM CIccDeviceLink::Save(CIccCmm *pCmm, const icChar *szFilename)
+{
+  icStatusCMM status;
+  CIccProfile *pLink = Create(pCmm, status);
+
+  if (!pLink)
+    return status;
+
+  if (!SaveIccProfile(szFilename, pLink, icAlwaysWriteID))
+    status = icCmmStatCantOpenProfile;
+
+  delete pLink;
+
+  return status;
+}
+
+#ifdef USESAMPLEICCNAMESPACE
+} //namespace sampleICC
+#endif
@@ -0,0 +1,180 @@
+/** @file
+    File:       IccDeviceLink.h
+
+    Contains:   Header for exporting a CMM as a device link profile
+
+    Version:    V1
+
+    Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation of CIccDeviceLink 10-19-2026
+// -Added PCS inputs to CIccDeviceLink::CreateMpeTag 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_ICCDEVICELINK_H)
+#define _ICCDEVICELINK_H
+
+#include "IccCmm.h"
+
+#ifdef USESAMPLEICCNAMESPACE
+namespace sampleICC {
+#endif
+
+class CIccMBB;
+class CIccTagMultiProcessElement;
+
+/// Type of AToB0 tag written to a device link
+typedef enum {
+  icDevLinkLut16    = 0,  //lut16Type tag (16 bit input tables and CLUT)
+  icDevLinkLutAToB  = 1,  //lutAtoBType tag (A curves and 16 bit CLUT)
+  icDevLinkMpe      = 2,  //DToB0 multiProcessElementType tag (curve set and float CLUT) plus a lutAtoBType AToB0 tag
+} icDevLinkLutType;
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Exports a CMM that Begin() has been called on as a device link
+*  profile.  The whole chain of xforms is sampled on a regular grid into
+*  a single CLUT so that the link is applied as one CIccXform3DLut,
+*  CIccXform4DLut, CIccXformNDLut or CIccXformMpe when it is used.
+*
+*  A shaper curve is fitted for each input channel from how quickly the
+*  output of the chain changes along that channel.  CLUT grid points are
+*  placed through the inverse of the shaper so that more of them land
+*  where the output changes fastest (for example the dark end of gamma
+*  encoded data).  A shaper size of zero gives identity curves and a
+*  uniform grid.
+*
+*  Link inputs use the encoding passed to the CMM.  Lab and XYZ inputs
+*  of a link are device data to CIccXform (icSigDevLabData and
+*  icSigDevXYZData) so they are sampled as is.
+*
+*  The link gets description, copyright, profileSequenceDesc and
+*  profileSequenceIdentifier tags built from the profiles of the CMM.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccDeviceLink
+{
+public:
+  ///nGridPoints of zero selects GetDefaultGridPoints() for the number of input channels
+  CIccDeviceLink(icDevLinkLutType nLutType=icDevLinkLutAToB, icUInt8Number nGridPoints=0,
+                 icUInt16Number nShaperSize=256);
+  virtual ~CIccDeviceLink();
+
+  void SetLutType(icDevLinkLutType nLutType) { m_nLutType = nLutType; }
+  icDevLinkLutType GetLutType() const { return m_nLutType; }
+
+  void SetGridPoints(icUInt8Number nGridPoints) { m_nGridPoints = nGridPoints; }
+  icUInt8Number GetGridPoints() const { return m_nGridPoints; }
+
+  ///Number of entries in the fitted shaper curves (0 for identity curves, at most 4096)
+  void SetShaperSize(icUInt16Number nShaperSize) { m_nShaperSize = nShaperSize; }
+  icUInt16Number GetShaperSize() const { return m_nShaperSize; }
+
+  ///Sets the text of the profile description tag (the descriptions of the linked profiles are used by default)
+  void SetDescription(const icChar *szDesc) { m_sDesc = szDesc ? szDesc : ""; }
+  ///Sets the text of the copyright tag
+  void SetCopyright(const icChar *szCopyright) { m_sCopyright = szCopyright ? szCopyright : ""; }
+
+  ///Returns a new device link profile (owned by the caller) or NULL with status set
+  CIccProfile *Create(CIccCmm *pCmm, icStatusCMM &status);
+
+  ///Creates a device link profile and writes it (with a profile ID) to szFilename
+  icStatusCMM Save(CIccCmm *pCmm, const icChar *szFilename);
+
+  ///Samples the CMM into a lut16Type (bLut16) or lutAtoBType tag owned by the caller
+  CIccMBB *CreateLutTag(CIccCmm *pCmm, bool bLut16, icStatusCMM &status);
+
+  ///Samples the CMM into a multiProcessElementType tag with a curve set and a float CLUT owned by the caller
+  ///(bPcsInput maps actual Lab or XYZ inputs of a BToDx tag to the encoding used by the CMM)
+  CIccTagMultiProcessElement *CreateMpeTag(CIccCmm *pCmm, icStatusCMM &status, bool bPcsInput=false);
+
+  ///Returns the grid size used for nInputChannels when none has been set
+  static icUInt8Number GetDefaultGridPoints(icUInt32Number nInputChannels);
+
+protected:
+  icStatusCMM Sample(CIccCmm *pCmm, bool bLegacyLab);
+  CIccMBB *NewLutTag(bool bLut16);
+  CIccTagMultiProcessElement *NewMpeTag(bool bPcsInput);
+  void Cleanup();
+
+  icDevLinkLutType m_nLutType;
+  icUInt8Number m_nGridPoints;
+  icUInt16Number m_nShaperSize;
+  std::string m_sDesc;
+  std::string m_sCopyright;
+
+  //Set by Sample() and freed by Cleanup()
+  icUInt32Number m_nInput, m_nOutput;
+  icColorSpaceSignature m_nSrcSpace, m_nDstSpace;
+  icUInt8Number m_nGrid;
+  icFloatNumber *m_pShaper;  ///m_nInput curves of m_nShaperSize entries (NULL for identity)
+  CIccCLUT *m_pCLUT;         ///output of the chain at each grid point (CMM encoding)
+  bool m_bLegacyLab;         ///Lab grid outputs use version 2 (lut16Type) encoding
+};
+
+#ifdef USESAMPLEICCNAMESPACE
+} //namespace sampleICC
+#endif
+
+#endif //_ICCDEVICELINK_H
@@ -65,6 +65,7 @@ Copyright:  
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Evaluate grid samples with batch applies 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -79,6 +80,9 @@ namespace sampleICC {
 static const icFloatNumber SMALLNUM = (icFloatNumber)0.0001;
 static const icFloatNumber LESSTHANONE = (icFloatNumber)(1.0 - SMALLNUM);
 
+//Number of grid samples that are pushed through the CMMs with each batch Apply
+#define icEvalBatchPixels 256
+
 icStatusCMM CIccEvalCompare::EvaluateProfile(CIccProfile *pProfile, icUInt8Number nGran/* =0 */,
                                              icRenderingIntent nIntent/* =icUnknownIntent */, icXformInterp nInterp/* =icInterpLinear */,
                                              bool buseMpeTags/* =true */)
@@ -127,8 +131,9 @@ icStatusCMM CIccEvalCompare::EvaluateProfile(CIccProfile *pProfile, icUInt8Numbe
     return result;
   }
 
-  icFloatNumber sPixel[15];
-  icFloatNumber devPcs[15], roundPcs1[15], roundPcs2[15];
+  icFloatNumber sPixels[icEvalBatchPixels*15], *sPixel;
+  icFloatNumber devPcs[icEvalBatchPixels*3], roundPcs1[icEvalBatchPixels*3], roundPcs2[icEvalBatchPixels*3];
+  icUInt32Number k, nPixels = 0;
 
   int ndim = icGetSpaceSamples(pProfile->m_Header.colorSpace);
   int ndim1 = ndim+1;
@@ -160,6 +165,7 @@ icStatusCMM CIccEvalCompare::EvaluateProfile(CIccProfile *pProfile, icUInt8Numbe
   }
 
   while(steps[0]==nstart) {
+    sPixel = &sPixels[nPixels*ndim];
     for(j=0; j<ndim; j++) {
       sPixel[j] = icMin(steps[j+1],1.0);
     }
@@ -172,15 +178,22 @@ icStatusCMM CIccEvalCompare::EvaluateProfile(CIccProfile *pProfile, icUInt8Numbe
       else break;
     }
 
-    dev2Lab.Apply(devPcs, sPixel); //Convert device value to pcs from input table
-    Lab2Dev2Lab.Apply(roundPcs1, devPcs);  //First round trip gets color into output gamut
-    Lab2Dev2Lab.Apply(roundPcs2, roundPcs1);  //Second round trip find reproducibility error
+    nPixels++;
+    if (nPixels<icEvalBatchPixels && steps[0]==nstart)
+      continue;
+
+    dev2Lab.Apply(devPcs, sPixels, nPixels); //Convert device values to pcs from input table
+    Lab2Dev2Lab.Apply(roundPcs1, devPcs, nPixels);  //First round trip gets colors into output gamut
+    Lab2Dev2Lab.Apply(roundPcs2, roundPcs1, nPixels);  //Second round trip find reproducibility error
 
-    icLabFromPcs(devPcs);
-    icLabFromPcs(roundPcs1);
-    icLabFromPcs(roundPcs2);
+    for (k=0; k<nPixels; k++) {
+      icLabFromPcs(&devPcs[k*3]);
+      icLabFromPcs(&roundPcs1[k*3]);
+      icLabFromPcs(&roundPcs2[k*3]);
 
-    Compare(sPixel, devPcs, roundPcs1, roundPcs2);
+      Compare(&sPixels[k*ndim], &devPcs[k*3], &roundPcs1[k*3], &roundPcs2[k*3]);
+    }
+    nPixels = 0;
   }
 
   delete [] steps;
@@ -0,0 +1,912 @@
+/** @file
+    File:       IccGamutBoundary.cpp
+
+    Contains:   Implementation of gamut boundary descriptor generation and queries
+
+    Version:    V1
+
+    Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation of CIccGamutBoundary 10-19-2026 (based on iccGamutMapGirdle)
+//
+// -Added FindGirdle to report the round trip girdle of iccGamutMapGirdle 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#ifdef WIN32
+#pragma warning( disable: 4786) //disable warning in <list.h>
+#endif
+
+#include <math.h>
+#include <string.h>
+#include "IccGamutBoundary.h"
+#include "IccIO.h"
+#include "IccUtil.h"
+#include "IccThread.h"
+
+#ifdef USESAMPLEICCNAMESPACE
+namespace sampleICC {
+#endif
+
+//Signature and version written at the start of a serialized boundary descriptor
+#define icGamutBoundarySig      0x67626420  /* 'gbd ' */
+#define icGamutBoundaryVersion  1
+
+//Largest chroma that can be encoded in the PCS (a* and b* of 128 at 45 degrees)
+#define icGamutBoundaryMaxChroma ((icFloatNumber)181.02)
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Finds the boundary chroma of each hue of a CIccGamutBoundary grid.
+*  Every L* of a hue is bisected at the same time so that each bisection
+*  step is a single batch Apply of nLSteps pixels through the round trip
+*  CMM.
+**************************************************************************
+*/
+class CIccGamutBoundaryTask : public IIccParallelTask
+{
+public:
+  CIccGamutBoundaryTask(icFloatNumber *pChroma, icUInt32Number nHueSteps, icUInt32Number nLSteps,
+                        icFloatNumber dMaxDE, icFloatNumber dPrecision, icUInt32Number nThreads)
+  {
+    m_pChroma = pChroma;
+    m_nHueSteps = nHueSteps;
+    m_nLSteps = nLSteps;
+    m_dMaxDE = dMaxDE;
+    m_dPrecision = dPrecision;
+    m_nThreads = nThreads;
+
+    m_pApply = new CIccApplyCmm*[nThreads];
+    memset(m_pApply, 0, nThreads*sizeof(CIccApplyCmm*));
+  }
+
+  virtual ~CIccGamutBoundaryTask()
+  {
+    icUInt32Number i;
+    for (i=0; i<m_nThreads; i++) {
+      if (m_pApply[i])
+        delete m_pApply[i];
+    }
+    delete [] m_pApply;
+  }
+
+  icStatusCMM Init(CIccCmm &cmm)
+  {
+    icStatusCMM stat = icCmmStatOk;
+    icUInt32Number i;
+
+    for (i=0; i<m_nThreads; i++) {
+      m_pApply[i] = cmm.GetNewApplyCmm(stat);
+      if (!m_pApply[i])
+        return stat!=icCmmStatOk ? stat : icCmmStatAllocErr;
+    }
+    return icCmmStatOk;
+  }
+
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)
+  {
+    icUInt32Number nL = m_nLSteps;
+    icFloatNumber *lo = new icFloatNumber[nL*3];
+    icFloatNumber *hi = lo + nL;
+    icFloatNumber *mid = hi + nL;
+    icFloatNumber *pLab = new icFloatNumber[nL*3];
+    icFloatNumber *pPcs = new icFloatNumber[nL*3*2];
+    icUInt32Number *pIndex = new icUInt32Number[nL];
+    icUInt32Number nHue, i, n;
+
+    for (nHue=nStart; nHue<nEnd; nHue++) {
+      icFloatNumber h = (icFloatNumber)(nHue * 360.0 / m_nHueSteps);
+      icFloatNumber *pChroma = &m_pChroma[nHue*nL];
+
+      //Neutrals that don't survive the round trip have no in gamut chroma
+      n = 0;
+      for (i=0; i<nL; i++) {
+        pIndex[n++] = i;
+        lo[i] = 0.0;
+        hi[i] = icGamutBoundaryMaxChroma;
+      }
+      n = Test(nThread, h, pIndex, n, lo, pLab, pPcs, pChroma, (icFloatNumber)-1.0, false);
+
+      //Colors at the PCS chroma limit that survive don't need bisection
+      n = Test(nThread, h, pIndex, n, hi, pLab, pPcs, pChroma, icGamutBoundaryMaxChroma, true);
+
+      while (n && hi[pIndex[0]] - lo[pIndex[0]] > m_dPrecision) {
+        icUInt32Number j;
+
+        for (j=0; j<n; j++) {
+          i = pIndex[j];
+          mid[i] = (lo[i] + hi[i]) * (icFloatNumber)0.5;
+        }
+        Bisect(nThread, h, pIndex, n, lo, hi, mid, pLab, pPcs);
+      }
+
+      for (i=0; i<n; i++)
+        pChroma[pIndex[i]] = lo[pIndex[i]];
+    }
+
+    delete [] pIndex;
+    delete [] pPcs;
+    delete [] pLab;
+    delete [] lo;
+  }
+
+protected:
+  icFloatNumber GetL(icUInt32Number i) { return (icFloatNumber)(i * 100.0 / (m_nLSteps-1)); }
+
+  ///Round trips L*C*h for indexed L* values, storing in pOk whether each is within m_dMaxDE
+  void RoundTrip(icUInt32Number nThread, icFloatNumber h, const icUInt32Number *pIndex, icUInt32Number n,
+                 const icFloatNumber *pC, icFloatNumber *pLab, icFloatNumber *pPcs, bool *pOk)
+  {
+    icUInt32Number j;
+
+    for (j=0; j<n; j++) {
+      icFloatNumber *Lch = &pLab[j*3];
+
+      Lch[0] = GetL(pIndex[j]);
+      Lch[1] = pC[pIndex[j]];
+      Lch[2] = h;
+    }
+    icLch2LabN(pLab, pLab, n);
+
+    memcpy(pPcs, pLab, n*3*sizeof(icFloatNumber));
+    for (j=0; j<n; j++)
+      icLabToPcs(&pPcs[j*3]);
+
+    m_pApply[nThread]->Apply(&pPcs[n*3], pPcs, n);
+
+    //The source PCS values are no longer needed so they hold the delta E values
+    icFloatNumber *pDE = pPcs;
+    for (j=0; j<n; j++)
+      icLabFromPcs(&pPcs[(n+j)*3]);
+    icDeltaEN(pDE, pLab, &pPcs[n*3], n);
+
+    for (j=0; j<n; j++)
+      pOk[j] = pDE[j] <= m_dMaxDE;
+  }
+
+  ///Tests chroma pC for indexed L* values, resolving those whose in gamut state equals bResolve
+  icUInt32Number Test(icUInt32Number nThread, icFloatNumber h, icUInt32Number *pIndex, icUInt32Number n,
+                      const icFloatNumber *pC, icFloatNumber *pLab, icFloatNumber *pPcs,
+                      icFloatNumber *pChroma, icFloatNumber dResolved, bool bResolve)
+  {
+    bool *pOk = new bool[n ? n : 1];
+    icUInt32Number j, nActive = 0;
+
+    RoundTrip(nThread, h, pIndex, n, pC, pLab, pPcs, pOk);
+
+    for (j=0; j<n; j++) {
+      if (pOk[j]==bResolve)
+        pChroma[pIndex[j]] = dResolved;
+      else
+        pIndex[nActive++] = pIndex[j];
+    }
+
+    delete [] pOk;
+    return nActive;
+  }
+
+  void Bisect(icUInt32Number nThread, icFloatNumber h, const icUInt32Number *pIndex, icUInt32Number n,
+              icFloatNumber *lo, icFloatNumber *hi, const icFloatNumber *mid,
+              icFloatNumber *pLab, icFloatNumber *pPcs)
+  {
+    bool *pOk = new bool[n];
+    icUInt32Number j;
+
+    RoundTrip(nThread, h, pIndex, n, mid, pLab, pPcs, pOk);
+
+    for (j=0; j<n; j++) {
+      icUInt32Number i = pIndex[j];
+      if (pOk[j])
+        lo[i] = mid[i];
+      else
+        hi[i] = mid[i];
+    }
+
+    delete [] pOk;
+  }
+
+  icFloatNumber *m_pChroma;
+  icUInt32Number m_nHueSteps;
+  icUInt32Number m_nLSteps;
+  icFloatNumber m_dMaxDE;
+  icFloatNumber m_dPrecision;
+  icUInt32Number m_nThreads;
+
+  CIccApplyCmm **m_pApply;
+};
+
+
+//Number of samples of each hue evaluated by FindGirdle (L* from 100 to 0 at
+//C* of 128, then C* from 25 to 127.5 at both L* of 100 and 0)
+#define icGirdleLSamples  201
+#define icGirdleCSamples  206
+#define icGirdleSamples   (icGirdleLSamples + 2*icGirdleCSamples)
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Finds the round trip girdle of a set of hues for
+*  CIccGamutBoundary::FindGirdle.  The samples of each hue are visited in
+*  the same order as the original iccGamutMapGirdle scan and applied as
+*  a single batch.
+**************************************************************************
+*/
+class CIccGamutGirdleTask : public IIccParallelTask
+{
+public:
+  CIccGamutGirdleTask(icFloatNumber *pLCh, const icFloatNumber *pHue, icUInt32Number nThreads)
+  {
+    m_pLCh = pLCh;
+    m_pHue = pHue;
+    m_nThreads = nThreads;
+
+    m_pApply = new CIccApplyCmm*[nThreads];
+    memset(m_pApply, 0, nThreads*sizeof(CIccApplyCmm*));
+  }
+
+  virtual ~CIccGamutGirdleTask()
+  {
+    icUInt32Number i;
+    for (i=0; i<m_nThreads; i++) {
+      if (m_pApply[i])
+        delete m_pApply[i];
+    }
+    delete [] m_pApply;
+  }
+
+  icStatusCMM Init(CIccCmm &cmm)
+  {
+    icStatusCMM stat = icCmmStatOk;
+    icUInt32Number i;
+
+    for (i=0; i<m_nThreads; i++) {
+      m_pApply[i] = cmm.GetNewApplyCmm(stat);
+      if (!m_pApply[i])
+        return stat!=icCmmStatOk ? stat : icCmmStatAllocErr;
+    }
+    return icCmmStatOk;
+  }
+
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)
+  {
+    icFloatNumber *pPixels = new icFloatNumber[icGirdleSamples*3];
+    icFloatNumber *pixel;
+    icFloatNumber Lval, Cval, maxC;
+    icUInt32Number nHue, i;
+
+    for (nHue=nStart; nHue<nEnd; nHue++) {
+      icFloatNumber hue = m_pHue[nHue];
+      icFloatNumber *bestLCH = &m_pLCh[nHue*3];
+
+      pixel = pPixels;
+      for (Lval = 100.0; Lval>=0.0; Lval-=.5) {
+        pixel[0] = Lval;
+        pixel[1] = 128;
+        pixel[2] = hue;
+        pixel += 3;
+      }
+      for (Cval=25; Cval<128; Cval+=.5) {
+        pixel[0] = 100;
+        pixel[1] = Cval;
+        pixel[2] = hue;
+        pixel += 3;
+
+        pixel[0] = 0;
+        pixel[1] = Cval;
+        pixel[2] = hue;
+        pixel += 3;
+      }
+
+      for (i=0, pixel=pPixels; i<icGirdleSamples; i++, pixel+=3) {
+        icLch2Lab(pixel);
+        icLabToPcs(pixel);
+      }
+
+      m_pApply[nThread]->Apply(pPixels, pPixels, icGirdleSamples);
+
+      maxC=-10;
+      memset(bestLCH, 0, 3*sizeof(icFloatNumber));
+      for (i=0, pixel=pPixels; i<icGirdleSamples; i++, pixel+=3) {
+        icLabFromPcs(pixel);
+        icLab2Lch(pixel);
+        if (pixel[1]>maxC) {
+          maxC = pixel[1];
+          memcpy(bestLCH, pixel, 3*sizeof(icFloatNumber));
+        }
+      }
+    }
+
+    delete [] pPixels;
+  }
+
+protected:
+  icFloatNumber *m_pLCh;
+  const icFloatNumber *m_pHue;
+  icUInt32Number m_nThreads;
+
+  CIccApplyCmm **m_pApply;
+};
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::CIccGamutBoundary
+ * 
+ * Purpose: 
+ *  Constructor
+ **************************************************************************
+ */
+CIccGamutBoundary::CIccGamutBoundary()
+{
+  m_nHueSteps = 0;
+  m_nLSteps = 0;
+  m_dMaxDE = 0;
+  m_pChroma = NULL;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::~CIccGamutBoundary
+ * 
+ * Purpose: 
+ *  Destructor
+ **************************************************************************
+ */
+CIccGamutBoundary::~CIccGamutBoundary()
+{
+  Reset();
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::Reset
+ * 
+ * Purpose: 
+ *  Releases the boundary descriptor
+ **************************************************************************
+ */
+void CIccGamutBoundary::Reset()
+{
+  if (m_pChroma)
+    delete [] m_pChroma;
+
+  m_pChroma = NULL;
+  m_nHueSteps = 0;
+  m_nLSteps = 0;
+  m_dMaxDE = 0;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::Generate
+ * 
+ * Purpose: 
+ *  Generates the boundary descriptor for a profile by round tripping Lab
+ *  values through the profile using the given intent.
+ * 
+ * Args: 
+ *  pProfile = profile to describe (not owned by the boundary)
+ *  nIntent = rendering intent of the round trip
+ *  nInterp = interpolation used by the round trip
+ *  bUseMpeTags = use multi processing element tags if present
+ *  nHueSteps = number of equally spaced hue angles
+ *  nLSteps = number of equally spaced L* values from 0 to 100 (inclusive)
+ *  dMaxDE = largest round trip deltaE that is considered in gamut
+ *  dPrecision = chroma precision to which the boundary is bisected
+ *  nThreads = number of evaluation threads (0 = one per processor)
+ * 
+ * Return: 
+ *  icCmmStatOk if successful
+ **************************************************************************
+ */
+icStatusCMM CIccGamutBoundary::Generate(CIccProfile *pProfile, icRenderingIntent nIntent/* =icAbsoluteColorimetric */,
+                                        icXformInterp nInterp/* =icInterpTetrahedral */, bool bUseMpeTags/* =false */,
+                                        icUInt32Number nHueSteps/* =360 */, icUInt32Number nLSteps/* =201 */,
+                                        icFloatNumber dMaxDE/* =1.0 */, icFloatNumber dPrecision/* =0.1 */,
+                                        icUInt32Number nThreads/* =0 */)
+{
+  Reset();
+
+  if (!pProfile)
+    return icCmmStatCantOpenProfile;
+
+  if (nHueSteps<1 || nLSteps<2 || dPrecision<=0.0)
+    return icCmmStatBadXform;
+
+  CIccCmm cmm(icSigLabData, icSigLabData, false);
+
+  icStatusCMM result = cmm.AddXform(*pProfile, nIntent, nInterp, icXformLutColor, bUseMpeTags);
+  if (result != icCmmStatOk)
+    return result;
+
+  result = cmm.AddXform(*pProfile, nIntent, nInterp, icXformLutColor, bUseMpeTags);
+  if (result != icCmmStatOk)
+    return result;
+
+  result = cmm.Begin(false);
+  if (result != icCmmStatOk)
+    return result;
+
+  icFloatNumber *pChroma = new icFloatNumber[nHueSteps*nLSteps];
+  if (!pChroma)
+    return icCmmStatAllocErr;
+
+  nThreads = icGetNumThreads(nThreads);
+  if (nThreads>nHueSteps)
+    nThreads = nHueSteps;
+
+  CIccGamutBoundaryTask task(pChroma, nHueSteps, nLSteps, dMaxDE, dPrecision, nThreads);
+
+  result = task.Init(cmm);
+  if (result == icCmmStatOk && !icParallelExecute(&task, nHueSteps, 1, nThreads))
+    result = icCmmStatBad;
+
+  if (result != icCmmStatOk) {
+    delete [] pChroma;
+    return result;
+  }
+
+  m_pChroma = pChroma;
+  m_nHueSteps = nHueSteps;
+  m_nLSteps = nLSteps;
+  m_dMaxDE = dMaxDE;
+
+  return icCmmStatOk;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::Generate
+ * 
+ * Purpose: 
+ *  Generates the boundary descriptor for the profile in szProfilePath.
+ **************************************************************************
+ */
+icStatusCMM CIccGamutBoundary::Generate(const icChar *szProfilePath, icRenderingIntent nIntent/* =icAbsoluteColorimetric */,
+                                        icXformInterp nInterp/* =icInterpTetrahedral */, bool bUseMpeTags/* =false */,
+                                        icUInt32Number nHueSteps/* =360 */, icUInt32Number nLSteps/* =201 */,
+                                        icFloatNumber dMaxDE/* =1.0 */, icFloatNumber dPrecision/* =0.1 */,
+                                        icUInt32Number nThreads/* =0 */)
+{
+  CIccProfile *pProfile = ReadIccProfile(szProfilePath);
+
+  if (!pProfile)
+    return icCmmStatCantOpenProfile;
+
+  icStatusCMM result = Generate(pProfile, nIntent, nInterp, bUseMpeTags, nHueSteps, nLSteps,
+                                dMaxDE, dPrecision, nThreads);
+
+  delete pProfile;
+
+  return result;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::FindGirdle
+ * 
+ * Purpose: 
+ *  Finds the largest chroma L*C*h that results from round tripping
+ *  colours of each hue through a profile.  For each hue L* is scanned from
+ *  100 to 0 at a C* of 128 and C* is scanned from 25 to 128 at L* values
+ *  of 100 and 0 (in 0.5 steps).  The L*C*h with the largest chroma after
+ *  the Lab->Device->Lab round trip is reported, so the reported hue is
+ *  the round trip hue.
+ * 
+ * Args: 
+ *  pLCh = receives nHues L*C*h values
+ *  pHue = hue angles to scan
+ *  nHues = number of hue angles
+ *  pProfile = profile to round trip through (not owned)
+ *  nIntent = rendering intent of the round trip
+ *  nInterp = interpolation used by the round trip
+ *  bUseMpeTags = use multi processing element tags if present
+ *  nThreads = number of evaluation threads (0 = one per processor)
+ * 
+ * Return: 
+ *  icCmmStatOk if successful
+ **************************************************************************
+ */
+icStatusCMM CIccGamutBoundary::FindGirdle(icFloatNumber *pLCh, const icFloatNumber *pHue, icUInt32Number nHues,
+                                          CIccProfile *pProfile, icRenderingIntent nIntent/* =icAbsoluteColorimetric */,
+                                          icXformInterp nInterp/* =icInterpTetrahedral */, bool bUseMpeTags/* =false */,
+                                          icUInt32Number nThreads/* =0 */)
+{
+  if (!pProfile)
+    return icCmmStatCantOpenProfile;
+
+  if (!nHues)
+    return icCmmStatOk;
+
+  CIccCmm cmm(icSigLabData, icSigLabData, false);
+
+  icStatusCMM result = cmm.AddXform(*pProfile, nIntent, nInterp, icXformLutColor, bUseMpeTags);
+  if (result != icCmmStatOk)
+    return result;
+
+  result = cmm.AddXform(*pProfile, nIntent, nInterp, icXformLutColor, bUseMpeTags);
+  if (result != icCmmStatOk)
+    return result;
+
+  result = cmm.Begin(false);
+  if (result != icCmmStatOk)
+    return result;
+
+  nThreads = icGetNumThreads(nThreads);
+  if (nThreads>nHues)
+    nThreads = nHues;
+
+  CIccGamutGirdleTask task(pLCh, pHue, nThreads);
+
+  result = task.Init(cmm);
+  if (result == icCmmStatOk && !icParallelExecute(&task, nHues, 1, nThreads))
+    result = icCmmStatBad;
+
+  return result;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::FindGirdle
+ * 
+ * Purpose: 
+ *  Finds the round trip girdle of the profile in szProfilePath.
+ **************************************************************************
+ */
+icStatusCMM CIccGamutBoundary::FindGirdle(icFloatNumber *pLCh, const icFloatNumber *pHue, icUInt32Number nHues,
+                                          const icChar *szProfilePath, icRenderingIntent nIntent/* =icAbsoluteColorimetric */,
+                                          icXformInterp nInterp/* =icInterpTetrahedral */, bool bUseMpeTags/* =false */,
+                                          icUInt32Number nThreads/* =0 */)
+{
+  CIccProfile *pProfile = ReadIccProfile(szProfilePath);
+
+  if (!pProfile)
+    return icCmmStatCantOpenProfile;
+
+  icStatusCMM result = FindGirdle(pLCh, pHue, nHues, pProfile, nIntent, nInterp, bUseMpeTags, nThreads);
+
+  delete pProfile;
+
+  return result;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::GetMaxChroma
+ * 
+ * Purpose: 
+ *  Bilinearly interpolates the boundary chroma at L* and hue angle h.
+ * 
+ * Return: 
+ *  The boundary chroma, or a negative value if there is no in gamut
+ *  chroma (or no descriptor).
+ **************************************************************************
+ */
+icFloatNumber CIccGamutBoundary::GetMaxChroma(icFloatNumber L, icFloatNumber h) const
+{
+  if (!m_pChroma || L<0.0 || L>100.0)
+    return -1;
+
+  if (h<0.0 || h>=360.0) {
+    h = (icFloatNumber)(h - floor(h/360.0)*360.0);
+    if (h>=360.0)
+      h = 0.0;
+  }
+
+  icFloatNumber fH = (icFloatNumber)(h * m_nHueSteps / 360.0);
+  icUInt32Number nH1 = (icUInt32Number)fH;
+  if (nH1>=m_nHueSteps)
+    nH1 = m_nHueSteps-1;
+  icUInt32Number nH2 = nH1+1<m_nHueSteps ? nH1+1 : 0;
+  icFloatNumber dH = fH - nH1;
+
+  icFloatNumber fL = (icFloatNumber)(L * (m_nLSteps-1) / 100.0);
+  icUInt32Number nL = (icUInt32Number)fL;
+  icFloatNumber dL;
+  if (nL>=m_nLSteps-1) {
+    nL = m_nLSteps-2;
+    dL = 1.0;
+  }
+  else {
+    dL = fL - nL;
+  }
+
+  const icFloatNumber *pRow1 = &m_pChroma[nH1*m_nLSteps + nL];
+  const icFloatNumber *pRow2 = &m_pChroma[nH2*m_nLSteps + nL];
+
+  icFloatNumber ch1 = pRow1[0] + (pRow1[1]-pRow1[0])*dL;
+  icFloatNumber ch2 = pRow2[0] + (pRow2[1]-pRow2[0])*dL;
+
+  return ch1 + (ch2-ch1)*dH;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::InGamut
+ * 
+ * Purpose: 
+ *  Determines whether L*C*h is inside the boundary.
+ **************************************************************************
+ */
+bool CIccGamutBoundary::InGamut(icFloatNumber L, icFloatNumber c, icFloatNumber h) const
+{
+  icFloatNumber dChroma = GetMaxChroma(L, h);
+
+  if (dChroma<0.0 || c>dChroma)
+    return false;
+
+  return true;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::InGamut
+ * 
+ * Purpose: 
+ *  Determines whether a (non PCS encoded) Lab value is inside the boundary.
+ **************************************************************************
+ */
+bool CIccGamutBoundary::InGamut(const icFloatNumber *Lab) const
+{
+  icFloatNumber Lch[3];
+
+  memcpy(Lch, Lab, 3*sizeof(icFloatNumber));
+  icLab2Lch(Lch);
+
+  return InGamut(Lch[0], Lch[1], Lch[2]);
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::InGamut
+ * 
+ * Purpose: 
+ *  Checks nPixels (non PCS encoded) Lab values against the boundary.
+ * 
+ * Return: 
+ *  The number of pixels that are in gamut.
+ **************************************************************************
+ */
+icUInt32Number CIccGamutBoundary::InGamut(bool *bInGamut, const icFloatNumber *Lab, icUInt32Number nPixels) const
+{
+  icUInt32Number i, nIn = 0;
+
+  for (i=0; i<nPixels; i++, Lab+=3) {
+    bInGamut[i] = InGamut(Lab);
+    if (bInGamut[i])
+      nIn++;
+  }
+
+  return nIn;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::GetCusp
+ * 
+ * Purpose: 
+ *  Finds the point of maximum chroma of the boundary at hue h.  The cusp
+ *  is found at the L* resolution of the descriptor.
+ * 
+ * Args: 
+ *  LCh = receives L*, C* and hue of the cusp
+ *  h = hue angle
+ * 
+ * Return: 
+ *  true if a cusp was found
+ **************************************************************************
+ */
+bool CIccGamutBoundary::GetCusp(icFloatNumber *LCh, icFloatNumber h) const
+{
+  if (!m_pChroma)
+    return false;
+
+  icFloatNumber maxC = -1;
+  icUInt32Number i;
+
+  LCh[0] = LCh[1] = 0;
+  LCh[2] = h;
+
+  for (i=0; i<m_nLSteps; i++) {
+    icFloatNumber L = (icFloatNumber)(i * 100.0 / (m_nLSteps-1));
+    icFloatNumber c = GetMaxChroma(L, h);
+
+    if (c>maxC) {
+      maxC = c;
+      LCh[0] = L;
+      LCh[1] = c;
+    }
+  }
+
+  return maxC>=0.0;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::Read
+ * 
+ * Purpose: 
+ *  Reads a boundary descriptor written by Write().
+ **************************************************************************
+ */
+bool CIccGamutBoundary::Read(CIccIO *pIO)
+{
+  icUInt32Number nSig, nVersion, nHueSteps, nLSteps;
+  icFloatNumber dMaxDE;
+
+  Reset();
+
+  if (!pIO)
+    return false;
+
+  if (!pIO->Read32(&nSig) || nSig!=icGamutBoundarySig ||
+      !pIO->Read32(&nVersion) || nVersion!=icGamutBoundaryVersion ||
+      !pIO->Read32(&nHueSteps) || !pIO->Read32(&nLSteps) ||
+      !pIO->ReadFloat32Float(&dMaxDE))
+    return false;
+
+  if (nHueSteps<1 || nLSteps<2 || nHueSteps>0xffff || nLSteps>0xffff)
+    return false;
+
+  icUInt32Number nSize = nHueSteps * nLSteps;
+  icFloatNumber *pChroma = new icFloatNumber[nSize];
+  if (!pChroma)
+    return false;
+
+  if (pIO->ReadFloat32Float(pChroma, nSize)!=(icInt32Number)nSize) {
+    delete [] pChroma;
+    return false;
+  }
+
+  m_pChroma = pChroma;
+  m_nHueSteps = nHueSteps;
+  m_nLSteps = nLSteps;
+  m_dMaxDE = dMaxDE;
+
+  return true;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::Write
+ * 
+ * Purpose: 
+ *  Writes the boundary descriptor as big endian 32 bit values.
+ **************************************************************************
+ */
+bool CIccGamutBoundary::Write(CIccIO *pIO)
+{
+  if (!pIO || !m_pChroma)
+    return false;
+
+  icUInt32Number nSig = icGamutBoundarySig;
+  icUInt32Number nVersion = icGamutBoundaryVersion;
+  icUInt32Number nSize = m_nHueSteps * m_nLSteps;
+
+  if (!pIO->Write32(&nSig) || !pIO->Write32(&nVersion) ||
+      !pIO->Write32(&m_nHueSteps) || !pIO->Write32(&m_nLSteps) ||
+      !pIO->WriteFloat32Float(&m_dMaxDE))
+    return false;
+
+  if (pIO->WriteFloat32Float(m_pChroma, nSize)!=(icInt32Number)nSize)
+    return false;
+
+  return true;
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::Load
+ * 
+ * Purpose: 
+ *  Reads a boundary descriptor from a file.
+ **************************************************************************
+ */
+bool CIccGamutBoundary::Load(const icChar *szFilename)
+{
+  CIccFileIO FileIO;
+
+  if (!FileIO.Open(szFilename, "rb"))
+    return false;
+
+  return Read(&FileIO);
+}
+
+
+/**
+ **************************************************************************
+ * Name: CIccGamutBoundary::Save
+ * 
+ * Purpose: 
+ *  Writes the boundary descriptor to a file.
+ **************************************************************************
+ */
+bool CIccGamutBoundary::Save(const icChar *szFilename)
+{
+  CIccFileIO FileIO;
+
+  if (!FileIO.Open(szFilename, "wb"))
+    return false;
+
+  return Write(&FileIO);
+}
+
+#ifdef USESAMPLEICCNAMESPACE
+} //namespace sampleICC
+#endif
@@ -0,0 +1,169 @@
+/** @file
+    File:       IccGamutBoundary.h
+
+    Contains:   Header for gamut boundary descriptor generation and queries
+
+    Version:    V1
+
+    Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation of CIccGamutBoundary 10-19-2026 (based on iccGamutMapGirdle)
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_ICCGAMUTBOUNDARY_H)
+#define _ICCGAMUTBOUNDARY_H
+
+#include "IccCmm.h"
+
+#ifdef USESAMPLEICCNAMESPACE
+namespace sampleICC {
+#endif
+
+class CIccIO;
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  L*C*h gamut boundary descriptor for a profile.  The descriptor is a
+*  regular grid of hue angles by L* values holding the largest chroma that
+*  survives a Lab->Device->Lab round trip through the profile within a
+*  deltaE tolerance.  Each boundary chroma is found by bisection with all
+*  L* values of a hue evaluated as a single batch, and hues are evaluated
+*  in parallel.
+*
+*  Once generated (or read back with Read/Load) the descriptor answers
+*  in gamut queries with a single bilinear lookup, so it can be used to
+*  gamut check pixels without running the profile.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccGamutBoundary
+{
+public:
+  CIccGamutBoundary();
+  virtual ~CIccGamutBoundary();
+
+  void Reset();
+
+  ///nThreads is the number of evaluation threads to use (0 = one per processor)
+  icStatusCMM Generate(CIccProfile *pProfile, icRenderingIntent nIntent=icAbsoluteColorimetric,
+                       icXformInterp nInterp=icInterpTetrahedral, bool bUseMpeTags=false,
+                       icUInt32Number nHueSteps=360, icUInt32Number nLSteps=201,
+                       icFloatNumber dMaxDE=1.0, icFloatNumber dPrecision=0.1,
+                       icUInt32Number nThreads=0);
+  icStatusCMM Generate(const icChar *szProfilePath, icRenderingIntent nIntent=icAbsoluteColorimetric,
+                       icXformInterp nInterp=icInterpTetrahedral, bool bUseMpeTags=false,
+                       icUInt32Number nHueSteps=360, icUInt32Number nLSteps=201,
+                       icFloatNumber dMaxDE=1.0, icFloatNumber dPrecision=0.1,
+                       icUInt32Number nThreads=0);
+
+  ///Finds the largest chroma L*C*h that results from round tripping colours of each hue
+  ///in pHue through a profile (the girdle reported by iccGamutMapGirdle).  pLCh receives
+  ///nHues L*C*h values.  Unlike the descriptor this isn't limited by a deltaE tolerance.
+  static icStatusCMM FindGirdle(icFloatNumber *pLCh, const icFloatNumber *pHue, icUInt32Number nHues,
+                                CIccProfile *pProfile, icRenderingIntent nIntent=icAbsoluteColorimetric,
+                                icXformInterp nInterp=icInterpTetrahedral, bool bUseMpeTags=false,
+                                icUInt32Number nThreads=0);
+  static icStatusCMM FindGirdle(icFloatNumber *pLCh, const icFloatNumber *pHue, icUInt32Number nHues,
+                                const icChar *szProfilePath, icRenderingIntent nIntent=icAbsoluteColorimetric,
+                                icXformInterp nInterp=icInterpTetrahedral, bool bUseMpeTags=false,
+                                icUInt32Number nThreads=0);
+
+  bool IsValid() const { return m_pChroma!=NULL; }
+
+  icUInt32Number GetNumHueSteps() const { return m_nHueSteps; }
+  icUInt32Number GetNumLSteps() const { return m_nLSteps; }
+  icFloatNumber GetMaxDE() const { return m_dMaxDE; }
+
+  ///Returns boundary chroma at grid node (nHue, nL) or a negative value if no colour at that L* is in gamut
+  icFloatNumber GetNodeChroma(icUInt32Number nHue, icUInt32Number nL) const { return m_pChroma[nHue*m_nLSteps + nL]; }
+
+  ///Returns interpolated boundary chroma at L* and hue (negative if out of gamut for any chroma)
+  icFloatNumber GetMaxChroma(icFloatNumber L, icFloatNumber h) const;
+
+  bool InGamut(icFloatNumber L, icFloatNumber c, icFloatNumber h) const;
+  bool InGamut(const icFloatNumber *Lab) const;
+  icUInt32Number InGamut(bool *bInGamut, const icFloatNumber *Lab, icUInt32Number nPixels) const;
+
+  ///Finds the L*C*h of the maximum chroma (cusp) of the boundary at hue h
+  bool GetCusp(icFloatNumber *LCh, icFloatNumber h) const;
+
+  bool Read(CIccIO *pIO);
+  bool Write(CIccIO *pIO);
+
+  bool Load(const icChar *szFilename);
+  bool Save(const icChar *szFilename);
+
+protected:
+  icUInt32Number m_nHueSteps;
+  icUInt32Number m_nLSteps;
+  icFloatNumber m_dMaxDE;
+
+  ///m_nHueSteps x m_nLSteps boundary chroma values (hue major)
+  icFloatNumber *m_pChroma;
+};
+
+#ifdef USESAMPLEICCNAMESPACE
+} //namespace sampleICC
+#endif
+
+#endif //_ICCGAMUTBOUNDARY_H
@@ -65,6 +65,9 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Added NewReadView for concurrent reads of shared data 10-19-2026
+// -Added positional ReadAt and CIccReadViewIO 10-19-2026
+// -Added CIccMappedFileIO 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -73,6 +76,15 @@
 #include <stdlib.h>
 #include <memory.h>
 #include <string.h>
+#if !defined(WIN32) && !defined(WIN64)
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <windows.h>
+#endif
 
 #ifndef __max
 #define __max(a,b)  (((a) > (b)) ? (a) : (b))
@@ -331,6 +343,22 @@ bool CIccIO::Sync32(icUInt32Number nOffset)
   return true;
 }
 
+icInt32Number CIccIO::ReadAt(icUInt32Number nOffset, void *pBuf8, icInt32Number nNum)
+{
+  icInt32Number nPos = Tell();
+
+  if (Seek((icInt32Number)nOffset, icSeekSet)!=(icInt32Number)nOffset) {
+    Seek(nPos, icSeekSet);
+    return 0;
+  }
+
+  nNum = Read8(pBuf8, nNum);
+
+  Seek(nPos, icSeekSet);
+
+  return nNum;
+}
+
 
 //////////////////////////////////////////////////////////////////////
 // Class CIccFileIO
@@ -339,6 +367,7 @@ bool CIccIO::Sync32(icUInt32Number nOffset)
 CIccFileIO::CIccFileIO() : CIccIO()
 {
   m_fFile = NULL;
+  m_bReadOnly = false;
 }
 
 CIccFileIO::~CIccFileIO()
@@ -363,6 +392,7 @@ bool CIccFileIO::Open(const icChar *szFilename, const icChar *szAttr)
     fclose(m_fFile);
 
   m_fFile = fopen(szFilename, szAttr);
+  m_bReadOnly = strpbrk(szAttr, "wa+")==NULL;
 
   return m_fFile != NULL;
 }
@@ -384,6 +414,7 @@ bool CIccFileIO::Open(const icWChar *szFilename, const icWChar *szAttr)
     fclose(m_fFile);
 
   m_fFile = _wfopen(szFilename, szAttr);
+  m_bReadOnly = wcspbrk(szAttr, L"wa+")==NULL;
 
   return m_fFile != NULL;
 }
@@ -449,6 +480,50 @@ icInt32Number CIccFileIO::Tell()
 }
 
 
+icInt32Number CIccFileIO::ReadAt(icUInt32Number nOffset, void *pBuf8, icInt32Number nNum)
+{
+  if (!m_fFile)
+    return 0;
+
+#if !defined(WIN32) && !defined(WIN64)
+  //Files that are only read can use pread which leaves the stream position alone
+  if (m_bReadOnly) {
+    icInt32Number nRead = 0;
+
+    while (nRead<nNum) {
+      ssize_t n = pread(fileno(m_fFile), (icUInt8Number*)pBuf8+nRead, nNum-nRead, (off_t)nOffset+nRead);
+
+      if (n<0 && errno==EINTR)
+        continue;
+      if (n<=0)
+        break;
+      nRead += (icInt32Number)n;
+    }
+    return nRead;
+  }
+#endif
+
+  CIccMutexLock lock(m_mutex);
+
+  return CIccIO::ReadAt(nOffset, pBuf8, nNum);
+}
+
+
+CIccIO *CIccFileIO::NewReadView(icUInt32Number nOffset, icUInt32Number nSize)
+{
+  if (!m_fFile)
+    return NULL;
+
+  icInt32Number nLength;
+  {
+    CIccMutexLock lock(m_mutex);
+    nLength = GetLength();
+  }
+
+  return new CIccReadViewIO(this, (icUInt32Number)nLength, nOffset, nSize);
+}
+
+
 //////////////////////////////////////////////////////////////////////
 // Class CIccMemIO
 //////////////////////////////////////////////////////////////////////
@@ -513,6 +588,35 @@ bool CIccMemIO::Attach(icUInt8Number *pData, icUInt32Number nSize, bool bWrite)
 }
 
 
+icInt32Number CIccMemIO::ReadAt(icUInt32Number nOffset, void *pBuf8, icInt32Number nNum)
+{
+  if (!m_pData || nOffset>=m_nSize || nNum<=0)
+    return 0;
+
+  nNum = __min((icInt32Number)(m_nSize-nOffset), nNum);
+
+  memcpy(pBuf8, m_pData+nOffset, nNum);
+
+  return nNum;
+}
+
+
+CIccIO *CIccMemIO::NewReadView(icUInt32Number nOffset, icUInt32Number nSize)
+{
+  if (!m_pData)
+    return NULL;
+
+  CIccMemIO *pIO = new CIccMemIO;
+
+  if (!pIO->Attach(m_pData, m_nSize)) {
+    delete pIO;
+    return NULL;
+  }
+
+  return pIO;
+}
+
+
 void CIccMemIO::Close()
 {
   if (m_pData) {
@@ -613,6 +717,156 @@ icInt32Number CIccMemIO::Tell()
   return (icInt32Number)m_nPos;
 }
 
+//////////////////////////////////////////////////////////////////////
+// Class CIccMappedFileIO
+//////////////////////////////////////////////////////////////////////
+
+CIccMappedFileIO::CIccMappedFileIO() : CIccMemIO()
+{
+  m_pMapping = NULL;
+#if defined(WIN32) || defined(WIN64)
+  m_hFile = NULL;
+  m_hMap = NULL;
+#else
+  m_nFile = -1;
+#endif
+}
+
+CIccMappedFileIO::~CIccMappedFileIO()
+{
+  Close();
+}
+
+#if defined(WIN32) || defined(WIN64)
+
+bool CIccMappedFileIO::Open(const icChar *szFilename)
+{
+  Close();
+
+  HANDLE hFile = CreateFileA(szFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, NULL);
+  if (hFile==INVALID_HANDLE_VALUE)
+    return false;
+
+  m_hFile = hFile;
+
+  DWORD nSizeHigh = 0;
+  DWORD nSize = GetFileSize(hFile, &nSizeHigh);
+
+  if (nSize==INVALID_FILE_SIZE || nSizeHigh)
+    nSize = 0;
+
+  return Map(nSize);
+}
+
+bool CIccMappedFileIO::Open(const icWChar *szFilename)
+{
+  Close();
+
+  HANDLE hFile = CreateFileW(szFilename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, NULL);
+  if (hFile==INVALID_HANDLE_VALUE)
+    return false;
+
+  m_hFile = hFile;
+
+  DWORD nSizeHigh = 0;
+  DWORD nSize = GetFileSize(hFile, &nSizeHigh);
+
+  if (nSize==INVALID_FILE_SIZE || nSizeHigh)
+    nSize = 0;
+
+  return Map(nSize);
+}
+
+bool CIccMappedFileIO::Map(icUInt32Number nSize)
+{
+  if (nSize) {
+    //Copy on write mapping so that changes are never written to the file
+    m_hMap = CreateFileMapping((HANDLE)m_hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+    if (m_hMap)
+      m_pMapping = MapViewOfFile((HANDLE)m_hMap, FILE_MAP_COPY, 0, 0, 0);
+  }
+
+  if (!m_pMapping) {
+    Close();
+    return false;
+  }
+
+  return Attach((icUInt8Number*)m_pMapping, nSize);
+}
+
+void CIccMappedFileIO::Close()
+{
+  if (m_pMapping) {
+    UnmapViewOfFile(m_pMapping);
+    m_pMapping = NULL;
+  }
+  if (m_hMap) {
+    CloseHandle((HANDLE)m_hMap);
+    m_hMap = NULL;
+  }
+  if (m_hFile) {
+    CloseHandle((HANDLE)m_hFile);
+    m_hFile = NULL;
+  }
+
+  CIccMemIO::Close();
+}
+
+#else
+
+bool CIccMappedFileIO::Open(const icChar *szFilename)
+{
+  Close();
+
+  m_nFile = open(szFilename, O_RDONLY);
+  if (m_nFile<0)
+    return false;
+
+  struct stat st;
+  icUInt32Number nSize = 0;
+
+  if (!fstat(m_nFile, &st) && st.st_size>0 && (ICCUINT64)st.st_size<=0xffffffff)
+    nSize = (icUInt32Number)st.st_size;
+
+  return Map(nSize);
+}
+
+bool CIccMappedFileIO::Map(icUInt32Number nSize)
+{
+  if (nSize) {
+    //Private mapping so that changes are never written to the file
+    void *pMapping = mmap(NULL, nSize, PROT_READ|PROT_WRITE, MAP_PRIVATE, m_nFile, 0);
+
+    if (pMapping!=MAP_FAILED)
+      m_pMapping = pMapping;
+  }
+
+  if (!m_pMapping) {
+    Close();
+    return false;
+  }
+
+  return Attach((icUInt8Number*)m_pMapping, nSize);
+}
+
+void CIccMappedFileIO::Close()
+{
+  if (m_pMapping) {
+    munmap(m_pMapping, m_nSize);
+    m_pMapping = NULL;
+  }
+  if (m_nFile>=0) {
+    close(m_nFile);
+    m_nFile = -1;
+  }
+
+  CIccMemIO::Close();
+}
+
+#endif
+
 ///////////////////////////////
 
 //////////////////////////////////////////////////////////////////////
@@ -707,6 +961,113 @@ icInt32Number CIccNullIO::Tell()
 }
 
 
+//////////////////////////////////////////////////////////////////////
+// Class CIccReadViewIO
+//////////////////////////////////////////////////////////////////////
+
+CIccReadViewIO::CIccReadViewIO(CIccIO *pSource, icUInt32Number nLength,
+                               icUInt32Number nOffset/*=0*/, icUInt32Number nSize/*=0*/) : CIccIO()
+{
+  m_pSource = pSource;
+  m_nLength = nLength;
+  m_nPos = 0;
+
+  m_pWindow = NULL;
+  m_nWindowOffset = 0;
+  m_nWindowSize = 0;
+
+  if (nSize && nOffset<nLength) {
+    if (nSize > nLength-nOffset)
+      nSize = nLength-nOffset;
+
+    m_pWindow = (icUInt8Number*)malloc(nSize);
+
+    if (m_pWindow) {
+      m_nWindowOffset = nOffset;
+      m_nWindowSize = (icUInt32Number)__max(pSource->ReadAt(nOffset, m_pWindow, (icInt32Number)nSize), 0);
+    }
+  }
+}
+
+CIccReadViewIO::~CIccReadViewIO()
+{
+  if (m_pWindow)
+    free(m_pWindow);
+}
+
+
+icInt32Number CIccReadViewIO::Read8(void *pBuf, icInt32Number nNum)
+{
+  nNum = ReadAt(m_nPos, pBuf, nNum);
+
+  m_nPos += nNum;
+
+  return nNum;
+}
+
+
+icInt32Number CIccReadViewIO::GetLength()
+{
+  return (icInt32Number)m_nLength;
+}
+
+
+icInt32Number CIccReadViewIO::Seek(icInt32Number nOffset, icSeekVal pos)
+{
+  icInt32Number nPos;
+  switch(pos) {
+  case icSeekSet:
+    nPos = nOffset;
+    break;
+  case icSeekCur:
+    nPos = (icInt32Number)m_nPos + nOffset;
+    break;
+  case icSeekEnd:
+    nPos = (icInt32Number)m_nLength + nOffset;
+    break;
+  default:
+    nPos = 0;
+    break;
+  }
+
+  if (nPos < 0 || (icUInt32Number)nPos > m_nLength)
+    return -1;
+
+  m_nPos = (icUInt32Number)nPos;
+
+  return nPos;
+}
+
+
+icInt32Number CIccReadViewIO::Tell()
+{
+  return (icInt32Number)m_nPos;
+}
+
+
+icInt32Number CIccReadViewIO::ReadAt(icUInt32Number nOffset, void *pBuf8, icInt32Number nNum)
+{
+  if (nOffset>=m_nLength || nNum<=0)
+    return 0;
+
+  nNum = __min((icInt32Number)(m_nLength-nOffset), nNum);
+
+  if (nOffset>=m_nWindowOffset && nOffset-m_nWindowOffset<=m_nWindowSize &&
+      (icUInt32Number)nNum<=m_nWindowSize-(nOffset-m_nWindowOffset)) {
+    memcpy(pBuf8, m_pWindow+(nOffset-m_nWindowOffset), nNum);
+    return nNum;
+  }
+
+  return m_pSource->ReadAt(nOffset, pBuf8, nNum);
+}
+
+
+CIccIO *CIccReadViewIO::NewReadView(icUInt32Number nOffset, icUInt32Number nSize)
+{
+  return new CIccReadViewIO(m_pSource, m_nLength, nOffset, nSize);
+}
+
+
 #ifdef USESAMPLEICCNAMESPACE
 } //namespace sampleICC
 #endif
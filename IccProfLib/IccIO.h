@@ -65,6 +65,9 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Added NewReadView for concurrent reads of shared data 10-19-2026
+// -Added positional ReadAt and CIccReadViewIO 10-19-2026
+// -Added GetDirectData and CIccMappedFileIO 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -72,6 +75,7 @@
 #define _ICCIO_H
 
 #include "IccDefs.h"
+#include "IccThread.h"
 #include "stdio.h"
 
 #ifdef USESAMPLEICCNAMESPACE
@@ -134,6 +138,21 @@ public:
 
   ///Operation to make sure read position is evenly divisible by 4
   bool Sync32(icUInt32Number nOffset=0); 
+
+  ///Reads nNum bytes starting at nOffset without changing the current position.
+  ///IO objects that support NewReadView() allow concurrent calls from several threads.
+  virtual icInt32Number ReadAt(icUInt32Number nOffset, void *pBuf8, icInt32Number nNum);
+
+  ///Returns a new read only IO object with its own read position over the same data
+  ///so that other threads can read from it concurrently, or NULL if not supported.
+  ///nOffset and nSize optionally give the range that will be read so that it can be
+  ///fetched at once.  The returned object must be deleted before this object is
+  ///closed or deleted.
+  virtual CIccIO *NewReadView(icUInt32Number nOffset=0, icUInt32Number nSize=0) { return NULL; }
+
+  ///Returns a pointer to all GetLength() bytes when they are held in (or mapped
+  ///into) memory so that they can be used without copying, or NULL if not supported.
+  virtual const icUInt8Number *GetDirectData() { return NULL; }
 };
 
 /**
@@ -163,8 +182,14 @@ public:
   virtual icInt32Number Seek(icInt32Number nOffset, icSeekVal pos);
   virtual icInt32Number Tell();
 
+  virtual icInt32Number ReadAt(icUInt32Number nOffset, void *pBuf8, icInt32Number nNum);
+  virtual CIccIO *NewReadView(icUInt32Number nOffset=0, icUInt32Number nSize=0);
+
 protected:
   FILE *m_fFile;
+
+  bool m_bReadOnly;
+  CIccMutex m_mutex;
 };
 
 /**
@@ -193,7 +218,11 @@ public:
   virtual icInt32Number Seek(icInt32Number nOffset, icSeekVal pos);
   virtual icInt32Number Tell();
 
+  virtual icInt32Number ReadAt(icUInt32Number nOffset, void *pBuf8, icInt32Number nNum);
+  virtual CIccIO *NewReadView(icUInt32Number nOffset=0, icUInt32Number nSize=0);
+
   icUInt8Number *GetData() { return m_pData; }
+  virtual const icUInt8Number *GetDirectData() { return m_pData; }
 
 protected:
   icUInt8Number *m_pData;
@@ -204,6 +233,75 @@ protected:
   bool m_bFreeData;
 };
 
+/**
+ **************************************************************************
+ * Type: Class
+ * 
+ * Purpose: Read only memory IO over a file that is mapped into memory.
+ *  Open() fails if the file cannot be mapped (callers can fall back to
+ *  CIccFileIO).
+ **************************************************************************
+ */
+class ICCPROFLIB_API CIccMappedFileIO : public CIccMemIO
+{
+public:
+  CIccMappedFileIO();
+  virtual ~CIccMappedFileIO();
+
+  bool Open(const icChar *szFilename);
+#if defined(WIN32) || defined(WIN64)
+  bool Open(const icWChar *szFilename);
+#endif
+  virtual void Close();
+
+protected:
+  bool Map(icUInt32Number nSize);
+
+  void *m_pMapping;
+#if defined(WIN32) || defined(WIN64)
+  void *m_hFile;
+  void *m_hMap;
+#else
+  int m_nFile;
+#endif
+};
+
+/**
+ **************************************************************************
+ * Type: Class
+ * 
+ * Purpose: Read only IO with its own position that reads from a source
+ *  IO object using ReadAt().  An optional range of the source can be
+ *  fetched when the view is created so that reads within it don't go
+ *  back to the source.  The source must outlive the view.
+ **************************************************************************
+ */
+class ICCPROFLIB_API CIccReadViewIO : public CIccIO
+{
+public:
+  CIccReadViewIO(CIccIO *pSource, icUInt32Number nLength, icUInt32Number nOffset=0, icUInt32Number nSize=0);
+  virtual ~CIccReadViewIO();
+
+  virtual icInt32Number Read8(void *pBuf, icInt32Number nNum=1);
+
+  virtual icInt32Number GetLength();
+
+  virtual icInt32Number Seek(icInt32Number nOffset, icSeekVal pos);
+  virtual icInt32Number Tell();
+
+  virtual icInt32Number ReadAt(icUInt32Number nOffset, void *pBuf8, icInt32Number nNum);
+  virtual CIccIO *NewReadView(icUInt32Number nOffset=0, icUInt32Number nSize=0);
+
+protected:
+  CIccIO *m_pSource;
+  icUInt32Number m_nLength;
+  icUInt32Number m_nPos;
+
+  icUInt8Number *m_pWindow;
+  icUInt32Number m_nWindowOffset;
+  icUInt32Number m_nWindowSize;
+};
+
 /**
  **************************************************************************
  * Type: Class
@@ -66,6 +66,8 @@
 //
 // -Initial implementation by Max Derhak 1-30-2006
 //
+// -Added streaming (IIccDescribeSink) CLUT element dumps 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 #if defined(WIN32) || defined(WIN64)
@@ -2389,6 +2391,37 @@ CIccMpeCLUT::~CIccMpeCLUT()
     delete m_pCLUT;
 }
 
+/**
+ ******************************************************************************
+ * Name: CIccApplyMpeCLUT::CIccApplyMpeCLUT
+ * 
+ * Purpose: 
+ * 
+ * Args: 
+ * 
+ * Return: 
+ ******************************************************************************/
+CIccApplyMpeCLUT::CIccApplyMpeCLUT(CIccMultiProcessElement *pElem) : CIccApplyMpe(pElem)
+{
+  m_pNodeWeights = NULL;
+}
+
+/**
+ ******************************************************************************
+ * Name: CIccApplyMpeCLUT::~CIccApplyMpeCLUT
+ * 
+ * Purpose: 
+ * 
+ * Args: 
+ * 
+ * Return: 
+ ******************************************************************************/
+CIccApplyMpeCLUT::~CIccApplyMpeCLUT()
+{
+  if (m_pNodeWeights)
+    delete [] m_pNodeWeights;
+}
+
 /**
  ******************************************************************************
  * Name: CIccMpeCLUT::SetCLUT
@@ -2429,6 +2462,22 @@ void CIccMpeCLUT::Describe(std::string &sDescription)
   }
 }
 
+/**
+ ******************************************************************************
+ * Name: CIccMpeCLUT::DescribeTo
+ * 
+ * Purpose: Streams the CLUT dump to a describe sink
+ * 
+ * Args: 
+ *  pSink = sink to send the dump to
+ ******************************************************************************/
+void CIccMpeCLUT::DescribeTo(IIccDescribeSink *pSink)
+{
+  if (m_pCLUT) {
+    m_pCLUT->DumpLut(pSink, "ELEM_CLUT", icSigUnknownData, icSigUnknownData);
+  }
+}
+
 /**
  ******************************************************************************
  * Name: CIccMpeCLUT::Read
@@ -2585,6 +2634,36 @@ bool CIccMpeCLUT::Begin(icElemInterp nInterp, CIccTagMultiProcessElement *pMPE)
   return true;
 }
 
+/**
+ ******************************************************************************
+ * Name: CIccMpeCLUT::GetNewApply
+ * 
+ * Purpose: 
+ *  Allocates the node weights for N-dimensional interpolation once per apply
+ *  object when the CLUT has too many nodes to weight them on the stack.
+ * 
+ * Args: 
+ *  pApplyTag = apply object of the containing MPE tag
+ * 
+ * Return: 
+ *  new apply object (NULL on allocation failure)
+ ******************************************************************************/
+CIccApplyMpe* CIccMpeCLUT::GetNewApply(CIccApplyTagMpe *pApplyTag)
+{
+  CIccApplyMpeCLUT *pApply = new CIccApplyMpeCLUT(this);
+
+  if (pApply && m_interpType==icNdInterp && m_pCLUT &&
+      m_pCLUT->GetNumOffset()>icCLUTMaxLocalNodes) {
+    pApply->m_pNodeWeights = new icFloatNumber[m_pCLUT->GetNumOffset()];
+    if (!pApply->m_pNodeWeights) {
+      delete pApply;
+      return NULL;
+    }
+  }
+
+  return pApply;
+}
+
 /**
  ******************************************************************************
  * Name: CIccMpeCLUT::Apply
@@ -2616,7 +2695,9 @@ void CIccMpeCLUT::Apply(CIccApplyMpe *pApply, icFloatNumber *dstPixel, const icF
     pCLUT->Interp6d(dstPixel, srcPixel);
     break;
   case icNdInterp:
-    pCLUT->InterpND(dstPixel, srcPixel);
+    pCLUT->InterpND(dstPixel, srcPixel,
+                    pApply && pApply->GetType()==icSigCLutElemType ?
+                    ((CIccApplyMpeCLUT*)pApply)->GetNodeWeights() : NULL);
     break;
   }
 }
@@ -391,11 +391,13 @@ public:
   virtual const icChar *GetClassName() const { return "CIccMpeCLUT"; }
 
   virtual void Describe(std::string &sDescription);
+  virtual void DescribeTo(IIccDescribeSink *pSink);
 
   virtual bool Read(icUInt32Number size, CIccIO *pIO);
   virtual bool Write(CIccIO *pIO);
 
   virtual bool Begin(icElemInterp nInterp, CIccTagMultiProcessElement *pMPE);
+  virtual CIccApplyMpe* GetNewApply(CIccApplyTagMpe *pApplyTag);
   virtual void Apply(CIccApplyMpe *pApply, icFloatNumber *dstPixel, const icFloatNumber *srcPixel) const;
 
   virtual icValidateStatus Validate(icTagSignature sig, std::string &sReport, const CIccTagMultiProcessElement* pMPE=NULL) const;
@@ -408,6 +410,31 @@ protected:
   icCLUTElemType m_interpType;
 };
 
+/**
+****************************************************************************
+* Class: CIccApplyMpeCLUT
+* 
+* Purpose: Apply storage for CIccMpeCLUT, holding the node weights used by
+*  InterpND when there are too many nodes to weight on the stack
+*****************************************************************************
+*/
+class CIccApplyMpeCLUT : public CIccApplyMpe
+{
+  friend class CIccMpeCLUT;
+public:
+  virtual ~CIccApplyMpeCLUT();
+
+  virtual icElemTypeSignature GetType() const { return icSigCLutElemType; }
+  virtual const icChar *GetClassName() const { return "CIccApplyMpeCLUT"; }
+
+  icFloatNumber *GetNodeWeights() const { return m_pNodeWeights; }
+
+protected:
+  CIccApplyMpeCLUT(CIccMultiProcessElement *pElem);
+
+  icFloatNumber *m_pNodeWeights;
+};
+
 
 //CIccMPElements support
 #ifdef USESAMPLEICCNAMESPACE
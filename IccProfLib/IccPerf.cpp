@@ -0,0 +1,472 @@
+/** @file
+    File:       IccPerf.cpp
+
+    Contains:   Performance counters for the apply chain
+
+    Version:    V1
+
+    Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation of apply chain performance counters 10-19-2026
+// -Added setup phase timing events 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "IccPerf.h"
+#include "IccThread.h"
+#include "IccUtil.h"
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(WIN32) || defined(WIN64)
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #include <windows.h>
+  #if defined(_M_IX86) || defined(_M_X64)
+    #include <intrin.h>
+    #define ICC_PERF_RDTSC() __rdtsc()
+  #endif
+#else
+  #include <time.h>
+  #if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    #include <x86intrin.h>
+    #define ICC_PERF_RDTSC() __rdtsc()
+  #endif
+#endif
+
+#if defined(ICC_NO_THREADS)
+  #define ICC_THREAD_LOCAL
+#elif defined(_MSC_VER)
+  #define ICC_THREAD_LOCAL __declspec(thread)
+#else
+  #define ICC_THREAD_LOCAL __thread
+#endif
+
+#ifdef USESAMPLEICCNAMESPACE
+namespace sampleICC {
+#endif
+
+/**
+**************************************************************************
+* Name: icPerfCountersEnabled
+* 
+* Purpose: 
+*  Returns whether the apply chain updates its performance counters
+**************************************************************************
+*/
+bool icPerfCountersEnabled()
+{
+#ifdef ICC_PERF_COUNTERS
+  return true;
+#else
+  return false;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: icPerfClockNs
+* 
+* Purpose: 
+*  Returns a monotonic clock value in nanoseconds
+**************************************************************************
+*/
+static double icPerfClockNs()
+{
+#if defined(WIN32) || defined(WIN64)
+  LARGE_INTEGER nCount, nFreq;
+  QueryPerformanceCounter(&nCount);
+  QueryPerformanceFrequency(&nFreq);
+  return (double)nCount.QuadPart * 1.0e9 / (double)nFreq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1.0e9 + (double)ts.tv_nsec;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: icPerfTicks
+* 
+* Purpose: 
+*  Returns the processor time stamp counter where available, otherwise
+*  a monotonic clock in nanoseconds
+**************************************************************************
+*/
+icPerfCount icPerfTicks()
+{
+#if defined(ICC_PERF_RDTSC)
+  return (icPerfCount)ICC_PERF_RDTSC();
+#else
+  return (icPerfCount)icPerfClockNs();
+#endif
+}
+
+static CIccMutex icPerfMutex;
+static double icPerfTicksPerSec = 0.0;
+
+/**
+**************************************************************************
+* Name: icPerfTicksPerSecond
+* 
+* Purpose: 
+*  Returns the rate of icPerfTicks().  The time stamp counter rate is
+*  measured against the monotonic clock the first time this is called.
+**************************************************************************
+*/
+double icPerfTicksPerSecond()
+{
+  CIccMutexLock lock(icPerfMutex);
+
+  if (icPerfTicksPerSec==0.0) {
+#if defined(ICC_PERF_RDTSC)
+    double dStart = icPerfClockNs(), dNow;
+    icPerfCount nStart = icPerfTicks();
+
+    do {
+      dNow = icPerfClockNs();
+    } while (dNow - dStart < 20.0e6);
+
+    icPerfTicksPerSec = (double)(icPerfTicks() - nStart) * 1.0e9 / (dNow - dStart);
+#else
+    icPerfTicksPerSec = 1.0e9;
+#endif
+  }
+
+  return icPerfTicksPerSec;
+}
+
+/**
+**************************************************************************
+* Name: CIccPerfCounter::GetNanoseconds
+* 
+* Purpose: 
+*  Converts the accumulated ticks to nanoseconds
+**************************************************************************
+*/
+double CIccPerfCounter::GetNanoseconds() const
+{
+  if (!m_nTicks)
+    return 0.0;
+
+  return (double)m_nTicks * 1.0e9 / icPerfTicksPerSecond();
+}
+
+/**
+**************************************************************************
+* Name: CIccPerfCounter::Describe
+* 
+* Purpose: 
+*  Appends a line with the counter values to sReport
+**************************************************************************
+*/
+void CIccPerfCounter::Describe(std::string &sReport, const icChar *szName) const
+{
+  char buf[256];
+
+  sprintf(buf, "%-32s calls=%.0f pixels=%.0f ticks=%.0f ns=%.0f ns/pixel=%.2f\n", szName,
+          (double)m_nCalls, (double)m_nPixels, (double)m_nTicks, GetNanoseconds(), GetNsPerPixel());
+
+  sReport += buf;
+}
+
+static ICC_THREAD_LOCAL IIccSetupListener *g_pSetupListener = NULL;
+static ICC_THREAD_LOCAL icUInt32Number g_nSetupDepth = 0;
+
+/**
+**************************************************************************
+* Name: icGetSetupPhaseName
+* 
+* Purpose: 
+*  Returns a printable name for a setup phase
+**************************************************************************
+*/
+const icChar *icGetSetupPhaseName(icSetupPhase nPhase)
+{
+  switch(nPhase) {
+  case icSetupProfileOpen:
+    return "Profile open";
+  case icSetupTagLoad:
+    return "Tag load";
+  case icSetupCmmBegin:
+    return "CMM begin";
+  case icSetupXformBegin:
+    return "Xform begin";
+  case icSetupInvCurve:
+    return "Curve inversion";
+  case icSetupAdjustPCS:
+    return "PCS adjustment";
+  case icSetupCLUTBegin:
+    return "CLUT begin";
+  case icSetupMpeBegin:
+    return "MPE begin";
+  case icSetupApply:
+    return "Apply allocation";
+  default:
+    return "Unknown";
+  }
+}
+
+/**
+**************************************************************************
+* Name: CIccSetupScope::CIccSetupScope
+* 
+* Purpose: 
+*  Makes pListener the setup listener of the calling thread
+**************************************************************************
+*/
+CIccSetupScope::CIccSetupScope(IIccSetupListener *pListener)
+{
+  m_pPrev = g_pSetupListener;
+  m_bSet = pListener!=NULL;
+
+  if (m_bSet) {
+    //Measure the tick rate now so that it isn't measured inside a timed phase
+    icPerfTicksPerSecond();
+
+    g_pSetupListener = pListener;
+  }
+}
+
+/**
+**************************************************************************
+* Name: CIccSetupScope::~CIccSetupScope
+* 
+* Purpose: 
+*  Restores the previous setup listener
+**************************************************************************
+*/
+CIccSetupScope::~CIccSetupScope()
+{
+  if (m_bSet)
+    g_pSetupListener = m_pPrev;
+}
+
+/**
+**************************************************************************
+* Name: icGetSetupListener
+* 
+* Purpose: 
+*  Returns the setup listener of the calling thread
+**************************************************************************
+*/
+IIccSetupListener *icGetSetupListener()
+{
+  return g_pSetupListener;
+}
+
+/**
+**************************************************************************
+* Name: CIccSetupTimer::CIccSetupTimer
+* 
+* Purpose: 
+*  Starts timing a setup phase if the calling thread has a setup listener
+**************************************************************************
+*/
+CIccSetupTimer::CIccSetupTimer(icSetupPhase nPhase, icInt32Number nIndex/*=-1*/, icSignature sig/*=0*/)
+{
+  m_pListener = g_pSetupListener;
+
+  m_event.nPhase = nPhase;
+  m_event.nIndex = nIndex;
+  m_event.sig = sig;
+  m_event.nDepth = g_nSetupDepth;
+  m_event.dNanoseconds = 0.0;
+  m_event.nBytes = 0;
+  m_nStart = 0;
+
+  if (m_pListener) {
+    g_nSetupDepth++;
+    m_pListener->BeginPhase(m_event);
+    m_nStart = icPerfTicks();
+  }
+}
+
+/**
+**************************************************************************
+* Name: CIccSetupTimer::~CIccSetupTimer
+* 
+* Purpose: 
+*  Reports the end of the phase to the listener
+**************************************************************************
+*/
+CIccSetupTimer::~CIccSetupTimer()
+{
+  if (m_pListener) {
+    icPerfCount nTicks = icPerfTicks() - m_nStart;
+
+    m_event.dNanoseconds = (double)nTicks * 1.0e9 / icPerfTicksPerSecond();
+    g_nSetupDepth--;
+
+    m_pListener->EndPhase(m_event);
+  }
+}
+
+/**
+**************************************************************************
+* Name: CIccSetupReport::BeginPhase
+* 
+* Purpose: 
+*  Records a placeholder for the phase so events are kept in start order
+**************************************************************************
+*/
+void CIccSetupReport::BeginPhase(const icSetupEvent &event)
+{
+  m_Open.push_back(m_Events.size());
+  m_Events.push_back(event);
+}
+
+/**
+**************************************************************************
+* Name: CIccSetupReport::EndPhase
+* 
+* Purpose: 
+*  Fills in the results of the innermost open phase
+**************************************************************************
+*/
+void CIccSetupReport::EndPhase(const icSetupEvent &event)
+{
+  if (m_Open.empty()) {
+    m_Events.push_back(event);
+    return;
+  }
+
+  m_Events[m_Open.back()] = event;
+  m_Open.pop_back();
+}
+
+/**
+**************************************************************************
+* Name: CIccSetupReport::GetPhaseNanoseconds
+* 
+* Purpose: 
+*  Returns the total time of the events of a phase that are not nested
+*  inside another event of the same phase
+**************************************************************************
+*/
+double CIccSetupReport::GetPhaseNanoseconds(icSetupPhase nPhase) const
+{
+  std::vector<icSetupPhase> Outer;
+  std::vector<icSetupEvent>::const_iterator i;
+  double dTotal = 0.0;
+
+  for (i=m_Events.begin(); i!=m_Events.end(); i++) {
+    if (Outer.size()>i->nDepth)
+      Outer.resize(i->nDepth);
+
+    if (i->nPhase==nPhase && std::find(Outer.begin(), Outer.end(), nPhase)==Outer.end())
+      dTotal += i->dNanoseconds;
+
+    Outer.push_back(i->nPhase);
+  }
+
+  return dTotal;
+}
+
+/**
+**************************************************************************
+* Name: CIccSetupReport::GetReport
+* 
+* Purpose: 
+*  Appends the recorded events, indented by nesting level, followed by
+*  the total time of each phase to sReport
+**************************************************************************
+*/
+void CIccSetupReport::GetReport(std::string &sReport) const
+{
+  std::vector<icSetupEvent>::const_iterator i;
+  char buf[256], name[64], sig[32];
+  int nPhase;
+
+  for (i=m_Events.begin(); i!=m_Events.end(); i++) {
+    strcpy(name, icGetSetupPhaseName(i->nPhase));
+
+    if (i->nIndex>=0)
+      sprintf(name+strlen(name), " %d", i->nIndex);
+    if (i->sig)
+      sprintf(name+strlen(name), " %s", icGetSig(sig, i->sig, false));
+
+    sprintf(buf, "%*s%-*s %10.3f ms", i->nDepth*2, "", 36-i->nDepth*2, name, i->dNanoseconds / 1.0e6);
+    sReport += buf;
+
+    if (i->nBytes) {
+      sprintf(buf, " %10lu bytes", (unsigned long)i->nBytes);
+      sReport += buf;
+    }
+    sReport += "\n";
+  }
+
+  sReport += "\nSetup totals:\n";
+  for (nPhase=icSetupProfileOpen; nPhase<=icSetupApply; nPhase++) {
+    double dTotal = GetPhaseNanoseconds((icSetupPhase)nPhase);
+
+    if (dTotal>0.0) {
+      sprintf(buf, "%-36s %10.3f ms\n", icGetSetupPhaseName((icSetupPhase)nPhase), dTotal / 1.0e6);
+      sReport += buf;
+    }
+  }
+}
+
+#ifdef USESAMPLEICCNAMESPACE
+} //namespace sampleICC
+#endif
@@ -0,0 +1,284 @@
+/** @file
+    File:       IccPerf.h
+
+    Contains:   Performance counters for the apply chain
+
+    Version:    V1
+
+    Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation of apply chain performance counters 10-19-2026
+// -Added setup phase timing events 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_ICCPERF_H)
+#define _ICCPERF_H
+
+#include "IccDefs.h"
+#include "IccProfLibConf.h"
+#include <string>
+#include <vector>
+
+#ifdef USESAMPLEICCNAMESPACE
+namespace sampleICC {
+#endif
+
+///Type used for performance counter values
+typedef ICCUINT64 icPerfCount;
+
+///Returns true if IccProfLib was built with ICC_PERF_COUNTERS defined (counters are never updated otherwise)
+ICCPROFLIB_API bool icPerfCountersEnabled();
+
+///Returns a high resolution time stamp (processor cycles where available)
+ICCPROFLIB_API icPerfCount icPerfTicks();
+
+///Returns the number of icPerfTicks() ticks per second
+ICCPROFLIB_API double icPerfTicksPerSecond();
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Accumulates the number of calls, pixels and time (in icPerfTicks()
+*  ticks) spent in one part of the apply chain.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccPerfCounter
+{
+public:
+  CIccPerfCounter() { Reset(); }
+
+  void Reset() { m_nCalls = m_nPixels = m_nTicks = 0; }
+
+  void Add(icPerfCount nTicks, icUInt32Number nPixels=1) { m_nCalls++; m_nPixels += nPixels; m_nTicks += nTicks; }
+  void Add(const CIccPerfCounter &counter) { m_nCalls += counter.m_nCalls; m_nPixels += counter.m_nPixels; m_nTicks += counter.m_nTicks; }
+
+  ///Returns the accumulated time in nanoseconds
+  double GetNanoseconds() const;
+  ///Returns the average time per pixel in nanoseconds
+  double GetNsPerPixel() const { return m_nPixels ? GetNanoseconds() / (double)m_nPixels : 0.0; }
+
+  ///Appends a one line description of the counter to sReport
+  void Describe(std::string &sReport, const icChar *szName) const;
+
+  icPerfCount m_nCalls;
+  icPerfCount m_nPixels;
+  icPerfCount m_nTicks;
+};
+
+//Macros used to time a statement.  They compile to nothing unless ICC_PERF_COUNTERS is defined.
+#ifdef ICC_PERF_COUNTERS
+#define ICC_PERF_START(t)               icPerfCount t = icPerfTicks()
+#define ICC_PERF_STOP(counter, t, n)    (counter).Add(icPerfTicks()-(t), (n))
+#else
+#define ICC_PERF_START(t)
+#define ICC_PERF_STOP(counter, t, n)
+#endif
+
+/**
+ * Setup phases reported to an IIccSetupListener.  Phases nest, for example
+ * icSetupInvCurve events happen inside an icSetupXformBegin event which is
+ * inside an icSetupCmmBegin event.
+ */
+typedef enum {
+  icSetupProfileOpen    = 0,  //Reading a profile in CIccCmm::AddXform()
+  icSetupTagLoad        = 1,  //On demand loading of a tag (see CIccProfile::Attach())
+  icSetupCmmBegin       = 2,  //CIccCmm::Begin()
+  icSetupXformBegin     = 3,  //CIccXform::Begin() of one xform
+  icSetupInvCurve       = 4,  //Inversion of a TRC curve (GetInvCurve())
+  icSetupAdjustPCS      = 5,  //PCS adjustment factors (e.g. CIccApplyBPC::CalcFactors())
+  icSetupCLUTBegin      = 6,  //CIccCLUT::Begin()
+  icSetupMpeBegin       = 7,  //CIccTagMultiProcessElement::Begin()
+  icSetupApply          = 8,  //Allocating the apply objects (CIccCmm::GetNewApplyCmm())
+} icSetupPhase;
+
+///Returns a printable name for a setup phase
+ICCPROFLIB_API const icChar *icGetSetupPhaseName(icSetupPhase nPhase);
+
+/**
+ * A setup event.  nIndex is the index of the xform in the CMM for CMM
+ * level phases (-1 otherwise) and sig is the tag signature of tag level
+ * phases (0 otherwise).  nBytes is the memory allocated or read by the
+ * phase when it is known (0 otherwise).
+ */
+typedef struct {
+  icSetupPhase nPhase;
+  icInt32Number nIndex;
+  icSignature sig;
+  icUInt32Number nDepth;
+  double dNanoseconds;
+  size_t nBytes;
+} icSetupEvent;
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Interface for receiving setup phase events.  Events are sent to the
+*  listener made current on the calling thread with CIccSetupScope (for
+*  example by CIccCmm::SetSetupListener()).
+**************************************************************************
+*/
+class ICCPROFLIB_API IIccSetupListener
+{
+public:
+  virtual ~IIccSetupListener() {}
+
+  ///Called when a phase starts (dNanoseconds and nBytes are zero)
+  virtual void BeginPhase(const icSetupEvent &event) {}
+
+  ///Called when a phase ends
+  virtual void EndPhase(const icSetupEvent &event)=0;
+};
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Makes pListener the setup listener of the calling thread for the
+*  lifetime of the object.  A NULL pListener leaves the current listener
+*  in place.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccSetupScope
+{
+public:
+  CIccSetupScope(IIccSetupListener *pListener);
+  ~CIccSetupScope();
+
+private:
+  CIccSetupScope(const CIccSetupScope &);
+  CIccSetupScope &operator=(const CIccSetupScope &);
+
+  IIccSetupListener *m_pPrev;
+  bool m_bSet;
+};
+
+///Returns the setup listener of the calling thread (NULL if there is none)
+ICCPROFLIB_API IIccSetupListener *icGetSetupListener();
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Times a setup phase from construction to destruction and reports it
+*  to the current setup listener.  Does nothing if there is no listener.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccSetupTimer
+{
+public:
+  CIccSetupTimer(icSetupPhase nPhase, icInt32Number nIndex=-1, icSignature sig=0);
+  ~CIccSetupTimer();
+
+  void SetBytes(size_t nBytes) { m_event.nBytes = nBytes; }
+
+private:
+  CIccSetupTimer(const CIccSetupTimer &);
+  CIccSetupTimer &operator=(const CIccSetupTimer &);
+
+  IIccSetupListener *m_pListener;
+  icSetupEvent m_event;
+  icPerfCount m_nStart;
+};
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Setup listener that records the events of one thread in the order the
+*  phases started, and formats them as an indented report.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccSetupReport : public IIccSetupListener
+{
+public:
+  CIccSetupReport() {}
+  virtual ~CIccSetupReport() {}
+
+  virtual void BeginPhase(const icSetupEvent &event);
+  virtual void EndPhase(const icSetupEvent &event);
+
+  void Reset() { m_Events.clear(); m_Open.clear(); }
+
+  const std::vector<icSetupEvent> &GetEvents() const { return m_Events; }
+
+  ///Returns the time spent in the outermost events of a phase
+  double GetPhaseNanoseconds(icSetupPhase nPhase) const;
+
+  ///Appends the events (one per line) followed by totals per phase to sReport
+  void GetReport(std::string &sReport) const;
+
+protected:
+  std::vector<icSetupEvent> m_Events;
+  std::vector<size_t> m_Open;
+};
+
+#ifdef USESAMPLEICCNAMESPACE
+} //namespace sampleICC
+#endif
+
+#endif //_ICCPERF_H
@@ -63,6 +63,8 @@ Copyright:  
 
 #include "IccPrmg.h"
 #include "IccUtil.h"
+#include "IccThread.h"
+#include <math.h>
 
 #ifdef USESAMPLEICCNAMESPACE
 namespace sampleICC {
@@ -120,28 +122,30 @@ static icFloatNumber icPRMG_Chroma[37][21] = {
   {0, 11, 26, 39, 52, 64, 74, 83, 91, 92, 91, 87, 82, 75, 67, 57, 47, 37, 25, 13, 0},
 };
 
-CIccPRMG::CIccPRMG()
-{
-  m_nTotal = m_nDE1 = m_nDE2 = m_nDE3 = m_nDE5 = m_nDE10 = 0;
+/**********************************************************************
+ * The PRMG boundary is a bilinear interpolation of the table above.
+ * Since every table node lies on a multiple of 0.5 L* and 1 degree of
+ * hue, sampling the boundary at that resolution gives a grid whose
+ * bilinear interpolation is identical to interpolating the original
+ * table, but can be indexed directly without the special handling of
+ * the first lightness interval.
+ */
+#define icPRMG_GRID_LSTEPS  200  /* 0.5 L* per step from 0 to 100 */
+#define icPRMG_GRID_HSTEPS  360  /* 1 degree per step from 0 to 360 */
+#define icPRMG_GRID_LSCALE  2.0
 
-  m_bPrmgImplied = false;
-}
+static icFloatNumber icPRMG_ChromaGrid[icPRMG_GRID_HSTEPS+1][icPRMG_GRID_LSTEPS+1];
+static bool icPRMG_bChromaGridInit = false;
+static CIccMutex icPRMG_ChromaGridMutex;
 
-icFloatNumber CIccPRMG::GetChroma(icFloatNumber L, icFloatNumber h)
+static icFloatNumber icPRMGTableChroma(icFloatNumber L, icFloatNumber h)
 {
-  if (L<3.5 || L>100.0)
-    return -1;
-
   int nHIndex, nLIndex;
   icFloatNumber dHFraction, dLFraction;
 
-  while (h<0.0)
-    h+=360.0;
-
-  while (h>=360.0)
-    h-=360.0;
-
   nHIndex = (int)(h/10.0);
+  if (nHIndex>35)
+    nHIndex = 35;
   dHFraction = (icFloatNumber)((h - nHIndex*10.0)/10.0);
 
   if (L<5) {
@@ -165,6 +169,71 @@ icFloatNumber CIccPRMG::GetChroma(icFloatNumber L, icFloatNumber h)
   return (icFloatNumber)(ch1*(1.0-dHFraction) + ch2 * 1.0*dHFraction);
 }
 
+static void icPRMGInitChromaGrid()
+{
+  CIccMutexLock lock(icPRMG_ChromaGridMutex);
+
+  if (icPRMG_bChromaGridInit)
+    return;
+
+  int h, l;
+  for (h=0; h<=icPRMG_GRID_HSTEPS; h++) {
+    for (l=0; l<=icPRMG_GRID_LSTEPS; l++) {
+      icFloatNumber L = (icFloatNumber)(l / icPRMG_GRID_LSCALE);
+
+      //Nodes below L*=3.5 are never used for interpolation
+      icPRMG_ChromaGrid[h][l] = L<3.5 ? 0 : icPRMGTableChroma(L, (icFloatNumber)h);
+    }
+  }
+
+  icPRMG_bChromaGridInit = true;
+}
+
+CIccPRMG::CIccPRMG()
+{
+  m_nTotal = m_nDE1 = m_nDE2 = m_nDE3 = m_nDE5 = m_nDE10 = 0;
+
+  m_bPrmgImplied = false;
+
+  icPRMGInitChromaGrid();
+}
+
+icFloatNumber CIccPRMG::GetChroma(icFloatNumber L, icFloatNumber h)
+{
+  if (L<3.5 || L>100.0)
+    return -1;
+
+  int nHIndex, nLIndex;
+  icFloatNumber dHFraction, dLFraction;
+
+  if (h<0.0 || h>=360.0) {
+    h = (icFloatNumber)(h - floor(h/360.0)*360.0);
+    if (h>=360.0)
+      h = 0.0;
+  }
+
+  nHIndex = (int)h;
+  dHFraction = h - nHIndex;
+
+  icFloatNumber fL = (icFloatNumber)(L*icPRMG_GRID_LSCALE);
+  nLIndex = (int)fL;
+  if (nLIndex>=icPRMG_GRID_LSTEPS) {
+    nLIndex = icPRMG_GRID_LSTEPS-1;
+    dLFraction = 1.0;
+  }
+  else {
+    dLFraction = fL - nLIndex;
+  }
+
+  const icFloatNumber *pRow1 = &icPRMG_ChromaGrid[nHIndex][nLIndex];
+  const icFloatNumber *pRow2 = &icPRMG_ChromaGrid[nHIndex+1][nLIndex];
+
+  icFloatNumber ch1 = pRow1[0] + (pRow1[1]-pRow1[0])*dLFraction;
+  icFloatNumber ch2 = pRow2[0] + (pRow2[1]-pRow2[0])*dLFraction;
+
+  return ch1 + (ch2-ch1)*dHFraction;
+}
+
 bool CIccPRMG::InGamut(icFloatNumber L, icFloatNumber c, icFloatNumber h)
 {
   icFloatNumber dChroma = GetChroma(L, h);
@@ -183,8 +252,155 @@ bool CIccPRMG::InGamut(icFloatNumber *Lab)
   return InGamut(Lch[0], Lch[1], Lch[2]);
 }
 
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Evaluates rows of the PCS sampling grid for CIccPRMG::EvaluateProfile.
+*  Each item is one (L, a) row of b samples.  In gamut samples are gathered
+*  into blocks that are pushed through the round trip CMM with a single
+*  batch Apply, and the resulting deltaE histograms are accumulated per
+*  thread to be merged once all rows are done.
+**************************************************************************
+*/
+#define icPRMG_BATCH_PIXELS 1024
+
+class CIccPRMGEvalTask : public IIccParallelTask
+{
+public:
+  CIccPRMGEvalTask(CIccPRMG *pPrmg, const icFloatNumber *pSteps, icUInt32Number nSteps, icUInt32Number nThreads)
+  {
+    m_pPrmg = pPrmg;
+    m_pSteps = pSteps;
+    m_nSteps = nSteps;
+    m_nThreads = nThreads;
+
+    m_pApply = new CIccApplyCmm*[nThreads];
+    m_pCounts = new icUInt32Number[nThreads*6];
+    memset(m_pApply, 0, nThreads*sizeof(CIccApplyCmm*));
+    memset(m_pCounts, 0, nThreads*6*sizeof(icUInt32Number));
+  }
+
+  virtual ~CIccPRMGEvalTask()
+  {
+    icUInt32Number i;
+    for (i=0; i<m_nThreads; i++) {
+      if (m_pApply[i])
+        delete m_pApply[i];
+    }
+    delete [] m_pApply;
+    delete [] m_pCounts;
+  }
+
+  icStatusCMM Init(CIccCmm &cmm)
+  {
+    icStatusCMM stat = icCmmStatOk;
+    icUInt32Number i;
+
+    for (i=0; i<m_nThreads; i++) {
+      m_pApply[i] = cmm.GetNewApplyCmm(stat);
+      if (!m_pApply[i])
+        return stat!=icCmmStatOk ? stat : icCmmStatAllocErr;
+    }
+    return icCmmStatOk;
+  }
+
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)
+  {
+    icFloatNumber src[icPRMG_BATCH_PIXELS*3], dst[icPRMG_BATCH_PIXELS*3];
+    icFloatNumber Lab1[3];
+    icUInt32Number nPixels = 0;
+    icUInt32Number nRow, k;
+
+    for (nRow=nStart; nRow<nEnd; nRow++) {
+      icFloatNumber pcsL = m_pSteps[nRow / m_nSteps];
+      icFloatNumber pcsA = m_pSteps[nRow % m_nSteps];
+
+      for (k=0; k<m_nSteps; k++) {
+        icFloatNumber *pcs = &src[nPixels*3];
+        pcs[0] = pcsL;
+        pcs[1] = pcsA;
+        pcs[2] = m_pSteps[k];
+
+        memcpy(Lab1, pcs, 3*sizeof(icFloatNumber));
+        icLabFromPcs(Lab1);
+        if (m_pPrmg->InGamut(Lab1)) {
+          nPixels++;
+          if (nPixels==icPRMG_BATCH_PIXELS) {
+            Evaluate(nThread, dst, src, nPixels);
+            nPixels = 0;
+          }
+        }
+      }
+    }
+
+    if (nPixels)
+      Evaluate(nThread, dst, src, nPixels);
+  }
+
+  void GetCounts(icUInt32Number &nDE1, icUInt32Number &nDE2, icUInt32Number &nDE3,
+                 icUInt32Number &nDE5, icUInt32Number &nDE10, icUInt32Number &nTotal)
+  {
+    icUInt32Number i;
+
+    nDE1 = nDE2 = nDE3 = nDE5 = nDE10 = nTotal = 0;
+    for (i=0; i<m_nThreads; i++) {
+      icUInt32Number *pCount = &m_pCounts[i*6];
+      nDE1 += pCount[0];
+      nDE2 += pCount[1];
+      nDE3 += pCount[2];
+      nDE5 += pCount[3];
+      nDE10 += pCount[4];
+      nTotal += pCount[5];
+    }
+  }
+
+protected:
+  void Evaluate(icUInt32Number nThread, icFloatNumber *dst, icFloatNumber *src, icUInt32Number nPixels)
+  {
+    icUInt32Number *pCount = &m_pCounts[nThread*6];
+    icFloatNumber pDE[icPRMG_BATCH_PIXELS];
+    icFloatNumber dE;
+    icUInt32Number i;
+
+    m_pApply[nThread]->Apply(dst, src, nPixels);
+
+    for (i=0; i<nPixels; i++) {
+      icLabFromPcs(&src[i*3]);
+      icLabFromPcs(&dst[i*3]);
+    }
+    icDeltaEN(pDE, src, dst, nPixels);
+
+    for (i=0; i<nPixels; i++) {
+      dE = pDE[i];
+
+      if (dE<=1.0)
+        pCount[0]++;
+      if (dE<=2.0)
+        pCount[1]++;
+      if (dE<=3.0)
+        pCount[2]++;
+      if (dE<=5.0)
+        pCount[3]++;
+      if (dE<=10.0)
+        pCount[4]++;
+      pCount[5]++;
+    }
+  }
+
+  CIccPRMG *m_pPrmg;
+  const icFloatNumber *m_pSteps;
+  icUInt32Number m_nSteps;
+  icUInt32Number m_nThreads;
+
+  CIccApplyCmm **m_pApply;
+  icUInt32Number *m_pCounts;
+};
+
 icStatusCMM CIccPRMG::EvaluateProfile(CIccProfile *pProfile, icRenderingIntent nIntent/* =icUnknownIntent */,
-                                      icXformInterp nInterp/* =icInterpLinear */, bool buseMpeTags/* =true */)
+                                      icXformInterp nInterp/* =icInterpLinear */, bool buseMpeTags/* =true */,
+                                      icUInt32Number nThreads/* =0 */)
 {
   if (!pProfile)
   {
@@ -224,68 +440,49 @@ icStatusCMM CIccPRMG::EvaluateProfile(CIccProfile *pProfile, icRenderingIntent n
     return result;
   }
 
-  result = Lab2Dev2Lab.Begin();
+  result = Lab2Dev2Lab.Begin(false);
   if (result != icCmmStatOk) {
     return result;
   }
-  icFloatNumber pcs[3], Lab1[3], Lab2[3], dE;
 
   m_nTotal = m_nDE1 = m_nDE2 = m_nDE3 = m_nDE5 = m_nDE10 = 0;
 
-  for (pcs[0]=0.0; pcs[0]<=1.0; pcs[0] += (icFloatNumber)0.01) {
-    for (pcs[1]=0.0; pcs[1]<=1.0; pcs[1] += (icFloatNumber)0.01) {
-      for (pcs[2]=0.0; pcs[2]<=1.0; pcs[2] += (icFloatNumber)0.01) {
-        memcpy(Lab1, pcs, 3*sizeof(icFloatNumber));
-        icLabFromPcs(Lab1);
-        if (InGamut(Lab1)) {
-          Lab2Dev2Lab.Apply(Lab2, pcs);
-          icLabFromPcs(Lab2);
-
-          dE = icDeltaE(Lab1, Lab2);
-          m_nTotal++;
-
-          if (dE<=1.0) {
-            m_nDE1++;
-            m_nDE2++;
-            m_nDE3++;
-            m_nDE5++;
-            m_nDE10++;
-          }
-          else if (dE<=2.0) {
-            m_nDE2++;
-            m_nDE3++;
-            m_nDE5++;
-            m_nDE10++;
-          }
-          else if (dE<=3.0) {
-            m_nDE3++;
-            m_nDE5++;
-            m_nDE10++;
-          }
-          else if (dE<=5.0) {
-            m_nDE5++;
-            m_nDE10++;
-          }
-          else if (dE<=10.0) {
-            m_nDE10++;
-          }
-        }
-      }
-    }
+  //Generate the PCS sample positions in the same way that each channel
+  //was originally stepped so that exactly the same samples are evaluated
+  icFloatNumber steps[128], v;
+  icUInt32Number nSteps = 0;
+  for (v=0.0; v<=1.0 && nSteps<128; v += (icFloatNumber)0.01) {
+    steps[nSteps++] = v;
+  }
+
+  nThreads = icGetNumThreads(nThreads);
+
+  CIccPRMGEvalTask task(this, steps, nSteps, nThreads);
+
+  result = task.Init(Lab2Dev2Lab);
+  if (result != icCmmStatOk) {
+    return result;
   }
 
+  if (!icParallelExecute(&task, nSteps*nSteps, 16, nThreads)) {
+    return icCmmStatBad;
+  }
+
+  task.GetCounts(m_nDE1, m_nDE2, m_nDE3, m_nDE5, m_nDE10, m_nTotal);
+
   return icCmmStatOk;
 }
 
 icStatusCMM CIccPRMG::EvaluateProfile(const icChar *szProfilePath, icRenderingIntent nIntent/* =icUnknownIntent */, 
-                                             icXformInterp nInterp/* =icInterpLinear */, bool buseMpeTags/* =true */)
+                                             icXformInterp nInterp/* =icInterpLinear */, bool buseMpeTags/* =true */,
+                                             icUInt32Number nThreads/* =0 */)
 {
   CIccProfile *pProfile = ReadIccProfile(szProfilePath);
 
   if (!pProfile) 
     return icCmmStatCantOpenProfile;
 
-  icStatusCMM result = EvaluateProfile(pProfile, nIntent, nInterp, buseMpeTags);
+  icStatusCMM result = EvaluateProfile(pProfile, nIntent, nInterp, buseMpeTags, nThreads);
 
   delete pProfile;
 
@@ -67,6 +67,9 @@ Copyright:  
 // -Oct 27, 2007 
 // Initial implementation of class CIccPRMG
 //
+// -Oct 19, 2026
+// Precomputed boundary grid and multi-threaded EvaluateProfile
+//
 //////////////////////////////////////////////////////////////////////
 
 #ifndef _ICCPRMG_H
@@ -88,10 +91,13 @@ public:
   bool InGamut(icFloatNumber *Lab);
   bool InGamut(icFloatNumber L, icFloatNumber c, icFloatNumber h);
 
+  ///nThreads is the number of evaluation threads to use (0 = one per processor)
   icStatusCMM EvaluateProfile(CIccProfile *pProfile, icRenderingIntent nIntent=icUnknownIntent, 
-                              icXformInterp nInterp=icInterpLinear, bool buseMpeTags=true);
+                              icXformInterp nInterp=icInterpLinear, bool buseMpeTags=true,
+                              icUInt32Number nThreads=0);
   icStatusCMM EvaluateProfile(const icChar *szProfilePath, icRenderingIntent nIntent=icUnknownIntent, 
-                              icXformInterp nInterp=icInterpLinear, bool buseMpeTags=true);
+                              icXformInterp nInterp=icInterpLinear, bool buseMpeTags=true,
+                              icUInt32Number nThreads=0);
 
   icUInt32Number m_nDE1, m_nDE2, m_nDE3, m_nDE5, m_nDE10, m_nTotal;
 
@@ -102,4 +108,4 @@ public:
 }
 #endif
 
-#endif
\ No newline at end of file
+#endif
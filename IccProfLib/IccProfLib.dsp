@@ -99,10 +99,18 @@ SOURCE=.\IccConvertUTF.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\IccDeviceLink.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\IccEval.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\IccGamutBoundary.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\IccIO.cpp
 # End Source File
 # Begin Source File
@@ -151,6 +159,14 @@ SOURCE=.\IccTagProfSeqId.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=.\IccThread.cpp
+# End Source File
+# Begin Source File
+
+SOURCE=.\IccPerf.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=.\IccUtil.cpp
 # End Source File
 # Begin Source File
@@ -179,6 +195,10 @@ SOURCE=.\IccConvertUTF.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\IccDeviceLink.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\IccDefs.h
 # End Source File
 # Begin Source File
@@ -187,6 +207,10 @@ SOURCE=.\IccEval.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\IccGamutBoundary.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\IccIO.h
 # End Source File
 # Begin Source File
@@ -243,6 +267,14 @@ SOURCE=.\IccTagProfSeqId.h
 # End Source File
 # Begin Source File
 
+SOURCE=.\IccThread.h
+# End Source File
+# Begin Source File
+
+SOURCE=.\IccPerf.h
+# End Source File
+# Begin Source File
+
 SOURCE=.\IccUtil.h
 # End Source File
 # Begin Source File
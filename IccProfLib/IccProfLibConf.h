@@ -156,6 +156,12 @@ namespace sampleICC {
 // remove comment below if you want LAB to XYZ conversions to not clip negative XYZ values
 #define SAMPLEICC_NOCLIPLABTOXYZ
 
+// remove comment below to build without multi-threaded evaluation (IccThread.h functions run serially)
+//#define ICC_NO_THREADS
+
+// remove comment below to collect apply chain performance counters (see IccPerf.h)
+//#define ICC_PERF_COUNTERS
+
 #ifdef SAMPLEICCCMM_EXPORTS
 #define MAKE_A_DLL
 #endif
@@ -65,6 +65,11 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Added parallel tag loading 10-19-2026
+// -Made on demand tag loading thread safe 10-19-2026
+// -Report on demand tag loads as setup phases 10-19-2026
+// -Added in memory and multi-threaded profile ID calculation 10-19-2026
+// -Added multi-threaded tag validation and fast validation 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -77,13 +82,35 @@
 #include "IccTag.h"
 #include "IccIO.h"
 #include "IccUtil.h"
+#include "IccTagFactory.h"
+#include "IccMpeFactory.h"
+#include "IccThread.h"
+#include "IccPerf.h"
 #include "md5.h"
+#include <algorithm>
 
 
 #ifdef USESAMPLEICCNAMESPACE
 namespace sampleICC {
 #endif
 
+/**
+ ******************************************************************************
+ * Name: icInitTagFactories
+ * 
+ * Purpose: Makes sure that the tag and element factory singletons exist so
+ *  that they aren't created by several threads at once.
+ *******************************************************************************
+ */
+static void icInitTagFactories()
+{
+  std::string sName;
+
+  CIccTagCreator::GetTagSigName(icSigAToB0Tag);
+  CIccMpeCreator::GetElementSigName(sName, icSigCurveSetElemType);
+}
+
+
 //////////////////////////////////////////////////////////////////////
 // Construction/Destruction
 //////////////////////////////////////////////////////////////////////
@@ -102,6 +129,9 @@ CIccProfile::CIccProfile()
   memset(&m_Header, 0, sizeof(m_Header));
   m_Tags = new(TagEntryList);
   m_TagVals = new(TagPtrList);
+  m_bParallelLoad = false;
+  m_nLoadThreads = 0;
+  m_nLoadMinTagSize = icParallelLoadMinTagSize;
 }
 
 /**
@@ -124,6 +154,9 @@ CIccProfile::CIccProfile(const CIccProfile &Profile)
   memset(&m_Header, 0, sizeof(m_Header));
   m_Tags = new(TagEntryList);
   m_TagVals = new(TagPtrList);
+  m_bParallelLoad = false;
+  m_nLoadThreads = 0;
+  m_nLoadMinTagSize = icParallelLoadMinTagSize;
   memcpy(&m_Header, &Profile.m_Header, sizeof(m_Header));
 
   if (!Profile.m_TagVals->empty()) {
@@ -264,6 +297,27 @@ void CIccProfile::Cleanup()
   memset(&m_Header, 0, sizeof(m_Header));
 }
 
+/**
+ ***************************************************************************
+ * Name: CIccProfile::SetParallelLoad
+ * 
+ * Purpose: Enables or disables decoding of large tags on multiple threads
+ *  when the profile is read.
+ * 
+ * Args: 
+ *  bParallel - true to decode large tags concurrently,
+ *  nThreads - number of threads to use (0 = one per processor),
+ *  nMinTagSize - tags smaller than this are decoded by the calling thread
+ ***************************************************************************
+ */
+void CIccProfile::SetParallelLoad(bool bParallel/*=true*/, icUInt32Number nThreads/*=0*/,
+                                  icUInt32Number nMinTagSize/*=icParallelLoadMinTagSize*/)
+{
+  m_bParallelLoad = bParallel;
+  m_nLoadThreads = nThreads;
+  m_nLoadMinTagSize = nMinTagSize;
+}
+
 /**
  ****************************************************************************
  * Name: CIccProfile::GetTag
@@ -367,14 +421,84 @@ CIccTag* CIccProfile::FindTag(icSignature sig)
   IccTagEntry *pEntry = GetTag(sig);
 
   if (pEntry) {
-    if (!pEntry->pTag && m_pAttachIO)
-      LoadTag(pEntry, m_pAttachIO);
+    if (m_pAttachIO)
+      return LoadTagOnce(pEntry);
     return pEntry->pTag;
   }
 
   return NULL;
 }
 
+/**
+ ******************************************************************************
+ * Name: CIccProfile::LoadTagOnce
+ * 
+ * Purpose: Loads the tag for a directory entry from the attached IO object
+ *  if it hasn't been loaded yet.  This can be called concurrently from
+ *  several threads.  Each tag is read through its own view of the attached
+ *  IO (see CIccIO::NewReadView) so different tags load in parallel, while
+ *  threads asking for a tag that is already being loaded wait for it instead
+ *  of reading it again.  IO objects that don't support views are read while
+ *  holding the profile's load lock.
+ * 
+ * Args: 
+ *  pTagEntry - pointer to tag directory entry
+ * 
+ * Return: 
+ *  The tag object, or NULL if it could not be loaded.
+ *******************************************************************************
+ */
+CIccTag* CIccProfile::LoadTagOnce(IccTagEntry *pTagEntry)
+{
+  icUInt32Number nOffset = pTagEntry->TagInfo.offset;
+  CIccTag *pTag;
+
+  m_loadMutex.Lock();
+
+  while (!pTagEntry->pTag &&
+         std::find(m_LoadingOffsets.begin(), m_LoadingOffsets.end(), nOffset)!=m_LoadingOffsets.end()) {
+    if (!m_loadCond.Wait(m_loadMutex))
+      break;
+  }
+
+  if (pTagEntry->pTag) {
+    pTag = pTagEntry->pTag;
+    m_loadMutex.Unlock();
+    return pTag;
+  }
+
+  CIccIO *pView = m_pAttachIO->NewReadView(nOffset, pTagEntry->TagInfo.size);
+
+  if (!pView) {
+    LoadTag(pTagEntry, m_pAttachIO);
+    pTag = pTagEntry->pTag;
+    m_loadMutex.Unlock();
+    return pTag;
+  }
+
+  m_LoadingOffsets.push_back(nOffset);
+  m_loadMutex.Unlock();
+
+  {
+    CIccSetupTimer setupTimer(icSetupTagLoad, -1, pTagEntry->TagInfo.sig);
+
+    setupTimer.SetBytes(pTagEntry->TagInfo.size);
+    pTag = ReadTagObject(pTagEntry, pView);
+  }
+  delete pView;
+
+  m_loadMutex.Lock();
+
+  m_LoadingOffsets.remove(nOffset);
+  if (pTag)
+    SetLoadedTag(pTagEntry, pTag);
+
+  m_loadCond.Broadcast();
+  m_loadMutex.Unlock();
+
+  return pTag;
+}
+
 /**
 ******************************************************************************
 * Name: CIccProfile::GetTagIO
@@ -406,8 +530,7 @@ CIccMemIO* CIccProfile::GetTagIO(icSignature sig)
       return NULL;
     }
 
-    m_pAttachIO->Seek(pEntry->TagInfo.offset, icSeekSet);
-    m_pAttachIO->Read8(pIO->GetData(), pIO->GetLength());
+    m_pAttachIO->ReadAt(pEntry->TagInfo.offset, pIO->GetData(), pIO->GetLength());
     return pIO;
   }
 
@@ -532,6 +655,9 @@ bool CIccProfile::Attach(CIccIO *pIO)
     return false;
   }
 
+  //Tags may be loaded on demand from several threads
+  icInitTagFactories();
+
   m_pAttachIO = pIO;
 
   return true;
@@ -587,19 +713,13 @@ bool CIccProfile::ReadTags(CIccProfile* pProfile)
 		return false;
 	}
 
-	TagEntryList::iterator i;
 	icUInt32Number pos = pIO->Tell();
 
-	for (i=m_Tags->begin(); i!=m_Tags->end(); i++) {
-		if (!LoadTag((IccTagEntry*)&(i->TagInfo), pIO)) {
-			pIO->Seek(pos, icSeekSet);
-			return false;
-		}
-	}
+	bool rv = LoadTags(pIO, true);
 
 	pIO->Seek(pos, icSeekSet);
 
-	return true;
+	return rv;
 }
 
 /**
@@ -628,13 +748,9 @@ bool CIccProfile::Read(CIccIO *pIO)
     return false;
   }
 
-  TagEntryList::iterator i;
-
-  for (i=m_Tags->begin(); i!=m_Tags->end(); i++) {
-    if (!LoadTag((IccTagEntry*)&(i->TagInfo), pIO)) {
-      Cleanup();
-      return false;
-    }
+  if (!LoadTags(pIO, true)) {
+    Cleanup();
+    return false;
   }
 
   return true;
@@ -651,12 +767,13 @@ bool CIccProfile::Read(CIccIO *pIO)
 *  pIO - pointer to IO object to read ICC profile from
 *  sReport - string to put validation report info into. String should be initialized
 *  before calling
+*  bFast - skip checks that scan all of the profile data (the profile ID check)
 * 
 * Return: 
 *  icValidateOK if file can be read, bad status otherwise.
 *******************************************************************************
 */
-icValidateStatus CIccProfile::ReadValidate(CIccIO *pIO, std::string &sReport)
+icValidateStatus CIccProfile::ReadValidate(CIccIO *pIO, std::string &sReport, bool bFast/*=false*/)
 {
   icValidateStatus rv = icValidateOK;
 
@@ -682,7 +799,7 @@ icValidateStatus CIccProfile::ReadValidate(CIccIO *pIO, std::string &sReport)
   icProfileID profileID;
 
   // Check profile ID
-  if (Info.IsProfileIDCalculated(&m_Header.profileID)) {
+  if (!bFast && Info.IsProfileIDCalculated(&m_Header.profileID)) {
     CalcProfileID(pIO, &profileID);
     if (strncmp((char*)profileID.ID8, (char*)m_Header.profileID.ID8, 16) != 0) {
       sReport += icValidateNonCompliantMsg;
@@ -694,8 +811,10 @@ icValidateStatus CIccProfile::ReadValidate(CIccIO *pIO, std::string &sReport)
 
   TagEntryList::iterator i;
 
+  LoadTags(pIO, false);
+
   for (i=m_Tags->begin(); i!=m_Tags->end(); i++) {
-    if (!LoadTag((IccTagEntry*)&(i->TagInfo), pIO)) {
+    if (!i->pTag) {
       sReport += icValidateCriticalErrorMsg;
       sReport += " - ";
       sReport += Info.GetTagSigName(i->TagInfo.sig);
@@ -986,36 +1105,65 @@ bool CIccProfile::LoadTag(IccTagEntry *pTagEntry, CIccIO *pIO)
   if (pTagEntry->pTag)
     return true;
 
+  CIccTag *pTag = ReadTagObject(pTagEntry, pIO);
+
+  if (!pTag)
+    return false;
+
+  SetLoadedTag(pTagEntry, pTag);
+
+  return true;
+}
+
+
+/**
+ ******************************************************************************
+ * Name: CIccProfile::ReadTagObject
+ * 
+ * Purpose: Creates a tag object and reads its data for a tag directory entry.
+ *  The profile is not modified so this can be called concurrently for
+ *  different entries as long as each call has its own IO object.
+ * 
+ * Args: 
+ *  pTagEntry - pointer to tag directory entry,
+ *  pIO - pointer to IO object to read tag object data from
+ * 
+ * Return: 
+ *  the new tag object, or NULL on failure
+ *******************************************************************************
+ */
+CIccTag *CIccProfile::ReadTagObject(const IccTagEntry *pTagEntry, CIccIO *pIO) const
+{
   if (pTagEntry->TagInfo.offset<sizeof(m_Header) ||
     !pTagEntry->TagInfo.size) {
-    return false;
+    return NULL;
   }
 
   icTagTypeSignature sigType;
 
   //First we need to get the tag type to create the right kind of tag
   if (pIO->Seek(pTagEntry->TagInfo.offset, icSeekSet)!=(icInt32Number)pTagEntry->TagInfo.offset)
-    return false;
+    return NULL;
 
   if (!pIO->Read32(&sigType))
-    return false;
+    return NULL;
 
   CIccTag *pTag = CIccTag::Create(sigType);
 
   if (!pTag)
-    return false;
+    return NULL;
 
   //Now seek back to where the tag starts so the created tag object can read
   //in its data.
   //First we need to get the tag type to create the right kind of tag
   if (pIO->Seek(pTagEntry->TagInfo.offset, icSeekSet)!=(icInt32Number)pTagEntry->TagInfo.offset) {
     delete pTag;
-    return false;
+    return NULL;
   }
 
   if (!pTag->Read(pTagEntry->TagInfo.size, pIO)) {
     delete pTag;
-    return false;
+    return NULL;
   }
 
   switch(pTagEntry->TagInfo.sig) {
@@ -1045,6 +1193,24 @@ bool CIccProfile::LoadTag(IccTagEntry *pTagEntry, CIccIO *pIO)
     break;
   }
 
+  return pTag;
+}
+
+
+/**
+ ******************************************************************************
+ * Name: CIccProfile::SetLoadedTag
+ * 
+ * Purpose: Associates a newly read tag object with a tag directory entry and
+ *  all other entries that share the same offset.
+ * 
+ * Args: 
+ *  pTagEntry - pointer to tag directory entry,
+ *  pTag - tag object read for the entry (now owned by the profile)
+ *******************************************************************************
+ */
+void CIccProfile::SetLoadedTag(IccTagEntry *pTagEntry, CIccTag *pTag)
+{
   pTagEntry->pTag = pTag;
 
   IccTagPtr TagPtr;
@@ -1060,8 +1226,224 @@ bool CIccProfile::LoadTag(IccTagEntry *pTagEntry, CIccIO *pIO)
         i->pTag != pTag)
       i->pTag = pTag; 
   }
-  
-  return true;
+}
+
+
+/**
+ ******************************************************************************
+ * Name: CIccProfile::LoadTags
+ * 
+ * Purpose: Loads all tag directory entries that don't have a tag object yet.
+ * 
+ * Args: 
+ *  pIO - pointer to IO object to read tag object data from,
+ *  bStopOnError - when loading serially stop at the first tag that fails
+ * 
+ * Return: 
+ *  true - all tag directory entries have a tag object,
+ *  false - one or more tags could not be loaded
+ *******************************************************************************
+ */
+bool CIccProfile::LoadTags(CIccIO *pIO, bool bStopOnError)
+{
+  if (m_bParallelLoad && m_Tags->size()>1 && icGetNumThreads(m_nLoadThreads)>1)
+    return LoadTagsParallel(pIO);
+
+  TagEntryList::iterator i;
+  bool rv = true;
+
+  for (i=m_Tags->begin(); i!=m_Tags->end(); i++) {
+    if (!LoadTag((IccTagEntry*)&(i->TagInfo), pIO)) {
+      rv = false;
+      if (bStopOnError)
+        break;
+    }
+  }
+
+  return rv;
+}
+
+
+/**
+ **************************************************************************
+ * Type: Class
+ * 
+ * Purpose: 
+ *  Parallel task used by CIccProfile::LoadTagsParallel to read tag objects.
+ *  Each tag is read through its own view of the profile data.
+ **************************************************************************
+ */
+class CIccTagLoadTask : public IIccParallelTask
+{
+public:
+  CIccTagLoadTask(const CIccProfile *pProfile, CIccIO *pIO, IccTagEntry **pEntries,
+                  CIccTag **pTags)
+  {
+    m_pProfile = pProfile;
+    m_pIO = pIO;
+    m_pEntries = pEntries;
+    m_pTags = pTags;
+  }
+
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)
+  {
+    for (icUInt32Number i=nStart; i<nEnd; i++) {
+      CIccIO *pView = m_pIO->NewReadView(m_pEntries[i]->TagInfo.offset, m_pEntries[i]->TagInfo.size);
+
+      if (pView) {
+        m_pTags[i] = m_pProfile->ReadTagObject(m_pEntries[i], pView);
+        delete pView;
+      }
+      else
+        m_pTags[i] = NULL;
+    }
+  }
+
+protected:
+  const CIccProfile *m_pProfile;
+  CIccIO *m_pIO;
+  IccTagEntry **m_pEntries;
+  CIccTag **m_pTags;
+};
+
+/**
+ **************************************************************************
+ * Type: Class
+ * 
+ * Purpose: 
+ *  Orders tag directory entries by decreasing size so that the largest tags
+ *  are started first when loading in parallel.
+ **************************************************************************
+ */
+class CIccTagSizeCompare
+{
+public:
+  bool operator()(const IccTagEntry *pEntry1, const IccTagEntry *pEntry2) const
+  {
+    return pEntry1->TagInfo.size > pEntry2->TagInfo.size;
+  }
+};
+
+/**
+ ******************************************************************************
+ * Name: CIccProfile::LoadTagsParallel
+ * 
+ * Purpose: Loads all tag directory entries that don't have a tag object yet,
+ *  decoding tags of at least m_nLoadMinTagSize bytes concurrently.  Entries
+ *  that share an offset still share a single tag object, and tag objects are
+ *  associated with the directory in the same order as a serial load.  Falls
+ *  back to a serial load if pIO doesn't support NewReadView().
+ * 
+ * Args: 
+ *  pIO - pointer to IO object to read tag object data from
+ * 
+ * Return: 
+ *  true - all tag directory entries have a tag object,
+ *  false - one or more tags could not be loaded
+ *******************************************************************************
+ */
+bool CIccProfile::LoadTagsParallel(CIccIO *pIO)
+{
+  icUInt32Number nEntries=0, nLarge=0, i, j;
+  IccTagEntry **pEntries = new IccTagEntry*[m_Tags->size()];
+  TagEntryList::iterator t;
+
+  //Find the distinct offsets that still need to be loaded
+  for (t=m_Tags->begin(); t!=m_Tags->end(); t++) {
+    IccTagEntry *pEntry = (IccTagEntry*)&(t->TagInfo);
+
+    if (pEntry->pTag)
+      continue;
+
+    for (j=0; j<nEntries; j++) {
+      if (pEntries[j]->TagInfo.offset==pEntry->TagInfo.offset)
+        break;
+    }
+    if (j<nEntries)
+      continue;
+
+    pEntries[nEntries++] = pEntry;
+    if (pEntry->TagInfo.size>=m_nLoadMinTagSize)
+      nLarge++;
+  }
+
+  icUInt32Number nThreads = icGetNumThreads(m_nLoadThreads);
+  if (nThreads>nLarge)
+    nThreads = nLarge;
+
+  bool bShared = false;
+
+  if (nThreads>1) {
+    CIccIO *pView = pIO->NewReadView();
+
+    if (pView) {
+      bShared = true;
+      delete pView;
+    }
+  }
+
+  if (!bShared) {
+    delete [] pEntries;
+
+    bool rv = true;
+
+    for (t=m_Tags->begin(); t!=m_Tags->end(); t++) {
+      if (!LoadTag((IccTagEntry*)&(t->TagInfo), pIO))
+        rv = false;
+    }
+    return rv;
+  }
+
+  //Large tags are moved to the front (largest first) for the worker threads
+  IccTagEntry **pOrder = new IccTagEntry*[nEntries];
+  CIccTag **pTags = new CIccTag*[nEntries];
+
+  for (i=0, j=0; i<nEntries; i++) {
+    if (pEntries[i]->TagInfo.size>=m_nLoadMinTagSize)
+      pOrder[j++] = pEntries[i];
+  }
+  std::stable_sort(pOrder, pOrder+nLarge, CIccTagSizeCompare());
+  for (i=0; i<nEntries; i++) {
+    if (pEntries[i]->TagInfo.size<m_nLoadMinTagSize)
+      pOrder[j++] = pEntries[i];
+  }
+
+  icInitTagFactories();
+
+  CIccTagLoadTask task(this, pIO, pOrder, pTags);
+
+  icParallelExecute(&task, nLarge, 1, nThreads);
+
+  //Small tags are read by the calling thread
+  for (i=nLarge; i<nEntries; i++) {
+    pTags[i] = ReadTagObject(pOrder[i], pIO);
+  }
+
+  //Associate the tag objects in directory order
+  bool rv = true;
+
+  for (t=m_Tags->begin(); t!=m_Tags->end(); t++) {
+    IccTagEntry *pEntry = (IccTagEntry*)&(t->TagInfo);
+
+    if (pEntry->pTag)
+      continue;
+
+    for (j=0; j<nEntries; j++) {
+      if (pOrder[j]==pEntry)
+        break;
+    }
+
+    if (j<nEntries && pTags[j])
+      SetLoadedTag(pEntry, pTags[j]);
+    else
+      rv = false;
+  }
+
+  delete [] pTags;
+  delete [] pOrder;
+  delete [] pEntries;
+
+  return rv;
 }
 
 
@@ -1828,6 +2210,41 @@ bool CIccProfile::CheckFileSize(CIccIO *pIO) const
 }
 
 
+/**
+ **************************************************************************
+ * Type: Class
+ * 
+ * Purpose: 
+ *  Parallel task that validates tags into separate reports so that they
+ *  can be merged in tag directory order.
+ **************************************************************************
+ */
+class CIccTagValidateTask : public IIccParallelTask
+{
+public:
+  CIccTagValidateTask(const CIccProfile *pProfile, IccTagEntry **pEntries,
+                      std::string *pReports, icValidateStatus *pStatus)
+  {
+    m_pProfile = pProfile;
+    m_pEntries = pEntries;
+    m_pReports = pReports;
+    m_pStatus = pStatus;
+  }
+
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)
+  {
+    for (icUInt32Number i=nStart; i<nEnd; i++) {
+      m_pStatus[i] = m_pEntries[i]->pTag->Validate(m_pEntries[i]->TagInfo.sig, m_pReports[i], m_pProfile);
+    }
+  }
+
+protected:
+  const CIccProfile *m_pProfile;
+  IccTagEntry **m_pEntries;
+  std::string *m_pReports;
+  icValidateStatus *m_pStatus;
+};
+
 /**
  ****************************************************************************
  * Name: CIccProfile::Validate
@@ -1836,13 +2253,14 @@ bool CIccProfile::CheckFileSize(CIccIO *pIO) const
  *  the ICC specification
  * 
  * Args:
- *  sReport = String to put report into
+ *  sReport = String to put report into,
+ *  nThreads = number of threads to validate tags on (0 = one per processor)
  * 
  * Return: 
  *  icValidateOK if profile is valid, warning/error level otherwise
  *****************************************************************************
  */
-icValidateStatus CIccProfile::Validate(std::string &sReport) const
+icValidateStatus CIccProfile::Validate(std::string &sReport, icUInt32Number nThreads/*=1*/) const
 {
   icValidateStatus rv = icValidateOK;
 
@@ -1861,9 +2279,31 @@ icValidateStatus CIccProfile::Validate(std::string &sReport) const
 
   // Per Tag tests
   rv = icMaxStatus(rv, CheckTagTypes(sReport));
-  TagEntryList::iterator i;
-  for (i=m_Tags->begin(); i!=m_Tags->end(); i++) {
-    rv = icMaxStatus(rv, i->pTag->Validate(i->TagInfo.sig, sReport, this));
+
+  icUInt32Number nTags = (icUInt32Number)m_Tags->size();
+  if (nTags) {
+    IccTagEntry **pEntries = new IccTagEntry*[nTags];
+    std::string *pReports = new std::string[nTags];
+    icValidateStatus *pStatus = new icValidateStatus[nTags];
+    TagEntryList::iterator i;
+    icUInt32Number n;
+
+    for (n=0, i=m_Tags->begin(); i!=m_Tags->end(); i++, n++)
+      pEntries[n] = &(*i);
+
+    CIccTagValidateTask task(this, pEntries, pReports, pStatus);
+
+    icParallelExecute(&task, nTags, 1, nThreads);
+
+    //Merge in tag directory order
+    for (n=0; n<nTags; n++) {
+      sReport += pReports[n];
+      rv = icMaxStatus(rv, pStatus[n]);
+    }
+
+    delete [] pStatus;
+    delete [] pReports;
+    delete [] pEntries;
   }
 
   return rv;
@@ -2170,12 +2610,15 @@ CIccProfile* OpenIccProfile(const icUInt8Number *pMem, icUInt32Number nSize)
 *  pIO - Handle to IO access object (Not ValidateIccProfile assumes ownership of this object)
 *  sReport - std::string to put report into
 *  nStatus - return status value
+*  nThreads - number of threads to validate tags on (0 = one per processor)
+*  bFast - skip checks that scan all of the profile data
 * 
 * Return: 
 *  Pointer to icc profile object, or NULL on failure
 *******************************************************************************
 */
-CIccProfile* ValidateIccProfile(CIccIO *pIO, std::string &sReport, icValidateStatus &nStatus)
+CIccProfile* ValidateIccProfile(CIccIO *pIO, std::string &sReport, icValidateStatus &nStatus,
+                                icUInt32Number nThreads/*=1*/, bool bFast/*=false*/)
 {
   if (!pIO) {
     sReport = icValidateCriticalErrorMsg;
@@ -2192,7 +2635,7 @@ CIccProfile* ValidateIccProfile(CIccIO *pIO, std::string &sReport, icValidateSta
     return NULL;
   }
 
-  nStatus = pIcc->ReadValidate(pIO, sReport);
+  nStatus = pIcc->ReadValidate(pIO, sReport, bFast);
 
   if (nStatus>=icValidateCriticalError) {
     delete pIcc;
@@ -2202,7 +2645,7 @@ CIccProfile* ValidateIccProfile(CIccIO *pIO, std::string &sReport, icValidateSta
 
   delete pIO;
 
-  nStatus = pIcc->Validate(sReport);
+  nStatus = pIcc->Validate(sReport, nThreads);
 
   return pIcc;
 }
@@ -2220,12 +2663,15 @@ CIccProfile* ValidateIccProfile(CIccIO *pIO, std::string &sReport, icValidateSta
 *  szFilename - zero terminated string with filename of ICC profile to read 
 *  sReport - std::string to put report into
 *  nStatus - return status value
+*  nThreads - number of threads to validate tags on (0 = one per processor)
+*  bFast - skip checks that scan all of the profile data
 * 
 * Return: 
 *  Pointer to icc profile object, or NULL on failure
 *******************************************************************************
 */
-CIccProfile* ValidateIccProfile(const icWChar *szFilename, std::string &sReport, icValidateStatus &nStatus)
+CIccProfile* ValidateIccProfile(const icWChar *szFilename, std::string &sReport, icValidateStatus &nStatus,
+                                icUInt32Number nThreads/*=1*/, bool bFast/*=false*/)
 {
   CIccFileIO *pFileIO = new CIccFileIO;
 
@@ -2234,7 +2680,7 @@ CIccProfile* ValidateIccProfile(const icWChar *szFilename, std::string &sReport,
     return NULL;
   }
 
-  return ValidateIccProfile(pFileIO, sReport, nStatus);
+  return ValidateIccProfile(pFileIO, sReport, nStatus, nThreads, bFast);
 }
 #endif
 
@@ -2251,12 +2697,15 @@ CIccProfile* ValidateIccProfile(const icWChar *szFilename, std::string &sReport,
 *  szFilename - zero terminated string with filename of ICC profile to read 
 *  sReport - std::string to put report into
 *  nStatus - return status value
+*  nThreads - number of threads to validate tags on (0 = one per processor)
+*  bFast - skip checks that scan all of the profile data
 * 
 * Return: 
 *  Pointer to icc profile object, or NULL on failure
 *******************************************************************************
 */
-CIccProfile* ValidateIccProfile(const icChar *szFilename, std::string &sReport, icValidateStatus &nStatus)
+CIccProfile* ValidateIccProfile(const icChar *szFilename, std::string &sReport, icValidateStatus &nStatus,
+                                icUInt32Number nThreads/*=1*/, bool bFast/*=false*/)
 {
   CIccFileIO *pFileIO = new CIccFileIO;
 
@@ -2276,7 +2725,7 @@ CIccProfile* ValidateIccProfile(const icChar *szFilename, std::string &sReport,
     return NULL;
   }
 
-  nStatus = pIcc->ReadValidate(pFileIO, sReport);
+  nStatus = pIcc->ReadValidate(pFileIO, sReport, bFast);
 
   if (nStatus>=icValidateCriticalError) {
     delete pIcc;
@@ -2286,7 +2735,7 @@ CIccProfile* ValidateIccProfile(const icChar *szFilename, std::string &sReport,
 
   delete pFileIO;
 
-  nStatus = pIcc->Validate(sReport);
+  nStatus = pIcc->Validate(sReport, nThreads);
 
   return pIcc;
 }
@@ -2375,6 +2824,13 @@ void CalcProfileID(CIccIO *pIO, icProfileID *pProfileID)
   MD5_CTX context;
   icUInt8Number buffer[1024];
 
+  //Hash memory based data in place
+  const icUInt8Number *pData = pIO->GetDirectData();
+  if (pData) {
+    CalcProfileID(pData, pIO->GetLength(), pProfileID);
+    return;
+  }
+
   //remember where we are
   pos = pIO->Tell();
 
@@ -2387,6 +2843,8 @@ void CalcProfileID(CIccIO *pIO, icProfileID *pProfileID)
   nBlock = 0;
   while(len) {
     num = pIO->Read8(&buffer[0],1024);
+    if ((icInt32Number)num<=0)
+      break;
     if (!nBlock) {  // Zero out 3 header contents in Profile ID calculation
       memset(buffer+44, 0, 4); //Profile flags
       memset(buffer+64, 0, 4);  //Rendering Intent
@@ -2402,6 +2860,39 @@ void CalcProfileID(CIccIO *pIO, icProfileID *pProfileID)
   pIO->Seek(pos, icSeekSet);
 }
 
+/**
+ ****************************************************************************
+ * Name: CalcProfileID
+ * 
+ * Purpose: Calculate the Profile ID using MD5 Fingerprinting method directly
+ *  over profile data in memory.  Only the header is copied (to zero out the
+ *  fields that are excluded from the Profile ID).
+ * 
+ * Args: 
+ *  pData = the profile data,
+ *  nSize = number of bytes of profile data,
+ *  pProfileID = array where the profileID will be stored
+ *
+ ****************************************************************************
+ */
+void CalcProfileID(const icUInt8Number *pData, icUInt32Number nSize, icProfileID *pProfileID)
+{
+  MD5_CTX context;
+  icUInt8Number header[128];
+  icUInt32Number nHeader = nSize<sizeof(header) ? nSize : (icUInt32Number)sizeof(header);
+
+  memcpy(header, pData, nHeader);
+  memset(header+44, 0, 4); //Profile flags
+  memset(header+64, 0, 4);  //Rendering Intent
+  memset(header+84, 0, 16); //Profile Id
+
+  icMD5Init(&context);
+  icMD5Update(&context, header, nHeader);
+  if (nSize>nHeader)
+    icMD5Update(&context, (icUInt8Number*)pData+nHeader, nSize-nHeader);
+  icMD5Final(&pProfileID->ID8[0],&context);
+}
+
 /**
  ****************************************************************************
  * Name: CalcProfileID
@@ -2415,6 +2906,13 @@ void CalcProfileID(CIccIO *pIO, icProfileID *pProfileID)
  */
 bool CalcProfileID(const icChar *szFilename, icProfileID *pProfileID)
 {
+  CIccMappedFileIO MappedIO;
+
+  if (MappedIO.Open(szFilename)) {
+    CalcProfileID(&MappedIO, pProfileID);
+    return true;
+  }
+
   CIccFileIO FileIO;
 
   if (!FileIO.Open(szFilename, "rb")) {
@@ -2440,6 +2938,13 @@ bool CalcProfileID(const icChar *szFilename, icProfileID *pProfileID)
 */
 bool CalcProfileID(const icWChar *szFilename, icProfileID *pProfileID)
 {
+  CIccMappedFileIO MappedIO;
+
+  if (MappedIO.Open(szFilename)) {
+    CalcProfileID(&MappedIO, pProfileID);
+    return true;
+  }
+
   CIccFileIO FileIO;
 
   if (!FileIO.Open(szFilename, L"rb")) {
@@ -2452,6 +2957,78 @@ bool CalcProfileID(const icWChar *szFilename, icProfileID *pProfileID)
 }
 #endif
 
+/**
+ **************************************************************************
+ * Type: Class
+ * 
+ * Purpose: 
+ *  Parallel task that calculates the profile IDs of a list of files
+ **************************************************************************
+ */
+class CIccProfileIDTask : public IIccParallelTask
+{
+public:
+  CIccProfileIDTask(const icChar * const *szFilenames, icProfileID *pProfileIDs, bool *pOk)
+  {
+    m_szFilenames = szFilenames;
+    m_pProfileIDs = pProfileIDs;
+    m_pOk = pOk;
+  }
+
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)
+  {
+    for (icUInt32Number i=nStart; i<nEnd; i++) {
+      m_pOk[i] = CalcProfileID(m_szFilenames[i], &m_pProfileIDs[i]);
+    }
+  }
+
+protected:
+  const icChar * const *m_szFilenames;
+  icProfileID *m_pProfileIDs;
+  bool *m_pOk;
+};
+
+/**
+ ****************************************************************************
+ * Name: CalcProfileIDs
+ * 
+ * Purpose: Calculate the Profile IDs of several files concurrently using
+ *  the MD5 Fingerprinting method.
+ * 
+ * Args: 
+ *  szFileNames = names of the files whose profile IDs have to be calculated,
+ *  nFiles = number of files,
+ *  pProfileIDs = array of nFiles profileIDs where the results will be stored,
+ *  nThreads = number of threads to use (0 uses all processors)
+ * 
+ * Return: 
+ *  true if the profile IDs of all of the files were calculated
+ *****************************************************************************
+ */
+bool CalcProfileIDs(const icChar * const *szFilenames, icUInt32Number nFiles,
+                    icProfileID *pProfileIDs, icUInt32Number nThreads/*=0*/)
+{
+  if (!nFiles)
+    return true;
+
+  bool *pOk = new bool[nFiles];
+  icUInt32Number i;
+  bool rv = true;
+
+  CIccProfileIDTask task(szFilenames, pProfileIDs, pOk);
+
+  icParallelExecute(&task, nFiles, 1, nThreads);
+
+  for (i=0; i<nFiles; i++) {
+    if (!pOk[i])
+      rv = false;
+  }
+
+  delete [] pOk;
+
+  return rv;
+}
+
 
 #ifdef USESAMPLEICCNAMESPACE
 } //namespace sampleICC
@@ -65,6 +65,10 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Added parallel tag loading 10-19-2026
+// -Made on demand tag loading thread safe 10-19-2026
+// -Added in memory and multi-threaded profile ID calculation 10-19-2026
+// -Added multi-threaded tag validation and fast validation 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -72,6 +76,7 @@
 #define _ICCPROFILE_H
 
 #include "IccDefs.h"
+#include "IccThread.h"
 #include <list>
 #include <string>
 
@@ -134,6 +139,9 @@ typedef enum {
   icNeverWriteID,
 }icProfileIDSaveMethod;
 
+///Default minimum tag size (in bytes) for a tag to be decoded on a worker thread when parallel loading
+#define icParallelLoadMinTagSize 16384
+
 /**
  **************************************************************************
  * Type: Class
@@ -155,6 +163,7 @@ public:
 
   TagEntryList *m_Tags;
 
+  ///Tags of a profile opened with Attach() are loaded on first use, which is safe to do from several threads at once
   CIccTag* FindTag(icSignature sig);
   bool AttachTag(icSignature sig, CIccTag *pTag);
   bool DeleteTag(icSignature sig);
@@ -164,17 +173,27 @@ public:
   bool Attach(CIccIO *pIO);
   bool Detach();
   bool Read(CIccIO *pIO);
-  icValidateStatus ReadValidate(CIccIO *pIO, std::string &sReport);
+  ///bFast skips checks that scan all of the profile's data (the profile ID check)
+  icValidateStatus ReadValidate(CIccIO *pIO, std::string &sReport, bool bFast=false);
   bool Write(CIccIO *pIO, icProfileIDSaveMethod nWriteId=icVersionBasedID);
 
   void InitHeader();
-  icValidateStatus Validate(std::string &sReport) const;
+  ///Tags are validated on nThreads threads (0 = one per processor).  Tag reports
+  ///are merged in tag directory order so the report doesn't depend on nThreads.
+  icValidateStatus Validate(std::string &sReport, icUInt32Number nThreads=1) const;
 
   icUInt16Number GetSpaceSamples() const;
 
   bool AreTagsUnique() const;
 	bool IsTagPresent(icSignature sig) const { return (GetTag(sig)!=NULL); }
 
+  ///When enabled, Read(), ReadTags() and ReadValidate() decode tags of at least nMinTagSize bytes
+  ///on nThreads threads (0 = one per processor).  This requires an IO object that supports
+  ///NewReadView() (such as CIccMemIO); tags are loaded serially otherwise.
+  void SetParallelLoad(bool bParallel=true, icUInt32Number nThreads=0,
+                       icUInt32Number nMinTagSize=icParallelLoadMinTagSize);
+  bool GetParallelLoad() const { return m_bParallelLoad; }
+
 protected:
 
   void Cleanup();
@@ -182,6 +201,11 @@ protected:
   IccTagEntry* GetTag(CIccTag *pTag) const;
   bool ReadBasic(CIccIO *pIO);
   bool LoadTag(IccTagEntry *pTagEntry, CIccIO *pIO);
+  CIccTag* LoadTagOnce(IccTagEntry *pTagEntry);
+  bool LoadTags(CIccIO *pIO, bool bStopOnError);
+  bool LoadTagsParallel(CIccIO *pIO);
+  CIccTag *ReadTagObject(const IccTagEntry *pTagEntry, CIccIO *pIO) const;
+  void SetLoadedTag(IccTagEntry *pTagEntry, CIccTag *pTag);
   bool DetachTag(CIccTag *pTag);
 
   // Profile Validation functions
@@ -195,6 +219,17 @@ protected:
   CIccIO *m_pAttachIO;
 
   TagPtrList *m_TagVals;
+
+  bool m_bParallelLoad;
+  icUInt32Number m_nLoadThreads;
+  icUInt32Number m_nLoadMinTagSize;
+
+  //Serializes on demand loading of tags from m_pAttachIO
+  CIccMutex m_loadMutex;
+  CIccCondition m_loadCond;
+  std::list<icUInt32Number> m_LoadingOffsets;
+
+  friend class CIccTagLoadTask;
 };
 
 CIccProfile ICCPROFLIB_API *ReadIccProfile(const icChar *szFilename);
@@ -202,18 +237,27 @@ CIccProfile ICCPROFLIB_API *ReadIccProfile(const icUInt8Number *pMem, icUInt32Nu
 CIccProfile ICCPROFLIB_API *OpenIccProfile(const icChar *szFilename);
 CIccProfile ICCPROFLIB_API *OpenIccProfile(const icUInt8Number *pMem, icUInt32Number nSize);  //pMem must be available for entire life of returned CIccProfile Object
 
-CIccProfile ICCPROFLIB_API *ValidateIccProfile(CIccIO *pIO, std::string &sReport, icValidateStatus &nStatus);
-CIccProfile ICCPROFLIB_API *ValidateIccProfile(const icChar *szFilename, std::string &sReport, icValidateStatus &nStatus);
+CIccProfile ICCPROFLIB_API *ValidateIccProfile(CIccIO *pIO, std::string &sReport, icValidateStatus &nStatus,
+                                               icUInt32Number nThreads=1, bool bFast=false);
+CIccProfile ICCPROFLIB_API *ValidateIccProfile(const icChar *szFilename, std::string &sReport, icValidateStatus &nStatus,
+                                               icUInt32Number nThreads=1, bool bFast=false);
 
 bool ICCPROFLIB_API SaveIccProfile(const icChar *szFilename, CIccProfile *pIcc, icProfileIDSaveMethod nWriteId=icVersionBasedID);
 
 void ICCPROFLIB_API CalcProfileID(CIccIO *pIO, icProfileID *profileID);
+void ICCPROFLIB_API CalcProfileID(const icUInt8Number *pData, icUInt32Number nSize, icProfileID *profileID);
 bool ICCPROFLIB_API CalcProfileID(const icChar *szFilename, icProfileID *profileID);
 
+//Calculates the profile IDs of nFiles files using nThreads threads (0 = all processors).
+//Returns false if any file couldn't be read (its profile ID is set to zeros).
+bool ICCPROFLIB_API CalcProfileIDs(const icChar * const *szFilenames, icUInt32Number nFiles,
+                                   icProfileID *profileIDs, icUInt32Number nThreads=0);
+
 #if defined(WIN32) || defined(WIN64)
 CIccProfile ICCPROFLIB_API *ReadIccProfile(const icWChar *szFilename);
 CIccProfile ICCPROFLIB_API *OpenIccProfile(const icWChar *szFilename);
-CIccProfile ICCPROFLIB_API *ValidateIccProfile(const icWChar *szFilename, std::string &sReport, icValidateStatus &nStatus);
+CIccProfile ICCPROFLIB_API *ValidateIccProfile(const icWChar *szFilename, std::string &sReport, icValidateStatus &nStatus,
+                                               icUInt32Number nThreads=1, bool bFast=false);
 bool ICCPROFLIB_API SaveIccProfile(const icWChar *szFilename, CIccProfile *pIcc, icProfileIDSaveMethod nWriteId=icVersionBasedID);
 bool ICCPROFLIB_API CalcProfileID(const icWChar *szFilename, icProfileID *profileID);
 #endif
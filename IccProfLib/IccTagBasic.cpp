@@ -65,6 +65,10 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Added spatial indexes for CIccTagNamedColor2 color lookups 10-19-2026
+// -Added hashed name lookups for CIccTagNamedColor2 10-19-2026
+// -Added non allocating CIccTagNamedColor2::GetColorName 10-19-2026
+// -Added IIccDescribeSink for streaming tag descriptions 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -76,14 +80,15 @@
 #include <math.h>
 #include <string.h>
 #include <stdlib.h>
+#include <ctype.h>
 #include "IccTag.h"
 #include "IccUtil.h"
 #include "IccProfile.h"
 #include "IccTagFactory.h"
 #include "IccConvertUTF.h"
 
-#ifndef __min
 #include <algorithm>
+#ifndef __min
 using std::min;
 #define __min min
 #endif
@@ -119,6 +124,115 @@ CIccTag::~CIccTag()
 
 }
 
+/**
+ ****************************************************************************
+ * Name: CIccTag::DescribeTo
+ * 
+ * Purpose: Streams the tag's description to a sink.  Describes the tag
+ *  into a string and appends it for tags that do not override this.
+ * 
+ * Args: 
+ *  pSink = sink that receives the description text
+ *****************************************************************************
+ */
+void CIccTag::DescribeTo(IIccDescribeSink *pSink)
+{
+  std::string sDescription;
+
+  Describe(sDescription);
+  pSink->Append(sDescription.c_str(), sDescription.size());
+}
+
+/**
+ ****************************************************************************
+ * Name: IIccDescribeSink::AppendText
+ * 
+ * Purpose: Appends a null terminated string
+ *****************************************************************************
+ */
+void IIccDescribeSink::AppendText(const icChar *szText)
+{
+  Append(szText, strlen(szText));
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDescribeFileSink::CIccDescribeFileSink
+ * 
+ * Purpose: Constructor
+ * 
+ * Args: 
+ *  f = file to write the description to,
+ *  nMaxGridPoints = largest number of CLUT grid points to describe (0 for all),
+ *  nBufSize = size of the write buffer
+ *****************************************************************************
+ */
+CIccDescribeFileSink::CIccDescribeFileSink(FILE *f, icUInt32Number nMaxGridPoints/*=0*/, size_t nBufSize/*=65536*/)
+{
+  m_f = f;
+  m_nMaxGridPoints = nMaxGridPoints;
+  m_nBufSize = nBufSize ? nBufSize : 1;
+  m_pBuf = new icChar[m_nBufSize];
+  m_nUsed = 0;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDescribeFileSink::~CIccDescribeFileSink
+ * 
+ * Purpose: Destructor (writes any buffered text)
+ *****************************************************************************
+ */
+CIccDescribeFileSink::~CIccDescribeFileSink()
+{
+  Flush();
+  delete [] m_pBuf;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDescribeFileSink::Append
+ * 
+ * Purpose: Buffers text, writing the buffer to the file as it fills
+ *****************************************************************************
+ */
+void CIccDescribeFileSink::Append(const icChar *szText, size_t nLen)
+{
+  if (m_nUsed + nLen > m_nBufSize) {
+    Flush();
+
+    if (nLen > m_nBufSize) {
+      fwrite(szText, 1, nLen, m_f);
+      return;
+    }
+  }
+
+  memcpy(m_pBuf+m_nUsed, szText, nLen);
+  m_nUsed += nLen;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDescribeFileSink::Flush
+ * 
+ * Purpose: Writes the buffered text to the file
+ * 
+ * Return: 
+ *  true if all of the text was written
+ *****************************************************************************
+ */
+bool CIccDescribeFileSink::Flush()
+{
+  bool rv = true;
+
+  if (m_nUsed) {
+    rv = fwrite(m_pBuf, 1, m_nUsed, m_f)==m_nUsed;
+    m_nUsed = 0;
+  }
+
+  return rv;
+}
+
 /**
  ****************************************************************************
  * Name: CIccTag::Create
@@ -1385,6 +1499,450 @@ icValidateStatus CIccTagSignature::Validate(icTagSignature sig, std::string &sRe
   return rv;
 }
 
+//Named color tables smaller than this are searched linearly
+#define icNamedIndexMinSize   32
+
+//Number of points searched linearly at the leaves of a CIccNamedColorIndex
+#define icNamedIndexLeafSize  8
+
+/**
+ ****************************************************************************
+ * Name: icNamedColorDist
+ * 
+ * Purpose: Euclidean distance between two points.  The summation order
+ *  matches icDeltaE() so that indexed and linear searches agree exactly.
+ *****************************************************************************
+ */
+static inline icFloatNumber icNamedColorDist(const icFloatNumber *p1, const icFloatNumber *p2, icUInt32Number nDim)
+{
+  icFloatNumber d, dSum = 0.0;
+
+  for (icUInt32Number j=0; j<nDim; j++) {
+    d = p1[j] - p2[j];
+    dSum += d*d;
+  }
+
+  return (icFloatNumber)sqrt(dSum);
+}
+
+/**
+****************************************************************************
+* Class: CIccNamedColorIndex
+* 
+* Purpose: A k-d tree over a set of points used by CIccTagNamedColor2 to
+*  find the nearest named color entry.  The tree is stored implicitly: the
+*  node for the range [lo,hi) is the point at (lo+hi)/2, with the lower
+*  half of the range to its left and the upper half to its right.
+****************************************************************************
+*/
+class CIccNamedColorIndex
+{
+public:
+  CIccNamedColorIndex();
+  ~CIccNamedColorIndex();
+
+  bool Build(const icFloatNumber *pPoints, icUInt32Number nStride, icUInt32Number nPoints, icUInt32Number nDim);
+
+  icInt32Number FindNearest(const icFloatNumber *pPoint, icFloatNumber &dDist) const;
+
+protected:
+  void BuildNode(icUInt32Number nLo, icUInt32Number nHi);
+  void SearchNode(icUInt32Number nLo, icUInt32Number nHi, const icFloatNumber *pPoint,
+                  icFloatNumber &dBest, icInt32Number &nBest) const;
+
+  const icFloatNumber *Point(icUInt32Number i) const { return m_pCoords + i*m_nDim; }
+
+  icFloatNumber *m_pCoords; //Points in tree order
+  icInt32Number *m_pIndex;  //Entry index of each point in tree order
+  icUInt8Number *m_pAxis;   //Split axis of each node
+  icUInt32Number m_nPoints;
+  icUInt32Number m_nDim;
+
+  //Build time only
+  const icFloatNumber *m_pSrc;
+  icUInt32Number m_nStride;
+};
+
+/**
+****************************************************************************
+* Class: CIccNamedIndexCompare
+* 
+* Purpose: Orders entry indexes by one coordinate for std::nth_element
+****************************************************************************
+*/
+class CIccNamedIndexCompare
+{
+public:
+  CIccNamedIndexCompare(const icFloatNumber *pSrc, icUInt32Number nStride, icUInt32Number nAxis) :
+    m_pSrc(pSrc), m_nStride(nStride), m_nAxis(nAxis) {}
+
+  bool operator()(icInt32Number a, icInt32Number b) const
+  {
+    icFloatNumber va = m_pSrc[a*m_nStride + m_nAxis], vb = m_pSrc[b*m_nStride + m_nAxis];
+    return va<vb || (va==vb && a<b);
+  }
+
+protected:
+  const icFloatNumber *m_pSrc;
+  icUInt32Number m_nStride;
+  icUInt32Number m_nAxis;
+};
+
+CIccNamedColorIndex::CIccNamedColorIndex()
+{
+  m_pCoords = NULL;
+  m_pIndex = NULL;
+  m_pAxis = NULL;
+  m_nPoints = 0;
+  m_nDim = 0;
+  m_pSrc = NULL;
+  m_nStride = 0;
+}
+
+CIccNamedColorIndex::~CIccNamedColorIndex()
+{
+  if (m_pCoords)
+    delete [] m_pCoords;
+  if (m_pIndex)
+    delete [] m_pIndex;
+  if (m_pAxis)
+    delete [] m_pAxis;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccNamedColorIndex::Build
+ * 
+ * Purpose: Builds the tree over a set of points
+ * 
+ * Args:
+ *  pPoints = first coordinate of first point,
+ *  nStride = number of icFloatNumbers between successive points,
+ *  nPoints = number of points,
+ *  nDim = number of coordinates per point
+ *
+ * Return: 
+ *  true if successful, false if failure
+ *****************************************************************************
+ */
+bool CIccNamedColorIndex::Build(const icFloatNumber *pPoints, icUInt32Number nStride,
+                                icUInt32Number nPoints, icUInt32Number nDim)
+{
+  if (!nPoints || !nDim || nDim>255)
+    return false;
+
+  m_pCoords = new icFloatNumber[nPoints*nDim];
+  m_pIndex = new icInt32Number[nPoints];
+  m_pAxis = new icUInt8Number[nPoints];
+  if (!m_pCoords || !m_pIndex || !m_pAxis)
+    return false;
+
+  m_nPoints = nPoints;
+  m_nDim = nDim;
+  m_pSrc = pPoints;
+  m_nStride = nStride;
+
+  icUInt32Number i, j;
+  for (i=0; i<nPoints; i++)
+    m_pIndex[i] = (icInt32Number)i;
+
+  BuildNode(0, nPoints);
+
+  for (i=0; i<nPoints; i++) {
+    const icFloatNumber *pSrc = pPoints + m_pIndex[i]*nStride;
+    icFloatNumber *pDst = m_pCoords + i*nDim;
+    for (j=0; j<nDim; j++)
+      pDst[j] = pSrc[j];
+  }
+
+  m_pSrc = NULL;
+
+  return true;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccNamedColorIndex::BuildNode
+ * 
+ * Purpose: Partitions the range [nLo,nHi) about its median along the axis
+ *  of greatest spread, then recurses into both halves.
+ *****************************************************************************
+ */
+void CIccNamedColorIndex::BuildNode(icUInt32Number nLo, icUInt32Number nHi)
+{
+  if (nHi - nLo <= icNamedIndexLeafSize)
+    return;
+
+  icUInt32Number i, j, nAxis = 0;
+  icFloatNumber dSpread = -1.0;
+
+  for (j=0; j<m_nDim; j++) {
+    icFloatNumber vMin, vMax, v;
+    vMin = vMax = m_pSrc[m_pIndex[nLo]*m_nStride + j];
+    for (i=nLo+1; i<nHi; i++) {
+      v = m_pSrc[m_pIndex[i]*m_nStride + j];
+      if (v<vMin)
+        vMin = v;
+      else if (v>vMax)
+        vMax = v;
+    }
+    if (vMax - vMin > dSpread) {
+      dSpread = vMax - vMin;
+      nAxis = j;
+    }
+  }
+
+  icUInt32Number nMid = (nLo + nHi) / 2;
+
+  std::nth_element(m_pIndex+nLo, m_pIndex+nMid, m_pIndex+nHi, CIccNamedIndexCompare(m_pSrc, m_nStride, nAxis));
+  m_pAxis[nMid] = (icUInt8Number)nAxis;
+
+  BuildNode(nLo, nMid);
+  BuildNode(nMid+1, nHi);
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccNamedColorIndex::FindNearest
+ * 
+ * Purpose: Finds the point closest to pPoint.  When several points are
+ *  equally close the one with the lowest entry index is returned, which
+ *  is the same result as a first to last linear search.
+ * 
+ * Args:
+ *  pPoint = point to search for,
+ *  dDist = receives the distance to the closest point
+ *
+ * Return: 
+ *  entry index of the closest point, or -1 if the index is empty
+ *****************************************************************************
+ */
+icInt32Number CIccNamedColorIndex::FindNearest(const icFloatNumber *pPoint, icFloatNumber &dDist) const
+{
+  icInt32Number nBest = -1;
+
+  dDist = 0.0;
+  if (!m_nPoints)
+    return -1;
+
+  dDist = icNamedColorDist(pPoint, Point(0), m_nDim);
+  nBest = m_pIndex[0];
+
+  SearchNode(0, m_nPoints, pPoint, dDist, nBest);
+
+  return nBest;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccNamedColorIndex::SearchNode
+ * 
+ * Purpose: Recursive part of FindNearest().  The far side of a split is
+ *  only skipped when its plane is clearly farther than the best distance
+ *  so far, which keeps ties and rounding from changing the result.
+ *****************************************************************************
+ */
+void CIccNamedColorIndex::SearchNode(icUInt32Number nLo, icUInt32Number nHi, const icFloatNumber *pPoint,
+                                     icFloatNumber &dBest, icInt32Number &nBest) const
+{
+  icFloatNumber d;
+
+  if (nHi - nLo <= icNamedIndexLeafSize) {
+    for (icUInt32Number i=nLo; i<nHi; i++) {
+      d = icNamedColorDist(pPoint, Point(i), m_nDim);
+      if (d<dBest || (d==dBest && m_pIndex[i]<nBest)) {
+        dBest = d;
+        nBest = m_pIndex[i];
+      }
+    }
+    return;
+  }
+
+  icUInt32Number nMid = (nLo + nHi) / 2;
+  icUInt32Number nAxis = m_pAxis[nMid];
+  icFloatNumber dPlane = pPoint[nAxis] - Point(nMid)[nAxis];
+
+  d = icNamedColorDist(pPoint, Point(nMid), m_nDim);
+  if (d<dBest || (d==dBest && m_pIndex[nMid]<nBest)) {
+    dBest = d;
+    nBest = m_pIndex[nMid];
+  }
+
+  if (dPlane<0) {
+    SearchNode(nLo, nMid, pPoint, dBest, nBest);
+    if (-dPlane <= dBest*1.0001f + 1.0e-6f)
+      SearchNode(nMid+1, nHi, pPoint, dBest, nBest);
+  }
+  else {
+    SearchNode(nMid+1, nHi, pPoint, dBest, nBest);
+    if (dPlane <= dBest*1.0001f + 1.0e-6f)
+      SearchNode(nLo, nMid, pPoint, dBest, nBest);
+  }
+}
+
+
+/**
+ ****************************************************************************
+ * Name: icNamedRootMatch
+ * 
+ * Purpose: Compares the first nLen characters of szName to a null
+ *  terminated root name.  bNoCase gives the same matching as stricmp().
+ *****************************************************************************
+ */
+static bool icNamedRootMatch(const icChar *szRoot, const icChar *szName, icUInt32Number nLen, bool bNoCase)
+{
+  icUInt32Number i;
+
+  if (bNoCase) {
+    for (i=0; i<nLen; i++) {
+      if (!szRoot[i] || tolower((unsigned char)szRoot[i])!=tolower((unsigned char)szName[i]))
+        return false;
+    }
+  }
+  else {
+    for (i=0; i<nLen; i++) {
+      if (!szRoot[i] || szRoot[i]!=szName[i])
+        return false;
+    }
+  }
+
+  return szRoot[nLen]=='\0';
+}
+
+/**
+****************************************************************************
+* Class: CIccNamedColorNameIndex
+* 
+* Purpose: A chained hash table from root color name to entry index used
+*  by CIccTagNamedColor2 name lookups.
+****************************************************************************
+*/
+class CIccNamedColorNameIndex
+{
+public:
+  CIccNamedColorNameIndex(bool bNoCase);
+  ~CIccNamedColorNameIndex();
+
+  bool Build(const CIccTagNamedColor2 *pTag);
+
+  icInt32Number Find(const icChar *szName, icUInt32Number nLen) const;
+
+protected:
+  icUInt32Number Hash(const icChar *szName, icUInt32Number nLen) const;
+
+  const CIccTagNamedColor2 *m_pTag;
+  bool m_bNoCase;
+
+  icInt32Number *m_pBucket; //First entry of each bucket
+  icInt32Number *m_pNext;   //Next entry in the same bucket
+  icUInt32Number m_nMask;
+};
+
+CIccNamedColorNameIndex::CIccNamedColorNameIndex(bool bNoCase)
+{
+  m_pTag = NULL;
+  m_bNoCase = bNoCase;
+  m_pBucket = NULL;
+  m_pNext = NULL;
+  m_nMask = 0;
+}
+
+CIccNamedColorNameIndex::~CIccNamedColorNameIndex()
+{
+  if (m_pBucket)
+    delete [] m_pBucket;
+  if (m_pNext)
+    delete [] m_pNext;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccNamedColorNameIndex::Hash
+ * 
+ * Purpose: FNV-1a hash of the first nLen characters of szName
+ *****************************************************************************
+ */
+icUInt32Number CIccNamedColorNameIndex::Hash(const icChar *szName, icUInt32Number nLen) const
+{
+  icUInt32Number i, h = 2166136261U;
+
+  if (m_bNoCase) {
+    for (i=0; i<nLen; i++)
+      h = (h ^ (icUInt8Number)tolower((unsigned char)szName[i])) * 16777619U;
+  }
+  else {
+    for (i=0; i<nLen; i++)
+      h = (h ^ (icUInt8Number)szName[i]) * 16777619U;
+  }
+
+  return h;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccNamedColorNameIndex::Build
+ * 
+ * Purpose: Hashes the root names of all entries in pTag.  Entries are
+ *  added last to first so that each bucket lists them in index order.
+ * 
+ * Return: 
+ *  true if successful, false if failure
+ *****************************************************************************
+ */
+bool CIccNamedColorNameIndex::Build(const CIccTagNamedColor2 *pTag)
+{
+  icUInt32Number nSize = pTag->GetSize();
+  icUInt32Number i, nBuckets = 16;
+
+  while (nBuckets < nSize*2)
+    nBuckets <<= 1;
+
+  m_pBucket = new icInt32Number[nBuckets];
+  m_pNext = new icInt32Number[nSize];
+  if (!m_pBucket || !m_pNext)
+    return false;
+
+  m_pTag = pTag;
+  m_nMask = nBuckets-1;
+
+  for (i=0; i<nBuckets; i++)
+    m_pBucket[i] = -1;
+
+  for (i=nSize; i>0; i--) {
+    const icChar *szRoot = pTag->GetEntry(i-1)->rootName;
+    icUInt32Number h = Hash(szRoot, (icUInt32Number)strlen(szRoot)) & m_nMask;
+
+    m_pNext[i-1] = m_pBucket[h];
+    m_pBucket[h] = (icInt32Number)(i-1);
+  }
+
+  return true;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccNamedColorNameIndex::Find
+ * 
+ * Purpose: Finds the first entry whose root name matches the first nLen
+ *  characters of szName.
+ * 
+ * Return: 
+ *  entry index, or -1 if no entry matches
+ *****************************************************************************
+ */
+icInt32Number CIccNamedColorNameIndex::Find(const icChar *szName, icUInt32Number nLen) const
+{
+  icInt32Number i;
+
+  for (i=m_pBucket[Hash(szName, nLen) & m_nMask]; i>=0; i=m_pNext[i]) {
+    if (icNamedRootMatch(m_pTag->GetEntry(i)->rootName, szName, nLen, m_bNoCase))
+      return i;
+  }
+
+  return -1;
+}
+
+
 /**
  ****************************************************************************
  * Name: CIccTagNamedColor2::CIccTagNamedColor2
@@ -1419,6 +1977,10 @@ CIccTagNamedColor2::CIccTagNamedColor2(int nSize/*=1*/, int nDeviceCoords/*=0*/)
   m_NamedColor = (SIccNamedColorEntry*)calloc(nSize, m_nColorEntrySize);
 
   m_NamedLab = NULL;
+  m_pLabIndex = NULL;
+  m_pDeviceIndex = NULL;
+  m_pNameIndex = NULL;
+  m_pRootIndex = NULL;
 }
 
 
@@ -1449,6 +2011,10 @@ CIccTagNamedColor2::CIccTagNamedColor2(const CIccTagNamedColor2 &ITNC)
   memcpy(m_NamedColor, ITNC.m_NamedColor, m_nColorEntrySize*m_nSize);
 
   m_NamedLab = NULL;
+  m_pLabIndex = NULL;
+  m_pDeviceIndex = NULL;
+  m_pNameIndex = NULL;
+  m_pRootIndex = NULL;
 }
 
 
@@ -1483,7 +2049,7 @@ CIccTagNamedColor2 &CIccTagNamedColor2::operator=(const CIccTagNamedColor2 &Name
   m_NamedColor = (SIccNamedColorEntry*)calloc(m_nSize, m_nColorEntrySize);
   memcpy(m_NamedColor, NamedColor2Tag.m_NamedColor, m_nColorEntrySize*m_nSize);
 
-  m_NamedLab = NULL;
+  ResetPCSCache();
 
   return *this;
 }
@@ -1502,8 +2068,7 @@ CIccTagNamedColor2::~CIccTagNamedColor2()
   if (m_NamedColor)
     free(m_NamedColor);
 
-  if (m_NamedLab)
-    delete [] m_NamedLab;
+  ResetPCSCache();
 }
 
 /**
@@ -1818,8 +2383,11 @@ void CIccTagNamedColor2::SetColorSpaces(icColorSpaceSignature csPCS, icColorSpac
  */
 icInt32Number CIccTagNamedColor2::FindRootColor(const icChar *szRootColor) const
 {
+  if (m_pRootIndex)
+    return m_pRootIndex->Find(szRootColor, (icUInt32Number)strlen(szRootColor));
+
   for (icUInt32Number i=0; i<m_nSize; i++) {
-    if (stricmp(m_NamedColor[i].rootName,szRootColor) == 0)
+    if (stricmp(GetEntry(i)->rootName,szRootColor) == 0)
       return i;
   }
 
@@ -1841,6 +2409,22 @@ void CIccTagNamedColor2::ResetPCSCache()
     delete [] m_NamedLab;
     m_NamedLab = NULL;
   }
+  if (m_pLabIndex) {
+    delete m_pLabIndex;
+    m_pLabIndex = NULL;
+  }
+  if (m_pDeviceIndex) {
+    delete m_pDeviceIndex;
+    m_pDeviceIndex = NULL;
+  }
+  if (m_pNameIndex) {
+    delete m_pNameIndex;
+    m_pNameIndex = NULL;
+  }
+  if (m_pRootIndex) {
+    delete m_pRootIndex;
+    m_pRootIndex = NULL;
+  }
 }
 
 /**
@@ -1855,7 +2439,7 @@ void CIccTagNamedColor2::ResetPCSCache()
 */
 bool CIccTagNamedColor2::InitFindCachedPCSColor()
 {
-  icFloatNumber *pXYZ, *pLab;
+  icFloatNumber pXYZ[3], *pLab;
 
   if (!m_NamedLab) {
     m_NamedLab = new SIccNamedLabEntry[m_nSize];
@@ -1865,7 +2449,7 @@ bool CIccTagNamedColor2::InitFindCachedPCSColor()
     if (m_csPCS != icSigLabData) {
       for (icUInt32Number i=0; i<m_nSize; i++) {
         pLab = m_NamedLab[i].lab;
-        pXYZ = m_NamedColor[i].pcsCoords;
+        memcpy(pXYZ, GetEntry(i)->pcsCoords, sizeof(pXYZ));
         icXyzFromPcs(pXYZ);
         icXYZtoLab(pLab, pXYZ);
       }
@@ -1873,12 +2457,46 @@ bool CIccTagNamedColor2::InitFindCachedPCSColor()
     else {
       for (icUInt32Number i=0; i<m_nSize; i++) {
         pLab = m_NamedLab[i].lab;
-        Lab2ToLab4(pLab, m_NamedColor[i].pcsCoords);
+        Lab2ToLab4(pLab, GetEntry(i)->pcsCoords);
         icLabFromPcs(pLab);
       }
     }
   }
 
+  if (m_nSize>=icNamedIndexMinSize) {
+    if (!m_pLabIndex) {
+      m_pLabIndex = new CIccNamedColorIndex;
+      if (!m_pLabIndex->Build(m_NamedLab[0].lab, sizeof(SIccNamedLabEntry)/sizeof(icFloatNumber), m_nSize, 3)) {
+        delete m_pLabIndex;
+        m_pLabIndex = NULL;
+      }
+    }
+
+    if (!m_pDeviceIndex && m_nDeviceCoords) {
+      m_pDeviceIndex = new CIccNamedColorIndex;
+      if (!m_pDeviceIndex->Build(m_NamedColor->deviceCoords, m_nColorEntrySize/sizeof(icFloatNumber), m_nSize, m_nDeviceCoords)) {
+        delete m_pDeviceIndex;
+        m_pDeviceIndex = NULL;
+      }
+    }
+
+    if (!m_pNameIndex) {
+      m_pNameIndex = new CIccNamedColorNameIndex(false);
+      if (!m_pNameIndex->Build(this)) {
+        delete m_pNameIndex;
+        m_pNameIndex = NULL;
+      }
+    }
+
+    if (!m_pRootIndex) {
+      m_pRootIndex = new CIccNamedColorNameIndex(true);
+      if (!m_pRootIndex->Build(this)) {
+        delete m_pRootIndex;
+        m_pRootIndex = NULL;
+      }
+    }
+  }
+
   return true;
 }
 
@@ -1899,9 +2517,10 @@ bool CIccTagNamedColor2::InitFindCachedPCSColor()
 icInt32Number CIccTagNamedColor2::FindCachedPCSColor(icFloatNumber *pPCS, icFloatNumber dMinDE/*=1000.0*/) const
 {
   icFloatNumber dCalcDE, dLeastDE=0.0;
-  icFloatNumber pLabIn[3];
-  icFloatNumber *pXYZ, *pLab;
+  icFloatNumber pLabIn[3], pLabN[icNamedIndexMinSize*3], pDE[icNamedIndexMinSize];
+  icFloatNumber *pXYZ;
   icInt32Number leastDEindex = -1;
+  icUInt32Number i, k, nBlock;
   if (m_csPCS != icSigLabData) {
     pXYZ = pPCS;
     icXyzFromPcs(pXYZ);
@@ -1915,21 +2534,39 @@ icInt32Number CIccTagNamedColor2::FindCachedPCSColor(icFloatNumber *pPCS, icFloa
   if (!m_NamedLab)
     return -1;
 
-  for (icUInt32Number i=0; i<m_nSize; i++) {
-    pLab = m_NamedLab[i].lab;
+  if (m_pLabIndex) {
+    //Same result as the linear search below: entry 0 is returned when no entry is within dMinDE
+    leastDEindex = m_pLabIndex->FindNearest(pLabIn, dLeastDE);
+    if (!(dLeastDE<dMinDE))
+      leastDEindex = 0;
 
-    dCalcDE = icDeltaE(pLabIn, pLab);
+    return leastDEindex;
+  }
 
-    if (i==0) {
-      dLeastDE = dCalcDE;
-      leastDEindex = i;
-    }
+  //m_NamedLab entries are packed Lab triples so blocks of them can be
+  //compared against copies of pLabIn with icDeltaEN()
+  for (k=0; k<icNamedIndexMinSize; k++)
+    memcpy(&pLabN[k*3], pLabIn, sizeof(pLabIn));
+
+  for (i=0; i<m_nSize; i+=nBlock) {
+    nBlock = m_nSize-i < icNamedIndexMinSize ? m_nSize-i : icNamedIndexMinSize;
+
+    icDeltaEN(pDE, pLabN, m_NamedLab[i].lab, nBlock);
+
+    for (k=0; k<nBlock; k++) {
+      dCalcDE = pDE[k];
 
-    if (dCalcDE<dMinDE) {
-      if (dCalcDE<dLeastDE) {
+      if (i+k==0) {
         dLeastDE = dCalcDE;
-        leastDEindex = i;
-      }      
+        leastDEindex = 0;
+      }
+
+      if (dCalcDE<dMinDE) {
+        if (dCalcDE<dLeastDE) {
+          dLeastDE = dCalcDE;
+          leastDEindex = i+k;
+        }      
+      }
     }
   }
 
@@ -1973,29 +2610,34 @@ icInt32Number CIccTagNamedColor2::FindPCSColor(icFloatNumber *pPCS, icFloatNumbe
  */
 icInt32Number CIccTagNamedColor2::FindColor(const icChar *szColor) const
 {
-  std::string sColorName;
-  icInt32Number i, j;
+  icInt32Number i, nPrefix, nSufix, nLen;
+
+  nPrefix = (icInt32Number)strlen(m_szPrefix);
+  nSufix = (icInt32Number)strlen(m_szSufix);
+  nLen = (icInt32Number)strlen(szColor);
+
+  if (nLen < nPrefix + nSufix)
+    return -1;
 
-  j = (icInt32Number)strlen(m_szPrefix);
-  if (j != 0) {  
-    if (strncmp(szColor, m_szPrefix, j))
+  if (nPrefix != 0) {  
+    if (strncmp(szColor, m_szPrefix, nPrefix))
       return -1;
   }
 
-  j = (icInt32Number)strlen(m_szSufix);
-  i = (icInt32Number)strlen(szColor);
-  if (j != 0) {
-    if (strncmp(szColor+(i-j), m_szSufix, j))
+  if (nSufix != 0) {
+    if (strncmp(szColor+(nLen-nSufix), m_szSufix, nSufix))
       return -1;    
   }
 
+  //Only the root name is left to match
+  szColor += nPrefix;
+  nLen -= nPrefix + nSufix;
 
-  for ( i=0; i<(icInt32Number)m_nSize; i++) {
-    sColorName = m_szPrefix;
-    sColorName += m_NamedColor[i].rootName;
-    sColorName += m_szSufix;
+  if (m_pNameIndex)
+    return m_pNameIndex->Find(szColor, nLen);
 
-    if (strcmp(sColorName.c_str(),szColor) == 0)
+  for ( i=0; i<(icInt32Number)m_nSize; i++) {
+    if (icNamedRootMatch(GetEntry(i)->rootName, szColor, nLen, false))
       return i;
   }
 
@@ -2024,14 +2666,13 @@ icInt32Number CIccTagNamedColor2::FindDeviceColor(icFloatNumber *pDevColor) cons
   icFloatNumber *pDevOut;
   icInt32Number leastDiffindex = -1;
 
+  if (m_pDeviceIndex)
+    return m_pDeviceIndex->FindNearest(pDevColor, dLeastDiff);
 
   for (icUInt32Number i=0; i<m_nSize; i++) {
-    pDevOut = m_NamedColor[i].deviceCoords;
+    pDevOut = GetEntry(i)->deviceCoords;
 
-    for (icUInt32Number j=0; j<m_nDeviceCoords; j++) {
-      dCalcDiff += (pDevColor[j]-pDevOut[j])*(pDevColor[j]-pDevOut[j]);
-    }
-    dCalcDiff = sqrt(dCalcDiff);
+    dCalcDiff = icNamedColorDist(pDevColor, pDevOut, m_nDeviceCoords);
 
     if (i==0) {
       dLeastDiff = dCalcDiff;
@@ -2042,8 +2683,6 @@ icInt32Number CIccTagNamedColor2::FindDeviceColor(icFloatNumber *pDevColor) cons
       dLeastDiff = dCalcDiff;
       leastDiffindex = i;
     }      
-
-    dCalcDiff = 0.0;
   }
 
   return leastDiffindex;
@@ -2070,12 +2709,37 @@ bool CIccTagNamedColor2::GetColorName(std::string &sColorName, icInt32Number ind
     return false;
 
   sColorName += m_szPrefix;
-  sColorName += m_NamedColor[index].rootName;
+  sColorName += GetEntry(index)->rootName;
   sColorName += m_szSufix;
 
   return true;
 }
 
+/**
+ ****************************************************************************
+ * Name: CIccTagNamedColor2::GetColorName
+ * 
+ * Purpose: Formats the full color name of an entry without allocating
+ * 
+ * Args: 
+ *  szColorName = buffer of at least 96 characters where the color name is stored,
+ *  index = array index of the color name
+ * 
+ * Return: 
+ *  true = if the index is within range,
+ *  false = index out of range
+ *****************************************************************************
+ */
+bool CIccTagNamedColor2::GetColorName(icChar *szColorName, icInt32Number index) const
+{
+  if (index<0 || index > (icInt32Number)m_nSize-1)
+    return false;
+
+  sprintf(szColorName, "%.31s%.31s%.31s", m_szPrefix, GetEntry(index)->rootName, m_szSufix);
+
+  return true;
+}
+
 /**
  ****************************************************************************
  * Name: CIccTagNamedColor2::UnitClip
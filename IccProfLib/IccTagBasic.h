@@ -66,6 +66,10 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Added spatial indexes for CIccTagNamedColor2 color lookups 10-19-2026
+// -Added hashed name lookups for CIccTagNamedColor2 10-19-2026
+// -Added non allocating CIccTagNamedColor2::GetColorName 10-19-2026
+// -Added IIccDescribeSink for streaming tag descriptions 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -74,6 +78,7 @@
 
 #include <list>
 #include <string>
+#include <stdio.h>
 #include "IccDefs.h"
 #ifdef USESAMPLEICCNAMESPACE
 namespace sampleICC {
@@ -90,6 +95,77 @@ public:
   virtual const char *GetExtDerivedClassName() const=0;
 };
 
+/**
+ ***********************************************************************
+ * Class: IIccDescribeSink
+ *
+ * Purpose:
+ *  Receives the text of a tag description as it is made so that large
+ *  tags (such as CLUTs) do not need to be described into one string.
+ ***********************************************************************
+ */
+class ICCPROFLIB_API IIccDescribeSink
+{
+public:
+  virtual ~IIccDescribeSink() {}
+
+  virtual void Append(const icChar *szText, size_t nLen)=0;
+  void AppendText(const icChar *szText);
+
+  ///Largest number of CLUT grid points to describe (0 for all of them)
+  virtual icUInt32Number GetMaxGridPoints() const { return 0; }
+};
+
+/**
+ ***********************************************************************
+ * Class: CIccDescribeStringSink
+ *
+ * Purpose:
+ *  Describe sink that appends to a string
+ ***********************************************************************
+ */
+class ICCPROFLIB_API CIccDescribeStringSink : public IIccDescribeSink
+{
+public:
+  CIccDescribeStringSink(std::string &sDescription, icUInt32Number nMaxGridPoints=0) :
+    m_sDescription(sDescription), m_nMaxGridPoints(nMaxGridPoints) {}
+
+  virtual void Append(const icChar *szText, size_t nLen) { m_sDescription.append(szText, nLen); }
+  virtual icUInt32Number GetMaxGridPoints() const { return m_nMaxGridPoints; }
+
+protected:
+  std::string &m_sDescription;
+  icUInt32Number m_nMaxGridPoints;
+};
+
+/**
+ ***********************************************************************
+ * Class: CIccDescribeFileSink
+ *
+ * Purpose:
+ *  Describe sink that writes to a FILE through a fixed size buffer
+ *  (the buffer is written when it fills and by Flush() or the
+ *  destructor).
+ ***********************************************************************
+ */
+class ICCPROFLIB_API CIccDescribeFileSink : public IIccDescribeSink
+{
+public:
+  CIccDescribeFileSink(FILE *f, icUInt32Number nMaxGridPoints=0, size_t nBufSize=65536);
+  virtual ~CIccDescribeFileSink();
+
+  virtual void Append(const icChar *szText, size_t nLen);
+  virtual icUInt32Number GetMaxGridPoints() const { return m_nMaxGridPoints; }
+
+  bool Flush();
+
+protected:
+  FILE *m_f;
+  icUInt32Number m_nMaxGridPoints;
+  icChar *m_pBuf;
+  size_t m_nBufSize, m_nUsed;
+};
+
 /**
  ***********************************************************************
  * Class: CIccTag
@@ -181,6 +257,16 @@ public:
   */
   virtual void Describe(std::string &sDescription) { sDescription.empty(); }
 
+  /**
+  * Function: DescribeTo
+  *  Streams the tag's description to a sink.  Tags with large
+  *  descriptions override this; others describe into a string first.
+  *
+  * Parameter(s):
+  * pSink - sink that receives the description text.
+  */
+  virtual void DescribeTo(IIccDescribeSink *pSink);
+
   /**
    ******************************************************************************
    * Function: Validate
@@ -366,6 +452,9 @@ typedef struct {
   icFloatNumber lab[3];
 } SIccNamedLabEntry;
 
+class CIccNamedColorIndex;
+class CIccNamedColorNameIndex;
+
 /**
 ****************************************************************************
 * Class: CIccTagNamedColor2
@@ -408,6 +497,9 @@ public:
   icInt32Number FindDeviceColor(icFloatNumber *pDevColor) const;
   icInt32Number FindPCSColor(icFloatNumber *pPCS, icFloatNumber dMinDE=1000.0);
 
+  //InitFindCachedPCSColor() also builds the indexes used by FindCachedPCSColor(),
+  //FindDeviceColor(), FindColor() and FindRootColor().  Without them these
+  //functions fall back to a linear search.
   bool InitFindCachedPCSColor();
   //FindPCSColor returns the zero based index of the color or -1 to indicate that the color was not found.
   //InitFindPCSColor must be called before FindPCSColor
@@ -417,6 +509,8 @@ public:
   void ResetPCSCache();
 
   bool GetColorName(std::string &sColorName, icInt32Number index) const;
+  ///Non allocating version, szColorName must hold at least 96 characters
+  bool GetColorName(icChar *szColorName, icInt32Number index) const;
   SIccNamedColorEntry &operator[](icUInt32Number index) const {return *(SIccNamedColorEntry*)((icUInt8Number*)m_NamedColor + index * m_nColorEntrySize);}
   SIccNamedColorEntry *GetEntry(icUInt32Number index) const {return (SIccNamedColorEntry*)((icUInt8Number*)m_NamedColor + index * m_nColorEntrySize);}
 
@@ -442,6 +536,10 @@ protected:
   
   SIccNamedColorEntry *m_NamedColor;
   SIccNamedLabEntry *m_NamedLab; ///For quick response of repeated FindPCSColor
+  CIccNamedColorIndex *m_pLabIndex; ///Nearest neighbor index over m_NamedLab
+  CIccNamedColorIndex *m_pDeviceIndex; ///Nearest neighbor index over device coordinates
+  CIccNamedColorNameIndex *m_pNameIndex; ///Hashed root names for FindColor
+  CIccNamedColorNameIndex *m_pRootIndex; ///Case insensitive hashed root names for FindRootColor
   icUInt32Number m_nColorEntrySize;
 
   icUInt32Number m_nVendorFlags;
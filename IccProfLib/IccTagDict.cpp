@@ -66,6 +66,11 @@
 //
 // -Initial implementation by Max Derhak Jun-26-2009
 //
+// -Added hashed name index and on demand decoding of values 10-19-2026
+//
+// -Entries are only renamed, added and removed through CIccTagDict so that
+//  the name index can't go stale 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 #if defined(WIN32) || defined(WIN64)
@@ -79,11 +84,309 @@
 #include "IccTagDict.h"
 #include "IccUtil.h"
 #include "IccIO.h"
+#include "IccThread.h"
 
 
 //MSVC 6.0 doesn't support std::string correctly so we disable support in this case
 #ifndef ICC_UNSUPPORTED_TAG_DICT
 
+/**
+****************************************************************************
+* Class: CIccDictSource
+* 
+* Purpose: Copy of the data of a dictionary tag that entries decode their
+*  values and localizations from when they are first accessed.
+****************************************************************************
+*/
+class CIccDictSource
+{
+public:
+  CIccDictSource(icUInt32Number nSize)
+  {
+    m_pData = (icUInt8Number*)malloc(nSize ? nSize : 1);
+    m_nSize = nSize;
+  }
+  ~CIccDictSource() { free(m_pData); }
+
+  icUInt8Number *m_pData;
+  icUInt32Number m_nSize;
+
+  ///Serializes decoding of entries that share the data
+  CIccMutex m_mutex;
+};
+
+/**
+****************************************************************************
+* Class: CIccDictNameIndex
+* 
+* Purpose: A chained hash table from entry name to dictionary list entry
+*  used by CIccTagDict name lookups.  Entries with the same name are kept
+*  in list order so that lookups find the first of them.
+****************************************************************************
+*/
+class CIccDictNameIndex
+{
+public:
+  CIccDictNameIndex();
+  ~CIccDictNameIndex();
+
+  void Clear();
+  void Build(CIccNameValueDict *pDict);
+  void Add(CIccNameValueDict::iterator entry);
+  bool Remove(const CIccUTF16String &sName, CIccNameValueDict::iterator &entry);
+
+  CIccDictEntry *Find(const CIccUTF16String &sName) const;
+
+  icUInt32Number GetCount() const { return m_nCount; }
+  icUInt32Number GetDuplicates() const { return m_nDuplicates; }
+
+protected:
+  struct SIccDictIndexNode {
+    CIccNameValueDict::iterator entry;
+    icUInt32Number nHash;
+    SIccDictIndexNode *pNext;
+  };
+
+  static icUInt32Number Hash(const CIccUTF16String &sName);
+  void Resize(icUInt32Number nBuckets);
+  void Link(SIccDictIndexNode *pNode);
+
+  SIccDictIndexNode **m_pBucket;
+  icUInt32Number m_nMask;
+  icUInt32Number m_nCount;
+  icUInt32Number m_nDuplicates;
+};
+
+CIccDictNameIndex::CIccDictNameIndex()
+{
+  m_pBucket = NULL;
+  m_nMask = 0;
+  m_nCount = 0;
+  m_nDuplicates = 0;
+}
+
+CIccDictNameIndex::~CIccDictNameIndex()
+{
+  Clear();
+  if (m_pBucket)
+    delete [] m_pBucket;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDictNameIndex::Hash
+ * 
+ * Purpose: FNV-1a hash of the UTF-16 code units of sName
+ *****************************************************************************
+ */
+icUInt32Number CIccDictNameIndex::Hash(const CIccUTF16String &sName)
+{
+  icUInt32Number h = 2166136261U;
+  const icUInt16Number *pStr = sName.c_str();
+  size_t i, n = sName.Size();
+
+  for (i=0; i<n; i++) {
+    h = (h ^ (pStr[i] & 0xff)) * 16777619U;
+    h = (h ^ (pStr[i] >> 8)) * 16777619U;
+  }
+
+  return h;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDictNameIndex::Clear
+ * 
+ * Purpose: Removes all entries from the index
+ *****************************************************************************
+ */
+void CIccDictNameIndex::Clear()
+{
+  icUInt32Number i;
+
+  if (m_pBucket) {
+    for (i=0; i<=m_nMask; i++) {
+      SIccDictIndexNode *pNode = m_pBucket[i];
+
+      while (pNode) {
+        SIccDictIndexNode *pNext = pNode->pNext;
+        delete pNode;
+        pNode = pNext;
+      }
+      m_pBucket[i] = NULL;
+    }
+  }
+
+  m_nCount = 0;
+  m_nDuplicates = 0;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDictNameIndex::Link
+ * 
+ * Purpose: Adds pNode to the end of its bucket
+ *****************************************************************************
+ */
+void CIccDictNameIndex::Link(SIccDictIndexNode *pNode)
+{
+  SIccDictIndexNode **ppNode = &m_pBucket[pNode->nHash & m_nMask];
+
+  while (*ppNode)
+    ppNode = &(*ppNode)->pNext;
+
+  pNode->pNext = NULL;
+  *ppNode = pNode;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDictNameIndex::Resize
+ * 
+ * Purpose: Rehashes the index into nBuckets buckets (a power of two)
+ *****************************************************************************
+ */
+void CIccDictNameIndex::Resize(icUInt32Number nBuckets)
+{
+  SIccDictIndexNode **pOld = m_pBucket;
+  icUInt32Number i, nOld = pOld ? m_nMask+1 : 0;
+
+  m_pBucket = new SIccDictIndexNode*[nBuckets];
+  m_nMask = nBuckets-1;
+
+  for (i=0; i<nBuckets; i++)
+    m_pBucket[i] = NULL;
+
+  for (i=0; i<nOld; i++) {
+    SIccDictIndexNode *pNode = pOld[i];
+
+    while (pNode) {
+      SIccDictIndexNode *pNext = pNode->pNext;
+      Link(pNode);
+      pNode = pNext;
+    }
+  }
+
+  if (pOld)
+    delete [] pOld;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDictNameIndex::Build
+ * 
+ * Purpose: Indexes all of the entries of pDict
+ *****************************************************************************
+ */
+void CIccDictNameIndex::Build(CIccNameValueDict *pDict)
+{
+  icUInt32Number nBuckets = 16;
+  CIccNameValueDict::iterator i;
+
+  Clear();
+
+  while (nBuckets < pDict->size()*2)
+    nBuckets <<= 1;
+
+  if (!m_pBucket || nBuckets > m_nMask+1)
+    Resize(nBuckets);
+
+  for (i=pDict->begin(); i!=pDict->end(); i++)
+    Add(i);
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDictNameIndex::Add
+ * 
+ * Purpose: Adds a dictionary list entry to the index
+ *****************************************************************************
+ */
+void CIccDictNameIndex::Add(CIccNameValueDict::iterator entry)
+{
+  if (!m_pBucket)
+    Resize(16);
+  else if (m_nCount >= (m_nMask+1)*2)
+    Resize((m_nMask+1)*2);
+
+  SIccDictIndexNode *pNode = new SIccDictIndexNode;
+  pNode->entry = entry;
+  pNode->nHash = Hash(entry->ptr->GetName());
+
+  if (Find(entry->ptr->GetName()))
+    m_nDuplicates++;
+
+  Link(pNode);
+  m_nCount++;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDictNameIndex::Remove
+ * 
+ * Purpose: Removes the first entry named sName from the index
+ * 
+ * Args:
+ *  sName = name of the entry to remove,
+ *  entry = gets the dictionary list entry that was removed
+ * 
+ * Return: 
+ *  true if an entry was removed, false if there was no entry named sName
+ *****************************************************************************
+ */
+bool CIccDictNameIndex::Remove(const CIccUTF16String &sName, CIccNameValueDict::iterator &entry)
+{
+  if (!m_pBucket)
+    return false;
+
+  icUInt32Number h = Hash(sName);
+  SIccDictIndexNode **ppNode;
+
+  for (ppNode = &m_pBucket[h & m_nMask]; *ppNode; ppNode = &(*ppNode)->pNext) {
+    SIccDictIndexNode *pNode = *ppNode;
+
+    if (pNode->nHash==h && pNode->entry->ptr->GetName()==sName) {
+      entry = pNode->entry;
+      *ppNode = pNode->pNext;
+      delete pNode;
+      m_nCount--;
+
+      if (Find(sName))
+        m_nDuplicates--;
+
+      return true;
+    }
+  }
+
+  return false;
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccDictNameIndex::Find
+ * 
+ * Purpose: Finds the first entry named sName
+ * 
+ * Return: 
+ *  Pointer to the entry, or NULL if not found
+ *****************************************************************************
+ */
+CIccDictEntry *CIccDictNameIndex::Find(const CIccUTF16String &sName) const
+{
+  if (!m_pBucket)
+    return NULL;
+
+  icUInt32Number h = Hash(sName);
+  SIccDictIndexNode *pNode;
+
+  for (pNode = m_pBucket[h & m_nMask]; pNode; pNode = pNode->pNext) {
+    if (pNode->nHash==h && pNode->entry->ptr->GetName()==sName)
+      return pNode->entry->ptr;
+  }
+
+  return NULL;
+}
+
 /*=============================================================================
 * CLASS CIccDictEntry
 *=============================================================================*/
@@ -103,6 +406,13 @@ CIccDictEntry::CIccDictEntry()
   m_pNameLocalized = NULL;
   m_pValueLocalized = NULL;
   m_bValueSet = false;
+
+  m_pSource = NULL;
+  m_bPending.Set(false);
+  m_bLoadError = false;
+  memset(&m_posValue, 0, sizeof(m_posValue));
+  memset(&m_posNameLocalized, 0, sizeof(m_posNameLocalized));
+  memset(&m_posValueLocalized, 0, sizeof(m_posValueLocalized));
 }
 
 /**
@@ -117,6 +427,15 @@ CIccDictEntry::CIccDictEntry()
 ******************************************************************************/
 CIccDictEntry::CIccDictEntry(const CIccDictEntry& IDE)
 {
+  const_cast<CIccDictEntry&>(IDE).LoadPending();
+
+  m_pSource = NULL;
+  m_bPending.Set(false);
+  m_bLoadError = IDE.m_bLoadError;
+  memset(&m_posValue, 0, sizeof(m_posValue));
+  memset(&m_posNameLocalized, 0, sizeof(m_posNameLocalized));
+  memset(&m_posValueLocalized, 0, sizeof(m_posValueLocalized));
+
   m_sName = IDE.m_sName;
   m_bValueSet = IDE.m_bValueSet;
   m_sValue = IDE.m_sValue;
@@ -146,6 +465,15 @@ CIccDictEntry::CIccDictEntry(const CIccDictEntry& IDE)
 ******************************************************************************/
 CIccDictEntry &CIccDictEntry::operator=(const CIccDictEntry &IDE)
 {
+  if (&IDE == this)
+    return *this;
+
+  const_cast<CIccDictEntry&>(IDE).LoadPending();
+
+  m_pSource = NULL;
+  m_bPending.Set(false);
+  m_bLoadError = IDE.m_bLoadError;
+
   if (m_pNameLocalized)
     delete m_pNameLocalized;
 
@@ -201,6 +529,8 @@ void CIccDictEntry::Describe(std::string &sDescription)
 {
   std::string s;
 
+  LoadPending();
+
   sDescription += "BEGIN DICT_ENTRY\r\nName=";
   m_sName.ToUtf8(s);
   sDescription += s;
@@ -235,6 +565,8 @@ void CIccDictEntry::Describe(std::string &sDescription)
 ******************************************************************************/
 icUInt32Number CIccDictEntry::PosRecSize()
 {
+  LoadPending();
+
   if (m_pValueLocalized)
     return 32;
   if (m_pNameLocalized)
@@ -243,8 +575,84 @@ icUInt32Number CIccDictEntry::PosRecSize()
 }
 
 
+/**
+******************************************************************************
+* Name: CIccDictEntry::LoadPending
+* 
+* Purpose: Decodes the value and localizations of an entry read by
+*  CIccTagDict::Read() the first time any of them are needed.  A failure to
+*  decode a localization leaves it unset and is reported by IsLoadValid().
+*  Entries that are already decoded return without taking the lock.
+******************************************************************************/
+void CIccDictEntry::LoadPending()
+{
+  if (!m_pSource || !m_bPending.Get())
+    return;
+
+  CIccMutexLock lock(m_pSource->m_mutex);
+
+  if (!m_bPending.Get())
+    return;
+
+  CIccMemIO io;
+  if (!io.Attach(m_pSource->m_pData, m_pSource->m_nSize)) {
+    m_bLoadError = true;
+    m_bPending.Set(false);
+    return;
+  }
+
+  if (m_posValue.offset && m_posValue.size) {
+    icUInt32Number num = m_posValue.size / sizeof(icUnicodeChar);
+    icUnicodeChar *buf = (icUnicodeChar*)malloc((num+1)*sizeof(icUnicodeChar));
+
+    if (buf && io.Seek(m_posValue.offset, icSeekSet)>=0 &&
+        io.Read16(buf, num)==(icInt32Number)num) {
+      buf[num] = 0;
+      m_sValue = buf;
+    }
+    else
+      m_bLoadError = true;
+
+    if (buf)
+      free(buf);
+  }
+
+  if (m_posNameLocalized.offset) {
+    CIccTagMultiLocalizedUnicode *pTag = new CIccTagMultiLocalizedUnicode();
+
+    if (io.Seek(m_posNameLocalized.offset, icSeekSet)>=0 &&
+        pTag->Read(m_posNameLocalized.size, &io)) {
+      m_pNameLocalized = pTag;
+    }
+    else {
+      delete pTag;
+      m_bLoadError = true;
+    }
+  }
+
+  if (m_posValueLocalized.offset) {
+    CIccTagMultiLocalizedUnicode *pTag = new CIccTagMultiLocalizedUnicode();
+
+    if (io.Seek(m_posValueLocalized.offset, icSeekSet)>=0 &&
+        pTag->Read(m_posValueLocalized.size, &io)) {
+      m_pValueLocalized = pTag;
+    }
+    else {
+      delete pTag;
+      m_bLoadError = true;
+    }
+  }
+
+  //Clearing the flag last publishes the decoded data to threads that test it
+  //without the lock
+  m_bPending.Set(false);
+}
+
+
 bool CIccDictEntry::SetValue(const CIccUTF16String &sValue)
 {
+  LoadPending();
+
   bool rv = m_bValueSet && !m_sValue.Empty();
 
   m_sValue = sValue;
@@ -266,6 +674,8 @@ bool CIccDictEntry::SetNameLocalized(CIccTagMultiLocalizedUnicode *pNameLocalize
 {
   bool rv;
 
+  LoadPending();
+
   if (m_pNameLocalized) {
     delete m_pNameLocalized;
     rv = true;
@@ -293,6 +703,8 @@ bool CIccDictEntry::SetValueLocalized(CIccTagMultiLocalizedUnicode *pValueLocali
 {
   bool rv;
 
+  LoadPending();
+
   if (m_pValueLocalized) {
     delete m_pValueLocalized;
     rv = true;
@@ -324,6 +736,8 @@ CIccTagDict::CIccTagDict()
   m_bBadAlignment = false;
 
   m_Dict = new CIccNameValueDict;
+  m_pIndex = new CIccDictNameIndex;
+  m_pSource = NULL;
 }
 
 /**
@@ -340,6 +754,8 @@ CIccTagDict::CIccTagDict(const CIccTagDict &dict)
 {
   m_bBadAlignment = false;
   m_Dict = new CIccNameValueDict;
+  m_pIndex = new CIccDictNameIndex;
+  m_pSource = NULL;
 
   CIccNameValueDict::iterator i;
   CIccDictEntryPtr ptr;
@@ -349,6 +765,8 @@ CIccTagDict::CIccTagDict(const CIccTagDict &dict)
 
     m_Dict->push_back(ptr);
   }
+
+  UpdateIndex();
 }
 
 /**
@@ -377,6 +795,8 @@ CIccTagDict &CIccTagDict::operator=(const CIccTagDict &dict)
     m_Dict->push_back(ptr);
   }
 
+  UpdateIndex();
+
   return *this;
 }
 
@@ -394,6 +814,7 @@ CIccTagDict::~CIccTagDict()
 {
   Cleanup();
   delete m_Dict;
+  delete m_pIndex;
 }
 
 
@@ -493,6 +914,18 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
 
   m_tagStart = pIO->Tell();
 
+  //Keep a copy of the tag data so that entry values and localizations can
+  //be decoded when they are first accessed
+  m_pSource = new CIccDictSource(size);
+  if (pIO->Read8(m_pSource->m_pData, size)!=(icInt32Number)size)
+    return false;
+
+  CIccMemIO memIO;
+  if (!memIO.Attach(m_pSource->m_pData, size))
+    return false;
+
+  pIO = &memIO;
+
   if (!pIO->Read32(&sig))
     return false;
 
@@ -550,7 +983,7 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
   }
 
   icUInt32Number bufsize = 128, num;
-  icUnicodeChar *buf = (icUnicodeChar*)malloc(bufsize);
+  icUnicodeChar *buf = (icUnicodeChar*)malloc(bufsize+sizeof(icUnicodeChar));
   CIccDictEntryPtr ptr;
   CIccUTF16String str;
 
@@ -559,7 +992,7 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
     if (!ptr.ptr)
       return false;
 
-    //GetName
+    //GetName (names are decoded here so that they can be indexed)
     if (pos[i].posName.offset) {
       if (!pos[i].posName.size) {
         str.Clear();
@@ -585,7 +1018,7 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
           }
         }
 
-        if (pIO->Seek(m_tagStart+pos[i].posName.offset, icSeekSet)<0) {
+        if (pIO->Seek(pos[i].posName.offset, icSeekSet)<0) {
           free(pos);
           free(buf);
           delete ptr.ptr;
@@ -604,7 +1037,7 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
       }
     }
 
-    //GetValue
+    //Check Value (decoded by CIccDictEntry::LoadPending)
     if (pos[i].posValue.offset) {
       if (!pos[i].posValue.size) {
         str.Clear();
@@ -619,37 +1052,13 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
             return false;
         }
 
-        //Make sure we have buf large enough for the string
-        if (bufsize < pos[i].posValue.size) {
-          bufsize = pos[i].posValue.size;
-          buf = (icUnicodeChar*)realloc(buf, bufsize+1*sizeof(icUnicodeChar));
-          if (!buf) {
-            free(pos);
-            delete ptr.ptr;
-            return false;
-          }
-        }
-
-        if (pIO->Seek(m_tagStart+pos[i].posValue.offset, icSeekSet)<0) {
-          free(pos);
-          free(buf);
-          delete ptr.ptr;
-          return false;
-        }
-
-        num = pos[i].posValue.size / sizeof(icUnicodeChar);
-        if (pIO->Read16(buf, num)!=(icInt32Number)num) {
-          free(pos);
-          free(buf);
-          delete ptr.ptr;
-          return false;
-        }
-        buf[num]=0;
-        ptr.ptr->SetValue(buf);
+        ptr.ptr->m_posValue = pos[i].posValue;
+        ptr.ptr->m_bValueSet = true;
+        ptr.ptr->m_bPending.Set(true);
       }
     }
 
-    //Get NameLocalized
+    //Check NameLocalized
     if (pos[i].posNameLocalized.offset) {
       if (pos[i].posNameLocalized.offset + pos[i].posNameLocalized.size > size ||
           pos[i].posNameLocalized.size < sizeof(icSignature)) {
@@ -659,7 +1068,7 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
         return false;
       }
 
-      if (pIO->Seek(m_tagStart+pos[i].posNameLocalized.offset, icSeekSet)<0) {
+      if (pIO->Seek(pos[i].posNameLocalized.offset, icSeekSet)<0) {
         free(pos);
         free(buf);
         delete ptr.ptr;
@@ -681,26 +1090,11 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
         return false;
       }
 
-      if (pIO->Seek(m_tagStart+pos[i].posNameLocalized.offset, icSeekSet)<0) {
-        free(pos);
-        free(buf);
-        delete ptr.ptr;
-        return false;
-      }
-
-      CIccTagMultiLocalizedUnicode *pTag = new CIccTagMultiLocalizedUnicode();
-
-      if (!pTag || !pTag->Read(pos[i].posNameLocalized.size, pIO)) {
-        free(pos);
-        free(buf);
-        delete ptr.ptr;
-        return false;
-      }
-
-      ptr.ptr->SetNameLocalized(pTag);
+      ptr.ptr->m_posNameLocalized = pos[i].posNameLocalized;
+      ptr.ptr->m_bPending.Set(true);
     }
 
-    //Get ValueLocalized
+    //Check ValueLocalized
     if (pos[i].posValueLocalized.offset) {
       if (pos[i].posValueLocalized.offset + pos[i].posValueLocalized.size > size ||
         pos[i].posValueLocalized.size < sizeof(icSignature)) {
@@ -710,7 +1104,7 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
           return false;
       }
 
-      if (pIO->Seek(m_tagStart+pos[i].posValueLocalized.offset, icSeekSet)<0) {
+      if (pIO->Seek(pos[i].posValueLocalized.offset, icSeekSet)<0) {
         free(pos);
         free(buf);
         delete ptr.ptr;
@@ -732,31 +1126,21 @@ bool CIccTagDict::Read(icUInt32Number size, CIccIO *pIO)
         return false;
       }
 
-      if (pIO->Seek(m_tagStart+pos[i].posValueLocalized.offset, icSeekSet)<0) {
-        free(pos);
-        free(buf);
-        delete ptr.ptr;
-        return false;
-      }
-
-      CIccTagMultiLocalizedUnicode *pTag = new CIccTagMultiLocalizedUnicode();
-
-      if (!pTag || !pTag->Read(pos[i].posValueLocalized.size, pIO)) {
-        free(pos);
-        free(buf);
-        delete ptr.ptr;
-        return false;
-      }
-
-      ptr.ptr->SetValueLocalized(pTag);
+      ptr.ptr->m_posValueLocalized = pos[i].posValueLocalized;
+      ptr.ptr->m_bPending.Set(true);
     }
 
+    if (ptr.ptr->m_bPending.Get())
+      ptr.ptr->m_pSource = m_pSource;
+
     m_Dict->push_back(ptr);
   }
 
   free(pos);
   free(buf);
 
+  UpdateIndex();
+
   return true;
 }
 
@@ -919,6 +1303,18 @@ icValidateStatus CIccTagDict::Validate(icTagSignature sig, std::string &sReport,
     rv =icMaxStatus(rv, icValidateWarning);
   }
 
+  // Check entries whose localizations could not be decoded
+  CIccNameValueDict::const_iterator i;
+  for (i=m_Dict->begin(); i!=m_Dict->end(); i++) {
+    if (!i->ptr->IsLoadValid()) {
+      sReport += icValidateCriticalErrorMsg;
+      sReport += sSigName;
+      sReport += " - Dictionary entry has invalid value or localization data.\r\n";
+      rv =icMaxStatus(rv, icValidateCriticalError);
+      break;
+    }
+  }
+
   return rv;
 }
 
@@ -938,6 +1334,44 @@ void CIccTagDict::Cleanup()
       delete i->ptr;
   }
   m_Dict->clear();
+  m_pIndex->Clear();
+
+  if (m_pSource) {
+    delete m_pSource;
+    m_pSource = NULL;
+  }
+}
+
+/**
+ ***************************************************************************
+ * Name: CIccTagDict::UpdateIndex
+ * 
+ * Purpose: Rebuilds the name index from the entries in m_Dict
+ ***************************************************************************
+ */
+void CIccTagDict::UpdateIndex()
+{
+  m_pIndex->Build(m_Dict);
+}
+
+/**
+ ***************************************************************************
+ * Name: CIccTagDict::AddEntry
+ * 
+ * Purpose: Adds a new empty entry named sName to the end of the dictionary
+ ***************************************************************************
+ */
+CIccDictEntry *CIccTagDict::AddEntry(const CIccUTF16String &sName)
+{
+  CIccDictEntryPtr ptr;
+
+  ptr.ptr = new CIccDictEntry;
+  ptr.ptr->m_sName = sName;
+
+  m_Dict->push_back(ptr);
+  m_pIndex->Add(--m_Dict->end());
+
+  return ptr.ptr;
 }
 
 /**
@@ -955,17 +1389,7 @@ void CIccTagDict::Cleanup()
 */
 bool CIccTagDict::AreNamesUnique() const
 {
-  CIccNameValueDict::const_iterator i, j;
-
-  for (i=m_Dict->begin(); i!=m_Dict->end(); i++) {
-    j=i;
-    for (j++; j!= m_Dict->end(); j++) {
-      if (i->ptr->m_sName == j->ptr->m_sName)
-        return false;
-    }
-  }
-
-  return true;
+  return m_pIndex->GetDuplicates()==0;
 }
 
 /**
@@ -1009,14 +1433,7 @@ return true;
  */
 CIccDictEntry* CIccTagDict::Get(const CIccUTF16String &sName) const
 {
-  CIccNameValueDict::const_iterator i;
-
-  for (i=m_Dict->begin(); i!=m_Dict->end(); i++) {
-    if (i->ptr->m_sName == sName)
-      return i->ptr;
-  }
-
-  return NULL;
+  return m_pIndex->Find(sName);
 }
 
 /**
@@ -1279,16 +1696,13 @@ bool CIccTagDict::Remove(const CIccUTF16String &sName)
 {
   CIccNameValueDict::iterator i;
 
-  for (i=m_Dict->begin(); i!=m_Dict->end(); i++) {
-    if (i->ptr->m_sName == sName) {
-      delete i->ptr;
+  if (!m_pIndex->Remove(sName, i))
+    return false;
 
-      m_Dict->erase(i);
-      return true;
-    }
-  }
+  delete i->ptr;
 
-  return false;
+  m_Dict->erase(i);
+  return true;
 }
 
 
@@ -1335,6 +1749,80 @@ bool CIccTagDict::Remove(const char *szName)
 }
 
 
+/**
+******************************************************************************
+* Name: CIccTagDict::Rename
+* 
+* Purpose: Changes the name of a dictionary entry
+*
+* Args:
+*  sName = the name to look for in the dictionary
+*  sNewName = new name for the entry
+* 
+* Return: 
+*  true if sName exists and was renamed, or false otherwise
+*******************************************************************************
+*/
+bool CIccTagDict::Rename(const CIccUTF16String &sName, const CIccUTF16String &sNewName)
+{
+  CIccDictEntry *pEntry = m_pIndex->Find(sName);
+
+  if (!pEntry)
+    return false;
+
+  pEntry->m_sName = sNewName;
+
+  //Rebuilt rather than relinked so that entries sharing sNewName stay in list order
+  UpdateIndex();
+
+  return true;
+}
+
+
+/**
+******************************************************************************
+* Name: CIccTagDict::Rename
+* 
+* Purpose: Changes the name of a dictionary entry
+*
+* Args:
+*  szName = the name to look for in the dictionary
+*  szNewName = new name for the entry
+* 
+* Return: 
+*  true if szName exists and was renamed, or false otherwise
+*******************************************************************************
+*/
+bool CIccTagDict::Rename(const icUnicodeChar *szName, const icUnicodeChar *szNewName)
+{
+  CIccUTF16String sName(szName), sNewName(szNewName);
+
+  return Rename(sName, sNewName);
+}
+
+
+/**
+******************************************************************************
+* Name: CIccTagDict::Rename
+* 
+* Purpose: Changes the name of a dictionary entry
+*
+* Args:
+*  szName = the name to look for in the dictionary
+*  szNewName = new name for the entry
+* 
+* Return: 
+*  true if szName exists and was renamed, or false otherwise
+*******************************************************************************
+*/
+bool CIccTagDict::Rename(const char *szName, const char *szNewName)
+{
+  CIccUTF16String sName(szName), sNewName(szNewName);
+
+  return Rename(sName, sNewName);
+}
+
+
 /**
 ******************************************************************************
 * Name: CIccTagDict::Set
@@ -1359,12 +1847,7 @@ bool CIccTagDict::Set(const CIccUTF16String &sName, const CIccUTF16String &sValu
       return false;
   }
   else {
-    de = new CIccDictEntry;
-    de->m_sName = sName;
-
-    CIccDictEntryPtr ptr;
-    ptr.ptr = de;
-    m_Dict->push_back(ptr);
+    de = AddEntry(sName);
   }
 
   if (sValue.Empty() && bUnSet)
@@ -1408,14 +1891,8 @@ bool CIccTagDict::SetNameLocalized(const CIccUTF16String &sName, CIccTagMultiLoc
 {
   CIccDictEntry *de = Get(sName);
 
-  if (!de) {
-    de = new CIccDictEntry;
-    de->m_sName = sName;
-
-    CIccDictEntryPtr ptr;
-    ptr.ptr = de;
-    m_Dict->push_back(ptr);
-  }
+  if (!de)
+    de = AddEntry(sName);
 
   return de->SetNameLocalized(pTag);
 }
@@ -1438,14 +1915,8 @@ bool CIccTagDict::SetValueLocalized(const CIccUTF16String &sName, CIccTagMultiLo
 {
   CIccDictEntry *de = Get(sName);
 
-  if (!de) {
-    de = new CIccDictEntry;
-    de->m_sName = sName;
-
-    CIccDictEntryPtr ptr;
-    ptr.ptr = de;
-    m_Dict->push_back(ptr);
-  }
+  if (!de)
+    de = AddEntry(sName);
 
   return de->SetValueLocalized(pTag);
 }
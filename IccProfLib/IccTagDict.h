@@ -68,6 +68,9 @@ Copyright:  
 // -Jun 26, 2009 
 //  Initial CIccDictTag prototype development
 //
+// -Oct 19, 2026
+//  Added hashed name index and on demand decoding of values
+//
 //////////////////////////////////////////////////////////////////////
 
 #ifndef _ICCTAGSUBTAG_H
@@ -77,6 +80,7 @@ Copyright:  
 #include "IccTag.h"
 #include "IccTagFactory.h"
 #include "IccUtil.h"
+#include "IccThread.h"
 #include <memory>
 #include <list>
 #include <string>
@@ -85,13 +89,17 @@ Copyright:  
 namespace sampleICC {
 #endif
 
+class CIccDictSource;
+class CIccDictNameIndex;
 
 /**
 ****************************************************************************
 * Data Class: CIccDictEntry
 * 
 * Purpose: Implementation of a dictionary entry with optional localization of
-* name and value
+* name and value.  Entries read by CIccTagDict::Read() decode their value and
+* localizations from the tag data the first time that they are accessed.
+* Entries are named by the CIccTagDict that owns them.
 *****************************************************************************
 */
 class ICCPROFLIB_API CIccDictEntry
@@ -106,30 +114,44 @@ public: //member functions
 
   icUInt32Number PosRecSize();
 
-  //Data
-  CIccUTF16String m_sName;
+  const CIccUTF16String &GetName() const { return m_sName; }
 
-  const CIccUTF16String &GetValue() { return m_sValue; }
+  const CIccUTF16String &GetValue() { LoadPending(); return m_sValue; }
   bool IsValueSet() { return m_bValueSet; }
 
   //GetNameLocalized and GetValueLocalized both give direct access to objects owned by the CIccDirEntry object
-  CIccTagMultiLocalizedUnicode* GetNameLocalized() { return m_pNameLocalized; }
-  CIccTagMultiLocalizedUnicode* GetValueLocalized() { return m_pValueLocalized; }
+  CIccTagMultiLocalizedUnicode* GetNameLocalized() { LoadPending(); return m_pNameLocalized; }
+  CIccTagMultiLocalizedUnicode* GetValueLocalized() { LoadPending(); return m_pValueLocalized; }
 
-  void UnsetValue() { m_sValue.Clear(); m_bValueSet = false; }
+  void UnsetValue() { LoadPending(); m_sValue.Clear(); m_bValueSet = false; }
   bool SetValue(const CIccUTF16String &sValue);
 
+  ///Returns false if the value or localizations in the tag data couldn't be decoded
+  bool IsLoadValid() { LoadPending(); return !m_bLoadError; }
+
   //SetNameLocalized and SetValueLocalized both transfer ownership of the argument to the CIccDirEntry object
   //deleting access to previous object
   bool SetNameLocalized(CIccTagMultiLocalizedUnicode *pNameLocalized);
   bool SetValueLocalized(CIccTagMultiLocalizedUnicode *pValueLocalized);
 
 protected:
+  CIccUTF16String m_sName;
   CIccUTF16String m_sValue; 
   bool m_bValueSet;
 
   CIccTagMultiLocalizedUnicode *m_pNameLocalized;
   CIccTagMultiLocalizedUnicode *m_pValueLocalized;
+
+  //Tag data that the value and localizations are decoded from on first access
+  void LoadPending();
+  CIccDictSource *m_pSource;
+  CIccAtomicFlag m_bPending;
+  bool m_bLoadError;
+  icPositionNumber m_posValue;
+  icPositionNumber m_posNameLocalized;
+  icPositionNumber m_posValueLocalized;
+
+  friend class CIccTagDict;
 };
 
 class CIccDictEntryPtr
@@ -151,7 +173,10 @@ typedef std::list<CIccDictEntryPtr> CIccNameValueDict;
 ****************************************************************************
 * Class: CIccTagDict
 * 
-* Purpose: A name-value dictionary tag with optional localization 
+* Purpose: A name-value dictionary tag with optional localization.  Names are
+* hashed so that Get() and the other name lookups don't search the list.
+* Entries are only added, removed and renamed through the tag so that the
+* hash index always matches the list.
 *****************************************************************************
 */
 class ICCPROFLIB_API CIccTagDict : public CIccTag
@@ -208,15 +233,27 @@ public:
   bool SetValueLocalized(const icUnicodeChar *szName, CIccTagMultiLocalizedUnicode *pTag);
   bool SetValueLocalized(const CIccUTF16String &sName, CIccTagMultiLocalizedUnicode *pTag);
 
-  CIccNameValueDict *m_Dict;
+  bool Rename(const CIccUTF16String &sName, const CIccUTF16String &sNewName);
+  bool Rename(const icUnicodeChar *szName, const icUnicodeChar *szNewName);
+  bool Rename(const char *szName, const char *szNewName);
+
+  ///Entries in dictionary order
+  const CIccNameValueDict *GetDict() const { return m_Dict; }
 
 protected:
+  CIccNameValueDict *m_Dict;
+
   bool m_bBadAlignment;
   void Cleanup();
   icUInt32Number MaxPosRecSize();
+  CIccDictEntry *AddEntry(const CIccUTF16String &sName);
+  void UpdateIndex();
 
   icUInt32Number m_tagSize;
   icUInt32Number m_tagStart;
+
+  CIccDictNameIndex *m_pIndex;
+  CIccDictSource *m_pSource;
 };
 
 
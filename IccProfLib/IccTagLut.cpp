@@ -68,6 +68,11 @@
 //
 // -Moved LUT tags to separate file 4-30-2005
 //
+// -Report CIccCLUT::Begin() as a setup phase 10-19-2026
+// -Fixed lut8Type/lut16Type validation of AToB and gamut curve counts 10-19-2026
+// -Added streaming (IIccDescribeSink) CLUT dumps with a grid point limit 10-19-2026
+// -Added parallel and batched CIccCLUT iteration 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 #if defined(WIN32) || defined(WIN64)
@@ -81,6 +86,8 @@
 #include "IccTag.h"
 #include "IccUtil.h"
 #include "IccProfile.h"
+#include "IccPerf.h"
+#include "IccThread.h"
 
 #ifdef USESAMPLEICCNAMESPACE
 namespace sampleICC {
@@ -1390,10 +1397,6 @@ CIccCLUT::CIccCLUT(icUInt8Number nInputChannels, icUInt16Number nOutputChannels,
   m_nPrecision = nPrecision;
   m_pData = NULL;
   m_nOffset = NULL;
-  m_g = NULL;
-  m_ig = NULL;
-  m_s = NULL;
-  m_df = NULL;
   memset(&m_nReserved2, 0 , sizeof(m_nReserved2));
 
   UnitClip = ClutUnitClip;
@@ -1414,10 +1417,6 @@ CIccCLUT::CIccCLUT(const CIccCLUT &ICLUT)
 {
   m_pData = NULL;
   m_nOffset = NULL;
-  m_g = NULL;
-  m_ig = NULL;
-  m_s = NULL;
-  m_df = NULL;
   m_nInput = ICLUT.m_nInput;
   m_nOutput = ICLUT.m_nOutput;
   m_nPrecision = ICLUT.m_nPrecision;
@@ -1496,18 +1495,6 @@ CIccCLUT::~CIccCLUT()
 
   if (m_nOffset)
     delete [] m_nOffset;
-
-  if (m_g)
-    delete [] m_g;
-
-  if (m_ig)
-    delete [] m_ig;
-
-  if (m_s)
-    delete [] m_s;
-
-  if (m_df)
-    delete [] m_df;
 }
 
 /**
@@ -1702,23 +1689,23 @@ bool CIccCLUT::Write(CIccIO *pIO)
  * Purpose: Iterate through the CLUT to dump the data
  * 
  * Args: 
- *  sDescription = string to concatenate data dump to,
+ *  pSink = sink to send data dump to,
  *  nIndex = the channel number,
  *  nPos = the current position in the CLUT
  * 
  *****************************************************************************
  */
-void CIccCLUT::Iterate(std::string &sDescription, icUInt8Number nIndex, icUInt32Number nPos, bool bUseLegacy)
+void CIccCLUT::Iterate(IIccDescribeSink *pSink, icUInt8Number nIndex, icUInt32Number nPos, bool bUseLegacy)
 {
   if (nIndex < m_nInput) {
     int i;
-    for (i=0; i<m_GridPoints[nIndex]; i++) {
+    for (i=0; i<m_GridPoints[nIndex] && m_nDumpLeft; i++) {
       m_GridAdr[nIndex] = i;
-      Iterate(sDescription, nIndex+1, nPos, bUseLegacy);
+      Iterate(pSink, nIndex+1, nPos, bUseLegacy);
       nPos += m_DimSize[nIndex];
     }
   }
-  else {
+  else if (m_nDumpLeft) {
     icChar *ptr = m_pOutText;
     icFloatNumber *pData = &m_pData[nPos];
     int i;
@@ -1737,8 +1724,9 @@ void CIccCLUT::Iterate(std::string &sDescription, icUInt8Number nIndex, icUInt32
       ptr += sprintf(ptr, " %s", m_pVal);
     }
     strcpy(ptr, "\r\n");
-    sDescription += (const icChar*)m_pOutText;
-
+    ptr += 2;
+    pSink->Append(m_pOutText, ptr - m_pOutText);
+    m_nDumpLeft--;
   }
 }
 
@@ -1801,6 +1789,172 @@ void CIccCLUT::Iterate(IIccCLUTExec* pExec)
 }
 
 
+/**
+****************************************************************************
+* Class: CIccCLUTIterateTask
+* 
+* Purpose: Parallel task that hands consecutive slices of CLUT grid nodes
+*  to an IIccCLUTBatchExec.  Each thread has its own grid coordinate buffer
+*  so no CLUT member scratch variables are used.
+*****************************************************************************
+*/
+class CIccCLUTIterateTask : public IIccParallelTask
+{
+public:
+  CIccCLUTIterateTask(CIccCLUT *pCLUT, IIccCLUTBatchExec *pExec,
+                      icUInt32Number nBatchSize, icUInt32Number nThreads)
+  {
+    m_pCLUT = pCLUT;
+    m_pExec = pExec;
+    m_nBatchSize = nBatchSize;
+    m_pGridAdr = new icFloatNumber[nThreads*nBatchSize*pCLUT->GetInputDim()];
+  }
+  virtual ~CIccCLUTIterateTask() { delete [] m_pGridAdr; }
+
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)
+  {
+    int nInput = m_pCLUT->GetInputDim();
+    icUInt32Number nOutput = m_pCLUT->GetOutputChannels();
+    icFloatNumber *pGridAdr = m_pGridAdr + nThread*m_nBatchSize*nInput;
+    icUInt32Number nGridAdr[16];
+    icUInt32Number n, nNodes;
+    int i;
+
+    while (nStart<nEnd) {
+      nNodes = nEnd - nStart;
+      if (nNodes>m_nBatchSize)
+        nNodes = m_nBatchSize;
+
+      //Find grid address of first node in batch
+      for (n=nStart, i=nInput-1; i>=0; i--) {
+        nGridAdr[i] = n % m_pCLUT->GridPoint(i);
+        n /= m_pCLUT->GridPoint(i);
+      }
+
+      icFloatNumber *pAdr = pGridAdr;
+      for (n=0; n<nNodes; n++) {
+        for (i=0; i<nInput; i++)
+          *pAdr++ = (icFloatNumber)nGridAdr[i]/(icFloatNumber)(m_pCLUT->GridPoint(i)-1);
+
+        for (i=nInput-1; i>=0; i--) {
+          if (++nGridAdr[i]<m_pCLUT->GridPoint(i))
+            break;
+          nGridAdr[i] = 0;
+        }
+      }
+
+      m_pExec->PixelOps(nThread, nNodes, pGridAdr, m_pCLUT->GetData(nStart*nOutput));
+      nStart += nNodes;
+    }
+  }
+
+protected:
+  CIccCLUT *m_pCLUT;
+  IIccCLUTBatchExec *m_pExec;
+  icUInt32Number m_nBatchSize;
+  icFloatNumber *m_pGridAdr;
+};
+
+/**
+****************************************************************************
+* Class: CIccCLUTPixelOpBatch
+* 
+* Purpose: Adapts an IIccCLUTExec to IIccCLUTBatchExec by calling PixelOp()
+*  for each node in a batch.
+*****************************************************************************
+*/
+class CIccCLUTPixelOpBatch : public IIccCLUTBatchExec
+{
+public:
+  CIccCLUTPixelOpBatch(IIccCLUTExec *pExec, icUInt8Number nInput, icUInt16Number nOutput)
+  {
+    m_pExec = pExec;
+    m_nInput = nInput;
+    m_nOutput = nOutput;
+  }
+
+  virtual void PixelOps(icUInt32Number nThread, icUInt32Number nNodes,
+                        const icFloatNumber *pGridAdr, icFloatNumber *pData)
+  {
+    icFloatNumber fGridAdr[16];
+    icUInt32Number n;
+
+    memset(fGridAdr, 0, sizeof(fGridAdr));
+    for (n=0; n<nNodes; n++) {
+      memcpy(fGridAdr, pGridAdr, m_nInput*sizeof(icFloatNumber));
+      m_pExec->PixelOp(fGridAdr, pData);
+
+      pGridAdr += m_nInput;
+      pData += m_nOutput;
+    }
+  }
+
+protected:
+  IIccCLUTExec *m_pExec;
+  icUInt8Number m_nInput;
+  icUInt16Number m_nOutput;
+};
+
+/**
+ ****************************************************************************
+ * Name: CIccCLUT::Iterate
+ * 
+ * Purpose: Iterate through the CLUT handing slices of consecutive grid
+ *  nodes to pExec->PixelOps().  The grid is partitioned across threads
+ *  so PixelOps() must be safe to call concurrently.
+ * 
+ * Args: 
+ *  pExec = pointer to the IIccCLUTBatchExec object that fills in the nodes,
+ *  nBatchSize = largest number of nodes per PixelOps() call (0 uses one row
+ *   of the last input dimension),
+ *  nThreads = number of threads to use (0 uses all processors)
+ * 
+ * Return: 
+ *  true if the CLUT was iterated
+ *****************************************************************************
+ */
+bool CIccCLUT::Iterate(IIccCLUTBatchExec* pExec, icUInt32Number nBatchSize/*=0*/, icUInt32Number nThreads/*=0*/)
+{
+  if (!pExec || !m_pData || !m_nInput)
+    return false;
+
+  if (!nBatchSize)
+    nBatchSize = m_GridPoints[m_nInput-1];
+
+  nThreads = icGetNumThreads(nThreads);
+
+  CIccCLUTIterateTask task(this, pExec, nBatchSize, nThreads);
+
+  return icParallelExecute(&task, NumPoints(), nBatchSize, nThreads);
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccCLUT::IterateParallel
+ * 
+ * Purpose: Same as Iterate(IIccCLUTExec*) with the grid partitioned across
+ *  threads.  Grid coordinates are passed in per-thread buffers, but
+ *  pExec->PixelOp() must be safe to call concurrently.
+ * 
+ * Args: 
+ *  pExec = pointer to the IIccCLUTExec object that implements the 
+ *          IIccCLUTExec::PixelOp() function,
+ *  nThreads = number of threads to use (0 uses all processors)
+ * 
+ * Return: 
+ *  true if the CLUT was iterated
+ *****************************************************************************
+ */
+bool CIccCLUT::IterateParallel(IIccCLUTExec* pExec, icUInt32Number nThreads/*=0*/)
+{
+  if (!pExec)
+    return false;
+
+  CIccCLUTPixelOpBatch batch(pExec, m_nInput, m_nOutput);
+
+  return Iterate(&batch, 0, nThreads);
+}
+
 /**
  ****************************************************************************
  * Name: CIccCLUT::SubIterate
@@ -1846,40 +2000,69 @@ void CIccCLUT::DumpLut(std::string  &sDescription, const icChar *szName,
                        icColorSpaceSignature csInput, icColorSpaceSignature csOutput,
                        bool bUseLegacy)
 {
-  icChar szOutText[2048], szColor[40];
+  icChar szColor[40];
   int i, len;
 
+  len = 0;
+  for (i=0; i<m_nInput; i++) {
+    icColorValue(szColor, 1.0, csInput, i, bUseLegacy);
+    len+= (int)strlen(szColor);
+  }
+  for (i=0; i<m_nOutput; i++) {
+    icColorValue(szColor, 1.0, csOutput, i, bUseLegacy);
+    len+= (int)strlen(szColor);
+  }
+  len += m_nInput + m_nOutput + 6;
+
+  sDescription.reserve(sDescription.size() + NumPoints()*len);
+
+  CIccDescribeStringSink sink(sDescription);
+
+  DumpLut(&sink, szName, csInput, csOutput, bUseLegacy);
+}
+
+
+/**
+ ****************************************************************************
+ * Name: CIccCLUT::DumpLut
+ * 
+ * Purpose: Dump data associated with the tag to a describe sink.  Only
+ *  the first pSink->GetMaxGridPoints() grid points are dumped when the
+ *  sink has a limit.
+ * 
+ * Args: 
+ *  pSink = sink to send tag dump to,
+ *  szName = name of the LUT to be printed,
+ *  csInput = color space signature of the input data,
+ *  csOutput = color space signature of the output data
+ *****************************************************************************
+ */
+void CIccCLUT::DumpLut(IIccDescribeSink *pSink, const icChar *szName,
+                       icColorSpaceSignature csInput, icColorSpaceSignature csOutput,
+                       bool bUseLegacy)
+{
+  icChar szOutText[2048], szColor[40];
+  icUInt32Number nMaxPoints = pSink->GetMaxGridPoints();
+  int i;
+
   sprintf(szOutText, "BEGIN_LUT %s %d %d\r\n", szName, m_nInput, m_nOutput);
-  sDescription += szOutText;
+  pSink->AppendText(szOutText);
 
   for (i=0; i<m_nInput; i++) {
     icColorIndexName(szColor, csInput, i, m_nInput, "In");
     sprintf(szOutText, " %s=%d", szColor, m_GridPoints[i]);
-    sDescription += szOutText;
+    pSink->AppendText(szOutText);
   }
 
-  sDescription += "  ";
+  pSink->AppendText("  ");
 
   for (i=0; i<m_nOutput; i++) {
     icColorIndexName(szColor, csOutput, i, m_nOutput, "Out");
     sprintf(szOutText, " %s", szColor);
-    sDescription += szOutText;
+    pSink->AppendText(szOutText);
   }
 
-  sDescription += "\r\n";
-
-  len = 0;
-  for (i=0; i<m_nInput; i++) {
-    icColorValue(szColor, 1.0, csInput, i, bUseLegacy);
-    len+= (int)strlen(szColor);
-  }
-  for (i=0; i<m_nOutput; i++) {
-    icColorValue(szColor, 1.0, csOutput, i, bUseLegacy);
-    len+= (int)strlen(szColor);
-  }
-  len += m_nInput + m_nOutput + 6;
-
-  sDescription.reserve(sDescription.size() + NumPoints()*len);
+  pSink->AppendText("\r\n");
 
   //Initialize iteration member variables
   m_csInput = csInput;
@@ -1887,10 +2070,16 @@ void CIccCLUT::DumpLut(std::string  &sDescription, const icChar *szName,
   m_pOutText = szOutText;
   m_pVal = szColor;
   memset(m_GridAdr, 0, 16);
+  m_nDumpLeft = (nMaxPoints && nMaxPoints<NumPoints()) ? nMaxPoints : NumPoints();
+
+  Iterate(pSink, 0, 0, bUseLegacy);
 
-  Iterate(sDescription, 0, 0, bUseLegacy);
+  if (nMaxPoints && nMaxPoints<NumPoints()) {
+    sprintf(szOutText, " ... %u of %u grid points not shown\r\n", NumPoints()-nMaxPoints, NumPoints());
+    pSink->AppendText(szOutText);
+  }
   
-  sDescription += "\r\n";
+  pSink->AppendText("\r\n");
 }
 
 
@@ -1905,11 +2094,13 @@ void CIccCLUT::DumpLut(std::string  &sDescription, const icChar *szName,
  */
 void CIccCLUT::Begin()
 {
+  CIccSetupTimer setupTimer(icSetupCLUTBegin);
   int i;
   for (i=0; i<m_nInput; i++) {
     m_MaxGridPoint[i] = m_GridPoints[i] - 1;
   }
   m_nNodes = (1<<m_nInput);
+  setupTimer.SetBytes(m_nNodes*sizeof(icUInt32Number));
 
   if (m_nOffset)
     delete [] m_nOffset;
@@ -2046,11 +2237,6 @@ void CIccCLUT::Begin()
   }
   else {
     //initialize ND interpolation variables
-    m_g = new icFloatNumber[m_nInput];
-    m_ig = new icUInt32Number[m_nInput];
-    m_s = new icFloatNumber[m_nInput];
-    m_df = new icFloatNumber[m_nNodes];
-    
     m_nOffset[0] = 0;
     int count, nFlag;
     icUInt32Number nPower[2];
@@ -2596,21 +2782,39 @@ void CIccCLUT::Interp6d(icFloatNumber *destPixel, const icFloatNumber *srcPixel)
  *
  * Args:
  *  Pixel = Pixel value to be found in the CLUT. Also used to store the result.
+ *  pNodeWeights = optional scratch of GetNumOffset() values, used instead of
+ *   allocating one per call when there are more than icCLUTMaxLocalNodes nodes.
  *******************************************************************************
  */
-void CIccCLUT::InterpND(icFloatNumber *destPixel, const icFloatNumber *srcPixel) const
+void CIccCLUT::InterpND(icFloatNumber *destPixel, const icFloatNumber *srcPixel, icFloatNumber *pNodeWeights) const
 {
   icUInt32Number i,j, index = 0;
 
+  //Interpolation temporaries are kept local so that the CLUT can be shared
+  //between threads applying pixels concurrently
+  icFloatNumber g[16], s[16];
+  icUInt32Number ig[16];
+  icFloatNumber dfBuf[icCLUTMaxLocalNodes];
+  icFloatNumber *df = dfBuf;
+  bool bNewDf = false;
+
+  if (m_nNodes>icCLUTMaxLocalNodes) {
+    df = pNodeWeights;
+    if (!df) {
+      df = new icFloatNumber[m_nNodes];
+      bNewDf = true;
+    }
+  }
+
   for (i=0; i<m_nInput; i++) {
-    m_g[i] = UnitClip(srcPixel[i]) * m_MaxGridPoint[i];
-    m_ig[i] = (icUInt32Number)m_g[i];
-    m_s[m_nInput-1-i] = m_g[i] - m_ig[i];
-    if (m_ig[i]==m_MaxGridPoint[i]) {
-      m_ig[i]--;
-      m_s[m_nInput-1-i] = 1.0;      
+    g[i] = UnitClip(srcPixel[i]) * m_MaxGridPoint[i];
+    ig[i] = (icUInt32Number)g[i];
+    s[m_nInput-1-i] = g[i] - ig[i];
+    if (ig[i]==m_MaxGridPoint[i]) {
+      ig[i]--;
+      s[m_nInput-1-i] = 1.0;      
     }
-    index += m_ig[i]*m_DimSize[i];
+    index += ig[i]*m_DimSize[i];
   }
 
   icFloatNumber *p = &m_pData[index];
@@ -2619,16 +2823,16 @@ void CIccCLUT::InterpND(icFloatNumber *destPixel, const icFloatNumber *srcPixel)
   int nFlag = 0;
 
   for (i=0; i<m_nNodes; i++) {
-    m_df[i] = 1.0;
+    df[i] = 1.0;
   }
 
 
   for (i=0; i<m_nInput; i++) {
-    temp[0] = (icFloatNumber)(1.0 - m_s[i]);
-    temp[1] = (icFloatNumber)(m_s[i]);
+    temp[0] = (icFloatNumber)(1.0 - s[i]);
+    temp[1] = (icFloatNumber)(s[i]);
     index = m_nPower[i];
     for (j=0; j<m_nNodes; j++) {
-      m_df[j] *= temp[nFlag];
+      df[j] *= temp[nFlag];
       if ((j+1)%index == 0)
         nFlag = !nFlag;
     }
@@ -2637,11 +2841,13 @@ void CIccCLUT::InterpND(icFloatNumber *destPixel, const icFloatNumber *srcPixel)
 
   for (i=0; i<m_nOutput; i++, p++) {
     for (pv=0, j=0; j<m_nNodes; j++)
-      pv += p[m_nOffset[j]] * m_df[j];
+      pv += p[m_nOffset[j]] * df[j];
 
     destPixel[i] = pv;
   }
 
+  if (bNewDf)
+    delete [] df;
 }
 
 
@@ -3006,6 +3212,26 @@ void CIccMBB::SetColorSpaces(icColorSpaceSignature csInput, icColorSpaceSignatur
  */
 void CIccMBB::Describe(std::string &sDescription)
 {
+  CIccDescribeStringSink sink(sDescription);
+
+  DescribeTo(&sink);
+}
+
+/**
+ ****************************************************************************
+ * Name: CIccMBB::DescribeTo
+ * 
+ * Purpose: Dump data associated with the tag to a describe sink.  Curves
+ *  and matrices are described into a string and appended while the CLUT
+ *  is streamed to the sink.
+ * 
+ * Args: 
+ *  pSink - sink to send tag dump to
+ *****************************************************************************
+ */
+void CIccMBB::DescribeTo(IIccDescribeSink *pSink)
+{
+  std::string sDescription;
   int i;
   icChar buf[128], color[40];
 
@@ -3033,8 +3259,11 @@ void CIccMBB::Describe(std::string &sDescription)
       }
     }
 
-    if (m_CLUT)
-      m_CLUT->DumpLut(sDescription, "CLUT", m_csInput, m_csOutput, GetType()==icSigLut16Type);
+    if (m_CLUT) {
+      pSink->Append(sDescription.c_str(), sDescription.size());
+      sDescription.erase();
+      m_CLUT->DumpLut(pSink, "CLUT", m_csInput, m_csOutput, GetType()==icSigLut16Type);
+    }
 
     if (m_CurvesA) {
       for (i=0; i<m_nOutput; i++) {
@@ -3053,8 +3282,11 @@ void CIccMBB::Describe(std::string &sDescription)
       }
     }
 
-    if (m_CLUT)
-      m_CLUT->DumpLut(sDescription, "CLUT", m_csInput, m_csOutput);
+    if (m_CLUT) {
+      pSink->Append(sDescription.c_str(), sDescription.size());
+      sDescription.erase();
+      m_CLUT->DumpLut(pSink, "CLUT", m_csInput, m_csOutput);
+    }
 
     if (m_CurvesM && this->GetType()!=icSigLut8Type) {
       for (i=0; i<m_nOutput; i++) {
@@ -3075,6 +3307,8 @@ void CIccMBB::Describe(std::string &sDescription)
       }
     }
   }
+
+  pSink->Append(sDescription.c_str(), sDescription.size());
 }
 
 
@@ -4326,14 +4560,14 @@ icValidateStatus CIccTagLut8::Validate(icTagSignature sig, std::string &sReport,
   case icSigGamutTag:
     {
       icUInt32Number nInput, nOutput;
-      if (sig==icSigAToB0Tag || sig==icSigAToB1Tag || sig==icSigAToB2Tag || sig==icSigGamutTag) {
-        nInput = icGetSpaceSamples(pProfile->m_Header.pcs);
-        nOutput = icGetSpaceSamples(pProfile->m_Header.colorSpace);
-      }
-      else {
+      if (sig==icSigAToB0Tag || sig==icSigAToB1Tag || sig==icSigAToB2Tag) {
         nInput = icGetSpaceSamples(pProfile->m_Header.colorSpace);
         nOutput = icGetSpaceSamples(pProfile->m_Header.pcs);
       }
+      else {
+        nInput = icGetSpaceSamples(pProfile->m_Header.pcs);
+        nOutput = icGetSpaceSamples(pProfile->m_Header.colorSpace);
+      }
 
       if (sig==icSigGamutTag) {
         nOutput = 1;
@@ -4747,14 +4981,14 @@ icValidateStatus CIccTagLut16::Validate(icTagSignature sig, std::string &sReport
   case icSigGamutTag:
     {
       icUInt32Number nInput, nOutput;
-      if (sig==icSigAToB0Tag || sig==icSigAToB1Tag || sig==icSigAToB2Tag || sig==icSigGamutTag) {
-        nInput = icGetSpaceSamples(pProfile->m_Header.pcs);
-        nOutput = icGetSpaceSamples(pProfile->m_Header.colorSpace);
-      }
-      else {
+      if (sig==icSigAToB0Tag || sig==icSigAToB1Tag || sig==icSigAToB2Tag) {
         nInput = icGetSpaceSamples(pProfile->m_Header.colorSpace);
         nOutput = icGetSpaceSamples(pProfile->m_Header.pcs);
       }
+      else {
+        nInput = icGetSpaceSamples(pProfile->m_Header.pcs);
+        nOutput = icGetSpaceSamples(pProfile->m_Header.colorSpace);
+      }
 
       if (sig==icSigGamutTag) {
         nOutput = 1;
@@ -69,6 +69,9 @@
 //
 // -Moved LUT tags to separate file 4-30-2005
 //
+// -Added streaming (IIccDescribeSink) CLUT dumps 10-19-2026
+// -Added parallel and batched CIccCLUT iteration 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 #if !defined(_ICCTAGLUT_H)
@@ -248,8 +251,36 @@ public:
   virtual void PixelOp(icFloatNumber* pGridAdr, icFloatNumber* pData)=0;
 };
 
+/**
+****************************************************************************
+* Interface Class: IIccCLUTBatchExec
+* 
+* Purpose: Interface class used to populate CLUTs a slice of grid nodes at
+*  a time.  PixelOps() may be called concurrently from several threads by
+*  CIccCLUT::Iterate(IIccCLUTBatchExec*, ...).
+*****************************************************************************
+*/
+class ICCPROFLIB_API IIccCLUTBatchExec 
+{
+public:
+  virtual ~IIccCLUTBatchExec() {}
+
+  /**
+   * Fills in nNodes consecutive grid nodes.  pGridAdr holds the normalized
+   * grid coordinates of the nodes (GetInputDim() values per node) and pData
+   * the node values to set (GetOutputChannels() values per node).  nThread
+   * (0 to number of threads-1) identifies the calling thread so that
+   * per-thread state can be kept without locking.
+   */
+  virtual void PixelOps(icUInt32Number nThread, icUInt32Number nNodes,
+                        const icFloatNumber *pGridAdr, icFloatNumber *pData)=0;
+};
+
 typedef icFloatNumber (*icCLUTCLIPFUNC)(icFloatNumber v);
 
+///Largest number of CLUT nodes (2^inputs) that InterpND weights on the stack
+#define icCLUTMaxLocalNodes 4096
+
 /**
 ****************************************************************************
 * Class: CIccCLUT
@@ -277,6 +308,9 @@ public:
   void DumpLut(std::string  &sDescription, const icChar *szName,
                icColorSpaceSignature csInput, icColorSpaceSignature csOutput,
                bool bUseLegacy=false);
+  void DumpLut(IIccDescribeSink *pSink, const icChar *szName,
+               icColorSpaceSignature csInput, icColorSpaceSignature csOutput,
+               bool bUseLegacy=false);
 
   icFloatNumber& operator[](int index) { return m_pData[index]; }
   icFloatNumber* GetData(int index) { return &m_pData[index]; }
@@ -300,9 +334,11 @@ public:
   void Interp4d(icFloatNumber *destPixel, const icFloatNumber *srcPixel) const;
   void Interp5d(icFloatNumber *destPixel, const icFloatNumber *srcPixel) const;
   void Interp6d(icFloatNumber *destPixel, const icFloatNumber *srcPixel) const;
-  void InterpND(icFloatNumber *destPixel, const icFloatNumber *srcPixel) const;
+  void InterpND(icFloatNumber *destPixel, const icFloatNumber *srcPixel, icFloatNumber *pNodeWeights=NULL) const;
 
   void Iterate(IIccCLUTExec* pExec);
+  bool IterateParallel(IIccCLUTExec* pExec, icUInt32Number nThreads=0);
+  bool Iterate(IIccCLUTBatchExec* pExec, icUInt32Number nBatchSize=0, icUInt32Number nThreads=0);
   icValidateStatus Validate(icTagTypeSignature sig, std::string &sReport, const CIccProfile* pProfile=NULL)  const;
 
   void SetClipFunc(icCLUTCLIPFUNC ClipFunc) { UnitClip = ClipFunc; }
@@ -310,7 +346,7 @@ public:
   icUInt8Number GetPrecision() { return m_nPrecision; }
 
 protected:
-  void Iterate(std::string &sDescription, icUInt8Number nIndex, icUInt32Number nPos, bool bUseLegacy=false);
+  void Iterate(IIccDescribeSink *pSink, icUInt8Number nIndex, icUInt32Number nPos, bool bUseLegacy=false);
   void SubIterate(IIccCLUTExec* pExec, icUInt8Number nIndex, icUInt32Number nPos);
 
   icCLUTCLIPFUNC UnitClip;
@@ -332,6 +368,7 @@ protected:
   icFloatNumber m_fGridAdr[16];
   icChar *m_pOutText, *m_pVal;
   icColorSpaceSignature m_csInput, m_csOutput;
+  icUInt32Number m_nDumpLeft;
 
   //Tetrahedral interpolation variables
   icUInt8Number m_MaxGridPoint[16];
@@ -339,9 +376,6 @@ protected:
 
   //ND Interpolation
   icUInt32Number *m_nOffset;
-  // Temporary ND Interp Variables
-  icFloatNumber *m_g, *m_s, *m_df;
-  icUInt32Number* m_ig;
   icUInt32Number m_nNodes, m_nPower[16];
 };
 
@@ -382,6 +416,7 @@ public:
   icUInt8Number OutputChannels() const { return m_nOutput; }
 
   virtual void Describe(std::string &sDescription);
+  virtual void DescribeTo(IIccDescribeSink *pSink);
 
   virtual void SetColorSpaces(icColorSpaceSignature csInput, icColorSpaceSignature csOutput);
   virtual icValidateStatus Validate(icTagSignature sig, std::string &sReport, const CIccProfile* pProfile=NULL) const;
@@ -66,6 +66,11 @@
 //
 // -Initial implementation by Max Derhak 1-30-2006
 //
+// -Added per element performance counters 10-19-2026
+// -Report CIccTagMultiProcessElement::Begin() as a setup phase 10-19-2026
+// -Fixed copy constructor and Write() handling of the position table 10-19-2026
+// -Added streaming (IIccDescribeSink) descriptions 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 #if defined(WIN32) || defined(WIN64)
@@ -147,6 +152,24 @@ CIccApplyMpe* CIccMultiProcessElement::GetNewApply( CIccApplyTagMpe *pApplyTag )
   return new CIccApplyMpe(this);
 }
 
+/**
+ ******************************************************************************
+ * Name: CIccMultiProcessElement::DescribeTo
+ * 
+ * Purpose: Streams the element's description to a sink (describes into
+ *  a string for elements that do not override this)
+ * 
+ * Args: 
+ *  pSink = sink to send the description to
+******************************************************************************/
+void CIccMultiProcessElement::DescribeTo(IIccDescribeSink *pSink)
+{
+  std::string sDescription;
+
+  Describe(sDescription);
+  pSink->Append(sDescription.c_str(), sDescription.size());
+}
+
 
 /**
  ******************************************************************************
@@ -717,6 +740,9 @@ CIccTagMultiProcessElement::CIccTagMultiProcessElement(icUInt16Number nInputChan
 CIccTagMultiProcessElement::CIccTagMultiProcessElement(const CIccTagMultiProcessElement &lut)
 {
   m_nReserved = lut.m_nReserved;
+  m_list = NULL;
+  m_nProcElements = 0;
+  m_position = NULL;
 
   if (lut.m_list) {
     m_list = new CIccMultiProcessElementList();
@@ -872,21 +898,37 @@ bool CIccTagMultiProcessElement::IsSupported()
  * Return: 
  ******************************************************************************/
 void CIccTagMultiProcessElement::Describe(std::string &sDescription)
+{
+  CIccDescribeStringSink sink(sDescription);
+
+  DescribeTo(&sink);
+}
+
+/**
+ ******************************************************************************
+ * Name: CIccTagMultiProcessElement::DescribeTo
+ * 
+ * Purpose: Streams the description of each element to a sink
+ * 
+ * Args: 
+ *  pSink = sink to send the description to
+ ******************************************************************************/
+void CIccTagMultiProcessElement::DescribeTo(IIccDescribeSink *pSink)
 {
   icChar buf[128];
 
   sprintf(buf, "BEGIN MULTI_PROCESS_ELEMENT_TAG %d %d\r\n", m_nInputChannels, m_nOutputChannels);
-  sDescription += buf;
-  sDescription += "\r\n";
+  pSink->AppendText(buf);
+  pSink->AppendText("\r\n");
 
   CIccMultiProcessElementList::iterator i;
   int j;
 
   for (j=0, i=m_list->begin(); i!=m_list->end(); j++, i++) {
     sprintf(buf, "PROCESS_ELEMENT #%d\r\n", j+1);
-    sDescription += buf;
-    i->ptr->Describe(sDescription);
-    sDescription += "\r\n";
+    pSink->AppendText(buf);
+    i->ptr->DescribeTo(pSink);
+    pSink->AppendText("\r\n");
   }
 }
 
@@ -1075,7 +1117,7 @@ bool CIccTagMultiProcessElement::Write(CIccIO *pIO)
     icUInt32Number offsetPos = pIO->Tell();
 
     if (m_position) {
-      delete [] m_position;
+      free(m_position);
     }
 
     m_position = (icPositionNumber*)calloc(m_nProcElements, sizeof(icPositionNumber));
@@ -1189,6 +1231,8 @@ void CIccTagMultiProcessElement::GetNextElemIterator(CIccMultiProcessElementList
  ******************************************************************************/
 bool CIccTagMultiProcessElement::Begin(icElemInterp nInterp/* =icElemInterpLinear */)
 {
+  CIccSetupTimer setupTimer(icSetupMpeBegin);
+
   if (!m_list || !m_list->size()) {
     if (m_nInputChannels != m_nOutputChannels)
       return false;
@@ -1305,6 +1349,20 @@ CIccApplyTagMpe *CIccTagMultiProcessElement::GetNewApply()
 }
 
 
+/**
+ ******************************************************************************
+ * Name: icApplyElem
+ * 
+ * Purpose: Applies one element of a CIccApplyTagMpe chain, updating the
+ *  element's performance counter when built with ICC_PERF_COUNTERS.
+ ******************************************************************************/
+static __inline void icApplyElem(CIccApplyMpe *pApply, icFloatNumber *pDestPixel, const icFloatNumber *pSrcPixel)
+{
+  ICC_PERF_START(nStart);
+  pApply->Apply(pDestPixel, pSrcPixel);
+  ICC_PERF_STOP(pApply->GetPerf(), nStart, 1);
+}
+
 /**
  ******************************************************************************
  * Name: CIccTagMultiProcessElement::Apply
@@ -1332,15 +1390,15 @@ void CIccTagMultiProcessElement::Apply(CIccApplyTagMpe *pApply, icFloatNumber *p
   if (next==pApply->end()) {
     //Elements rely on pDestPixel != pSrcPixel
     if (pSrcPixel==pDestPixel) {
-      i->ptr->Apply(pApplyBuf->GetDstBuf(), pSrcPixel);
+      icApplyElem(i->ptr, pApplyBuf->GetDstBuf(), pSrcPixel);
       memcpy(pDestPixel, pApplyBuf->GetDstBuf(), m_nOutputChannels*sizeof(icFloatNumber));
     }
     else {
-      i->ptr->Apply(pDestPixel, pSrcPixel);
+      icApplyElem(i->ptr, pDestPixel, pSrcPixel);
     }
   }
   else {
-    i->ptr->Apply(pApplyBuf->GetDstBuf(), pSrcPixel);
+    icApplyElem(i->ptr, pApplyBuf->GetDstBuf(), pSrcPixel);
     i++;
     next++;
     pApplyBuf->Switch();
@@ -1349,7 +1407,7 @@ void CIccTagMultiProcessElement::Apply(CIccApplyTagMpe *pApply, icFloatNumber *p
       CIccMultiProcessElement *pElem = i->ptr->GetElem();
 
       if (!pElem->IsAcs()) {
-        i->ptr->Apply(pApplyBuf->GetDstBuf(), pApplyBuf->GetSrcBuf());
+        icApplyElem(i->ptr, pApplyBuf->GetDstBuf(), pApplyBuf->GetSrcBuf());
         pApplyBuf->Switch();
       }
 
@@ -1357,7 +1415,7 @@ void CIccTagMultiProcessElement::Apply(CIccApplyTagMpe *pApply, icFloatNumber *p
       next++;
     }
 
-    i->ptr->Apply(pDestPixel, pApplyBuf->GetSrcBuf());
+    icApplyElem(i->ptr, pDestPixel, pApplyBuf->GetSrcBuf());
   }
 }
 
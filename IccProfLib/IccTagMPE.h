@@ -71,6 +71,10 @@ Copyright:  
 // -Nov 6, 2006
 //  Prototype Merged into release
 //
+// -Oct 19, 2026
+//  Apply elements keep performance counters
+//  Added streaming (IIccDescribeSink) descriptions
+//
 //////////////////////////////////////////////////////////////////////
 
 #ifndef _ICCTAGMPE_H
@@ -78,6 +82,7 @@ Copyright:  
 
 #include "IccTag.h"
 #include "IccTagFactory.h"
+#include "IccPerf.h"
 #include "icProfileHeader.h"
 #include <memory>
 #include <list>
@@ -160,6 +165,7 @@ public:
   virtual bool IsSupported() { return true; }
 
   virtual void Describe(std::string &sDescription) = 0;
+  virtual void DescribeTo(IIccDescribeSink *pSink);
 
   virtual bool Read(icUInt32Number size, CIccIO *pIO) = 0;
   virtual bool Write(CIccIO *pIO) = 0;
@@ -207,10 +213,15 @@ public:
 
   void Apply(icFloatNumber *pDestPixel, const icFloatNumber *pSrcPixel) { m_pElem->Apply(this, pDestPixel, pSrcPixel); }
 
+  ///Time spent in Apply (only updated when built with ICC_PERF_COUNTERS)
+  CIccPerfCounter &GetPerf() { return m_perf; }
+
 protected:
   CIccApplyTagMpe *m_pApplyTag;
 
   CIccMultiProcessElement *m_pElem;
+
+  CIccPerfCounter m_perf;
 };
 
 
@@ -360,6 +371,7 @@ public:
   virtual const icChar *GetClassName() const { return "CIccTagMultiProcessElement"; }
 
   virtual void Describe(std::string &sDescription);
+  virtual void DescribeTo(IIccDescribeSink *pSink);
 
   virtual bool Read(icUInt32Number size, CIccIO *pIO);
   virtual bool Write(CIccIO *pIO);
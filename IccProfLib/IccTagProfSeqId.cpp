@@ -65,6 +65,7 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak Oct-21-2006
+// -Fixed leak in CIccTagProfileSequenceId::Write 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -597,6 +598,8 @@ bool CIccTagProfileSequenceId::Write(CIccIO *pIO)
 
   pIO->Seek(endpos, icSeekSet);
 
+  delete [] pos;
+
   return true;
 }
 
@@ -0,0 +1,516 @@
+/** @file
+    File:       IccThread.cpp
+
+    Contains:   Implementation of platform independent threading support
+
+    Version:    V1
+
+    Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation of thread pool and mutex support 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#include "IccThread.h"
+
+#if defined(ICC_NO_THREADS)
+  //No threading support
+#elif defined(WIN32) || defined(_WIN32) || defined(WIN64)
+  #define ICC_USE_WIN32_THREADS
+  #ifndef WIN32_LEAN_AND_MEAN
+    #define WIN32_LEAN_AND_MEAN
+  #endif
+  #ifndef _WIN32_WINNT
+    #define _WIN32_WINNT 0x0600  //Condition variables need Vista or later
+  #endif
+  #include <windows.h>
+#else
+  #define ICC_USE_PTHREADS
+  #include <pthread.h>
+  #include <unistd.h>
+#endif
+
+#ifdef USESAMPLEICCNAMESPACE
+namespace sampleICC {
+#endif
+
+/**
+**************************************************************************
+* Name: CIccMutex::CIccMutex
+* 
+* Purpose: 
+*  Constructor
+**************************************************************************
+*/
+CIccMutex::CIccMutex()
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  CRITICAL_SECTION *pCS = new CRITICAL_SECTION;
+  InitializeCriticalSection(pCS);
+  m_pMutex = pCS;
+#elif defined(ICC_USE_PTHREADS)
+  pthread_mutex_t *pMutex = new pthread_mutex_t;
+  pthread_mutex_init(pMutex, NULL);
+  m_pMutex = pMutex;
+#else
+  m_pMutex = NULL;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: CIccMutex::~CIccMutex
+* 
+* Purpose: 
+*  Destructor
+**************************************************************************
+*/
+CIccMutex::~CIccMutex()
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  DeleteCriticalSection((CRITICAL_SECTION*)m_pMutex);
+  delete (CRITICAL_SECTION*)m_pMutex;
+#elif defined(ICC_USE_PTHREADS)
+  pthread_mutex_destroy((pthread_mutex_t*)m_pMutex);
+  delete (pthread_mutex_t*)m_pMutex;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: CIccMutex::Lock
+* 
+* Purpose: 
+*  Blocks until the mutex is owned by the calling thread
+**************************************************************************
+*/
+bool CIccMutex::Lock()
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  EnterCriticalSection((CRITICAL_SECTION*)m_pMutex);
+  return true;
+#elif defined(ICC_USE_PTHREADS)
+  return pthread_mutex_lock((pthread_mutex_t*)m_pMutex)==0;
+#else
+  return true;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: CIccMutex::Unlock
+* 
+* Purpose: 
+*  Releases ownership of the mutex
+**************************************************************************
+*/
+bool CIccMutex::Unlock()
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  LeaveCriticalSection((CRITICAL_SECTION*)m_pMutex);
+  return true;
+#elif defined(ICC_USE_PTHREADS)
+  return pthread_mutex_unlock((pthread_mutex_t*)m_pMutex)==0;
+#else
+  return true;
+#endif
+}
+
+
+/**
+**************************************************************************
+* Name: CIccCondition::CIccCondition
+* 
+* Purpose: 
+*  Constructor
+**************************************************************************
+*/
+CIccCondition::CIccCondition()
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  CONDITION_VARIABLE *pCond = new CONDITION_VARIABLE;
+  InitializeConditionVariable(pCond);
+  m_pCond = pCond;
+#elif defined(ICC_USE_PTHREADS)
+  pthread_cond_t *pCond = new pthread_cond_t;
+  pthread_cond_init(pCond, NULL);
+  m_pCond = pCond;
+#else
+  m_pCond = NULL;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: CIccCondition::~CIccCondition
+* 
+* Purpose: 
+*  Destructor
+**************************************************************************
+*/
+CIccCondition::~CIccCondition()
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  delete (CONDITION_VARIABLE*)m_pCond;
+#elif defined(ICC_USE_PTHREADS)
+  pthread_cond_destroy((pthread_cond_t*)m_pCond);
+  delete (pthread_cond_t*)m_pCond;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: CIccCondition::Wait
+* 
+* Purpose: 
+*  Atomically releases mutex and blocks until the condition is signaled.
+*  The mutex is owned again by the calling thread when Wait returns.
+**************************************************************************
+*/
+bool CIccCondition::Wait(CIccMutex &mutex)
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  return SleepConditionVariableCS((CONDITION_VARIABLE*)m_pCond, (CRITICAL_SECTION*)mutex.m_pMutex, INFINITE)!=0;
+#elif defined(ICC_USE_PTHREADS)
+  return pthread_cond_wait((pthread_cond_t*)m_pCond, (pthread_mutex_t*)mutex.m_pMutex)==0;
+#else
+  return false;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: CIccCondition::Signal
+* 
+* Purpose: 
+*  Wakes one thread waiting on the condition
+**************************************************************************
+*/
+void CIccCondition::Signal()
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  WakeConditionVariable((CONDITION_VARIABLE*)m_pCond);
+#elif defined(ICC_USE_PTHREADS)
+  pthread_cond_signal((pthread_cond_t*)m_pCond);
+#endif
+}
+
+/**
+**************************************************************************
+* Name: CIccCondition::Broadcast
+* 
+* Purpose: 
+*  Wakes all threads waiting on the condition
+**************************************************************************
+*/
+void CIccCondition::Broadcast()
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  WakeAllConditionVariable((CONDITION_VARIABLE*)m_pCond);
+#elif defined(ICC_USE_PTHREADS)
+  pthread_cond_broadcast((pthread_cond_t*)m_pCond);
+#endif
+}
+
+
+/**
+**************************************************************************
+* Name: CIccAtomicFlag::Get
+* 
+* Purpose: 
+*  Reads the flag with acquire semantics
+**************************************************************************
+*/
+bool CIccAtomicFlag::Get() const
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  return InterlockedCompareExchange((volatile LONG*)&m_nValue, 0, 0)!=0;
+#elif defined(ICC_USE_PTHREADS)
+  return __atomic_load_n(&m_nValue, __ATOMIC_ACQUIRE)!=0;
+#else
+  return m_nValue!=0;
+#endif
+}
+
+/**
+**************************************************************************
+* Name: CIccAtomicFlag::Set
+* 
+* Purpose: 
+*  Writes the flag with release semantics
+**************************************************************************
+*/
+void CIccAtomicFlag::Set(bool bValue)
+{
+#if defined(ICC_USE_WIN32_THREADS)
+  InterlockedExchange((volatile LONG*)&m_nValue, bValue ? 1 : 0);
+#elif defined(ICC_USE_PTHREADS)
+  __atomic_store_n(&m_nValue, bValue ? 1L : 0L, __ATOMIC_RELEASE);
+#else
+  m_nValue = bValue ? 1 : 0;
+#endif
+}
+
+
+/**
+**************************************************************************
+* Name: icGetNumProcessors
+* 
+* Purpose: 
+*  Returns the number of online processors (always at least 1)
+**************************************************************************
+*/
+icUInt32Number icGetNumProcessors()
+{
+  icUInt32Number nProcessors = 1;
+
+#if defined(ICC_USE_WIN32_THREADS)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  nProcessors = (icUInt32Number)info.dwNumberOfProcessors;
+#elif defined(ICC_USE_PTHREADS) && defined(_SC_NPROCESSORS_ONLN)
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  if (n>0)
+    nProcessors = (icUInt32Number)n;
+#endif
+
+  return nProcessors ? nProcessors : 1;
+}
+
+/**
+**************************************************************************
+* Name: icGetNumThreads
+* 
+* Purpose: 
+*  Resolves a requested thread count (0 = one per processor)
+**************************************************************************
+*/
+icUInt32Number icGetNumThreads(icUInt32Number nThreads)
+{
+#if defined(ICC_NO_THREADS)
+  return 1;
+#else
+  if (!nThreads)
+    nThreads = icGetNumProcessors();
+
+  return nThreads;
+#endif
+}
+
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Shared state of an icParallelExecute() call.  Workers pull blocks of
+*  items from m_nNext until all items have been handed out.
+**************************************************************************
+*/
+class CIccParallelState
+{
+public:
+  IIccParallelTask *m_pTask;
+  icUInt32Number m_nItems;
+  icUInt32Number m_nBlockSize;
+  icUInt32Number m_nNext;
+  CIccMutex m_mutex;
+
+  void Run(icUInt32Number nThread)
+  {
+    for (;;) {
+      icUInt32Number nStart, nEnd;
+
+      m_mutex.Lock();
+      nStart = m_nNext;
+      if (nStart<m_nItems)
+        m_nNext = (m_nItems-nStart > m_nBlockSize) ? nStart+m_nBlockSize : m_nItems;
+      nEnd = m_nNext;
+      m_mutex.Unlock();
+
+      if (nStart>=m_nItems)
+        break;
+
+      m_pTask->Execute(nThread, nStart, nEnd);
+    }
+  }
+};
+
+class CIccParallelWorker
+{
+public:
+  CIccParallelState *m_pState;
+  icUInt32Number m_nThread;
+};
+
+#if defined(ICC_USE_WIN32_THREADS)
+static DWORD WINAPI icParallelThreadProc(LPVOID pParam)
+{
+  CIccParallelWorker *pWorker = (CIccParallelWorker*)pParam;
+  pWorker->m_pState->Run(pWorker->m_nThread);
+  return 0;
+}
+#elif defined(ICC_USE_PTHREADS)
+extern "C" {
+static void *icParallelThreadProc(void *pParam)
+{
+  CIccParallelWorker *pWorker = (CIccParallelWorker*)pParam;
+  pWorker->m_pState->Run(pWorker->m_nThread);
+  return NULL;
+}
+}
+#endif
+
+/**
+**************************************************************************
+* Name: icParallelExecute
+* 
+* Purpose: 
+*  Processes nItems items through pTask using up to nThreads threads.  The
+*  calling thread is used as thread 0.  If additional threads cannot be
+*  created the remaining work is simply done by the threads that were.
+* 
+* Args:
+*  pTask = task to execute
+*  nItems = total number of items
+*  nBlockSize = number of items handed to a thread at a time
+*  nThreads = maximum number of threads to use (0 = number of processors)
+* 
+* Return:
+*  true if all items were processed.
+**************************************************************************
+*/
+bool icParallelExecute(IIccParallelTask *pTask, icUInt32Number nItems,
+                       icUInt32Number nBlockSize/*=1*/, icUInt32Number nThreads/*=0*/)
+{
+  if (!pTask)
+    return false;
+
+  if (!nItems)
+    return true;
+
+  if (!nBlockSize)
+    nBlockSize = 1;
+
+  nThreads = icGetNumThreads(nThreads);
+
+  icUInt32Number nBlocks = (nItems + nBlockSize - 1) / nBlockSize;
+  if (nThreads>nBlocks)
+    nThreads = nBlocks;
+
+  if (nThreads<=1) {
+    pTask->Execute(0, 0, nItems);
+    return true;
+  }
+
+  CIccParallelState state;
+  state.m_pTask = pTask;
+  state.m_nItems = nItems;
+  state.m_nBlockSize = nBlockSize;
+  state.m_nNext = 0;
+
+#if defined(ICC_USE_WIN32_THREADS) || defined(ICC_USE_PTHREADS)
+  CIccParallelWorker *pWorkers = new CIccParallelWorker[nThreads];
+#if defined(ICC_USE_WIN32_THREADS)
+  HANDLE *pThreads = new HANDLE[nThreads];
+#else
+  pthread_t *pThreads = new pthread_t[nThreads];
+#endif
+  bool *bStarted = new bool[nThreads];
+  icUInt32Number i;
+
+  for (i=1; i<nThreads; i++) {
+    pWorkers[i].m_pState = &state;
+    pWorkers[i].m_nThread = i;
+
+#if defined(ICC_USE_WIN32_THREADS)
+    pThreads[i] = CreateThread(NULL, 0, icParallelThreadProc, &pWorkers[i], 0, NULL);
+    bStarted[i] = pThreads[i]!=NULL;
+#else
+    bStarted[i] = pthread_create(&pThreads[i], NULL, icParallelThreadProc, &pWorkers[i])==0;
+#endif
+  }
+
+  state.Run(0);
+
+  for (i=1; i<nThreads; i++) {
+    if (bStarted[i]) {
+#if defined(ICC_USE_WIN32_THREADS)
+      WaitForSingleObject(pThreads[i], INFINITE);
+      CloseHandle(pThreads[i]);
+#else
+      pthread_join(pThreads[i], NULL);
+#endif
+    }
+  }
+
+  delete [] bStarted;
+  delete [] pThreads;
+  delete [] pWorkers;
+#else
+  state.Run(0);
+#endif
+
+  return true;
+}
+
+#ifdef USESAMPLEICCNAMESPACE
+} //namespace sampleICC
+#endif
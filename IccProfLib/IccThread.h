@@ -0,0 +1,226 @@
+/** @file
+    File:       IccThread.h
+
+    Contains:   Platform independent threading support used by IccProfLib
+
+    Version:    V1
+
+    Copyright:   see ICC Software License
+*/
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2015 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation of thread pool and mutex support 10-19-2026
+//
+// -Added CIccCondition 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#if !defined(_ICCTHREAD_H)
+#define _ICCTHREAD_H
+
+#include "IccDefs.h"
+#include "IccProfLibConf.h"
+
+#ifdef USESAMPLEICCNAMESPACE
+namespace sampleICC {
+#endif
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Simple non-recursive mutual exclusion object.  When IccProfLib is built
+*  with ICC_NO_THREADS defined all operations are no-ops.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccMutex
+{
+public:
+  CIccMutex();
+  virtual ~CIccMutex();
+
+  bool Lock();
+  bool Unlock();
+
+private:
+  //Not copyable
+  CIccMutex(const CIccMutex &);
+  CIccMutex &operator=(const CIccMutex &);
+
+  void *m_pMutex;
+
+  friend class CIccCondition;
+};
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Scoped lock that holds a CIccMutex for the lifetime of the object.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccMutexLock
+{
+public:
+  CIccMutexLock(CIccMutex &mutex) : m_mutex(mutex) { m_mutex.Lock(); }
+  ~CIccMutexLock() { m_mutex.Unlock(); }
+
+private:
+  CIccMutexLock(const CIccMutexLock &);
+  CIccMutexLock &operator=(const CIccMutexLock &);
+
+  CIccMutex &m_mutex;
+};
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Condition variable used with a CIccMutex to wait for state changes made
+*  by other threads.  Wait() must be called with the mutex locked.  When
+*  IccProfLib is built with ICC_NO_THREADS defined Wait() returns false
+*  since no other thread could ever signal it.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccCondition
+{
+public:
+  CIccCondition();
+  virtual ~CIccCondition();
+
+  bool Wait(CIccMutex &mutex);
+  void Signal();
+  void Broadcast();
+
+private:
+  //Not copyable
+  CIccCondition(const CIccCondition &);
+  CIccCondition &operator=(const CIccCondition &);
+
+  void *m_pCond;
+};
+
+/**
+**************************************************************************
+* Type: Class
+* 
+* Purpose: 
+*  Boolean flag that can be tested without holding a mutex.  Get() has
+*  acquire and Set() release semantics, so data written before a Set() is
+*  visible to a thread whose Get() sees the new value.
+**************************************************************************
+*/
+class ICCPROFLIB_API CIccAtomicFlag
+{
+public:
+  CIccAtomicFlag(bool bValue=false) { m_nValue = bValue ? 1 : 0; }
+
+  bool Get() const;
+  void Set(bool bValue);
+
+private:
+  //Not copyable
+  CIccAtomicFlag(const CIccAtomicFlag &);
+  CIccAtomicFlag &operator=(const CIccAtomicFlag &);
+
+  volatile long m_nValue;
+};
+
+/**
+**************************************************************************
+* Type: Interface Class
+* 
+* Purpose: 
+*  Interface for work that can be partitioned into independent ranges of
+*  items by icParallelExecute().  Execute() is called concurrently from
+*  several worker threads, each with a distinct nThread index in the range
+*  0 to nThreads-1, so implementations can keep per-thread state (apply
+*  objects, counters, etc) indexed by nThread without locking.
+**************************************************************************
+*/
+class ICCPROFLIB_API IIccParallelTask
+{
+public:
+  virtual ~IIccParallelTask() {}
+
+  ///Process items nStart up to (but not including) nEnd
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)=0;
+};
+
+///Returns the number of processors available to the process (at least 1)
+ICCPROFLIB_API icUInt32Number icGetNumProcessors();
+
+///Returns the number of threads that icParallelExecute will use for nThreads (0 = all processors)
+ICCPROFLIB_API icUInt32Number icGetNumThreads(icUInt32Number nThreads);
+
+/**
+ * Distributes nItems over nThreads threads in blocks of nBlockSize items.
+ * The calling thread participates as thread 0.  Returns once all items have
+ * been processed.  nThreads=0 uses icGetNumProcessors() threads.
+ */
+ICCPROFLIB_API bool icParallelExecute(IIccParallelTask *pTask, icUInt32Number nItems,
+                                      icUInt32Number nBlockSize=1, icUInt32Number nThreads=0);
+
+#ifdef USESAMPLEICCNAMESPACE
+} //namespace sampleICC
+#endif
+
+#endif //_ICCTHREAD_H
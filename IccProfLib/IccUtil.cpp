@@ -65,6 +65,7 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Added array versions of color conversions and icCubeRoot 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -391,6 +392,16 @@ icFloatNumber icDeltaE(icFloatNumber *lab1, icFloatNumber *lab2)
 }
 
 
+void icDeltaEN(icFloatNumber *pDE, const icFloatNumber *lab1, const icFloatNumber *lab2, icUInt32Number nPixels)
+{
+  icUInt32Number i;
+
+  for (i=0; i<nPixels; i++, lab1+=3, lab2+=3) {
+    pDE[i] = sqrt(icSq(lab1[0]-lab2[0]) + icSq(lab1[1]-lab2[1]) + icSq(lab1[2]-lab2[2]));
+  }
+}
+
+
 icS15Fixed16Number icDtoF(icFloatNumber num)
 {
   icS15Fixed16Number rv;
@@ -581,6 +592,68 @@ static icFloatNumber icubeth(icFloatNumber v)
 #endif
 }
 
+/**
+ ******************************************************************************
+* Name: icCubeRoot
+* 
+* Purpose: 
+*  Computes the cube root of v without calling pow or cbrt.  An estimate
+*  made by dividing the float exponent by three is refined with two Halley
+*  iterations in double precision giving a result accurate to float
+*  precision.  Loops calling this function can be vectorized by the
+*  compiler.  The estimate relies on the float bit layout, so builds where
+*  icFloatNumber is wider than float use pow instead.
+* 
+* Args: 
+*  v - value to take the cube root of
+* 
+* Return: 
+*  cube root of v
+******************************************************************************
+*/
+icFloatNumber icCubeRoot(icFloatNumber v)
+{
+  if (sizeof(icFloatNumber)!=sizeof(float)) {
+    double d = pow((double)(v<0 ? -v : v), 1.0/3.0);
+    return (icFloatNumber)(v<0 ? -d : d);
+  }
+
+  float a = (float)(v<0 ? -v : v);
+
+  //Zero, denormals, infinity and NaN are left to the library
+  if (!(a>=1.0e-30f && a<=1.0e30f))
+    return (icFloatNumber)ICC_CBRTF(v);
+
+  union {
+    float f;
+    icUInt32Number i;
+  } u;
+
+  u.f = a;
+  u.i = u.i/3 + 709921077;
+
+  double x = a;
+  double y = u.f;
+  double y3;
+
+  y3 = y*y*y;
+  y = y * (y3 + x + x) / (y3 + y3 + x);
+  y3 = y*y*y;
+  y = y * (y3 + x + x) / (y3 + y3 + x);
+
+  return (icFloatNumber)(v<0 ? -y : y);
+}
+
+static inline icFloatNumber icCubethFast(icFloatNumber v)
+{
+  if (v> 0.008856) {
+    return icCubeRoot(v);
+  }
+  else {
+    return (icFloatNumber)(7.787037037037037037037037037037*v + 16.0/116.0);
+  }
+}
+
 void icLabtoXYZ(icFloatNumber *XYZ, icFloatNumber *Lab /*=NULL*/, icFloatNumber *WhiteXYZ /*=NULL*/)
 {
   if (!Lab)
@@ -617,6 +690,46 @@ void icXYZtoLab(icFloatNumber *Lab, icFloatNumber *XYZ /*=NULL*/, icFloatNumber
 
 }
 
+void icLabtoXYZN(icFloatNumber *XYZ, const icFloatNumber *Lab, icUInt32Number nPixels, const icFloatNumber *WhiteXYZ /*=NULL*/)
+{
+  icUInt32Number i;
+
+  if (!WhiteXYZ)
+    WhiteXYZ = icD50XYZ;
+
+  icFloatNumber Xw = WhiteXYZ[0], Yw = WhiteXYZ[1], Zw = WhiteXYZ[2];
+
+  for (i=0; i<nPixels; i++, XYZ+=3, Lab+=3) {
+    icFloatNumber fy = (icFloatNumber)((Lab[0] + 16.0) / 116.0);
+    icFloatNumber fx = (icFloatNumber)(Lab[1]/500.0 + fy);
+    icFloatNumber fz = (icFloatNumber)(fy - Lab[2]/200.0);
+
+    XYZ[0] = icubeth(fx) * Xw;
+    XYZ[1] = icubeth(fy) * Yw;
+    XYZ[2] = icubeth(fz) * Zw;
+  }
+}
+
+void icXYZtoLabN(icFloatNumber *Lab, const icFloatNumber *XYZ, icUInt32Number nPixels, const icFloatNumber *WhiteXYZ /*=NULL*/)
+{
+  icUInt32Number i;
+
+  if (!WhiteXYZ)
+    WhiteXYZ = icD50XYZ;
+
+  icFloatNumber Xw = WhiteXYZ[0], Yw = WhiteXYZ[1], Zw = WhiteXYZ[2];
+
+  for (i=0; i<nPixels; i++, XYZ+=3, Lab+=3) {
+    icFloatNumber Xn = icCubethFast(XYZ[0] / Xw);
+    icFloatNumber Yn = icCubethFast(XYZ[1] / Yw);
+    icFloatNumber Zn = icCubethFast(XYZ[2] / Zw);
+
+    Lab[0] = (icFloatNumber)(116.0 * Yn - 16.0);
+    Lab[1] = (icFloatNumber)(500.0 * (Xn - Yn));
+    Lab[2] = (icFloatNumber)(200.0 * (Yn - Zn));
+  }
+}
+
 void icLch2Lab(icFloatNumber *Lab, icFloatNumber *Lch /*=NULL*/)
 {
   if (!Lch) {
@@ -649,6 +762,36 @@ void icLab2Lch(icFloatNumber *Lch, icFloatNumber *Lab /*=NULL*/)
   Lch[2] = h;
 }
 
+void icLch2LabN(icFloatNumber *Lab, const icFloatNumber *Lch, icUInt32Number nPixels)
+{
+  icUInt32Number i;
+
+  for (i=0; i<nPixels; i++, Lab+=3, Lch+=3) {
+    icFloatNumber a = (icFloatNumber)(Lch[1] * cos(Lch[2] * PI / 180.0));
+    icFloatNumber b = (icFloatNumber)(Lch[1] * sin(Lch[2] * PI / 180.0));
+
+    Lab[0] = Lch[0];
+    Lab[1] = a;
+    Lab[2] = b;
+  }
+}
+
+void icLab2LchN(icFloatNumber *Lch, const icFloatNumber *Lab, icUInt32Number nPixels)
+{
+  icUInt32Number i;
+
+  for (i=0; i<nPixels; i++, Lch+=3, Lab+=3) {
+    icFloatNumber c = sqrt(Lab[1]*Lab[1] + Lab[2]*Lab[2]);
+    icFloatNumber h = (icFloatNumber)(atan2(Lab[2], Lab[1]) * 180.0 / PI);
+    if (h<0.0)
+      h+=360.0;
+
+    Lch[0] = Lab[0];
+    Lch[1] = c;
+    Lch[2] = h;
+  }
+}
+
 icFloatNumber icMin(icFloatNumber v1, icFloatNumber v2)
 {
   return( v1 < v2 ? v1 : v2 );
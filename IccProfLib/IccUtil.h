@@ -65,6 +65,7 @@
 // HISTORY:
 //
 // -Initial implementation by Max Derhak 5-15-2003
+// -Added array versions of color conversions and icCubeRoot 10-19-2026
 //
 //////////////////////////////////////////////////////////////////////
 
@@ -141,6 +142,22 @@ icUInt32Number ICCPROFLIB_API icIntMax(icUInt32Number v1, icUInt32Number v2);
 
 icFloatNumber ICCPROFLIB_API icDeltaE(icFloatNumber *Lab1, icFloatNumber *Lab2);
 
+///Fast cube root (accurate to float precision, avoids libm pow/cbrt)
+icFloatNumber ICCPROFLIB_API icCubeRoot(icFloatNumber v);
+
+/**Array versions of the conversions above for nPixels packed triples.  Source and
+ * destination may be the same buffer.  icXYZtoLabN uses icCubeRoot() so results may
+ * differ from icXYZtoLab() by float rounding.
+ */
+void ICCPROFLIB_API icXYZtoLabN(icFloatNumber *Lab, const icFloatNumber *XYZ, icUInt32Number nPixels, const icFloatNumber *WhiteXYZ=NULL);
+void ICCPROFLIB_API icLabtoXYZN(icFloatNumber *XYZ, const icFloatNumber *Lab, icUInt32Number nPixels, const icFloatNumber *WhiteXYZ=NULL);
+
+void ICCPROFLIB_API icLab2LchN(icFloatNumber *Lch, const icFloatNumber *Lab, icUInt32Number nPixels);
+void ICCPROFLIB_API icLch2LabN(icFloatNumber *Lab, const icFloatNumber *Lch, icUInt32Number nPixels);
+
+///Stores icDeltaE of each of nPixels pairs of Lab values in pDE
+void ICCPROFLIB_API icDeltaEN(icFloatNumber *pDE, const icFloatNumber *Lab1, const icFloatNumber *Lab2, icUInt32Number nPixels);
+
 /**Floating point encoding of Lab in PCS is in range 0.0 to 1.0 */
 ///Here are some conversion routines to convert to regular Lab encoding
 void ICCPROFLIB_API icLabFromPcs(icFloatNumber *Lab);
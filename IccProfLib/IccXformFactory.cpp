@@ -93,7 +93,7 @@ CIccXform* CIccBaseXformFactory::CreateXform(icXformType xformSig, CIccTag *pTag
 
    case icXformTypeNamedColor:
      if (pHintManager) {
-			 IIccCreateXformHint* pHint = pHintManager->GetHint("CIccCreateXformNamedColorHint");
+			 IIccCreateXformHint* pHint = pHintManager->GetHint("CIccCreateNamedColorXformHint");
 			 if (pHint) {
 				 CIccCreateNamedColorXformHint *pNCHint = (CIccCreateNamedColorXformHint*)pHint;
 				 return new CIccXformNamedColor(pTag, pNCHint->csPcs, pNCHint->csDevice);
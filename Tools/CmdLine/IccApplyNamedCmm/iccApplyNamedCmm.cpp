@@ -1,4 +1,7 @@
 #include <fstream>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "IccCmm.h"
 #include "IccUtil.h"
@@ -164,9 +167,479 @@ bool ParseName(icChar* pName, icChar* pString)
   return true;
 }
 
+//===================================================
+
+//Number of colors transformed together in streaming mode
+#define STREAM_BLOCK_SIZE 4096
+
+//Size of streaming input and output buffers
+#define STREAM_BUF_SIZE   65536
+
+/**
+ * Reads lines from a stream using large block reads.  Lines are returned
+ * in place (the line feed is replaced by a terminating zero) and are only
+ * valid until the next call to GetLine().
+ */
+class CDataLineReader
+{
+public:
+  CDataLineReader(std::istream &InputData) : m_InputData(InputData)
+  {
+    m_nSize = STREAM_BUF_SIZE;
+    m_pBuf = (icChar*)malloc(m_nSize+1);
+    m_nPos = m_nLen = 0;
+    m_bEof = false;
+  }
+  ~CDataLineReader() { if (m_pBuf) free(m_pBuf); }
+
+  icChar *GetLine()
+  {
+    for (;;) {
+      icChar *pStart = m_pBuf + m_nPos;
+      icChar *pEnd = (icChar*)memchr(pStart, '\n', m_nLen - m_nPos);
+
+      if (pEnd) {
+        *pEnd = '\0';
+        m_nPos = (size_t)(pEnd - m_pBuf) + 1;
+        return pStart;
+      }
+
+      if (m_bEof) {
+        if (m_nPos>=m_nLen)
+          return NULL;
+        m_pBuf[m_nLen] = '\0';
+        m_nPos = m_nLen;
+        return pStart;
+      }
+
+      //Move the partial line to the front and fill the rest of the buffer
+      m_nLen -= m_nPos;
+      memmove(m_pBuf, pStart, m_nLen);
+      m_nPos = 0;
+
+      if (m_nLen==m_nSize) {
+        icChar *pBuf = (icChar*)realloc(m_pBuf, m_nSize*2+1);
+        if (!pBuf) {
+          m_bEof = true;
+          continue;
+        }
+        m_pBuf = pBuf;
+        m_nSize *= 2;
+      }
+
+      m_InputData.read(m_pBuf + m_nLen, (std::streamsize)(m_nSize - m_nLen));
+      m_nLen += (size_t)m_InputData.gcount();
+      if (!m_InputData)
+        m_bEof = true;
+    }
+  }
+
+protected:
+  std::istream &m_InputData;
+  icChar *m_pBuf;
+  size_t m_nSize, m_nPos, m_nLen;
+  bool m_bEof;
+};
+
+/**
+ * Buffers output text and writes it to a FILE in large blocks.  Numbers
+ * are formatted the same as printf("%9.4lf ") without calling printf
+ * for the usual case.
+ */
+class CDataWriter
+{
+public:
+  CDataWriter(FILE *f) { m_f = f; m_nLen = 0; }
+  ~CDataWriter() { Flush(); }
+
+  void Flush()
+  {
+    if (m_nLen) {
+      fwrite(m_buf, 1, m_nLen, m_f);
+      m_nLen = 0;
+    }
+  }
+
+  void Write(const icChar *szText, size_t nLen)
+  {
+    if (m_nLen + nLen > sizeof(m_buf)) {
+      Flush();
+      if (nLen > sizeof(m_buf)) {
+        fwrite(szText, 1, nLen, m_f);
+        return;
+      }
+    }
+    memcpy(m_buf + m_nLen, szText, nLen);
+    m_nLen += nLen;
+  }
+
+  void Puts(const icChar *szText) { Write(szText, strlen(szText)); }
+
+  void PutName(const icChar *szName, const icChar *szEnd)
+  {
+    Write("{ \"", 3);
+    Puts(szName);
+    Puts(szEnd);
+  }
+
+  void PutNumber(icFloatNumber v)
+  {
+    icChar buf[512];
+    double d = v;
+    double a = d<0.0 ? -d : d;
+    double s = a * 10000.0;
+    double s1 = floor(s);
+
+    //Fall back to printf for large, non-finite and exactly halfway values
+    if (!(a < 1.0e9) || s-s1 == 0.5) {
+      sprintf(buf, "%9.4lf ", d);
+      Puts(buf);
+      return;
+    }
+
+    ICUINT64TYPE n = (ICUINT64TYPE)s1;
+    if (s-s1 > 0.5)
+      n++;
+
+    icUInt32Number nInt = (icUInt32Number)(n / 10000);
+    icUInt32Number nFrac = (icUInt32Number)(n % 10000);
+    icChar *ptr = buf + sizeof(buf);
+    int i;
+
+    *--ptr = ' ';
+    for (i=0; i<4; i++) {
+      *--ptr = (icChar)('0' + nFrac%10);
+      nFrac /= 10;
+    }
+    *--ptr = '.';
+    do {
+      *--ptr = (icChar)('0' + nInt%10);
+      nInt /= 10;
+    } while (nInt);
+
+    //Negative zero also prints with a sign
+    if (d<0.0 || (d==0.0 && 1.0/d<0.0))
+      *--ptr = '-';
+
+    while (buf + sizeof(buf) - ptr < 10)
+      *--ptr = ' ';
+
+    Write(ptr, buf + sizeof(buf) - ptr);
+  }
+
+protected:
+  FILE *m_f;
+  icChar m_buf[STREAM_BUF_SIZE];
+  size_t m_nLen;
+};
+
+static const double StreamPow10[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * Parses a number the slow way with the same sscanf() format used by
+ * ParseNumbers(), advancing ptr past it.
+ */
+static bool ParseNumberScanf(icFloatNumber &v, const icChar *&ptr)
+{
+  int nLen = 0;
+
+  if (sscanf(ptr, ICFLOATFMT "%n", &v, &nLen)<1 || !nLen)
+    return false;
+
+  ptr += nLen;
+  return true;
+}
+
+/**
+ * Parses a decimal number starting at ptr, advancing ptr past it.  Numbers
+ * whose mantissa and power of ten are both exact in icFloatNumber are
+ * converted with a single multiply or divide, which rounds the same way
+ * sscanf() does.  Anything else (including inf and nan) is handed to
+ * ParseNumberScanf().
+ */
+static bool ParseNumberFast(icFloatNumber &v, const icChar *&ptr)
+{
+  const icChar *p = ptr;
+  bool bNeg = false;
+  ICUINT64TYPE nMant = 0;
+  int nDigits = 0, nExp = 0, nSeen = 0;
+
+  if (*p=='-' || *p=='+') {
+    bNeg = (*p=='-');
+    p++;
+  }
+
+  while (*p>='0' && *p<='9') {
+    if (nDigits<19) {
+      nMant = nMant*10 + (*p-'0');
+      if (nMant)
+        nDigits++;
+    }
+    else
+      nExp++;
+    nSeen++;
+    p++;
+  }
+
+  if (*p=='.') {
+    p++;
+    while (*p>='0' && *p<='9') {
+      if (nDigits<19) {
+        nMant = nMant*10 + (*p-'0');
+        if (nMant)
+          nDigits++;
+        nExp--;
+      }
+      nSeen++;
+      p++;
+    }
+  }
+
+  if (!nSeen)
+    return ParseNumberScanf(v, ptr);
+
+  if (*p=='e' || *p=='E') {
+    const icChar *pe = p+1;
+    bool bExpNeg = false;
+    int nExpVal = 0;
+
+    if (*pe=='-' || *pe=='+') {
+      bExpNeg = (*pe=='-');
+      pe++;
+    }
+    if (*pe>='0' && *pe<='9') {
+      while (*pe>='0' && *pe<='9') {
+        if (nExpVal<10000)
+          nExpVal = nExpVal*10 + (*pe-'0');
+        pe++;
+      }
+      nExp += bExpNeg ? -nExpVal : nExpVal;
+      p = pe;
+    }
+  }
+
+  //A float holds 24 bit mantissas and powers of ten up to 1e10 exactly.  Doing
+  //the one multiply or divide in double and then rounding to float gives the
+  //correctly rounded float, since double has more than twice the precision.
+  if (sizeof(icFloatNumber)==sizeof(float)) {
+    if (nMant>16777216 || nExp<-10 || nExp>10)
+      return ParseNumberScanf(v, ptr);
+  }
+  else if (nDigits>15 || nExp<-22 || nExp>22) {
+    return ParseNumberScanf(v, ptr);
+  }
+
+  double d = (double)nMant;
+  if (nExp<0)
+    d /= StreamPow10[-nExp];
+  else
+    d *= StreamPow10[nExp];
+
+  v = (icFloatNumber)(bNeg ? -d : d);
+  ptr = p;
+
+  return true;
+}
+
+/**
+ * Streaming equivalent of ParseNumbers()
+ */
+static bool ParseNumbersFast(icFloatNumber* pData, const icChar* pString, icUInt32Number nSamples)
+{
+  const icChar *ptr = pString;
+  icUInt32Number i;
+
+  for (i=0; i<nSamples; i++) {
+    while (*ptr==' ' || *ptr=='\t' || *ptr=='\r' || *ptr=='\n' || *ptr=='\v' || *ptr=='\f')
+      ptr++;
+
+    if (!ParseNumberFast(pData[i], ptr))
+      return false;
+  }
+
+  return true;
+}
+
+/**
+ * Applies the data set remaining in Reader to namedCmm, processing
+ * STREAM_BLOCK_SIZE colors at a time.  Output is identical to the line at
+ * a time processing done by main().
+ */
+static int ApplyStream(CIccNamedColorCmm &namedCmm, CDataLineReader &Reader,
+                       icColorSpaceSignature SrcspaceSig, icFloatColorEncoding srcEncoding,
+                       icColorSpaceSignature DestspaceSig, icFloatColorEncoding destEncoding)
+{
+  CDataWriter Writer(stdout);
+  int nSamples = icGetSpaceSamples(SrcspaceSig);
+  int nDestSamples = icGetSpaceSamples(DestspaceSig);
+  char SrcNameBuf[256], DestNameBuf[256];
+  icChar *pLine;
+  int i;
+
+  if(SrcspaceSig==icSigNamedData) {
+    icFloatNumber DestPixel[16];
+
+    if (namedCmm.GetInterface()!=icApplyNamed2Pixel && namedCmm.GetInterface()!=icApplyNamed2Named) {
+      printf("Incorrect interface.\n");
+      return -1;
+    }
+
+    while((pLine = Reader.GetLine())) {
+      if(strlen(pLine)>=sizeof(SrcNameBuf) || !ParseName(SrcNameBuf, pLine))
+        continue;
+
+      if(namedCmm.GetInterface()==icApplyNamed2Pixel) {
+        if(namedCmm.Apply(DestPixel, SrcNameBuf)) {
+          Writer.Flush();
+          printf("Profile application failed.\n");
+          return -1;
+        }
+
+        if(CIccCmm::FromInternalEncoding(DestspaceSig, destEncoding, DestPixel, DestPixel)) {
+          Writer.Flush();
+          printf("Invalid final data encoding\n");
+          return -1;
+        }
+
+        for(i = 0; i<nDestSamples; i++)
+          Writer.PutNumber(DestPixel[i]);
+        Writer.Write("\t; ", 3);
+      }
+      else {
+        if(namedCmm.Apply(DestNameBuf, SrcNameBuf)) {
+          Writer.Flush();
+          printf("Profile application failed.\n");
+          return -1;
+        }
+
+        Writer.PutName(DestNameBuf, "\" }\t; ");
+      }
+
+      Writer.PutName(SrcNameBuf, "\" }\n");
+    }
+
+    return 0;
+  }
+
+  if (namedCmm.GetInterface()!=icApplyPixel2Pixel && namedCmm.GetInterface()!=icApplyPixel2Named) {
+    printf("Incorrect interface.\n");
+    return -1;
+  }
+
+  icFloatNumber *pPixels = new icFloatNumber[STREAM_BLOCK_SIZE*nSamples];
+  icFloatNumber *pSrcPixels = new icFloatNumber[STREAM_BLOCK_SIZE*nSamples];
+  icFloatNumber *pDestPixels = new icFloatNumber[STREAM_BLOCK_SIZE*(nDestSamples ? nDestSamples : 1)];
+  int nStatus = 0;
+  bool bDone = false;
+
+  //Resolve the encoding conversions once for all blocks
+  CIccColorEncoding SrcEncoder, DestEncoder;
+  icStatusCMM nSrcEncStat = SrcEncoder.Begin(SrcspaceSig, srcEncoding, true);
+  icStatusCMM nDestEncStat = icCmmStatOk;
+  if (namedCmm.GetInterface()==icApplyPixel2Pixel)
+    nDestEncStat = DestEncoder.Begin(DestspaceSig, destEncoding, false);
+
+  while (!bDone && !nStatus) {
+    icUInt32Number n, k;
+
+    //Gather a block of colors
+    for (n=0; n<STREAM_BLOCK_SIZE; ) {
+      if (!(pLine = Reader.GetLine())) {
+        bDone = true;
+        break;
+      }
+      if (ParseNumbersFast(&pPixels[n*nSamples], pLine, nSamples))
+        n++;
+    }
+
+    if (!n)
+      break;
+
+    if (nSrcEncStat || SrcEncoder.Apply(pSrcPixels, pPixels, n)) {
+      Writer.Flush();
+      printf("Invalid source data encoding\n");
+      nStatus = -1;
+      break;
+    }
+
+    if (namedCmm.GetInterface()==icApplyPixel2Pixel) {
+      if(namedCmm.Apply(pDestPixels, pSrcPixels, n)) {
+        Writer.Flush();
+        printf("Profile application failed.\n");
+        nStatus = -1;
+        break;
+      }
+
+      if (nDestEncStat || DestEncoder.Apply(pDestPixels, pDestPixels, n)) {
+        Writer.Flush();
+        printf("Invalid final data encoding\n");
+        nStatus = -1;
+        break;
+      }
+
+      for (k=0; k<n; k++) {
+        icFloatNumber *DestPixel = &pDestPixels[k*nDestSamples];
+        icFloatNumber *Pixel = &pPixels[k*nSamples];
+
+        for(i = 0; i<nDestSamples; i++)
+          Writer.PutNumber(DestPixel[i]);
+        Writer.Write("\t; ", 3);
+
+        for(i = 0; i<nSamples; i++)
+          Writer.PutNumber(Pixel[i]);
+        Writer.Write("\n", 1);
+      }
+    }
+    else {
+      for (k=0; k<n; k++) {
+        icFloatNumber *Pixel = &pPixels[k*nSamples];
+
+        if(namedCmm.Apply(DestNameBuf, &pSrcPixels[k*nSamples])) {
+          Writer.Flush();
+          printf("Profile application failed.\n");
+          nStatus = -1;
+          break;
+        }
+        Writer.PutName(DestNameBuf, "\" }\t; ");
+
+        for(i = 0; i<nSamples; i++)
+          Writer.PutNumber(Pixel[i]);
+        Writer.Write("\n", 1);
+      }
+    }
+  }
+
+  delete [] pPixels;
+  delete [] pSrcPixels;
+  delete [] pDestPixels;
+
+  return nStatus;
+}
+
+//===================================================
+
+static void PrintPerfReport(CIccCmm &cmm)
+{
+  std::string sReport;
+
+  if (!cmm.GetApply())
+    return;
+
+  cmm.GetApply()->GetPerfReport(sReport);
+  fprintf(stderr, "\nApply performance counters:\n%s", sReport.c_str());
+}
+
+//===================================================
+
 void Usage() 
 {
-	printf("Usage: iccApplyNamedCmm data_file_path final_data_encoding interpolation {profile_file_path Rendering_intent}\n\n");
+	printf("Usage: iccApplyNamedCmm {--stream} {--perf} {--timing} data_file_path final_data_encoding interpolation {profile_file_path Rendering_intent}\n\n");
+	printf("  --stream processes the data set in blocks with buffered input and output (for large data sets)\n");
+	printf("  --perf prints the apply chain performance counters to stderr (requires IccProfLib built with ICC_PERF_COUNTERS)\n");
+	printf("  --timing prints the time spent opening profiles and setting up the transform to stderr\n\n");
 	printf("  For final_data_encoding:\n");
 	printf("    0 - icEncodeValue\n");
 	printf("    1 - icEncodePercent\n");
@@ -203,6 +676,27 @@ void Usage()
 
 int main(int argc, icChar* argv[])
 {
+  bool bStream = false;
+  bool bPerf = false;
+  bool bTiming = false;
+
+  //Options come before the positional arguments
+  while (argc>1 && !strncmp(argv[1], "--", 2)) {
+    if (!stricmp(argv[1], "--stream"))
+      bStream = true;
+    else if (!stricmp(argv[1], "--perf"))
+      bPerf = true;
+    else if (!stricmp(argv[1], "--timing"))
+      bTiming = true;
+    else {
+      printf("\nUnknown option [%s]\n", argv[1]);
+      Usage();
+      return -1;
+    }
+    argv++;
+    argc--;
+  }
+
 	int minargs = 4; // minimum number of arguments
   if(argc<minargs) {
 		Usage();
@@ -264,6 +758,10 @@ int main(int argc, icChar* argv[])
 
   int nIntent, nType;
   CIccNamedColorCmm namedCmm(SrcspaceSig, icSigUnknownData, !IsSpacePCS(SrcspaceSig));
+  CIccSetupReport SetupReport;
+
+  if (bTiming)
+    namedCmm.SetSetupListener(&SetupReport);
 
   int nCount;
   bool bUseMPE;
@@ -297,6 +795,13 @@ int main(int argc, icChar* argv[])
     return -1;
   }
 
+  if (bTiming) {
+    std::string sReport;
+
+    SetupReport.GetReport(sReport);
+    fprintf(stderr, "\nSetup timing:\n%s", sReport.c_str());
+  }
+
   icColorSpaceSignature DestspaceSig = namedCmm.GetDestSpace();
   int nDestSamples = icGetSpaceSamples(DestspaceSig);
   std::string OutPutData;
@@ -335,6 +840,17 @@ int main(int argc, icChar* argv[])
   
   fwrite(OutPutData.c_str(), 1, OutPutData.length(), stdout);
 
+  if (bStream) {
+    CDataLineReader Reader(InputData);
+
+    int nStatus = ApplyStream(namedCmm, Reader, SrcspaceSig, srcEncoding, DestspaceSig, destEncoding);
+
+    if (bPerf)
+      PrintPerfReport(namedCmm);
+
+    return nStatus;
+  }
+
   while(!InputData.eof()) {
 
     if(SrcspaceSig==icSigNamedData) {
@@ -446,6 +962,8 @@ int main(int argc, icChar* argv[])
     fwrite(OutPutData.c_str(), 1, OutPutData.length(), stdout);
   }
 
+  if (bPerf)
+    PrintPerfReport(namedCmm);
 
   return 0;
 }
@@ -66,6 +66,8 @@
 //
 // -Initial implementation by Max Derhak 5-15-2003
 //
+// -Added GetRowsPerStrip and 16 bit sample support 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 #include <stdio.h>
@@ -90,6 +92,7 @@ CTiffImg::CTiffImg()
   m_nHeight = 0;
   m_nBitsPerSample = 0;
   m_nSamples = 0;
+  m_nRowsPerStrip = 0;
 
   m_hTif = NULL;
   m_pStripBuf = NULL;
@@ -106,6 +109,7 @@ void CTiffImg::Close()
   m_nHeight = 0;
   m_nBitsPerSample = 0;
   m_nSamples = 0;
+  m_nRowsPerStrip = 0;
 
   if (m_hTif) {
     TIFFClose(m_hTif);
@@ -163,6 +167,7 @@ bool CTiffImg::Create(const char *szFname, unsigned long nWidth, unsigned long n
   TIFFSetField(m_hTif, TIFFTAG_SAMPLESPERPIXEL, m_nSamples);
   TIFFSetField(m_hTif, TIFFTAG_BITSPERSAMPLE, m_nBitsPerSample);
   TIFFSetField(m_hTif, TIFFTAG_ROWSPERSTRIP, 1);
+  m_nRowsPerStrip = 1;
   TIFFSetField(m_hTif, TIFFTAG_COMPRESSION, bCompress ? COMPRESSION_LZW : COMPRESSION_NONE);
   TIFFSetField(m_hTif, TIFFTAG_ORIENTATION, ORIENTATION_TOPLEFT);
   TIFFSetField(m_hTif, TIFFTAG_XRESOLUTION, fXRes);
@@ -195,13 +200,14 @@ bool CTiffImg::Open(const char *szFname)
   TIFFGetField(m_hTif, TIFFTAG_PLANARCONFIG, &nPlanar);
   TIFFGetField(m_hTif, TIFFTAG_SAMPLESPERPIXEL, &m_nSamples);
   TIFFGetField(m_hTif, TIFFTAG_BITSPERSAMPLE, &m_nBitsPerSample);
-  TIFFGetField(m_hTif, TIFFTAG_ROWSPERSTRIP, &m_nRowsPerStrip);
+  TIFFGetFieldDefaulted(m_hTif, TIFFTAG_ROWSPERSTRIP, &m_nRowsPerStrip);
   TIFFGetField(m_hTif, TIFFTAG_ORIENTATION, &nOrientation);
   TIFFGetField(m_hTif, TIFFTAG_XRESOLUTION, &m_fXRes);
   TIFFGetField(m_hTif, TIFFTAG_YRESOLUTION, &m_fYRes);
 
   if ((m_nSamples>1 && nPlanar != PLANARCONFIG_CONTIG) ||
-       nOrientation != ORIENTATION_TOPLEFT) {
+       nOrientation != ORIENTATION_TOPLEFT ||
+       (m_nBitsPerSample!=8 && m_nBitsPerSample!=16)) {
     Close();
     return false;
   }
@@ -66,6 +66,8 @@
 //
 // -Initial implementation by Max Derhak 5-15-2003
 //
+// -Added GetRowsPerStrip and 16 bit sample support 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 #if !defined(_TIFFIMG_H)
@@ -102,6 +104,7 @@ public:
   float GetYRes() {return m_fYRes;}
 
   unsigned long GetBytesPerLine() { return m_nBytesPerLine; }
+  unsigned long GetRowsPerStrip() { return m_nRowsPerStrip; }
 
 protected:
   TIFF *m_hTif;
@@ -66,14 +66,29 @@
 //
 // -Initial implementation by Max Derhak 5-15-2003
 //
+// -Pipelined multi-threaded strip processing and 16 bit support 10-19-2026
+//
+// -Added --perf option to report apply chain performance counters 10-19-2026
+//
+// -Added --timing option to report setup timing 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include "IccCmm.h"
 #include "IccUtil.h"
+#include "IccThread.h"
 #include "TiffImg.h"
 
+//Number of image bands that can be in flight for each thread
+#define BANDS_PER_THREAD  2
+
+//Smallest number of rows that are read, transformed and written as a band
+#define MIN_BAND_ROWS     32
+
 static icFloatNumber UnitClip(icFloatNumber v)
 {
   if (v<0.0)
@@ -83,19 +98,435 @@ static icFloatNumber UnitClip(icFloatNumber v)
   return v;
 }
 
+typedef enum {
+  BandFree,     //Available to be read into
+  BandRead,     //Read and waiting to be transformed
+  BandBusy,     //Being transformed
+  BandDone      //Transformed and waiting to be written
+} BandState;
+
+typedef struct {
+  unsigned long nBand;
+  unsigned long nRows;
+  unsigned char *pSrc;
+  unsigned char *pDst;
+  BandState nState;
+} ImgBand;
+
+/**
+ * Pipeline that reads the source image in bands of strips, transforms
+ * bands in parallel (each thread with its own apply object) and writes
+ * them to the destination image in order.  Bands are held in a ring of
+ * BANDS_PER_THREAD*nThreads slots so reading never gets more than that
+ * far ahead of writing.
+ *
+ * Every thread runs the same loop and takes whichever stage has work:
+ * writing the next band in order, reading the next band, or transforming
+ * a band that has been read.  Only one thread reads and one thread writes
+ * at a time.
+ */
+class CApplyPipeline : public IIccParallelTask
+{
+public:
+  CApplyPipeline(CTiffImg &SrcImg, CTiffImg &DstImg);
+  virtual ~CApplyPipeline();
+
+  bool Init(CIccCmm &cmm, icUInt32Number nThreads, unsigned long sphoto, unsigned long photo,
+            bool bSrcXYZ, bool bDstXYZ);
+
+  virtual void Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd);
+
+  bool Succeeded() { return !m_bError && m_nNextWrite==m_nBands; }
+
+  void GetPerfReport(std::string &sReport);
+
+protected:
+  bool ReadBand(ImgBand *pBand);
+  void TransformBand(icUInt32Number nThread, ImgBand *pBand);
+  bool WriteBand(ImgBand *pBand);
+
+  void DecodeLine(icFloatNumber *pPixels, unsigned char *pLine);
+  void EncodeLine(unsigned char *pLine, icFloatNumber *pPixels);
+
+  CTiffImg &m_SrcImg;
+  CTiffImg &m_DstImg;
+
+  unsigned long m_nWidth, m_nHeight, m_sn, m_dn, m_nBPS;
+  unsigned long m_sphoto, m_photo;
+  bool m_bSrcXYZ, m_bDstXYZ;
+
+  unsigned long m_nBandRows;
+  unsigned long m_nBands;
+  unsigned long m_nSlots;
+  ImgBand *m_pBands;
+
+  icUInt32Number m_nThreads;
+  CIccApplyCmm **m_pApply;
+  icFloatNumber **m_pSrcPixels;
+  icFloatNumber **m_pDstPixels;
+
+  CIccMutex m_mutex;
+  CIccCondition m_cond;
+  unsigned long m_nNextRead;
+  unsigned long m_nNextWrite;
+  bool m_bReading;
+  bool m_bWriting;
+  bool m_bError;
+};
+
+CApplyPipeline::CApplyPipeline(CTiffImg &SrcImg, CTiffImg &DstImg) : m_SrcImg(SrcImg), m_DstImg(DstImg)
+{
+  m_nBands = 0;
+  m_nSlots = 0;
+  m_pBands = NULL;
+
+  m_nThreads = 0;
+  m_pApply = NULL;
+  m_pSrcPixels = NULL;
+  m_pDstPixels = NULL;
+
+  m_nNextRead = 0;
+  m_nNextWrite = 0;
+  m_bReading = false;
+  m_bWriting = false;
+  m_bError = false;
+}
+
+CApplyPipeline::~CApplyPipeline()
+{
+  unsigned long i;
+
+  if (m_pBands) {
+    for (i=0; i<m_nSlots; i++) {
+      if (m_pBands[i].pSrc)
+        free(m_pBands[i].pSrc);
+      if (m_pBands[i].pDst)
+        free(m_pBands[i].pDst);
+    }
+    delete [] m_pBands;
+  }
+
+  for (i=0; i<m_nThreads; i++) {
+    if (m_pApply[i])
+      delete m_pApply[i];
+    if (m_pSrcPixels[i])
+      free(m_pSrcPixels[i]);
+    if (m_pDstPixels[i])
+      free(m_pDstPixels[i]);
+  }
+  if (m_pApply)
+    delete [] m_pApply;
+  if (m_pSrcPixels)
+    delete [] m_pSrcPixels;
+  if (m_pDstPixels)
+    delete [] m_pDstPixels;
+}
+
+bool CApplyPipeline::Init(CIccCmm &cmm, icUInt32Number nThreads, unsigned long sphoto, unsigned long photo,
+                          bool bSrcXYZ, bool bDstXYZ)
+{
+  unsigned long i;
+
+  m_nWidth = m_SrcImg.GetWidth();
+  m_nHeight = m_SrcImg.GetHeight();
+  m_nBPS = m_SrcImg.GetBitsPerSample();
+  m_sn = m_SrcImg.GetSamples();
+  m_dn = m_DstImg.GetSamples();
+  m_sphoto = sphoto;
+  m_photo = photo;
+  m_bSrcXYZ = bSrcXYZ;
+  m_bDstXYZ = bDstXYZ;
+
+  //Bands are made up of whole source strips so each strip is only decoded once
+  unsigned long nStripRows = m_SrcImg.GetRowsPerStrip();
+  if (!nStripRows || nStripRows>m_nHeight)
+    nStripRows = m_nHeight;
+
+  m_nBandRows = nStripRows;
+  if (m_nBandRows<MIN_BAND_ROWS)
+    m_nBandRows = ((MIN_BAND_ROWS + nStripRows - 1) / nStripRows) * nStripRows;
+  if (m_nBandRows>m_nHeight)
+    m_nBandRows = m_nHeight;
+
+  m_nBands = m_nBandRows ? (m_nHeight + m_nBandRows - 1) / m_nBandRows : 0;
+
+  m_nThreads = nThreads;
+  m_pApply = new CIccApplyCmm*[m_nThreads];
+  m_pSrcPixels = new icFloatNumber*[m_nThreads];
+  m_pDstPixels = new icFloatNumber*[m_nThreads];
+
+  for (i=0; i<m_nThreads; i++) {
+    m_pApply[i] = NULL;
+    m_pSrcPixels[i] = NULL;
+    m_pDstPixels[i] = NULL;
+  }
+
+  for (i=0; i<m_nThreads; i++) {
+    icStatusCMM stat;
+
+    m_pApply[i] = cmm.GetNewApplyCmm(stat);
+    m_pSrcPixels[i] = (icFloatNumber*)malloc(m_nWidth * m_sn * sizeof(icFloatNumber));
+    m_pDstPixels[i] = (icFloatNumber*)malloc(m_nWidth * m_dn * sizeof(icFloatNumber));
+
+    if (!m_pApply[i] || !m_pSrcPixels[i] || !m_pDstPixels[i])
+      return false;
+  }
+
+  m_nSlots = m_nThreads * BANDS_PER_THREAD;
+  m_pBands = new ImgBand[m_nSlots];
+
+  for (i=0; i<m_nSlots; i++) {
+    m_pBands[i].nBand = 0;
+    m_pBands[i].nRows = 0;
+    m_pBands[i].nState = BandFree;
+    m_pBands[i].pSrc = (unsigned char*)malloc(m_SrcImg.GetBytesPerLine() * m_nBandRows);
+    m_pBands[i].pDst = (unsigned char*)malloc(m_DstImg.GetBytesPerLine() * m_nBandRows);
+  }
+
+  for (i=0; i<m_nSlots; i++) {
+    if (!m_pBands[i].pSrc || !m_pBands[i].pDst)
+      return false;
+  }
+
+  return true;
+}
+
+void CApplyPipeline::GetPerfReport(std::string &sReport)
+{
+  icUInt32Number i;
+  char buf[64];
+
+  for (i=0; i<m_nThreads; i++) {
+    if (m_pApply[i]) {
+      sprintf(buf, "Thread %u:\n", i);
+      sReport += buf;
+      m_pApply[i]->GetPerfReport(sReport);
+    }
+  }
+}
+
+void CApplyPipeline::Execute(icUInt32Number nThread, icUInt32Number nStart, icUInt32Number nEnd)
+{
+  ImgBand *pBand;
+  unsigned long i;
+  bool bOk;
+
+  m_mutex.Lock();
+
+  while (!m_bError && m_nNextWrite<m_nBands) {
+
+    //Write the next band in order once it has been transformed
+    pBand = &m_pBands[m_nNextWrite % m_nSlots];
+    if (!m_bWriting && pBand->nState==BandDone && pBand->nBand==m_nNextWrite) {
+      m_bWriting = true;
+      m_mutex.Unlock();
+
+      bOk = WriteBand(pBand);
+
+      m_mutex.Lock();
+      pBand->nState = BandFree;
+      m_nNextWrite++;
+      m_bWriting = false;
+      if (!bOk)
+        m_bError = true;
+      m_cond.Broadcast();
+      continue;
+    }
+
+    //Read the next band if its slot has been written
+    pBand = &m_pBands[m_nNextRead % m_nSlots];
+    if (!m_bReading && m_nNextRead<m_nBands && pBand->nState==BandFree) {
+      m_bReading = true;
+      pBand->nBand = m_nNextRead++;
+      m_mutex.Unlock();
+
+      bOk = ReadBand(pBand);
+
+      m_mutex.Lock();
+      pBand->nState = BandRead;
+      m_bReading = false;
+      if (!bOk)
+        m_bError = true;
+      m_cond.Broadcast();
+      continue;
+    }
+
+    //Transform any band that has been read
+    for (pBand=NULL, i=0; i<m_nSlots; i++) {
+      if (m_pBands[i].nState==BandRead) {
+        pBand = &m_pBands[i];
+        break;
+      }
+    }
+    if (pBand) {
+      pBand->nState = BandBusy;
+      m_mutex.Unlock();
+
+      TransformBand(nThread, pBand);
+
+      m_mutex.Lock();
+      pBand->nState = BandDone;
+      m_cond.Broadcast();
+      continue;
+    }
+
+    if (!m_cond.Wait(m_mutex))
+      m_bError = true;
+  }
+
+  m_cond.Broadcast();
+  m_mutex.Unlock();
+}
+
+bool CApplyPipeline::ReadBand(ImgBand *pBand)
+{
+  unsigned long i, nBytes = m_SrcImg.GetBytesPerLine();
+  unsigned char *pLine = pBand->pSrc;
+
+  pBand->nRows = m_nHeight - pBand->nBand * m_nBandRows;
+  if (pBand->nRows>m_nBandRows)
+    pBand->nRows = m_nBandRows;
+
+  for (i=0; i<pBand->nRows; i++, pLine+=nBytes) {
+    if (!m_SrcImg.ReadLine(pLine))
+      return false;
+  }
+
+  return true;
+}
+
+void CApplyPipeline::TransformBand(icUInt32Number nThread, ImgBand *pBand)
+{
+  unsigned long i;
+  unsigned long nSrcBytes = m_SrcImg.GetBytesPerLine();
+  unsigned long nDstBytes = m_DstImg.GetBytesPerLine();
+  icFloatNumber *pSrcPixels = m_pSrcPixels[nThread];
+  icFloatNumber *pDstPixels = m_pDstPixels[nThread];
+
+  for (i=0; i<pBand->nRows; i++) {
+    DecodeLine(pSrcPixels, pBand->pSrc + i*nSrcBytes);
+
+    m_pApply[nThread]->Apply(pDstPixels, pSrcPixels, m_nWidth);
+
+    EncodeLine(pBand->pDst + i*nDstBytes, pDstPixels);
+  }
+}
+
+bool CApplyPipeline::WriteBand(ImgBand *pBand)
+{
+  unsigned long i, nBytes = m_DstImg.GetBytesPerLine();
+  unsigned char *pLine = pBand->pDst;
+
+  for (i=0; i<pBand->nRows; i++, pLine+=nBytes) {
+    if (!m_DstImg.WriteLine(pLine))
+      return false;
+  }
+
+  return true;
+}
+
+void CApplyPipeline::DecodeLine(icFloatNumber *pPixels, unsigned char *pLine)
+{
+  unsigned long j, k;
+  icFloatNumber *Pixel = pPixels;
+
+  if (m_nBPS==16) {
+    unsigned short *sptr = (unsigned short*)pLine;
+
+    for (j=0; j<m_nWidth; j++, sptr+=m_sn, Pixel+=m_sn) {
+      if (m_sphoto==PHOTO_CIELAB) {
+        Pixel[0] = (icFloatNumber)sptr[0] / 65535.0f;
+        Pixel[1] = ((icFloatNumber)((short)sptr[1]) / 256.0f + 128.0f) / 255.0f;
+        Pixel[2] = ((icFloatNumber)((short)sptr[2]) / 256.0f + 128.0f) / 255.0f;
+      }
+      else {
+        for (k=0; k<m_sn; k++) {
+          Pixel[k] = (icFloatNumber)sptr[k] / 65535.0f;
+        }
+      }
+    }
+  }
+  else {
+    unsigned char *sptr = pLine;
+
+    for (j=0; j<m_nWidth; j++, sptr+=m_sn, Pixel+=m_sn) {
+      if (m_sphoto==PHOTO_CIELAB) {
+        Pixel[0] = (icFloatNumber)sptr[0] / 255.0f;
+        Pixel[1] = ((icFloatNumber)((signed char)sptr[1]) + 128.0f) / 255.0f;
+        Pixel[2] = ((icFloatNumber)((signed char)sptr[2]) + 128.0f) / 255.0f;
+      }
+      else {
+        for (k=0; k<m_sn; k++) {
+          Pixel[k] = (icFloatNumber)sptr[k] / 255.0f;
+        }
+      }
+    }
+  }
+
+  if (m_sphoto==PHOTO_CIELAB && m_bSrcXYZ)
+    CIccPCS::LabToXyz(pPixels, pPixels, m_nWidth, true);
+}
+
+void CApplyPipeline::EncodeLine(unsigned char *pLine, icFloatNumber *pPixels)
+{
+  unsigned long j, k;
+  icFloatNumber *Pixel = pPixels;
+
+  if (m_photo==PHOTO_CIELAB && m_bDstXYZ)
+    CIccPCS::XyzToLab(pPixels, pPixels, m_nWidth, true);
+
+  if (m_nBPS==16) {
+    unsigned short *dptr = (unsigned short*)pLine;
+
+    for (j=0; j<m_nWidth; j++, dptr+=m_dn, Pixel+=m_dn) {
+      if (m_photo==PHOTO_CIELAB) {
+        dptr[0] = (unsigned short)(UnitClip(Pixel[0]) * 65535.0 + 0.5);
+        dptr[1] = (unsigned short)(short)((UnitClip(Pixel[1]) * 255.0 - 128.0) * 256.0);
+        dptr[2] = (unsigned short)(short)((UnitClip(Pixel[2]) * 255.0 - 128.0) * 256.0);
+      }
+      else {
+        for (k=0; k<m_dn; k++) {
+          dptr[k] = (unsigned short)(UnitClip(Pixel[k]) * 65535.0 + 0.5);
+        }
+      }
+    }
+  }
+  else {
+    unsigned char *dptr = pLine;
+
+    for (j=0; j<m_nWidth; j++, dptr+=m_dn, Pixel+=m_dn) {
+      if (m_photo==PHOTO_CIELAB) {
+        dptr[0] = (unsigned char)(UnitClip(Pixel[0]) * 255.0 + 0.5);
+        dptr[1] = (unsigned char)(UnitClip(Pixel[1]) * 255.0 - 128.0);
+        dptr[2] = (unsigned char)(UnitClip(Pixel[2]) * 255.0 - 128.0);
+      }
+      else {
+        for (k=0; k<m_dn; k++) {
+          dptr[k] = (unsigned char)(UnitClip(Pixel[k]) * 255.0 + 0.5);
+        }
+      }
+    }
+  }
+}
+
 bool Apply(const char *szSrcImage,
            const char *szSrcProfile,
            const char *szDstProfile,
            const char *szDstImage,
-           int nIntent)
+           int nIntent,
+           int nThreads,
+           bool bPerf,
+           bool bTiming)
 {
-  unsigned long i, j, k, sn, sphoto, dn, photo, space;
+  unsigned long sn, sphoto, dn, photo, space;
   CTiffImg SrcImg, DstImg;
   CIccCmm cmm;
-  unsigned char *sptr, *dptr;
-  bool bSuccess = true;
+  CIccSetupReport SetupReport;
   bool bConvert = false;
 
+  if (bTiming)
+    cmm.SetSetupListener(&SetupReport);
+
   if (cmm.AddXform(szSrcProfile, nIntent<0 ? icUnknownIntent : (icRenderingIntent)nIntent/*, icInterpTetrahedral*/)) {
     printf("Invalid Profile:  %s\n", szSrcProfile);
     return false;
@@ -106,11 +537,18 @@ bool Apply(const char *szSrcImage,
     return false;
   }
 
-  if (cmm.Begin() != icCmmStatOk) {
+  if (cmm.Begin(false) != icCmmStatOk) {
     printf("Invalid Profile:\n  %s\n  %s'\n", szSrcProfile, szDstProfile);
     return false;
   }
 
+  if (bTiming) {
+    std::string sReport;
+
+    SetupReport.GetReport(sReport);
+    printf("Setup timing:\n%s\n", sReport.c_str());
+  }
+
   if (!SrcImg.Open(szSrcImage)) {
     printf("Invalid Tiff file - '%s'\n", szSrcImage);
     return false;
@@ -119,7 +557,7 @@ bool Apply(const char *szSrcImage,
   sphoto = SrcImg.GetPhoto();
   space = cmm.GetSourceSpace();
 
-  if (SrcImg.GetBitsPerSample()!=8 ||
+  if ((SrcImg.GetBitsPerSample()!=8 && SrcImg.GetBitsPerSample()!=16) ||
       !((space==icSigRgbData && sn==3 && sphoto==PHOTO_MINISBLACK) ||
         (space==icSigLabData && sn==3 && sphoto==PHOTO_CIELAB) ||
         (space==icSigXYZData && sn==3 && sphoto==PHOTO_CIELAB) ||
@@ -182,97 +620,67 @@ bool Apply(const char *szSrcImage,
     return false;
   }
 
-  if (!DstImg.Create(szDstImage, SrcImg.GetWidth(), SrcImg.GetHeight(), 8, photo, dn, SrcImg.GetXRes(), SrcImg.GetYRes(), false)) {
+  if (!DstImg.Create(szDstImage, SrcImg.GetWidth(), SrcImg.GetHeight(), SrcImg.GetBitsPerSample(), photo, dn, SrcImg.GetXRes(), SrcImg.GetYRes(), false)) {
     printf("Unable to create Tiff file - '%s'\n", szDstImage);
     return false;
   }
 
-  unsigned char *pSBuf = (unsigned char *)malloc(SrcImg.GetBytesPerLine());
-  unsigned char *pDBuf = (unsigned char *)malloc(DstImg.GetBytesPerLine());
-  icFloatNumber Pixel[16];
+  icUInt32Number nNumThreads = icGetNumThreads(nThreads>0 ? (icUInt32Number)nThreads : 0);
+  CApplyPipeline pipeline(SrcImg, DstImg);
 
-  if (!pSBuf) {
+  if (!pipeline.Init(cmm, nNumThreads, sphoto, photo, space==icSigXYZData, bConvert)) {
     printf("Out of Memory!\n");
     return false;
   }
 
-  if (!pDBuf) {
-    printf("Out of Memory!\n");
-    free(pSBuf);
-    return false;
-  }
-
-  for (i=0; i<SrcImg.GetHeight(); i++) {
-    if (!SrcImg.ReadLine(pSBuf)) {
-      bSuccess = false;
-      break;
-    }
-    for (sptr=pSBuf, dptr=pDBuf, j=0; j<SrcImg.GetWidth(); j++, sptr+=sn, dptr+=dn) {
-      if (sphoto==PHOTO_CIELAB) {
-        Pixel[0] = (icFloatNumber)sptr[0] / 255.0f;
-        Pixel[1] = ((icFloatNumber)((signed char)sptr[1]) + 128.0f) / 255.0f;
-        Pixel[2] = ((icFloatNumber)((signed char)sptr[2]) + 128.0f) / 255.0f;
-
-        if (space==icSigXYZData) {
-          icLabFromPcs(Pixel);
-
-          icLabtoXYZ(Pixel);
-
-          icXyzToPcs(Pixel);
-        }
-      }
-      else {
-        for (k=0; k<sn; k++) {
-          Pixel[k] = (icFloatNumber)sptr[k] / 255.0f;
-        }
-      }
-
-      cmm.Apply(Pixel, Pixel);
+  icParallelExecute(&pipeline, nNumThreads, 1, nNumThreads);
 
-      if (photo==PHOTO_CIELAB) {
-        if (bConvert) {
-          icXyzFromPcs(Pixel);
+  SrcImg.Close();
 
-          icXYZtoLab(Pixel);
+  if (bPerf) {
+    std::string sReport;
 
-          icLabToPcs(Pixel);
-        }
-        dptr[0] = (unsigned char)(UnitClip(Pixel[0]) * 255.0 + 0.5);
-        dptr[1] = (unsigned char)(UnitClip(Pixel[1]) * 255.0 - 128.0);
-        dptr[2] = (unsigned char)(UnitClip(Pixel[2]) * 255.0 - 128.0);
-      }
-      else {
-        for (k=0; k<dn; k++) {
-          dptr[k] = (unsigned char)(UnitClip(Pixel[k]) * 255.0 + 0.5);
-        }
-      }
-    }
-    if (!DstImg.WriteLine(pDBuf)) {
-      bSuccess = false;
-      break;
-    }
+    pipeline.GetPerfReport(sReport);
+    printf("Apply performance counters:\n%s", sReport.c_str());
   }
 
-  SrcImg.Close();
-
-  free(pSBuf);
-  free(pDBuf);
-
-  return bSuccess;
+  return pipeline.Succeeded();
 }
 
 
 int main(int argc, char* argv[])
 {
   int nIntent = -1;
+  int nThreads = 0;
+  bool bPerf = false;
+  bool bTiming = false;
+
+  //Options come before the positional arguments
+  while (argc>1 && !strncmp(argv[1], "--", 2)) {
+    if (!stricmp(argv[1], "--perf"))
+      bPerf = true;
+    else if (!stricmp(argv[1], "--timing"))
+      bTiming = true;
+    else {
+      printf("Unknown option [%s]\n", argv[1]);
+      argc = 0;
+      break;
+    }
+    argv++;
+    argc--;
+  }
 
   if (argc<5) {
-    printf("Usage: iccApplyProfiles src_img_path src_profile_path dest_profile_path dest_image_path {Rendering_intent}\n\n");
+    printf("Usage: iccApplyProfiles {--perf} {--timing} src_img_path src_profile_path dest_profile_path dest_image_path {Rendering_intent {num_threads}}\n\n");
+    printf("  --perf prints the apply chain performance counters (requires IccProfLib built with ICC_PERF_COUNTERS)\n");
+    printf("  --timing prints the time spent opening profiles and setting up the transform\n\n");
     printf("  For Rendering_intent:\n");
     printf("    0 - Perceptual\n");
     printf("    1 - Relative Colorimetric\n");
     printf("    2 - Saturation\n");
-    printf("    3 - Absolute Colorimetric\n");
+    printf("    3 - Absolute Colorimetric\n\n");
+    printf("  num_threads is the number of transform threads (0 = one per processor)\n");
+    printf("  8 and 16 bit per sample images are supported\n");
 
     return -1;
   }
@@ -280,10 +688,12 @@ int main(int argc, char* argv[])
   if (argc>5)
     sscanf(argv[5], "%d", &nIntent);
 
-  if (Apply(argv[1], argv[2], argv[3], argv[4], nIntent)) {
+  if (argc>6)
+    sscanf(argv[6], "%d", &nThreads);
+
+  if (Apply(argv[1], argv[2], argv[3], argv[4], nIntent, nThreads, bPerf, bTiming)) {
     printf("Profiles successfully applied\n");
   }
   
   return 0;
 }
-
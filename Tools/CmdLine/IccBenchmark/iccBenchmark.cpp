@@ -0,0 +1,1155 @@
+/*
+ File:       iccBenchmark.cpp
+ 
+ Contains:   Console app to measure transform throughput for each xform
+             and interpolation type using synthetic profiles
+ 
+ Version:    V1
+ 
+ Copyright:   see below
+ */
+
+/*
+ * The ICC Software License, Version 0.2
+ *
+ *
+ * Copyright (c) 2003-2011 The International Color Consortium. All rights 
+ * reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer. 
+ *
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ *
+ * 3. In the absence of prior written permission, the names "ICC" and "The
+ *    International Color Consortium" must not be used to imply that the
+ *    ICC organization endorses or promotes products derived from this
+ *    software.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED ``AS IS'' AND ANY EXPRESSED OR IMPLIED
+ * WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED.  IN NO EVENT SHALL THE INTERNATIONAL COLOR CONSORTIUM OR
+ * ITS CONTRIBUTING MEMBERS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+ * USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+ * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+ * OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+ * SUCH DAMAGE.
+ * ====================================================================
+ *
+ * This software consists of voluntary contributions made by many
+ * individuals on behalf of the The International Color Consortium. 
+ *
+ *
+ * Membership in the ICC is encouraged when this software is used for
+ * commercial purposes. 
+ *
+ *  
+ * For more information on The International Color Consortium, please
+ * see <http://www.color.org/>.
+ *  
+ * 
+ */
+
+////////////////////////////////////////////////////////////////////// 
+// HISTORY:
+//
+// -Initial implementation 10-19-2026
+// -Added profile parse/serialize benchmark and synthetic corpus 10-19-2026
+//
+//////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "IccProfile.h"
+#include "IccTag.h"
+#include "IccTagMPE.h"
+#include "IccMpeBasic.h"
+#include "IccTagDict.h"
+#include "IccIO.h"
+#include "IccCmm.h"
+#include "IccPerf.h"
+#include "IccUtil.h"
+
+//----------------------------------------------------
+// Benchmark case definitions
+//----------------------------------------------------
+
+typedef enum {
+  bcMatrixTRC,
+  bcMatrixTRCRoundTrip,
+  bcMonochrome,
+  bc3DLut,
+  bc4DLut,
+  bcNDLut,
+  bc3DTo4DLut,
+  bcMpe,
+  bcNamedToIndex,
+  bcNamedFromIndex,
+  bcMru3DTo4DLut,
+} BenchCaseType;
+
+typedef enum {
+  bwUniform,
+  bwGradient,
+  bwPalette,
+} BenchWorkload;
+
+struct BenchCase
+{
+  BenchCaseType nType;
+  std::string name;
+  const char *szXform;
+  int nInput;
+  int nOutput;
+  bool bInterp; //interpolation choice changes the xform
+};
+
+#define BENCH_LUT3D_GRID      33
+#define BENCH_LUT4D_GRID      17
+#define BENCH_LUTND_ENTRIES   250000
+#define BENCH_MPE_GRID        17
+#define BENCH_NAMED_COLORS    1000
+#define BENCH_PALETTE_SIZE    16
+
+//----------------------------------------------------
+// Deterministic pseudo random numbers so that runs are comparable
+//----------------------------------------------------
+
+static icUInt32Number g_nSeed = 1;
+
+static void BenchSeed(icUInt32Number nSeed)
+{
+  g_nSeed = nSeed;
+}
+
+static icFloatNumber BenchRand()
+{
+  g_nSeed = g_nSeed * 1664525 + 1013904223;
+
+  return (icFloatNumber)(g_nSeed>>8) / (icFloatNumber)16777216.0;
+}
+
+//----------------------------------------------------
+// Synthetic profile construction
+//----------------------------------------------------
+
+static void InitBenchHeader(CIccProfile *pIcc, icProfileClassSignature nClass, icColorSpaceSignature nSpace,
+                            icColorSpaceSignature nPCS, icUInt32Number nVersion)
+{
+  pIcc->InitHeader();
+  pIcc->m_Header.version = nVersion;
+  pIcc->m_Header.deviceClass = nClass;
+  pIcc->m_Header.colorSpace = nSpace;
+  pIcc->m_Header.pcs = nPCS;
+}
+
+static CIccTagXYZ *NewXYZTag(icFloatNumber X, icFloatNumber Y, icFloatNumber Z)
+{
+  CIccTagXYZ *pTag = new CIccTagXYZ();
+
+  (*pTag)[0].X = icDtoF(X);
+  (*pTag)[0].Y = icDtoF(Y);
+  (*pTag)[0].Z = icDtoF(Z);
+
+  return pTag;
+}
+
+static CIccTagCurve *NewGammaCurve(icFloatNumber gamma)
+{
+  CIccTagCurve *pCurve = new CIccTagCurve(1);
+
+  pCurve->SetGamma(gamma);
+
+  return pCurve;
+}
+
+static void FillRandom(CIccCLUT *pCLUT)
+{
+  icUInt32Number i, n = pCLUT->NumPoints() * pCLUT->GetOutputChannels();
+  icFloatNumber *pData = pCLUT->GetData(0);
+
+  for (i=0; i<n; i++)
+    pData[i] = BenchRand();
+}
+
+static CIccProfile *NewMatrixTRCProfile()
+{
+  CIccProfile *pIcc = new CIccProfile();
+
+  InitBenchHeader(pIcc, icSigDisplayClass, icSigRgbData, icSigXYZData, icVersionNumberV4);
+
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9642, (icFloatNumber)1.0, (icFloatNumber)0.8249));
+  pIcc->AttachTag(icSigRedColorantTag, NewXYZTag((icFloatNumber)0.4361, (icFloatNumber)0.2225, (icFloatNumber)0.0139));
+  pIcc->AttachTag(icSigGreenColorantTag, NewXYZTag((icFloatNumber)0.3851, (icFloatNumber)0.7169, (icFloatNumber)0.0971));
+  pIcc->AttachTag(icSigBlueColorantTag, NewXYZTag((icFloatNumber)0.1431, (icFloatNumber)0.0606, (icFloatNumber)0.7139));
+  pIcc->AttachTag(icSigRedTRCTag, NewGammaCurve((icFloatNumber)2.2));
+  pIcc->AttachTag(icSigGreenTRCTag, NewGammaCurve((icFloatNumber)2.2));
+  pIcc->AttachTag(icSigBlueTRCTag, NewGammaCurve((icFloatNumber)2.2));
+
+  return pIcc;
+}
+
+static CIccProfile *NewGrayProfile()
+{
+  CIccProfile *pIcc = new CIccProfile();
+
+  InitBenchHeader(pIcc, icSigDisplayClass, icSigGrayData, icSigXYZData, icVersionNumberV4);
+
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9642, (icFloatNumber)1.0, (icFloatNumber)0.8249));
+  pIcc->AttachTag(icSigGrayTRCTag, NewGammaCurve((icFloatNumber)2.2));
+
+  return pIcc;
+}
+
+static LPIccCurve *SetIdentityCurves(LPIccCurve *pCurves, int nCurves)
+{
+  int i;
+
+  for (i=0; i<nCurves; i++)
+    pCurves[i] = new CIccTagCurve(0);
+
+  return pCurves;
+}
+
+///Creates an nChannel device profile with lutAtoBType/lutBtoAType tags to and from a Lab PCS
+static CIccProfile *NewLutProfile(icColorSpaceSignature nSpace, int nChannels, int nGrid)
+{
+  CIccProfile *pIcc = new CIccProfile();
+
+  InitBenchHeader(pIcc, icSigOutputClass, nSpace, icSigLabData, icVersionNumberV4);
+
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9642, (icFloatNumber)1.0, (icFloatNumber)0.8249));
+
+  CIccTagLutAtoB *pAToB = new CIccTagLutAtoB();
+  pAToB->Init((icUInt8Number)nChannels, 3);
+  SetIdentityCurves(pAToB->NewCurvesA(), nChannels);
+  FillRandom(pAToB->NewCLUT((icUInt8Number)nGrid));
+  SetIdentityCurves(pAToB->NewCurvesB(), 3);
+  pIcc->AttachTag(icSigAToB0Tag, pAToB);
+
+  CIccTagLutBtoA *pBToA = new CIccTagLutBtoA();
+  pBToA->Init(3, (icUInt8Number)nChannels);
+  SetIdentityCurves(pBToA->NewCurvesB(), 3);
+  FillRandom(pBToA->NewCLUT(BENCH_LUT4D_GRID));
+  SetIdentityCurves(pBToA->NewCurvesA(), nChannels);
+  pIcc->AttachTag(icSigBToA0Tag, pBToA);
+
+  return pIcc;
+}
+
+///Creates an RGB display profile with a DToB0 tag of curve, matrix and CLUT elements
+static CIccProfile *NewMpeProfile()
+{
+  CIccProfile *pIcc = new CIccProfile();
+  int i;
+
+  InitBenchHeader(pIcc, icSigDisplayClass, icSigRgbData, icSigXYZData, icVersionNumberV4);
+
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9642, (icFloatNumber)1.0, (icFloatNumber)0.8249));
+
+  CIccTagMultiProcessElement *pMpe = new CIccTagMultiProcessElement(3, 3);
+
+  CIccMpeCurveSet *pCurves = new CIccMpeCurveSet(3);
+  for (i=0; i<3; i++) {
+    CIccSegmentedCurve *pCurve = new CIccSegmentedCurve();
+    CIccFormulaCurveSegment *pSeg = new CIccFormulaCurveSegment(icMinFloat32Number, icMaxFloat32Number);
+    icFloatNumber params[4] = {(icFloatNumber)2.2, 1.0, 0.0, 0.0};
+
+    pSeg->SetFunction(0, 4, params);
+    pCurve->Insert(pSeg);
+    pCurves->SetCurve(i, pCurve);
+  }
+  pMpe->Attach(pCurves);
+
+  CIccMpeMatrix *pMatrix = new CIccMpeMatrix();
+  pMatrix->SetSize(3, 3);
+  for (i=0; i<9; i++)
+    pMatrix->GetMatrix()[i] = (i%4) ? (icFloatNumber)0.05 : (icFloatNumber)0.9;
+  pMpe->Attach(pMatrix);
+
+  CIccCLUT *pCLUT = new CIccCLUT(3, 3, 4);
+  pCLUT->Init(BENCH_MPE_GRID);
+  FillRandom(pCLUT);
+  CIccMpeCLUT *pMpeCLUT = new CIccMpeCLUT();
+  pMpeCLUT->SetCLUT(pCLUT);
+  pMpe->Attach(pMpeCLUT);
+
+  pIcc->AttachTag(icSigDToB0Tag, pMpe);
+
+  return pIcc;
+}
+
+static CIccProfile *NewNamedProfile(int nColors, icColorSpaceSignature nDevSpace, int nDevCoords)
+{
+  CIccProfile *pIcc = new CIccProfile();
+  int i, j;
+
+  InitBenchHeader(pIcc, icSigNamedColorClass, nDevSpace, icSigLabData, icVersionNumberV4);
+
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9642, (icFloatNumber)1.0, (icFloatNumber)0.8249));
+
+  CIccTagNamedColor2 *pNamed = new CIccTagNamedColor2(nColors, nDevCoords);
+  pNamed->SetColorSpaces(icSigLabData, nDevSpace);
+  pNamed->SetPrefix("Bench ");
+
+  for (i=0; i<nColors; i++) {
+    SIccNamedColorEntry *pEntry = pNamed->GetEntry(i);
+
+    sprintf(pEntry->rootName, "Color %d", i);
+    for (j=0; j<3; j++)
+      pEntry->pcsCoords[j] = BenchRand();
+    for (j=0; j<nDevCoords; j++)
+      pEntry->deviceCoords[j] = BenchRand();
+  }
+  pIcc->AttachTag(icSigNamedColor2Tag, pNamed);
+
+  return pIcc;
+}
+
+static icColorSpaceSignature GetNChannelSpace(int nChannels)
+{
+  static icColorSpaceSignature spaces[] = { icSigMCH5Data, icSigMCH6Data, icSigMCH7Data, icSigMCH8Data,
+                                            icSigMCH9Data, icSigMCHAData, icSigMCHBData, icSigMCHCData,
+                                            icSigMCHDData, icSigMCHEData, icSigMCHFData };
+  return spaces[nChannels-5];
+}
+
+static int GetNChannelGrid(int nChannels)
+{
+  int nGrid = (int)pow((double)BENCH_LUTND_ENTRIES, 1.0/nChannels);
+
+  return nGrid<2 ? 2 : nGrid;
+}
+
+//----------------------------------------------------
+// CMM setup
+//----------------------------------------------------
+
+///Creates and begins the CMM for a case.  Only the CMM construction, AddXform() and Begin() calls are timed.
+static CIccCmm *CreateBenchCmm(const BenchCase &bc, icXformInterp nInterp, double &dSetupMs)
+{
+  CIccProfile *pIcc1 = NULL, *pIcc2 = NULL;
+  CIccCmm *pCmm = NULL;
+  icPerfCount nStart;
+  bool bOk = true;
+
+  BenchSeed(0x1cc);
+
+  switch(bc.nType) {
+    case bcMatrixTRC:
+      pIcc1 = NewMatrixTRCProfile();
+      break;
+    case bcMatrixTRCRoundTrip:
+      pIcc1 = NewMatrixTRCProfile();
+      pIcc2 = NewMatrixTRCProfile();
+      break;
+    case bcMonochrome:
+      pIcc1 = NewGrayProfile();
+      break;
+    case bc3DLut:
+      pIcc1 = NewLutProfile(icSigRgbData, 3, BENCH_LUT3D_GRID);
+      break;
+    case bc4DLut:
+      pIcc1 = NewLutProfile(icSigCmykData, 4, BENCH_LUT4D_GRID);
+      break;
+    case bcNDLut:
+      pIcc1 = NewLutProfile(GetNChannelSpace(bc.nInput), bc.nInput, GetNChannelGrid(bc.nInput));
+      break;
+    case bc3DTo4DLut:
+    case bcMru3DTo4DLut:
+      pIcc1 = NewLutProfile(icSigRgbData, 3, BENCH_LUT3D_GRID);
+      pIcc2 = NewLutProfile(icSigCmykData, 4, BENCH_LUT4D_GRID);
+      break;
+    case bcMpe:
+      pIcc1 = NewMpeProfile();
+      break;
+    case bcNamedToIndex:
+    case bcNamedFromIndex:
+      pIcc1 = NewNamedProfile(BENCH_NAMED_COLORS, icSigRgbData, 3);
+      break;
+  }
+
+  nStart = icPerfTicks();
+
+  if (bc.nType==bcNamedToIndex) {
+    pCmm = new CIccNamedColorCmm(icSigLabData, icSigUnknownData, false);
+  }
+  else if (bc.nType==bcNamedFromIndex) {
+    pCmm = new CIccNamedColorCmm(icSigNamedData, icSigUnknownData, true);
+  }
+  else {
+    pCmm = new CIccCmm();
+  }
+
+  if (pCmm->AddXform(pIcc1, icPerceptual, nInterp)!=icCmmStatOk) {
+    delete pIcc1;
+    bOk = false;
+  }
+  if (pIcc2) {
+    if (!bOk || pCmm->AddXform(pIcc2, icPerceptual, nInterp)!=icCmmStatOk) {
+      delete pIcc2;
+      bOk = false;
+    }
+  }
+
+  if (bOk && pCmm->Begin()!=icCmmStatOk)
+    bOk = false;
+
+  if (bOk && bc.nType==bcMru3DTo4DLut) {
+    pCmm = CIccMruCmm::Attach(pCmm);
+    if (!pCmm)
+      return NULL;
+  }
+
+  dSetupMs = (double)(icPerfTicks() - nStart) * 1000.0 / icPerfTicksPerSecond();
+
+  if (!bOk) {
+    delete pCmm;
+    return NULL;
+  }
+
+  return pCmm;
+}
+
+//----------------------------------------------------
+// Workloads
+//----------------------------------------------------
+
+static const char *GetWorkloadName(BenchWorkload nWorkload)
+{
+  switch(nWorkload) {
+    case bwUniform:
+      return "uniform";
+    case bwGradient:
+      return "gradient";
+    case bwPalette:
+      return "palette";
+  }
+  return "unknown";
+}
+
+///Fills pixel (or index) buffers for a workload.  Palette workloads use runs of repeated colors like synthetic graphics.
+static void FillWorkload(BenchWorkload nWorkload, icFloatNumber *pSrc, icInt32Number *pIndex,
+                         icUInt32Number nPixels, int nSamples, int nIndexRange)
+{
+  icFloatNumber palette[BENCH_PALETTE_SIZE][16];
+  icInt32Number paletteIndex[BENCH_PALETTE_SIZE];
+  icUInt32Number i, nRun = 0;
+  int j, nColor = 0;
+
+  BenchSeed(0x5eed);
+
+  for (j=0; j<BENCH_PALETTE_SIZE; j++) {
+    int k;
+    for (k=0; k<nSamples; k++)
+      palette[j][k] = BenchRand();
+    paletteIndex[j] = (icInt32Number)(BenchRand() * nIndexRange);
+  }
+
+  for (i=0; i<nPixels; i++) {
+    icFloatNumber *pPixel = &pSrc[i*nSamples];
+
+    switch(nWorkload) {
+      case bwUniform:
+        for (j=0; j<nSamples; j++)
+          pPixel[j] = BenchRand();
+        pIndex[i] = (icInt32Number)(BenchRand() * nIndexRange);
+        break;
+
+      case bwGradient:
+        for (j=0; j<nSamples; j++)
+          pPixel[j] = (icFloatNumber)((i + (icUInt32Number)j*nPixels/nSamples) % nPixels) / (icFloatNumber)nPixels;
+        pIndex[i] = (icInt32Number)(i % nIndexRange);
+        break;
+
+      case bwPalette:
+        if (!nRun) {
+          nColor = (int)(BenchRand() * BENCH_PALETTE_SIZE);
+          nRun = 1 + (icUInt32Number)(BenchRand() * 32);
+        }
+        nRun--;
+        memcpy(pPixel, palette[nColor], nSamples*sizeof(icFloatNumber));
+        pIndex[i] = paletteIndex[nColor];
+        break;
+    }
+  }
+}
+
+static bool ApplyBench(const BenchCase &bc, CIccCmm *pCmm, icFloatNumber *pDst, const icFloatNumber *pSrc,
+                       icInt32Number *pIndex, icUInt32Number nPixels)
+{
+  if (bc.nType==bcNamedToIndex)
+    return ((CIccNamedColorCmm*)pCmm)->ApplyToIndex(pIndex, pSrc, nPixels)==icCmmStatOk;
+
+  if (bc.nType==bcNamedFromIndex)
+    return ((CIccNamedColorCmm*)pCmm)->ApplyFromIndex(pDst, pIndex, nPixels)==icCmmStatOk;
+
+  return pCmm->Apply(pDst, pSrc, nPixels)==icCmmStatOk;
+}
+
+//----------------------------------------------------
+// Profile I/O corpus
+//----------------------------------------------------
+
+#define BENCH_CORPUS_NAMED_COLORS   10000
+#define BENCH_CORPUS_DICT_ENTRIES   2000
+#define BENCH_CORPUS_MLUC_LOCALES   200
+
+struct BenchProfile
+{
+  std::string name;
+  icUInt32Number nVersion;
+  icUInt32Number nTags;
+  icUInt8Number *pData;
+  icUInt32Number nSize;
+};
+
+static CIccTagCurve *NewLinearCurve(int nSize)
+{
+  CIccTagCurve *pCurve = new CIccTagCurve(nSize);
+  int i;
+
+  for (i=0; i<nSize; i++)
+    (*pCurve)[i] = (icFloatNumber)i / (icFloatNumber)(nSize-1);
+
+  return pCurve;
+}
+
+static void SetLinearCurves(LPIccCurve *pCurves, int nCurves, int nSize)
+{
+  int i;
+
+  for (i=0; i<nCurves; i++)
+    pCurves[i] = NewLinearCurve(nSize);
+}
+
+///Adds the description, copyright and white point tags required of every profile class
+static void AddRequiredTags(CIccProfile *pIcc, const char *szDesc, int nLocales)
+{
+  if (pIcc->m_Header.version < icVersionNumberV4) {
+    CIccTagTextDescription *pDesc = new CIccTagTextDescription();
+    pDesc->SetText(szDesc);
+    pIcc->AttachTag(icSigProfileDescriptionTag, pDesc);
+
+    CIccTagText *pCprt = new CIccTagText();
+    pCprt->SetText("No copyright, use freely");
+    pIcc->AttachTag(icSigCopyrightTag, pCprt);
+  }
+  else {
+    CIccTagMultiLocalizedUnicode *pDesc = new CIccTagMultiLocalizedUnicode();
+    int i;
+
+    pDesc->SetText(szDesc);
+    for (i=1; i<nLocales; i++) {
+      char szText[256];
+      sprintf(szText, "%s (locale %d)", szDesc, i);
+      pDesc->SetText(szText, (icLanguageCode)(0x6161 + i), (icCountryCode)(0x4141 + i));
+    }
+    pIcc->AttachTag(icSigProfileDescriptionTag, pDesc);
+
+    CIccTagMultiLocalizedUnicode *pCprt = new CIccTagMultiLocalizedUnicode();
+    pCprt->SetText("No copyright, use freely");
+    pIcc->AttachTag(icSigCopyrightTag, pCprt);
+  }
+
+  pIcc->AttachTag(icSigMediaWhitePointTag, NewXYZTag((icFloatNumber)0.9642, (icFloatNumber)1.0, (icFloatNumber)0.8249));
+}
+
+///Creates a version 2 output profile using lut8Type or lut16Type AToB0/BToA0 tags
+static CIccProfile *NewLut8or16Profile(icColorSpaceSignature nSpace, int nChannels, bool bLut16)
+{
+  CIccProfile *pIcc = new CIccProfile();
+  CIccMBB *pAToB, *pBToA;
+  int nGrid = nChannels>3 ? BENCH_LUT4D_GRID : BENCH_LUT3D_GRID;
+
+  InitBenchHeader(pIcc, icSigOutputClass, nSpace, icSigLabData, icVersionNumberV2_1);
+  AddRequiredTags(pIcc, bLut16 ? "Benchmark lut16Type profile" : "Benchmark lut8Type profile", 1);
+
+  if (bLut16) {
+    pAToB = new CIccTagLut16();
+    pBToA = new CIccTagLut16();
+  }
+  else {
+    pAToB = new CIccTagLut8();
+    pBToA = new CIccTagLut8();
+  }
+
+  pAToB->Init((icUInt8Number)nChannels, 3);
+  SetLinearCurves(pAToB->NewCurvesB(), nChannels, 256);
+  FillRandom(pAToB->NewCLUT((icUInt8Number)nGrid, bLut16 ? 2 : 1));
+  SetLinearCurves(pAToB->NewCurvesA(), 3, 256);
+  pIcc->AttachTag(icSigAToB0Tag, pAToB);
+
+  pBToA->Init(3, (icUInt8Number)nChannels);
+  SetLinearCurves(pBToA->NewCurvesB(), 3, 256);
+  FillRandom(pBToA->NewCLUT(BENCH_LUT4D_GRID, bLut16 ? 2 : 1));
+  SetLinearCurves(pBToA->NewCurvesA(), nChannels, 256);
+  pIcc->AttachTag(icSigBToA0Tag, pBToA);
+
+  return pIcc;
+}
+
+static CIccProfile *NewCorpusMatrixTRCProfile(icUInt32Number nVersion)
+{
+  CIccProfile *pIcc = NewMatrixTRCProfile();
+
+  pIcc->m_Header.version = nVersion;
+  pIcc->DeleteTag(icSigMediaWhitePointTag);
+  AddRequiredTags(pIcc, "Benchmark matrix/TRC profile", 1);
+
+  return pIcc;
+}
+
+static CIccProfile *NewCorpusLutAtoBProfile()
+{
+  CIccProfile *pIcc = NewLutProfile(icSigCmykData, 4, BENCH_LUT4D_GRID);
+
+  pIcc->DeleteTag(icSigMediaWhitePointTag);
+  AddRequiredTags(pIcc, "Benchmark lutAtoBType profile", 1);
+
+  return pIcc;
+}
+
+static CIccProfile *NewCorpusMpeProfile()
+{
+  CIccProfile *pIcc = NewMpeProfile();
+
+  pIcc->DeleteTag(icSigMediaWhitePointTag);
+  AddRequiredTags(pIcc, "Benchmark multiProcessElementType profile", 1);
+
+  //Version 4 profiles carry a lutAtoBType fallback for CMMs without MPE support
+  CIccTagLutAtoB *pAToB = new CIccTagLutAtoB();
+  pAToB->Init(3, 3);
+  SetIdentityCurves(pAToB->NewCurvesA(), 3);
+  FillRandom(pAToB->NewCLUT(BENCH_LUT4D_GRID));
+  SetIdentityCurves(pAToB->NewCurvesB(), 3);
+  pIcc->AttachTag(icSigAToB0Tag, pAToB);
+
+  return pIcc;
+}
+
+static CIccProfile *NewCorpusMetaDataProfile()
+{
+  CIccProfile *pIcc = NewMatrixTRCProfile();
+  int i;
+
+  pIcc->DeleteTag(icSigMediaWhitePointTag);
+  AddRequiredTags(pIcc, "Benchmark dictType and multiLocalizedUnicodeType profile", BENCH_CORPUS_MLUC_LOCALES);
+
+  CIccTagDict *pDict = new CIccTagDict();
+  for (i=0; i<BENCH_CORPUS_DICT_ENTRIES; i++) {
+    char szName[32], szValue[64];
+
+    sprintf(szName, "name%d", i);
+    sprintf(szValue, "value of metadata entry %d", i);
+    pDict->Set(szName, szValue);
+  }
+  pIcc->AttachTag(icSigMetaDataTag, pDict);
+
+  return pIcc;
+}
+
+static CIccProfile *NewCorpusNamedProfile(icUInt32Number nVersion)
+{
+  CIccProfile *pIcc = NewNamedProfile(BENCH_CORPUS_NAMED_COLORS, icSigCmykData, 4);
+
+  pIcc->m_Header.version = nVersion;
+  pIcc->DeleteTag(icSigMediaWhitePointTag);
+  AddRequiredTags(pIcc, "Benchmark namedColor2Type profile", 1);
+
+  return pIcc;
+}
+
+///Serializes a synthetic profile into a corpus entry (deleting the profile)
+static bool AddCorpusProfile(std::vector<BenchProfile> &corpus, const char *szName, CIccProfile *pIcc)
+{
+  CIccMemIO io;
+  CIccNullIO nullIO;
+  BenchProfile bp;
+
+  if (!pIcc->Write(&nullIO, icNeverWriteID) || !io.Alloc(nullIO.GetLength(), true) ||
+      !pIcc->Write(&io, icVersionBasedID)) {
+    fprintf(stderr, "%s: unable to write profile\n", szName);
+    delete pIcc;
+    return false;
+  }
+
+  bp.name = szName;
+  bp.nVersion = pIcc->m_Header.version;
+  bp.nTags = (icUInt32Number)pIcc->m_Tags->size();
+  bp.nSize = (icUInt32Number)io.GetLength();
+  bp.pData = (icUInt8Number*)malloc(bp.nSize);
+  memcpy(bp.pData, io.GetData(), bp.nSize);
+
+  corpus.push_back(bp);
+  delete pIcc;
+
+  return true;
+}
+
+static void BuildCorpus(std::vector<BenchProfile> &corpus)
+{
+  BenchSeed(0xc0de);
+
+  AddCorpusProfile(corpus, "v2_matrix_trc", NewCorpusMatrixTRCProfile(icVersionNumberV2_1));
+  AddCorpusProfile(corpus, "v4_matrix_trc", NewCorpusMatrixTRCProfile(icVersionNumberV4));
+  AddCorpusProfile(corpus, "v2_lut8_cmyk", NewLut8or16Profile(icSigCmykData, 4, false));
+  AddCorpusProfile(corpus, "v2_lut16_rgb", NewLut8or16Profile(icSigRgbData, 3, true));
+  AddCorpusProfile(corpus, "v4_lutAtoB_cmyk", NewCorpusLutAtoBProfile());
+  AddCorpusProfile(corpus, "v4_mpe_rgb", NewCorpusMpeProfile());
+  AddCorpusProfile(corpus, "v4_dict_mluc", NewCorpusMetaDataProfile());
+  AddCorpusProfile(corpus, "v2_named_10k", NewCorpusNamedProfile(icVersionNumberV2_1));
+  AddCorpusProfile(corpus, "v4_named_10k", NewCorpusNamedProfile(icVersionNumberV4));
+}
+
+typedef enum {
+  boRead,
+  boOpenFindTags,
+  boValidate,
+  boWrite,
+  boProfileID,
+} BenchIOOperation;
+
+static const char *GetIOOperationName(BenchIOOperation nOp)
+{
+  switch(nOp) {
+    case boRead:
+      return "read";
+    case boOpenFindTags:
+      return "open_find_tags";
+    case boValidate:
+      return "validate";
+    case boWrite:
+      return "write";
+    case boProfileID:
+      return "profile_id";
+  }
+  return "unknown";
+}
+
+struct BenchIOOptions
+{
+  bool bParallel;
+  icUInt32Number nThreads;
+};
+
+static CIccProfile *ReadBenchProfile(const BenchProfile &bp, const BenchIOOptions &opts)
+{
+  if (!opts.bParallel)
+    return ReadIccProfile(bp.pData, bp.nSize);
+
+  //Same as ReadIccProfile() with parallel tag loading
+  CIccMemIO io;
+  CIccProfile *pIcc = new CIccProfile();
+
+  pIcc->SetParallelLoad(true, opts.nThreads);
+
+  if (!io.Attach(bp.pData, bp.nSize) || !pIcc->Read(&io)) {
+    delete pIcc;
+    return NULL;
+  }
+
+  return pIcc;
+}
+
+///Performs one operation on a corpus profile.  pIcc and pWriteIO are only used by boWrite.
+static bool RunIOOperation(BenchIOOperation nOp, const BenchProfile &bp, const BenchIOOptions &opts,
+                           CIccProfile *pIcc, CIccMemIO *pWriteIO)
+{
+  switch(nOp) {
+    case boRead:
+      {
+        CIccProfile *pRead = ReadBenchProfile(bp, opts);
+        if (!pRead)
+          return false;
+        delete pRead;
+        return true;
+      }
+
+    case boOpenFindTags:
+      {
+        CIccProfile *pOpen = OpenIccProfile(bp.pData, bp.nSize);
+        TagEntryList::iterator i;
+
+        if (!pOpen)
+          return false;
+
+        for (i=pOpen->m_Tags->begin(); i!=pOpen->m_Tags->end(); i++) {
+          if (!pOpen->FindTag(i->TagInfo.sig)) {
+            delete pOpen;
+            return false;
+          }
+        }
+        delete pOpen;
+        return true;
+      }
+
+    case boValidate:
+      {
+        CIccMemIO *pIO = new CIccMemIO();
+        std::string sReport;
+        icValidateStatus nStatus;
+
+        if (!pIO->Attach(bp.pData, bp.nSize)) {
+          delete pIO;
+          return false;
+        }
+
+        CIccProfile *pValid = ValidateIccProfile(pIO, sReport, nStatus);
+        if (!pValid)
+          return false;
+        delete pValid;
+        return true;
+      }
+
+    case boWrite:
+      pWriteIO->Seek(0, icSeekSet);
+      return pIcc->Write(pWriteIO, icNeverWriteID);
+
+    case boProfileID:
+      {
+        CIccMemIO io;
+        icProfileID id;
+
+        if (!io.Attach(bp.pData, bp.nSize))
+          return false;
+
+        CalcProfileID(&io, &id);
+        return true;
+      }
+  }
+
+  return false;
+}
+
+static void PrintIOResult(const char *szName, const char *szVersion, icUInt32Number nBytes, icUInt32Number nTags,
+                          BenchIOOperation nOp, icUInt32Number nIterations, icUInt32Number nProfiles,
+                          icPerfCount nElapsed)
+{
+  double dSeconds = (double)nElapsed / icPerfTicksPerSecond();
+  double dProfiles = (double)nIterations * nProfiles;
+
+  printf("%s,%s,%lu,%lu,%s,%lu,%.4f,%.1f,%.2f\n", szName, szVersion, (unsigned long)nBytes, (unsigned long)nTags,
+         GetIOOperationName(nOp), (unsigned long)nIterations, dSeconds * 1000.0 / dProfiles, dProfiles / dSeconds,
+         (double)nBytes * nIterations / dSeconds / 1.0e6);
+  fflush(stdout);
+}
+
+///Measures parse and serialize throughput of each corpus profile and of the corpus as a whole
+static int RunProfileIOBench(double dMinTime, const char *szFilter, const BenchIOOptions &opts, bool bList)
+{
+  std::vector<BenchProfile> corpus;
+  int i, nOp, nFailed = 0;
+
+  BuildCorpus(corpus);
+
+  if (bList) {
+    for (i=0; i<(int)corpus.size(); i++)
+      printf("%s\t%lu bytes\t%lu tags\n", corpus[i].name.c_str(), (unsigned long)corpus[i].nSize,
+             (unsigned long)corpus[i].nTags);
+    return 0;
+  }
+
+  icPerfCount nMinTicks = (icPerfCount)(dMinTime * icPerfTicksPerSecond());
+  std::vector<CIccProfile*> profiles(corpus.size(), (CIccProfile*)NULL);
+  std::vector<CIccMemIO*> writeIO(corpus.size(), (CIccMemIO*)NULL);
+  icUInt32Number nTotalBytes = 0, nTotalTags = 0, nSelected = 0;
+  char szVersion[16];
+
+  //Write operations serialize an already parsed profile into a preallocated buffer
+  for (i=0; i<(int)corpus.size(); i++) {
+    if (szFilter && !strstr(corpus[i].name.c_str(), szFilter))
+      continue;
+
+    profiles[i] = ReadIccProfile(corpus[i].pData, corpus[i].nSize);
+    writeIO[i] = new CIccMemIO();
+    if (!profiles[i] || !writeIO[i]->Alloc(corpus[i].nSize + 1024, true)) {
+      fprintf(stderr, "%s: unable to read profile\n", corpus[i].name.c_str());
+      delete profiles[i];
+      profiles[i] = NULL;
+      nFailed++;
+      continue;
+    }
+    nTotalBytes += corpus[i].nSize;
+    nTotalTags += corpus[i].nTags;
+    nSelected++;
+  }
+
+  printf("profile,version,bytes,tags,operation,iterations,ms_per_profile,profiles_per_sec,mb_per_sec\n");
+
+  for (nOp=boRead; nOp<=boProfileID; nOp++) {
+    for (i=0; i<(int)corpus.size(); i++) {
+      icUInt32Number nIterations = 0;
+      icPerfCount nStart, nElapsed;
+      bool bOk;
+
+      if (!profiles[i])
+        continue;
+
+      bOk = RunIOOperation((BenchIOOperation)nOp, corpus[i], opts, profiles[i], writeIO[i]);
+
+      nStart = icPerfTicks();
+      do {
+        bOk = bOk && RunIOOperation((BenchIOOperation)nOp, corpus[i], opts, profiles[i], writeIO[i]);
+        nIterations++;
+        nElapsed = icPerfTicks() - nStart;
+      } while (bOk && nElapsed < nMinTicks);
+
+      if (!bOk) {
+        fprintf(stderr, "%s: %s failed\n", corpus[i].name.c_str(), GetIOOperationName((BenchIOOperation)nOp));
+        nFailed++;
+        continue;
+      }
+
+      sprintf(szVersion, "%d.%d", corpus[i].nVersion>>24, (corpus[i].nVersion>>20) & 0xf);
+      PrintIOResult(corpus[i].name.c_str(), szVersion, corpus[i].nSize, corpus[i].nTags,
+                    (BenchIOOperation)nOp, nIterations, 1, nElapsed);
+    }
+
+    //Whole corpus, as seen by a service ingesting a mix of profiles
+    if (nSelected>1) {
+      icUInt32Number nIterations = 0;
+      icPerfCount nStart, nElapsed;
+      bool bOk = true;
+
+      nStart = icPerfTicks();
+      do {
+        for (i=0; i<(int)corpus.size(); i++) {
+          if (profiles[i])
+            bOk = RunIOOperation((BenchIOOperation)nOp, corpus[i], opts, profiles[i], writeIO[i]) && bOk;
+        }
+        nIterations++;
+        nElapsed = icPerfTicks() - nStart;
+      } while (nElapsed < nMinTicks);
+
+      if (bOk)
+        PrintIOResult("corpus", "mixed", nTotalBytes, nTotalTags, (BenchIOOperation)nOp, nIterations, nSelected, nElapsed);
+    }
+  }
+
+  for (i=0; i<(int)corpus.size(); i++) {
+    delete profiles[i];
+    delete writeIO[i];
+    free(corpus[i].pData);
+  }
+
+  return nFailed ? -1 : 0;
+}
+
+//----------------------------------------------------
+// Main
+//----------------------------------------------------
+
+static void AddCase(std::vector<BenchCase> &cases, BenchCaseType nType, const char *szName, const char *szXform,
+                    int nInput, int nOutput, bool bInterp)
+{
+  BenchCase bc;
+
+  bc.nType = nType;
+  bc.name = szName;
+  bc.szXform = szXform;
+  bc.nInput = nInput;
+  bc.nOutput = nOutput;
+  bc.bInterp = bInterp;
+
+  cases.push_back(bc);
+}
+
+static void Usage()
+{
+  printf("Usage: iccBenchmark {-t seconds} {-n pixels} {-c case} {-w workload} {-l}\n");
+  printf("       iccBenchmark -io {-t seconds} {-c profile} {-threads n} {-l}\n\n");
+  printf("  -t seconds   minimum measurement time per result (default 0.5)\n");
+  printf("  -n pixels    maximum pixels per Apply() batch (default 16384)\n");
+  printf("  -c case      only run cases whose name contains case\n");
+  printf("  -w workload  only run workload uniform, gradient or palette\n");
+  printf("  -l           list cases (or corpus profiles) and exit\n");
+  printf("  -io          measure profile parse, validate, write and profile ID throughput\n");
+  printf("               on a synthetic corpus instead of transform throughput\n");
+  printf("  -threads n   read profiles decoding tags on n threads, 0 = one per processor (-io only)\n\n");
+  printf("Results are written to stdout as comma separated values, one line per\n");
+  printf("case, interpolation and workload.  setup_ms covers AddXform() and Begin().\n");
+  printf("With -io there is one line per corpus profile and operation, followed by\n");
+  printf("a line for the whole corpus.\n");
+}
+
+int main(int argc, char* argv[])
+{
+  double dMinTime = 0.5;
+  icUInt32Number nPixels = 16384;
+  const char *szCaseFilter = NULL;
+  const char *szWorkload = NULL;
+  bool bList = false, bProfileIO = false;
+  BenchIOOptions ioOpts;
+  int i;
+
+  ioOpts.bParallel = false;
+  ioOpts.nThreads = 0;
+
+  for (i=1; i<argc; i++) {
+    if (!stricmp(argv[i], "-t") && i+1<argc) {
+      dMinTime = atof(argv[++i]);
+    }
+    else if (!stricmp(argv[i], "-n") && i+1<argc) {
+      nPixels = (icUInt32Number)atol(argv[++i]);
+    }
+    else if (!stricmp(argv[i], "-c") && i+1<argc) {
+      szCaseFilter = argv[++i];
+    }
+    else if (!stricmp(argv[i], "-w") && i+1<argc) {
+      szWorkload = argv[++i];
+    }
+    else if (!stricmp(argv[i], "-l")) {
+      bList = true;
+    }
+    else if (!stricmp(argv[i], "-io")) {
+      bProfileIO = true;
+    }
+    else if (!stricmp(argv[i], "-threads") && i+1<argc) {
+      ioOpts.bParallel = true;
+      ioOpts.nThreads = (icUInt32Number)atol(argv[++i]);
+    }
+    else {
+      Usage();
+      return -1;
+    }
+  }
+
+  if (!nPixels) {
+    Usage();
+    return -1;
+  }
+
+  if (bProfileIO)
+    return RunProfileIOBench(dMinTime, szCaseFilter, ioOpts, bList);
+
+  std::vector<BenchCase> cases;
+  char szName[32];
+
+  AddCase(cases, bcMatrixTRC, "matrix_trc", "MatrixTRC", 3, 3, false);
+  AddCase(cases, bcMatrixTRCRoundTrip, "matrix_trc_roundtrip", "MatrixTRC+MatrixTRC", 3, 3, false);
+  AddCase(cases, bcMonochrome, "monochrome", "Monochrome", 1, 3, false);
+  AddCase(cases, bc3DLut, "lut3d", "3DLut", 3, 3, true);
+  AddCase(cases, bc4DLut, "lut4d", "4DLut", 4, 3, false);
+  for (i=5; i<=15; i++) {
+    sprintf(szName, "lut%dd", i);
+    AddCase(cases, bcNDLut, szName, "NDLut", i, 3, false);
+  }
+  AddCase(cases, bc3DTo4DLut, "lut3d_to_lut4d", "3DLut+3DLut", 3, 4, true);
+  AddCase(cases, bcMpe, "mpe", "Mpe", 3, 3, false);
+  AddCase(cases, bcNamedToIndex, "named_to_index", "Named", 3, 1, false);
+  AddCase(cases, bcNamedFromIndex, "named_from_index", "Named", 1, 3, false);
+  AddCase(cases, bcMru3DTo4DLut, "mru_lut3d_to_lut4d", "Mru(3DLut+3DLut)", 3, 4, true);
+
+  if (bList) {
+    for (i=0; i<(int)cases.size(); i++)
+      printf("%s\t%s\t%d\t%d\n", cases[i].name.c_str(), cases[i].szXform, cases[i].nInput, cases[i].nOutput);
+    return 0;
+  }
+
+  icFloatNumber *pSrc = (icFloatNumber*)malloc(nPixels * 15 * sizeof(icFloatNumber));
+  icFloatNumber *pDst = (icFloatNumber*)malloc(nPixels * 15 * sizeof(icFloatNumber));
+  icInt32Number *pIndex = (icInt32Number*)malloc(nPixels * sizeof(icInt32Number));
+
+  if (!pSrc || !pDst || !pIndex) {
+    printf("Unable to allocate %lu pixel buffers\n", (unsigned long)nPixels);
+    return -1;
+  }
+
+  double dTicksPerSec = icPerfTicksPerSecond();
+  icPerfCount nMinTicks = (icPerfCount)(dMinTime * dTicksPerSec);
+  int nFailed = 0;
+
+  printf("case,xform,interp,workload,in_channels,out_channels,pixels,passes,setup_ms,ns_per_pixel,mpixels_per_sec\n");
+
+  for (i=0; i<(int)cases.size(); i++) {
+    const BenchCase &bc = cases[i];
+    int nInterp, nWorkload;
+
+    if (szCaseFilter && !strstr(bc.name.c_str(), szCaseFilter))
+      continue;
+
+    for (nInterp=icInterpLinear; nInterp<=(bc.bInterp ? icInterpTetrahedral : icInterpLinear); nInterp++) {
+      const char *szInterp = !bc.bInterp ? "n/a" : (nInterp==icInterpLinear ? "linear" : "tetrahedral");
+      double dSetupMs;
+      CIccCmm *pCmm = CreateBenchCmm(bc, (icXformInterp)nInterp, dSetupMs);
+
+      if (!pCmm) {
+        fprintf(stderr, "%s: unable to begin CMM\n", bc.name.c_str());
+        nFailed++;
+        continue;
+      }
+
+      for (nWorkload=bwUniform; nWorkload<=bwPalette; nWorkload++) {
+        const char *szWorkloadName = GetWorkloadName((BenchWorkload)nWorkload);
+        icUInt32Number nPasses = 0, nBatch = nPixels;
+        icPerfCount nStart, nElapsed;
+        bool bOk;
+
+        if (szWorkload && stricmp(szWorkload, szWorkloadName))
+          continue;
+
+        FillWorkload((BenchWorkload)nWorkload, pSrc, pIndex, nPixels, bc.nInput, BENCH_NAMED_COLORS);
+
+        //Warm up caches (and the MRU cache) with a short batch and use it to keep a single
+        //pass of slow xforms (high dimension NDLut) within the measurement time
+        if (nBatch>256)
+          nBatch = 256;
+        nStart = icPerfTicks();
+        bOk = ApplyBench(bc, pCmm, pDst, pSrc, pIndex, nBatch);
+        nElapsed = icPerfTicks() - nStart;
+
+        if (nElapsed)
+          nBatch = (icUInt32Number)((double)nMinTicks * nBatch / (double)nElapsed);
+        if (!nBatch)
+          nBatch = 1;
+        if (nBatch>nPixels)
+          nBatch = nPixels;
+
+        nStart = icPerfTicks();
+        do {
+          bOk = bOk && ApplyBench(bc, pCmm, pDst, pSrc, pIndex, nBatch);
+          nPasses++;
+          nElapsed = icPerfTicks() - nStart;
+        } while (bOk && nElapsed < nMinTicks);
+
+        if (!bOk) {
+          fprintf(stderr, "%s: Apply failed\n", bc.name.c_str());
+          nFailed++;
+          continue;
+        }
+
+        double dNsPerPixel = (double)nElapsed * 1.0e9 / dTicksPerSec / ((double)nPasses * nBatch);
+
+        printf("%s,%s,%s,%s,%d,%d,%lu,%lu,%.3f,%.2f,%.3f\n", bc.name.c_str(), bc.szXform, szInterp, szWorkloadName,
+               bc.nInput, bc.nOutput, (unsigned long)nBatch, (unsigned long)nPasses, dSetupMs, dNsPerPixel,
+               dNsPerPixel>0.0 ? 1000.0/dNsPerPixel : 0.0);
+        fflush(stdout);
+      }
+
+      delete pCmm;
+    }
+  }
+
+  free(pSrc);
+  free(pDst);
+  free(pIndex);
+
+  return nFailed ? -1 : 0;
+}
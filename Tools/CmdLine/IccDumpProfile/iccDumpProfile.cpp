@@ -66,23 +66,25 @@
 //
 // -Initial implementation by Max Derhak 5-15-2003
 //
+// -Tags are streamed to stdout, added -n option to limit CLUT dumps 10-19-2026
+// -Tags are validated on all processors, added -f option for fast validation 10-19-2026
+//
 //////////////////////////////////////////////////////////////////////
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <cstring>
 #include "IccProfile.h"
 #include "IccTag.h"
 #include "IccUtil.h"
 
-void DumpTag(CIccProfile *pIcc, icTagSignature sig)
+void DumpTag(CIccProfile *pIcc, icTagSignature sig, icUInt32Number nMaxGridPoints)
 {
   CIccTag *pTag = pIcc->FindTag(sig);
   char buf[64];
   CIccInfo Fmt;
 
-  std::string contents;
-
   if (pTag) {
     printf("\nContents of %s tag (%s)\n", Fmt.GetTagSigName(sig), icGetSig(buf, sig)); 
     printf("Type:   ");
@@ -90,8 +92,11 @@ void DumpTag(CIccProfile *pIcc, icTagSignature sig)
       printf("Array of ");
     }
     printf("%s\n", Fmt.GetTagTypeSigName(pTag->GetType()));
-    pTag->Describe(contents);
-    fwrite(contents.c_str(), contents.length(), 1, stdout);
+    fflush(stdout);
+
+    CIccDescribeFileSink sink(stdout, nMaxGridPoints);
+    pTag->DescribeTo(&sink);
+    sink.Flush();
   }
   else {
     printf("Tag (%s) not found in profile\n", icGetSig(buf, sig));
@@ -104,25 +109,45 @@ int main(int argc, char* argv[])
 
   if (argc<=1) {
 print_usage:
-    printf("Usage: iccDumpProfile [-v] profile [tagId to dump/\"ALL\"]\n");
+    printf("Usage: iccDumpProfile [-v] [-f] [-n max_grid_points] profile [tagId to dump/\"ALL\"]\n");
+    printf("  -v validates the profile\n");
+    printf("  -f skips validation checks that scan all of the profile data (profile ID check)\n");
+    printf("  -n only dumps the first max_grid_points grid points of each CLUT\n");
     return -1;
   }
 
   CIccProfile *pIcc;
   std::string sReport;
   icValidateStatus nStatus;
+  bool bValidate = false;
+  bool bFast = false;
+  icUInt32Number nMaxGridPoints = 0;
+
+  while (nArg<argc && argv[nArg][0]=='-') {
+    if (!strncmp(argv[nArg], "-V", 2) || !strncmp(argv[nArg], "-v", 2)) {
+      bValidate = true;
+      nArg++;
+    }
+    else if (!strncmp(argv[nArg], "-F", 2) || !strncmp(argv[nArg], "-f", 2)) {
+      bFast = true;
+      nArg++;
+    }
+    else if (!strncmp(argv[nArg], "-N", 2) || !strncmp(argv[nArg], "-n", 2)) {
+      if (nArg+1>=argc)
+        goto print_usage;
 
-  if (!strncmp(argv[1], "-V", 2) || !strncmp(argv[1], "-v", 2)) {
-    if (argc<=2)
+      nMaxGridPoints = (icUInt32Number)atol(argv[nArg+1]);
+      nArg += 2;
+    }
+    else
       goto print_usage;
-
-    nArg = 2;
-
-    pIcc = ValidateIccProfile(argv[nArg], sReport, nStatus);
   }
-  else
-  if (strncmp(argv[1], "-h", 2) == 0)
+
+  if (nArg>=argc)
     goto print_usage;
+
+  if (bValidate)
+    pIcc = ValidateIccProfile(argv[nArg], sReport, nStatus, 0, bFast);
   else
     pIcc = OpenIccProfile(argv[nArg]);
 
@@ -179,16 +204,16 @@ print_usage:
     if (argc>nArg+1) {
       if (!stricmp(argv[nArg+1], "ALL")) {
         for (n=0, i=pIcc->m_Tags->begin(); i!=pIcc->m_Tags->end(); i++, n++) {
-          DumpTag(pIcc, i->TagInfo.sig);
+          DumpTag(pIcc, i->TagInfo.sig, nMaxGridPoints);
         }
       }
       else {
-        DumpTag(pIcc, (icTagSignature)icGetSigVal(argv[nArg+1]));
+        DumpTag(pIcc, (icTagSignature)icGetSigVal(argv[nArg+1]), nMaxGridPoints);
       }
     }
   }
 
-  if (nArg>1) {
+  if (bValidate) {
     printf("\nValidation Report\n");
     printf(  "-----------------\n");
     switch (nStatus) {
@@ -66,114 +66,106 @@
 //
 // -Initial implementation by Max Derhak 6-3-2007
 //
+// -Oct 19, 2026
+// Girdle found with CIccGamutBoundary::FindGirdle, optionally saving a gamut boundary descriptor
+//
 //////////////////////////////////////////////////////////////////////
 
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <math.h>
 #include "IccCmm.h"
+#include "IccGamutBoundary.h"
 
 int main(int argc, char* argv[])
 {
-  int nArg = 1;
-
-  if (argc<=1) {
-    printf("Usage: iccGamutMapGirdle profile num_hue {rendering_intent=3 {use_mpe=0}}\n");
+  if (argc<=2) {
+    printf("Usage: iccGamutMapGirdle profile num_hue {rendering_intent=3 {use_mpe=0 {boundary_file}}}\n");
     printf("  where\n");
 	  printf("   num_hue is number of equal spaced hue steps\n");
 	  printf("   rendering_intent is (0=perceptual, 1=relative, 2=saturation, 3=absolute)\n");
+    printf("   boundary_file receives a CIccGamutBoundary descriptor of the profile (not used for the girdle)\n");
     return -1;
   }
 
   icRenderingIntent nIntent = icAbsoluteColorimetric;
   int nUseMPE = 0;
   int nHueSteps = atoi(argv[2]);
+  const char *szBoundaryFile = NULL;
+
+  if (nHueSteps<1) {
+    printf("Invalid number of hue steps\n");
+    return -1;
+  }
 
   if (argc>3) {
     nIntent = (icRenderingIntent)atoi(argv[3]);
     if (argc>4) {
       nUseMPE = atoi(argv[4]);
+      if (argc>5)
+        szBoundaryFile = argv[5];
     }
   }
 
-  CIccCmm cmm(icSigLabData, icSigLabData, false);
+  icFloatNumber hue, hueStep;
+  int i, nHues;
 
-  if (cmm.AddXform(argv[1], nIntent, icInterpTetrahedral, icXformLutColor, nUseMPE==1)!=icCmmStatOk) {
-    printf("Unable to add '%s' to cmm\n", argv[1]);
-    return -2;
-  }
-  if (cmm.AddXform(argv[1], nIntent, icInterpTetrahedral, icXformLutColor, nUseMPE==1)!=icCmmStatOk) {
-    printf("Unable to append '%s' to cmm\n", argv[1]);
+  hueStep = 360.0f /(icFloatNumber)nHueSteps;
+
+  //Hues are accumulated the same way as the original scan
+  for (nHues=0, hue=0.0; hue<360.0; hue += hueStep)
+    nHues++;
+
+  icFloatNumber *pHue = new icFloatNumber[nHues];
+  icFloatNumber *pLCh = new icFloatNumber[nHues*3];
+
+  for (i=0, hue=0.0; i<nHues; i++, hue += hueStep)
+    pHue[i] = hue;
+
+  icStatusCMM stat;
+
+  stat = CIccGamutBoundary::FindGirdle(pLCh, pHue, (icUInt32Number)nHues, argv[1], nIntent,
+                                       icInterpTetrahedral, nUseMPE==1);
+  if (stat==icCmmStatCantOpenProfile) {
+    printf("Unable to open '%s'\n", argv[1]);
+    delete [] pLCh;
+    delete [] pHue;
     return -2;
   }
-
-  if (cmm.Begin()!=icCmmStatOk) {
-    printf("Unable to begin profile apply\n");
+  else if (stat!=icCmmStatOk) {
+    printf("Unable to apply '%s'\n", argv[1]);
+    delete [] pLCh;
+    delete [] pHue;
     return -3;
   }
-  
-  icFloatNumber pixel[16], bestLCH[3];
-
-  icFloatNumber hue, hueStep;
-  icFloatNumber Lval, Cval;
-  icFloatNumber maxC;
 
-  hueStep = 360.0f /(icFloatNumber)nHueSteps;
+  if (szBoundaryFile) {
+    CIccGamutBoundary boundary;
 
-  printf("L*\tC*\tH*\n");
-  for (hue=0.0; hue<360.0; hue += hueStep) {
-    maxC=-10;
-    memset(bestLCH, 0, sizeof(bestLCH));
-    for (Lval = 100.0; Lval>=0.0; Lval-=.5) {
-      pixel[0] = Lval;
-      pixel[1] = 128;
-      pixel[2] = hue;
-      icLch2Lab(pixel);
-      icLabToPcs(pixel);
-
-      cmm.Apply(pixel,pixel);
-
-      icLabFromPcs(pixel);
-      icLab2Lch(pixel);
-      if (pixel[1]>maxC) {
-        maxC = pixel[1];
-        memcpy(bestLCH, pixel, 3*sizeof(icFloatNumber));
-      }
+    if (boundary.Generate(argv[1], nIntent, icInterpTetrahedral, nUseMPE==1, (icUInt32Number)nHueSteps)!=icCmmStatOk) {
+      printf("Unable to determine gamut boundary of '%s'\n", argv[1]);
+      delete [] pLCh;
+      delete [] pHue;
+      return -3;
     }
-    for (Cval=25; Cval<128; Cval+=.5) {
-      pixel[0] = 100;
-      pixel[1] = Cval;
-      pixel[2] = hue;
-      icLch2Lab(pixel);
-      icLabToPcs(pixel);
-
-      cmm.Apply(pixel,pixel);
-
-      icLabFromPcs(pixel);
-      icLab2Lch(pixel);
-      if (pixel[1]>maxC) {
-        maxC = pixel[1];
-        memcpy(bestLCH, pixel, 3*sizeof(icFloatNumber));
-      }
-
-      pixel[0] = 0;
-      pixel[1] = Cval;
-      pixel[2] = hue;
-      icLch2Lab(pixel);
-      icLabToPcs(pixel);
-
-      cmm.Apply(pixel,pixel);
-
-      icLabFromPcs(pixel);
-      icLab2Lch(pixel);
-      if (pixel[1]>maxC) {
-        maxC = pixel[1];
-        memcpy(bestLCH, pixel, 3*sizeof(icFloatNumber));
-      }
+    if (!boundary.Save(szBoundaryFile)) {
+      printf("Unable to save gamut boundary to '%s'\n", szBoundaryFile);
+      delete [] pLCh;
+      delete [] pHue;
+      return -4;
     }
+  }
+
+  printf("L*\tC*\tH*\n");
+  for (i=0; i<nHues; i++) {
+    icFloatNumber *bestLCH = &pLCh[i*3];
+
     printf("%.2f\t%.2f\t%.2f\n", bestLCH[0], bestLCH[1], bestLCH[2]);
   }
 
+  delete [] pLCh;
+  delete [] pHue;
+
   return 0;
 }
-
@@ -1,9 +1,14 @@
 // IccFloat.cpp : Defines the entry point for the console application.
 //
 
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 #include "IccCmm.h"
 #include "IccTagMPE.h"
 #include "IccMpeBasic.h"
+#include "IccDeviceLink.h"
+#include "IccUtil.h"
 
 #define minXYZ 0.0
 #define maxXYZ (1.0 + 32767.0/32768)
@@ -492,10 +497,119 @@ CIccTag* ConvertTag(CIccTag *pTag, bool bStrict, icColorSpaceSignature pcs)
 }
 
 
+//Number of random points used to find the maximum error of a flattened tag
+#define FLATTEN_TEST_POINTS 20000
+
+//Returns the largest difference (in IccProfLib 0.0 to 1.0 encoding) between the CMM and the flattened tag
+double FlattenError(CIccCmm *pCmm, CIccTagMultiProcessElement *pMPE, bool bPcsInput)
+{
+  icColorSpaceSignature srcSpace = pCmm->GetSourceSpace();
+  icColorSpaceSignature dstSpace = pCmm->GetDestSpace();
+  int nSrc = icGetSpaceSamples(srcSpace);
+  int nDst = icGetSpaceSamples(dstSpace);
+  icFloatNumber src[16], real[16], dst[16], flat[16];
+  double dMaxErr = 0.0;
+  int i, j;
+
+  if (!pMPE->Begin())
+    return -1.0;
+
+  CIccApplyTagMpe *pApply = pMPE->GetNewApply();
+  if (!pApply)
+    return -1.0;
+
+  srand(1);
+  for (i=0; i<FLATTEN_TEST_POINTS; i++) {
+    for (j=0; j<nSrc; j++)
+      src[j] = (icFloatNumber)rand() / (icFloatNumber)RAND_MAX;
+
+    pCmm->Apply(dst, src);
+
+    memcpy(real, src, nSrc*sizeof(icFloatNumber));
+    if (bPcsInput && srcSpace==icSigLabData)
+      icLabFromPcs(real);
+    else if (bPcsInput && srcSpace==icSigXYZData)
+      icXyzFromPcs(real);
+
+    pMPE->Apply(pApply, flat, real);
+
+    if (dstSpace==icSigLabData)
+      icLabToPcs(flat);
+    else if (dstSpace==icSigXYZData)
+      icXyzToPcs(flat);
+
+    for (j=0; j<nDst; j++) {
+      double dErr = fabs(flat[j] - dst[j]);
+
+      if (dErr>dMaxErr)
+        dMaxErr = dErr;
+    }
+  }
+
+  delete pApply;
+
+  return dMaxErr;
+}
+
+//Evaluates the whole lut tag sigLut of a profile into a curve set and a single float CLUT
+CIccTag* FlattenTag(CIccProfile *pProfile, icTagSignature sigLut, icUInt8Number nGridPoints)
+{
+  bool bInput = (sigLut>=icSigAToB0Tag && sigLut<=icSigAToB2Tag);
+  icRenderingIntent nIntent = (icRenderingIntent)(bInput ? sigLut - icSigAToB0Tag : sigLut - icSigBToA0Tag);
+  CIccCmm cmm(icSigUnknownData, icSigUnknownData, bInput);
+  CIccInfo Info;
+
+  //The CMM owns the profile passed to AddXform so give it a copy
+  if (cmm.AddXform(new CIccProfile(*pProfile), nIntent, icInterpLinear, icXformLutColor, false) ||
+      cmm.Begin()) {
+    printf("%s: unable to evaluate tag\n", Info.GetTagSigName(sigLut));
+    return NULL;
+  }
+
+  bool bPcsInput = !bInput && pProfile->m_Header.deviceClass!=icSigLinkClass;
+  CIccDeviceLink Flatten(icDevLinkMpe, nGridPoints);
+  icStatusCMM stat;
+  CIccTagMultiProcessElement *pMPE = Flatten.CreateMpeTag(&cmm, stat, bPcsInput);
+
+  if (!pMPE) {
+    printf("%s: unable to flatten tag (status %d)\n", Info.GetTagSigName(sigLut), stat);
+    return NULL;
+  }
+
+  printf("%s: flattened with max error %.6f\n", Info.GetTagSigName(sigLut), FlattenError(&cmm, pMPE, bPcsInput));
+
+  return pMPE;
+}
+
 int main(int argc, char* argv[])
 {
   CIccProfile *pProfile;
   bool bStrict = true;
+  bool bFlatten = false;
+  icUInt8Number nGridPoints = 0;
+
+  //Options come before the positional arguments
+  while (argc>1 && !strncmp(argv[1], "--", 2)) {
+    if (!stricmp(argv[1], "--flatten"))
+      bFlatten = true;
+    else if (!strncmp(argv[1], "--flatten=", 10)) {
+      int nGrid = atoi(argv[1]+10);
+
+      if (nGrid<2 || nGrid>255) {
+        printf("Invalid grid size [%s]\n", argv[1]);
+        return -1;
+      }
+      bFlatten = true;
+      nGridPoints = (icUInt8Number)nGrid;
+    }
+    else {
+      printf("Unknown option [%s]\n", argv[1]);
+      argc = 0;
+      break;
+    }
+    argv++;
+    argc--;
+  }
 
   if (argc>2) {
     pProfile = ReadIccProfile(argv[1]);
@@ -515,42 +629,60 @@ int main(int argc, char* argv[])
           connectSig = icSigUnknownData;
 
         if ((pTagLut=pProfile->FindTag(icSigAToB0Tag))) {
-          pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
+          if (bFlatten)
+            pTagMBE = FlattenTag(pProfile, icSigAToB0Tag, nGridPoints);
+          else
+            pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
           if (pTagMBE) {
             pProfile->AttachTag(icSigDToB0Tag, pTagMBE);
           }
         }
 
         if ((pTagLut=pProfile->FindTag(icSigAToB1Tag))) {
-          pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
+          if (bFlatten)
+            pTagMBE = FlattenTag(pProfile, icSigAToB1Tag, nGridPoints);
+          else
+            pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
           if (pTagMBE) {
             pProfile->AttachTag(icSigDToB1Tag, pTagMBE);
           }
         }
 
         if ((pTagLut=pProfile->FindTag(icSigAToB2Tag))) {
-          pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
+          if (bFlatten)
+            pTagMBE = FlattenTag(pProfile, icSigAToB2Tag, nGridPoints);
+          else
+            pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
           if (pTagMBE) {
             pProfile->AttachTag(icSigDToB2Tag, pTagMBE);
           }
         }
 
         if ((pTagLut=pProfile->FindTag(icSigBToA0Tag))) {
-          pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
+          if (bFlatten)
+            pTagMBE = FlattenTag(pProfile, icSigBToA0Tag, nGridPoints);
+          else
+            pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
           if (pTagMBE) {
             pProfile->AttachTag(icSigBToD0Tag, pTagMBE);
           }
         }
 
         if ((pTagLut=pProfile->FindTag(icSigBToA1Tag))) {
-          pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
+          if (bFlatten)
+            pTagMBE = FlattenTag(pProfile, icSigBToA1Tag, nGridPoints);
+          else
+            pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
           if (pTagMBE) {
             pProfile->AttachTag(icSigBToD1Tag, pTagMBE);
           }
         }
 
         if ((pTagLut=pProfile->FindTag(icSigBToA2Tag))) {
-          pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
+          if (bFlatten)
+            pTagMBE = FlattenTag(pProfile, icSigBToA2Tag, nGridPoints);
+          else
+            pTagMBE = ConvertTag(pTagLut, bStrict, connectSig);
           if (pTagMBE) {
             pProfile->AttachTag(icSigBToD2Tag, pTagMBE);
           }
@@ -571,7 +703,10 @@ int main(int argc, char* argv[])
     }
   }
   else {
-    printf("Usage IccV4ToMPE from_profile to_profile {strict=0/1}\n");
+    printf("Usage IccV4ToMPE {--flatten{=grid_points}} from_profile to_profile {strict=0/1}\n\n");
+    printf("  --flatten evaluates each lut tag into one curve set and one float CLUT\n");
+    printf("    (grid_points per input channel, default depends on the number of inputs)\n");
+    printf("    and reports the largest error of the result\n");
     return -1;
   }
   